@@ -291,10 +291,358 @@ void update_read_req_coverage(read_req_t* req,
 }
 
 
+/* Return the logio context for the log of the given local client,
+ * attaching to the log of another client on first use */
+static logio_context* get_client_logio(unifyfs_client* client,
+                                       int log_client_id)
+{
+    if (log_client_id == client->state.client_id) {
+        return client->state.logio_ctx;
+    }
+    if (client->logio_ctx_ptrs[log_client_id] == NULL) {
+        size_t shmem_size = 0;
+        if (client->state.logio_ctx->shmem != NULL) {
+            shmem_size = client->state.logio_ctx->shmem->size;
+        }
+        char* spill_dir = NULL;
+        if (client->state.logio_ctx->spill_sz > 0) {
+            spill_dir = client->cfg.logio_spill_dir;
+        }
+        unifyfs_logio_init(client->state.app_id,
+                           log_client_id,
+                           shmem_size,
+                           client->state.logio_ctx->spill_sz,
+                           spill_dir,
+                           &client->logio_ctx_ptrs[log_client_id]);
+    }
+    return client->logio_ctx_ptrs[log_client_id];
+}
+
+/* Read a batch of log ranges for a request from a single client log,
+ * and record the bytes read in the request coverage */
+static void read_local_log_ranges(logio_context* logio_ctx,
+                                  read_req_t* req,
+                                  int n_iov,
+                                  logio_iovec* iov,
+                                  size_t* req_byte_offsets)
+{
+    if ((NULL == logio_ctx) || (0 == n_iov)) {
+        return;
+    }
+
+    unifyfs_logio_readv(logio_ctx, n_iov, iov);
+    for (int k = 0; k < n_iov; k++) {
+        if (iov[k].rc == UNIFYFS_SUCCESS) {
+            /* update bytes we have filled in the request buffer */
+            update_read_req_coverage(req, req_byte_offsets[k],
+                                     iov[k].obytes);
+        } else {
+            LOGERR("local log read failed for offset=%zu size=%zu",
+                   (size_t) iov[k].log_offset, iov[k].nbytes);
+            req->errcode = iov[k].rc;
+        }
+    }
+}
+
+/* Copy the data for a read request from local logs, given the extents
+ * of its file sorted by offset, starting with the first extent that ends
+ * at or after the start of the request. Returns 1 if the extents cover
+ * the whole request and its data was copied, 0 if some bytes are not
+ * covered (and nothing was copied) */
+static int read_local_extents(unifyfs_client* client,
+                              read_req_t* req,
+                              const struct seg_tree_extent* exts,
+                              unsigned long n_avail)
+{
+    /* start and length of this request */
+    size_t req_start = req->offset;
+    size_t req_end   = req->offset + req->length;
+
+    /* this will point to the offset of the next byte we
+     * need to account for */
+    size_t expected_start = req_start;
+
+    /* check that there are no holes in coverage, and count the
+     * extents that cover the request */
+    unsigned long n_exts = 0;
+    while ((n_exts < n_avail) && (exts[n_exts].start < req_end)) {
+        if (expected_start < exts[n_exts].start) {
+            /* there is a gap between extents so we're missing
+             * some bytes */
+            return 0;
+        }
+
+        /* this extent has the next byte we expect, bump up to the
+         * first byte past the end of this extent */
+        expected_start = exts[n_exts].end + 1;
+        n_exts++;
+    }
+
+    /* check that we account for the full request
+     * up until the last byte */
+    if (expected_start < req_end) {
+        /* missing some bytes at the end of the request */
+        return 0;
+    }
+
+    /* we can copy the data locally, iterate over the extents and
+     * copy data into request buffer. the reads from each client log
+     * are issued together */
+    logio_iovec* iov = calloc(n_exts, sizeof(logio_iovec));
+    size_t* req_byte_offsets = calloc(n_exts, sizeof(size_t));
+    if ((n_exts > 0) && ((NULL == iov) || (NULL == req_byte_offsets))) {
+        LOGERR("failed to allocate local read iovecs");
+        req->errcode = ENOMEM;
+        n_exts = 0;
+    }
+    int n_iov = 0;
+    logio_context* batch_ctx = NULL;
+
+    for (unsigned long i = 0; i < n_exts; i++) {
+        const struct seg_tree_extent* ext = exts + i;
+
+        /* get start and length of this extent */
+        size_t ext_start = ext->start;
+        size_t ext_length = (ext->end + 1) - ext_start;
+
+        /* get the offset into the log */
+        size_t ext_log_pos = ext->ptr;
+
+        /* get number of bytes from start of extent and request
+         * buffers to the start of the overlap region */
+        size_t ext_byte_offset, req_byte_offset, cover_length;
+        char* req_ptr = get_extent_coverage(req, ext_start, ext_length,
+                                            &req_byte_offset,
+                                            &ext_byte_offset,
+                                            &cover_length);
+        assert(req_ptr != NULL);
+
+        if (ext_log_pos == SEG_TREE_HOLE_PTR) {
+            /* hole extents have no log data, fill with zeros */
+            memset(req_ptr, 0, cover_length);
+            update_read_req_coverage(req, req_byte_offset, cover_length);
+            continue;
+        }
+
+        /* we need to use the logio_ctx from correct client */
+        logio_context* logio_ctx = get_client_logio(client, ext->client_id);
+        if (logio_ctx != batch_ctx) {
+            /* read the ranges gathered for the previous log */
+            read_local_log_ranges(batch_ctx, req, n_iov, iov,
+                                  req_byte_offsets);
+            n_iov = 0;
+            batch_ctx = logio_ctx;
+        }
+
+        /* add range in local write log to copy into user buffer */
+        if (NULL != logio_ctx) {
+            iov[n_iov].log_offset = ext_log_pos + ext_byte_offset;
+            iov[n_iov].nbytes     = cover_length;
+            iov[n_iov].buf        = req_ptr;
+            req_byte_offsets[n_iov] = req_byte_offset;
+            n_iov++;
+        }
+    }
+    read_local_log_ranges(batch_ctx, req, n_iov, iov, req_byte_offsets);
+    free(iov);
+    free(req_byte_offsets);
+
+    return 1;
+}
+
+/* Copy data for a read request using the extent tree of its file, which
+ * must be locked for reading. Returns 1 if the request was completed,
+ * 0 if some bytes are not covered by local extents */
+static int read_local_tree(unifyfs_client* client,
+                           read_req_t* req,
+                           struct seg_tree* extents)
+{
+    size_t req_start = req->offset;
+    size_t req_end   = req->offset + req->length;
+
+    /* we search for a starting extent using a range
+     * of just the very first byte that we need */
+    struct seg_tree_node* first;
+    first = seg_tree_find_nolock(extents, req_start, req_start);
+    if (NULL == first) {
+        return (req->length == 0);
+    }
+
+    /* copy the extents that overlap the request */
+    unsigned long n_exts = 0;
+    struct seg_tree_node* next = first;
+    while ((next != NULL) && (next->start < req_end)) {
+        n_exts++;
+        next = seg_tree_iter(extents, next);
+    }
+    struct seg_tree_extent* exts = calloc(n_exts,
+                                          sizeof(struct seg_tree_extent));
+    if (NULL == exts) {
+        return 0;
+    }
+    unsigned long i = 0;
+    for (next = first; i < n_exts; next = seg_tree_iter(extents, next)) {
+        exts[i].start = next->start;
+        exts[i].end = next->end;
+        exts[i].ptr = next->ptr;
+        exts[i].client_id = next->client_id;
+        i++;
+    }
+
+    int have_local = read_local_extents(client, req, exts, n_exts);
+    free(exts);
+    return have_local;
+}
+
+/* detached shared extent index, unmapped once its readers are done */
+struct client_retired_extents {
+    client_retired_extents* next;
+    shm_context* ctx;
+    unsigned int drained; /* reader counters seen empty since detach */
+};
+
+/* Unmap the detached shared extent indexes of the file that no reader
+ * can still be using, as for withdrawn seg_tree snapshots.
+ * Caller must hold extent_cache_sync */
+static void reclaim_shared_extents(unifyfs_filemeta_t* meta)
+{
+    unsigned int drained =
+        reader_epoch_drained(&(meta->shared_extents_readers));
+    client_retired_extents** prev = &(meta->shared_extents_retired);
+    client_retired_extents* ret = meta->shared_extents_retired;
+    while (NULL != ret) {
+        client_retired_extents* next = ret->next;
+        ret->drained |= drained;
+        if (READER_EPOCH_DRAINED == ret->drained) {
+            __atomic_store_n(prev, next, __ATOMIC_SEQ_CST);
+            unifyfs_shm_free(&(ret->ctx));
+            free(ret);
+        } else {
+            prev = &(ret->next);
+        }
+        ret = next;
+    }
+}
+
+/* Return the shared extent index that the local server published for a
+ * laminated file, or NULL if the client has not attached to one. A
+ * returned index stays mapped until it is released with
+ * put_shared_extents(), passing the ticket set here */
+static const struct seg_tree_snapshot* get_shared_extents(
+    unifyfs_filemeta_t* meta,
+    unsigned long* ticket)
+{
+    unsigned long t = reader_epoch_enter(&(meta->shared_extents_readers));
+    shm_context* ctx = __atomic_load_n(&(meta->shared_extents),
+                                       __ATOMIC_SEQ_CST);
+    if (NULL == ctx) {
+        reader_epoch_exit(&(meta->shared_extents_readers), t);
+        return NULL;
+    }
+    *ticket = t;
+    return (const struct seg_tree_snapshot*)
+        ((char*)ctx->addr + sizeof(shm_extents_header));
+}
+
+/* Release an index returned by get_shared_extents(). The last reader of
+ * a detached index unmaps it */
+static void put_shared_extents(unifyfs_client* client,
+                               unifyfs_filemeta_t* meta,
+                               unsigned long ticket)
+{
+    if ((reader_epoch_exit(&(meta->shared_extents_readers), ticket) == 0) &&
+        (NULL != __atomic_load_n(&(meta->shared_extents_retired),
+                                 __ATOMIC_SEQ_CST))) {
+        pthread_mutex_lock(&(client->extent_cache_sync));
+        reclaim_shared_extents(meta);
+        pthread_mutex_unlock(&(client->extent_cache_sync));
+    }
+}
+
+/* detach from the shared extent index of a file, unmapping it once no
+ * reader is using it */
+void client_detach_shared_extents(unifyfs_client* client,
+                                  unifyfs_filemeta_t* meta)
+{
+    pthread_mutex_lock(&(client->extent_cache_sync));
+    reader_epoch_advance(&(meta->shared_extents_readers));
+    shm_context* ctx = __atomic_exchange_n(&(meta->shared_extents), NULL,
+                                           __ATOMIC_SEQ_CST);
+    if (NULL != ctx) {
+        client_retired_extents* ret = malloc(sizeof(*ret));
+        if (NULL == ret) {
+            /* leave it mapped rather than risk unmapping it under a
+             * reader */
+            LOGERR("failed to allocate to detach shared extent index");
+        } else {
+            ret->ctx = ctx;
+            ret->drained = 0;
+            ret->next = meta->shared_extents_retired;
+            __atomic_store_n(&(meta->shared_extents_retired), ret,
+                             __ATOMIC_SEQ_CST);
+        }
+    }
+    reclaim_shared_extents(meta);
+    pthread_mutex_unlock(&(client->extent_cache_sync));
+}
+
+/* Attach to the shared extent index of a laminated file, if the local
+ * server published one. An index that does not exist (yet) is looked
+ * for again after a short wait. Caller must hold extent_cache_sync */
+static void attach_shared_extents(unifyfs_client* client,
+                                  unifyfs_filemeta_t* meta)
+{
+    if (NULL != meta->shared_extents) {
+        return;
+    }
+    time_t now = time(NULL);
+    if (now < meta->shared_extents_retry) {
+        return;
+    }
+    meta->shared_extents_retry =
+        now + UNIFYFS_CLIENT_SHARED_EXTENTS_RETRY_SECONDS;
+
+    int gfid = meta->attrs.gfid;
+    char shm_name[SHMEM_NAME_LEN] = {0};
+    snprintf(shm_name, sizeof(shm_name), SHMEM_EXTENTS_FMTSTR,
+             client->state.app_id, gfid);
+    shm_context* ctx = unifyfs_shm_attach_readonly(shm_name);
+    if (NULL == ctx) {
+        return;
+    }
+
+    /* check the index is complete and matches its size */
+    const shm_extents_header* hdr = (const shm_extents_header*) ctx->addr;
+    const struct seg_tree_snapshot* snap = (const struct seg_tree_snapshot*)
+        ((char*)ctx->addr + sizeof(shm_extents_header));
+    size_t min_size = sizeof(shm_extents_header) +
+                      sizeof(struct seg_tree_snapshot);
+    if ((ctx->size < min_size) ||
+        !__atomic_load_n(&(hdr->ready), __ATOMIC_ACQUIRE) ||
+        (hdr->gfid != gfid) || (hdr->size != ctx->size) ||
+        (ctx->size != (min_size +
+                       (snap->count * sizeof(struct seg_tree_extent))))) {
+        LOGDBG("shared extent index %s is not ready", shm_name);
+        unifyfs_shm_free(&ctx);
+        return;
+    }
+
+    LOGDBG("attached to shared extent index %s with %lu extents",
+           shm_name, snap->count);
+    reader_epoch_advance(&(meta->shared_extents_readers));
+    __atomic_store_n(&(meta->shared_extents), ctx, __ATOMIC_RELEASE);
+}
+
 /* This uses information in the extent map for a file on the client to
  * complete any read requests.  It only complets a request if it contains
  * all of the data.  Otherwise the request is copied to the list of
- * requests to be handled by the server. */
+ * requests to be handled by the server.
+ *
+ * When the file has a published snapshot of its extents, the snapshot is
+ * searched without locking the extent tree, so readers do not contend
+ * with each other or wait for writers. For a laminated file with a
+ * shared extent index published by the local server, the index is
+ * searched instead of the client's own extents. */
 static
 void service_local_reqs(
     unifyfs_client* client,
@@ -330,54 +678,38 @@ void service_local_reqs(
             continue;
         }
 
-        /* start and length of this request */
-        size_t req_start = req->offset;
-        size_t req_end   = req->offset + req->length;
-
         /* get pointer to extents for this file */
         unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
         assert(meta != NULL);
         struct seg_tree* extents = &meta->extents;
 
-        /* lock the extent tree for reading */
-        seg_tree_rdlock(extents);
-
-        /* can we fully satisfy this request? assume we can */
-        int have_local = 1;
-
-        /* this will point to the offset of the next byte we
-         * need to account for */
-        size_t expected_start = req_start;
-
-        /* iterate over extents we have for this file,
-         * and check that there are no holes in coverage.
-         * we search for a starting extent using a range
-         * of just the very first byte that we need */
-        struct seg_tree_node* first;
-        first = seg_tree_find_nolock(extents, req_start, req_start);
-        struct seg_tree_node* next = first;
-        while (next != NULL && next->start < req_end) {
-            if (expected_start >= next->start) {
-                /* this extent has the next byte we expect,
-                 * bump up to the first byte past the end
-                 * of this extent */
-                expected_start = next->end + 1;
-            } else {
-                /* there is a gap between extents so we're missing
-                 * some bytes */
-                have_local = 0;
-                break;
-            }
-
-            /* get the next element in the tree */
-            next = seg_tree_iter(extents, next);
+        /* publish a snapshot of the extents on the first read after
+         * they were synced or the file was laminated, clearing the flag
+         * so that only one of the concurrent readers publishes */
+        if (__atomic_exchange_n(&(meta->publish_extents), 0,
+                                __ATOMIC_SEQ_CST)) {
+            seg_tree_snapshot_publish(extents);
         }
 
-        /* check that we account for the full request
-         * up until the last byte */
-        if (expected_start < req_end) {
-            /* missing some bytes at the end of the request */
-            have_local = 0;
+        int have_local;
+        unsigned long ticket;
+        const struct seg_tree_snapshot* snap;
+        const struct seg_tree_snapshot* shared = get_shared_extents(meta,
+                                                                    &ticket);
+        if (NULL != shared) {
+            unsigned long first = seg_tree_snapshot_find(shared, req->offset);
+            have_local = read_local_extents(client, req, shared->segs + first,
+                                            shared->count - first);
+            put_shared_extents(client, meta, ticket);
+        } else if (NULL != (snap = seg_tree_snapshot_get(extents, &ticket))) {
+            unsigned long first = seg_tree_snapshot_find(snap, req->offset);
+            have_local = read_local_extents(client, req, snap->segs + first,
+                                            snap->count - first);
+            seg_tree_snapshot_put(extents, ticket);
+        } else {
+            seg_tree_rdlock(extents);
+            have_local = read_local_tree(client, req, extents);
+            seg_tree_unlock(extents);
         }
 
         /* if we can't fully satisfy the request, copy request to
@@ -387,83 +719,12 @@ void service_local_reqs(
              * that we'll ask server for */
             memcpy(&server_reqs[server_count], req, sizeof(read_req_t));
             server_count++;
-
-            /* release lock before we go to next request */
-            seg_tree_unlock(extents);
-
             continue;
         }
 
-        /* otherwise we can copy the data locally, iterate
-         * over the extents and copy data into request buffer.
-         * again search for a starting extent using a range
-         * of just the very first byte that we need */
-        next = first;
-        while ((next != NULL) && (next->start < req_end)) {
-            /* get start and length of this extent */
-            size_t ext_start = next->start;
-            size_t ext_length = (next->end + 1) - ext_start;
-
-            /* get the offset into the log */
-            size_t ext_log_pos = next->ptr;
-
-            /* get number of bytes from start of extent and request
-             * buffers to the start of the overlap region */
-            size_t ext_byte_offset, req_byte_offset, cover_length;
-            char* req_ptr = get_extent_coverage(req, ext_start, ext_length,
-                                                &req_byte_offset,
-                                                &ext_byte_offset,
-                                                &cover_length);
-            assert(req_ptr != NULL);
-
-            /* copy data from local write log into user buffer */
-            off_t log_offset = ext_log_pos + ext_byte_offset;
-            size_t nread = 0;
-            /* we need to use the logio_ctx from correct client */
-            logio_context* logio_ctx = NULL;
-            if (next->client_id == client->state.client_id) {
-                logio_ctx = client->state.logio_ctx;
-            } else if (client->logio_ctx_ptrs[next->client_id] != NULL) {
-                logio_ctx = client->logio_ctx_ptrs[next->client_id];
-            } else {
-                size_t shmem_size = 0;
-                if (client->state.logio_ctx->shmem != NULL) {
-                    shmem_size = client->state.logio_ctx->shmem->size;
-                }
-                char* spill_dir = NULL;
-                if (client->state.logio_ctx->spill_sz > 0) {
-                    spill_dir = client->cfg.logio_spill_dir;
-                }
-                unifyfs_logio_init(client->state.app_id,
-                                   next->client_id,
-                                   shmem_size,
-                                   client->state.logio_ctx->spill_sz,
-                                   spill_dir,
-                                   &client->logio_ctx_ptrs[next->client_id]);
-                logio_ctx = client->logio_ctx_ptrs[next->client_id];
-            }
-            if (NULL != logio_ctx) {
-                int rc = unifyfs_logio_read(logio_ctx, log_offset,
-                                            cover_length, req_ptr, &nread);
-                if (rc == UNIFYFS_SUCCESS) {
-                    /* update bytes we have filled in the request buffer */
-                    update_read_req_coverage(req, req_byte_offset, nread);
-                } else {
-                    LOGERR("local log read failed for offset=%zu size=%zu",
-                           (size_t) log_offset, cover_length);
-                    req->errcode = rc;
-                }
-            }
-            /* get the next element in the tree */
-            next = seg_tree_iter(extents, next);
-        }
-
         /* copy request data to list we completed locally */
         memcpy(&local_reqs[local_count], req, sizeof(read_req_t));
         local_count++;
-
-        /* done reading the tree */
-        seg_tree_unlock(extents);
     }
 
     /* return to user the number of key/values we set */
@@ -472,6 +733,250 @@ void service_local_reqs(
     return;
 }
 
+/* return cache entry for slice of file gfid, or NULL if not cached.
+ * caller must hold extent_cache_sync */
+static client_extent_slice* extent_cache_find(unifyfs_client* client,
+                                              int gfid,
+                                              size_t slice)
+{
+    for (size_t i = 0; i < client->extent_cache_slices; i++) {
+        client_extent_slice* ent = client->extent_cache + i;
+        if ((ent->last_use != 0) && (ent->gfid == gfid) &&
+            (ent->slice == slice)) {
+            return ent;
+        }
+    }
+    return NULL;
+}
+
+/* add slice of file gfid to the cache, evicting the least recently
+ * used slice if the cache is full. The extents of an evicted slice are
+ * removed from its file's extent tree. caller must hold
+ * extent_cache_sync */
+static void extent_cache_insert(unifyfs_client* client,
+                                int gfid,
+                                size_t slice)
+{
+    client_extent_slice* victim = client->extent_cache;
+    for (size_t i = 0; i < client->extent_cache_slices; i++) {
+        client_extent_slice* ent = client->extent_cache + i;
+        if (ent->last_use < victim->last_use) {
+            victim = ent;
+        }
+        if (0 == ent->last_use) {
+            break;
+        }
+    }
+
+    if (0 != victim->last_use) {
+        int fid = unifyfs_fid_from_gfid(client, victim->gfid);
+        unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
+        if ((NULL != meta) && (meta->storage == FILE_STORAGE_LOGIO)) {
+            size_t start = victim->slice * client->extent_slice_size;
+            seg_tree_remove(&meta->extents, start,
+                            start + client->extent_slice_size - 1);
+            __atomic_store_n(&(meta->publish_extents), 1, __ATOMIC_SEQ_CST);
+        }
+    }
+
+    victim->gfid = gfid;
+    victim->slice = slice;
+    victim->last_use = ++(client->extent_cache_clock);
+}
+
+/* drop all cached extent slices of file gfid, e.g., when the file's
+ * extent tree is destroyed */
+void client_drop_extent_slices(unifyfs_client* client,
+                               int gfid)
+{
+    if (NULL == client->extent_cache) {
+        return;
+    }
+
+    pthread_mutex_lock(&(client->extent_cache_sync));
+    for (size_t i = 0; i < client->extent_cache_slices; i++) {
+        client_extent_slice* ent = client->extent_cache + i;
+        if (ent->gfid == gfid) {
+            ent->last_use = 0;
+        }
+    }
+    pthread_mutex_unlock(&(client->extent_cache_sync));
+}
+
+/* order extents by file id then by offset */
+static
+int compare_extent(const void* a, const void* b)
+{
+    const unifyfs_extent_t* ea = a;
+    const unifyfs_extent_t* eb = b;
+    if (ea->gfid != eb->gfid) {
+        return (ea->gfid < eb->gfid) ? -1 : 1;
+    }
+    if (ea->offset != eb->offset) {
+        return (ea->offset < eb->offset) ? -1 : 1;
+    }
+    return 0;
+}
+
+/* Fetch the node-local extents of laminated files for the slices
+ * touched by the read requests that are not already cached, using a
+ * single rpc to the local server. Files with a shared extent index from
+ * the local server are skipped. Only slices that are read are fetched,
+ * so the first read of a large file does not transfer the extents of
+ * the whole file, and at most extent_cache_slices are cached. */
+static void fetch_node_local_extents(unifyfs_client* client,
+                                     read_req_t* reqs,
+                                     size_t count)
+{
+    size_t slice_sz = client->extent_slice_size;
+    size_t max_ranges = client->extent_cache_slices;
+    unifyfs_extent_t* ranges = calloc(max_ranges, sizeof(unifyfs_extent_t));
+    if (NULL == ranges) {
+        return;
+    }
+
+    /* record the uncached slices, marking them cached so concurrent
+     * readers do not fetch them again */
+    size_t n_ranges = 0;
+    pthread_mutex_lock(&(client->extent_cache_sync));
+    for (size_t i = 0; (i < count) && (n_ranges < max_ranges); i++) {
+        read_req_t* req = reqs + i;
+        if (0 == req->length) {
+            continue;
+        }
+        int fid = unifyfs_fid_from_gfid(client, req->gfid);
+        unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
+        if ((NULL == meta) || !meta->attrs.is_laminated ||
+            (meta->storage != FILE_STORAGE_LOGIO)) {
+            continue;
+        }
+
+        /* no need to fetch extents found in a shared extent index */
+        attach_shared_extents(client, meta);
+        if (NULL != meta->shared_extents) {
+            continue;
+        }
+
+        off_t filesize = unifyfs_fid_logical_size(client, fid);
+        if ((filesize <= 0) || (req->offset >= (size_t)filesize)) {
+            continue;
+        }
+        size_t last_byte = req->offset + req->length - 1;
+        if (last_byte >= (size_t)filesize) {
+            last_byte = (size_t)filesize - 1;
+        }
+
+        size_t first_slice = req->offset / slice_sz;
+        size_t last_slice = last_byte / slice_sz;
+        for (size_t s = first_slice;
+             (s <= last_slice) && (n_ranges < max_ranges); s++) {
+            client_extent_slice* ent = extent_cache_find(client,
+                                                         req->gfid, s);
+            if (NULL != ent) {
+                ent->last_use = ++(client->extent_cache_clock);
+                continue;
+            }
+            extent_cache_insert(client, req->gfid, s);
+
+            unifyfs_extent_t* range = ranges + n_ranges;
+            range->gfid = req->gfid;
+            range->offset = s * slice_sz;
+            range->length = slice_sz;
+            if ((range->offset + range->length) > (size_t)filesize) {
+                range->length = (size_t)filesize - range->offset;
+            }
+            n_ranges++;
+        }
+    }
+    pthread_mutex_unlock(&(client->extent_cache_sync));
+
+    if (0 == n_ranges) {
+        free(ranges);
+        return;
+    }
+
+    /* the server returns the extents in the order of the ranges */
+    qsort(ranges, n_ranges, sizeof(unifyfs_extent_t), compare_extent);
+
+    size_t extent_count = 0;
+    unifyfs_client_index_t* extents = NULL;
+    int rc = invoke_client_node_local_extents_get_rpc(client, n_ranges,
+                                                      ranges, &extent_count,
+                                                      &extents);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to get node-local extents (rc=%d)", rc);
+
+        /* forget the slices so they are fetched on a later read */
+        pthread_mutex_lock(&(client->extent_cache_sync));
+        for (size_t i = 0; i < n_ranges; i++) {
+            client_extent_slice* ent = extent_cache_find(client,
+                ranges[i].gfid, ranges[i].offset / slice_sz);
+            if (NULL != ent) {
+                ent->last_use = 0;
+            }
+        }
+        pthread_mutex_unlock(&(client->extent_cache_sync));
+    } else {
+        LOGDBG("got %zu node-local extents for %zu slices",
+               extent_count, n_ranges);
+
+        /* a slice may have been evicted by another reader while the
+         * lock was dropped for the rpc, so only add the parts of the
+         * extents in slices that are still cached */
+        pthread_mutex_lock(&(client->extent_cache_sync));
+        int last_gfid = -1;
+        unifyfs_filemeta_t* meta = NULL;
+        for (size_t j = 0; j < extent_count; j++) {
+            unifyfs_client_index_t* ext = extents + j;
+            if (ext->log_app_id != client->state.app_id) {
+                /* can only read the logs of our application */
+                continue;
+            }
+            if (ext->gfid != last_gfid) {
+                int fid = unifyfs_fid_from_gfid(client, ext->gfid);
+                meta = unifyfs_get_meta_from_fid(client, fid);
+                last_gfid = ext->gfid;
+            }
+            if ((NULL == meta) || (0 == ext->length)) {
+                continue;
+            }
+
+            size_t ext_start = (size_t) ext->file_pos;
+            size_t ext_end = ext_start + ext->length - 1;
+            for (size_t s = ext_start / slice_sz;
+                 s <= (ext_end / slice_sz); s++) {
+                if (NULL == extent_cache_find(client, ext->gfid, s)) {
+                    continue;
+                }
+                size_t start = s * slice_sz;
+                size_t end = start + slice_sz - 1;
+                if (start < ext_start) {
+                    start = ext_start;
+                }
+                if (end > ext_end) {
+                    end = ext_end;
+                }
+                /* a clipped hole extent stays a hole */
+                unsigned long ptr = seg_tree_ptr_offset(
+                    (unsigned long) ext->log_pos, start - ext_start);
+                seg_tree_add(&meta->extents, start, end, ptr,
+                             ext->log_client_id);
+
+                /* extents of laminated files are only changed by
+                 * fetches and evictions, publish them for readers */
+                __atomic_store_n(&(meta->publish_extents), 1,
+                                 __ATOMIC_SEQ_CST);
+            }
+        }
+        pthread_mutex_unlock(&(client->extent_cache_sync));
+    }
+
+    if (NULL != extents) {
+        free(extents);
+    }
+    free(ranges);
+}
+
 /* order by file id then by offset */
 static
 int compare_read_req(const void* a, const void* b)
@@ -622,71 +1127,9 @@ int process_gfid_reads(unifyfs_client* client,
      * we allocate one, we should free this later if not NULL */
     read_req_t* reqs = NULL;
     if (client->use_node_local_extents) {
-        extents_list_t* list = calloc(1, sizeof(struct extents_list));
-        struct extents_list* cur = list;
-        int num_request_selected = 0;
-        for (int i = 0; i < in_count; ++i) {
-            int fid = unifyfs_fid_from_gfid(client, in_reqs[i].gfid);
-            /* get meta for this file id */
-            unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
-            if (meta != NULL) {
-                if (!meta->attrs.is_laminated || !meta->needs_reads_sync) {
-                    /* do not proceed for this request as
-                     * it is not a laminated file or has already been synced.*/
-                    continue;
-                }
-                num_request_selected++;
-                off_t filesize_offt = unifyfs_gfid_filesize(client,
-                                                            in_reqs[i].gfid);
-                cur->value.file_pos = 0;
-                cur->value.length = filesize_offt - 1;
-                cur->value.gfid = in_reqs[i].gfid;
-                if (i < in_count - 1) {
-                    cur->next = calloc(1, sizeof(struct extents_list));
-                    cur->next->next = NULL;
-                    cur = cur->next;
-                } else {
-                    cur->next = NULL;
-                }
-                meta->needs_reads_sync = 0;
-            }
-        }
-        if (num_request_selected > 0) {
-            /* There are files which are laminated and
-             * require sync of extents */
-            size_t extent_count = 0;
-            unifyfs_client_index_t* extents = NULL;
-            int rc =
-                  invoke_client_node_local_extents_get_rpc(client,
-                                                           num_request_selected,
-                                                           list,
-                                                           &extent_count,
-                                                           &extents);
-            if (rc == UNIFYFS_SUCCESS && extent_count != 0) {
-                for (int j = 0; j < extent_count; ++j) {
-                    if (extents[j].log_app_id ==
-                        client->state.app_id) {
-                        int fid = unifyfs_fid_from_gfid(client,
-                                                        extents[j].gfid);
-                        /* get meta for this file id */
-                        unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(
-                                client,
-                                fid);
-                        if (meta != NULL) {
-                            seg_tree_add(&meta->extents,
-                                         extents[j].file_pos,
-                                         extents[j].file_pos +
-                                         extents[j].length - 1,
-                                         extents[j].log_pos,
-                                         extents[j].log_client_id);
-                        }
-                    }
-                }
-            }
-            if (extents != NULL) {
-                free(extents);
-            }
-        }
+        /* fetch node-local extents for the slices of laminated files
+         * we are about to read */
+        fetch_node_local_extents(client, in_reqs, in_count);
     }
 
     /* attempt to complete requests locally if enabled */
@@ -712,12 +1155,16 @@ int process_gfid_reads(unifyfs_client* client,
         service_local_reqs(client, in_reqs, in_count,
                            local_reqs, server_reqs, &server_count);
         local_count = in_count - server_count;
+        size_t local_bytes = 0;
         for (i = 0; i < local_count; i++) {
             /* get pointer to next read request */
             read_req_t* req = local_reqs + i;
             LOGDBG("local request %d:", i);
+            local_bytes += req->nread;
             update_read_req_result(client, req);
         }
+        unifyfs_stats_add(UNIFYFS_STAT_CLIENT_READ_LOCAL_BYTES,
+                          (int64_t)local_bytes);
 
         /* return early if we satisfied all requests locally */
         if (server_count == 0) {
@@ -824,12 +1271,16 @@ int process_gfid_reads(unifyfs_client* client,
 
     /* got all of the data we'll get from the server, check for short reads
      * and whether those short reads are from errors, holes, or end of file */
+    size_t server_bytes = 0;
     for (i = 0; i < server_count; i++) {
         /* get pointer to next read request */
         read_req_t* req = server_reqs + i;
         LOGDBG("mread[%u] server request %d:", mread->id, i);
+        server_bytes += req->nread;
         update_read_req_result(client, req);
     }
+    unifyfs_stats_add(UNIFYFS_STAT_CLIENT_READ_SERVER_BYTES,
+                      (int64_t)server_bytes);
 
     /* if we attempted to service requests from our local extent map,
      * then we need to copy the resulting read requests from the local
@@ -108,6 +108,15 @@ void update_read_req_coverage(read_req_t* req,
                               size_t extent_byte_offset,
                               size_t extent_length);
 
+/* drop all cached node-local extent slices of file gfid */
+void client_drop_extent_slices(unifyfs_client* client,
+                               int gfid);
+
+/* detach from the shared extent index of a file, unmapping it once no
+ * reader is using it */
+void client_detach_shared_extents(unifyfs_client* client,
+                                  unifyfs_filemeta_t* meta);
+
 /* process a set of client read requests */
 int process_gfid_reads(unifyfs_client* client,
                        read_req_t* in_reqs,
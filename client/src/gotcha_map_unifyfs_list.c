@@ -138,6 +138,11 @@ UNIFYFS_DEF(lseek64, off64_t,
 UNIFYFS_DEF(posix_fadvise, int,
             (int fd, off_t offset, off_t len, int advice),
             (fd, offset, len, advice))
+#ifdef HAVE_FALLOCATE
+UNIFYFS_DEF(fallocate, int,
+            (int fd, int mode, off_t offset, off_t len),
+            (fd, mode, offset, len))
+#endif
 
 UNIFYFS_DEF(read, ssize_t,
             (int fd, void* buf, size_t count),
@@ -226,7 +231,7 @@ UNIFYFS_DEF(telldir, long,
             (DIR* dirp),
             (dirp))
 UNIFYFS_DEF(scandir, int,
-            (const char* dirp, struct dirent** namelist,
+            (const char* dirp, struct dirent*** namelist,
              int (*filter)(const struct dirent*),
              int (*compar)(const struct dirent**, const struct dirent**)),
             (dirp, namelist, filter, compar))
@@ -407,6 +412,9 @@ struct gotcha_binding_t unifyfs_wrappers[] = {
     { "lseek", UNIFYFS_WRAP(lseek), &wrappee_handle_lseek },
     { "lseek64", UNIFYFS_WRAP(lseek64), &wrappee_handle_lseek64 },
     { "posix_fadvise", UNIFYFS_WRAP(posix_fadvise), &wrappee_handle_posix_fadvise },
+#ifdef HAVE_FALLOCATE
+    { "fallocate", UNIFYFS_WRAP(fallocate), &wrappee_handle_fallocate },
+#endif
     { "read", UNIFYFS_WRAP(read), &wrappee_handle_read },
     { "write", UNIFYFS_WRAP(write), &wrappee_handle_write },
     { "readv", UNIFYFS_WRAP(readv), &wrappee_handle_readv },
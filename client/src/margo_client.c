@@ -42,6 +42,7 @@ static void register_client_rpcs(client_rpc_context_t* ctx)
                               unifyfs_##name##_out_t, \
                               NULL); \
         ctx->rpcs.name##_id = hgid; \
+        unifyfs_stats_hist_register((uint64_t) hgid, #name "_rpc"); \
     } while (0)
 
     CLIENT_REGISTER_RPC(attach);
@@ -54,10 +55,13 @@ static void register_client_rpcs(client_rpc_context_t* ctx)
     CLIENT_REGISTER_RPC(truncate);
     CLIENT_REGISTER_RPC(unlink);
     CLIENT_REGISTER_RPC(laminate);
+    CLIENT_REGISTER_RPC(list_files);
     CLIENT_REGISTER_RPC(fsync);
     CLIENT_REGISTER_RPC(mread);
+    CLIENT_REGISTER_RPC(readdir);
     CLIENT_REGISTER_RPC(node_local_extents_get);
     CLIENT_REGISTER_RPC(get_gfids);
+    CLIENT_REGISTER_RPC(stats);
 
 #undef CLIENT_REGISTER_RPC
 
@@ -228,12 +232,15 @@ static int forward_to_server(hg_handle_t hdl,
                              void* input_ptr,
                              double timeout_msec)
 {
+    uint64_t start_usec = unifyfs_stats_now_usec();
     hg_return_t hret = margo_forward_timed(hdl, input_ptr, timeout_msec);
     if (hret != HG_SUCCESS) {
         LOGERR("margo_forward_timed() failed - %s", HG_Error_to_string(hret));
         //margo_state_dump(client_rpc_context->mid, "-", 0, NULL);
         return UNIFYFS_ERROR_MARGO;
     }
+    const struct hg_info* info = margo_get_info(hdl);
+    unifyfs_stats_hist_record((uint64_t) info->id, start_usec);
     return UNIFYFS_SUCCESS;
 }
 
@@ -779,48 +786,350 @@ int invoke_client_laminate_rpc(unifyfs_client* client,
     return ret;
 }
 
-/* invokes the client sync rpc function */
+/* outstanding asynchronous sync rpc */
+struct client_sync_request {
+    hg_handle_t handle;
+    margo_request request;
+    int gfid;
+    int index_slot;
+    uint64_t start_usec;
+};
+
+/* invokes the client sync rpc function for the extents in the given
+ * write index slot, without waiting for the server to process them.
+ * on success, sync_req is set to the outstanding request, which must be
+ * completed with wait_client_sync_rpc() before reusing the index slot */
 int invoke_client_sync_rpc(unifyfs_client* client,
-                           int gfid)
+                           int gfid,
+                           int index_slot,
+                           client_sync_request** sync_req)
 {
     /* check that we have initialized margo */
     if (NULL == client_rpc_context) {
         return UNIFYFS_FAILURE;
     }
 
+    client_sync_request* req = malloc(sizeof(*req));
+    if (NULL == req) {
+        return ENOMEM;
+    }
+
     /* get handle to rpc function */
-    hg_handle_t handle = create_handle(client_rpc_context->rpcs.fsync_id);
+    req->handle = create_handle(client_rpc_context->rpcs.fsync_id);
+    req->gfid = gfid;
+    req->index_slot = index_slot;
+    req->start_usec = unifyfs_stats_now_usec();
 
     /* fill in input struct */
     unifyfs_fsync_in_t in;
-    in.app_id    = (int32_t) client->state.app_id;
-    in.client_id = (int32_t) client->state.client_id;
-    in.gfid      = (int32_t) gfid;
+    in.app_id     = (int32_t) client->state.app_id;
+    in.client_id  = (int32_t) client->state.client_id;
+    in.gfid       = (int32_t) gfid;
+    in.index_slot = (int32_t) index_slot;
 
     /* call rpc function */
-    LOGINFO("invoking the sync rpc function in client");
+    LOGINFO("invoking the sync rpc function in client (gfid=%d, slot=%d)",
+            gfid, index_slot);
     double timeout = client_rpc_context->timeout;
-    int rc = forward_to_server(handle, &in, timeout);
-    if (rc != UNIFYFS_SUCCESS) {
-        LOGERR("forward of sync rpc to server failed");
-        margo_destroy(handle);
-        return rc;
+    hg_return_t hret = margo_iforward_timed(req->handle, &in, timeout,
+                                            &(req->request));
+    if (hret != HG_SUCCESS) {
+        LOGERR("forward of sync rpc to server failed - %s",
+               HG_Error_to_string(hret));
+        margo_destroy(req->handle);
+        free(req);
+        return UNIFYFS_ERROR_MARGO;
+    }
+
+    *sync_req = req;
+    return UNIFYFS_SUCCESS;
+}
+
+/* waits for completion of an outstanding sync rpc and frees the request */
+int wait_client_sync_rpc(client_sync_request* sync_req)
+{
+    if (NULL == sync_req) {
+        return EINVAL;
     }
 
-    /* decode response */
     int ret;
-    unifyfs_fsync_out_t out;
-    hg_return_t hret = margo_get_output(handle, &out);
-    if (hret == HG_SUCCESS) {
-        LOGDBG("Got response ret=%" PRIi32, out.ret);
-        ret = (int) out.ret;
-        margo_free_output(handle, &out);
-    } else {
-        LOGERR("margo_get_output() failed - %s", HG_Error_to_string(hret));
+    hg_return_t hret = margo_wait(sync_req->request);
+    if (hret != HG_SUCCESS) {
+        LOGERR("wait on sync rpc (gfid=%d, slot=%d) failed - %s",
+               sync_req->gfid, sync_req->index_slot,
+               HG_Error_to_string(hret));
         ret = UNIFYFS_ERROR_MARGO;
+    } else {
+        unifyfs_stats_hist_record((uint64_t) client_rpc_context->rpcs.fsync_id,
+                                  sync_req->start_usec);
+
+        /* decode response */
+        unifyfs_fsync_out_t out;
+        hret = margo_get_output(sync_req->handle, &out);
+        if (hret == HG_SUCCESS) {
+            LOGDBG("Got response ret=%" PRIi32, out.ret);
+            ret = (int) out.ret;
+            margo_free_output(sync_req->handle, &out);
+        } else {
+            LOGERR("margo_get_output() failed - %s",
+                   HG_Error_to_string(hret));
+            ret = UNIFYFS_ERROR_MARGO;
+        }
     }
 
     /* free resources */
+    margo_destroy(sync_req->handle);
+    free(sync_req);
+
+    return ret;
+}
+
+/* invokes the stats rpc function, on success report is set to a newly
+ * allocated text report of the server's counters, which the caller
+ * must free */
+int invoke_client_stats_rpc(unifyfs_client* client,
+                            char** report)
+{
+    /* check that we have initialized margo */
+    if (NULL == client_rpc_context) {
+        return UNIFYFS_FAILURE;
+    }
+
+    margo_instance_id mid = client_rpc_context->mid;
+    double timeout = client_rpc_context->timeout;
+    hg_size_t buf_size = 64 * KIB;
+    char* buf = NULL;
+    int ret = UNIFYFS_SUCCESS;
+
+    /* the server pushes the report into our buffer, if it does not fit
+     * we try again with a buffer of the size it reports */
+    for (int attempt = 0; attempt < 2; attempt++) {
+        buf = calloc(1, buf_size);
+        if (NULL == buf) {
+            return ENOMEM;
+        }
+
+        hg_bulk_t bulk;
+        hg_return_t hret = margo_bulk_create(mid, 1, (void**)&buf, &buf_size,
+                                             HG_BULK_WRITE_ONLY, &bulk);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_bulk_create() failed - %s",
+                   HG_Error_to_string(hret));
+            free(buf);
+            return UNIFYFS_ERROR_MARGO;
+        }
+
+        /* get handle to rpc function */
+        hg_handle_t handle = create_handle(client_rpc_context->rpcs.stats_id);
+
+        /* fill in input struct */
+        unifyfs_stats_in_t in;
+        in.app_id      = (int32_t) client->state.app_id;
+        in.client_id   = (int32_t) client->state.client_id;
+        in.bulk_size   = buf_size;
+        in.bulk_report = bulk;
+
+        /* call rpc function */
+        LOGDBG("invoking the stats rpc function in client");
+        hg_size_t report_size = 0;
+        ret = forward_to_server(handle, &in, timeout);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("forward of stats rpc to server failed");
+        } else {
+            /* decode response */
+            unifyfs_stats_out_t out;
+            hret = margo_get_output(handle, &out);
+            if (hret == HG_SUCCESS) {
+                LOGDBG("Got response ret=%" PRIi32, out.ret);
+                ret = (int) out.ret;
+                report_size = out.report_size;
+                margo_free_output(handle, &out);
+            } else {
+                LOGERR("margo_get_output() failed - %s",
+                       HG_Error_to_string(hret));
+                ret = UNIFYFS_ERROR_MARGO;
+            }
+        }
+
+        /* free resources */
+        margo_bulk_free(bulk);
+        margo_destroy(handle);
+
+        if ((ret == UNIFYFS_SUCCESS) && (report_size > buf_size)) {
+            /* report was truncated, retry with a big enough buffer */
+            free(buf);
+            buf = NULL;
+            buf_size = report_size;
+            continue;
+        }
+        break;
+    }
+
+    if (NULL == buf) {
+        /* report grew between attempts */
+        return ENOSPC;
+    }
+    if (ret != UNIFYFS_SUCCESS) {
+        free(buf);
+        return ret;
+    }
+    buf[buf_size - 1] = '\0';
+    *report = buf;
+    return UNIFYFS_SUCCESS;
+}
+
+/* invokes the client list_files rpc function, the server pushes a page
+ * of up to max_files file records into the page buffer and advances
+ * the cursor */
+int invoke_client_list_files_rpc(unifyfs_client* client,
+                                 const unifyfs_file_filter_t* filter,
+                                 int* cursor_rank,
+                                 int* cursor_gfid,
+                                 unsigned int max_files,
+                                 void* page,
+                                 size_t page_sz,
+                                 unsigned int* num_files,
+                                 size_t* page_used)
+{
+    /* check that we have initialized margo */
+    if (NULL == client_rpc_context) {
+        return UNIFYFS_FAILURE;
+    }
+
+    *num_files = 0;
+    *page_used = 0;
+
+    hg_bulk_t bulk;
+    hg_size_t buf_size = (hg_size_t) page_sz;
+    hg_return_t hret = margo_bulk_create(client_rpc_context->mid, 1,
+                                         &page, &buf_size,
+                                         HG_BULK_WRITE_ONLY, &bulk);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_bulk_create() failed - %s", HG_Error_to_string(hret));
+        return UNIFYFS_ERROR_MARGO;
+    }
+
+    /* get handle to rpc function */
+    hg_handle_t handle = create_handle(client_rpc_context->rpcs.list_files_id);
+
+    /* fill in input struct */
+    unifyfs_list_files_in_t in;
+    in.app_id      = (int32_t) client->state.app_id;
+    in.client_id   = (int32_t) client->state.client_id;
+    in.cursor_rank = (int32_t) *cursor_rank;
+    in.cursor_gfid = (int32_t) *cursor_gfid;
+    in.max_files   = (int32_t) max_files;
+    in.owner_rank  = (int32_t) filter->owner_rank;
+    in.laminated   = (int32_t) filter->laminated;
+    in.prefix      = (NULL != filter->prefix) ? filter->prefix : "";
+    in.bulk_size   = buf_size;
+    in.bulk_page   = bulk;
+
+    /* call rpc function */
+    LOGDBG("invoking the list_files rpc function in client");
+    double timeout = client_rpc_context->timeout;
+    int ret = forward_to_server(handle, &in, timeout);
+    if (ret != UNIFYFS_SUCCESS) {
+        LOGERR("forward of list_files rpc to server failed");
+    } else {
+        /* decode response */
+        unifyfs_list_files_out_t out;
+        hret = margo_get_output(handle, &out);
+        if (hret == HG_SUCCESS) {
+            LOGDBG("Got response ret=%" PRIi32, out.ret);
+            ret = (int) out.ret;
+            if (ret == UNIFYFS_SUCCESS) {
+                *num_files   = (unsigned int) out.num_files;
+                *page_used   = (size_t) out.page_used;
+                *cursor_rank = (int) out.next_rank;
+                *cursor_gfid = (int) out.next_gfid;
+            }
+            margo_free_output(handle, &out);
+        } else {
+            LOGERR("margo_get_output() failed - %s",
+                   HG_Error_to_string(hret));
+            ret = UNIFYFS_ERROR_MARGO;
+        }
+    }
+
+    /* free resources */
+    margo_bulk_free(bulk);
+    margo_destroy(handle);
+
+    return ret;
+}
+
+/* invokes the client readdir rpc function, the server pushes up to
+ * max_entries entries of the directory into the entries array */
+int invoke_client_readdir_rpc(unifyfs_client* client,
+                              int gfid,
+                              int start_gfid,
+                              unsigned int max_entries,
+                              unifyfs_dirent_t* entries,
+                              unsigned int* num_entries,
+                              int* end_of_dir)
+{
+    /* check that we have initialized margo */
+    if (NULL == client_rpc_context) {
+        return UNIFYFS_FAILURE;
+    }
+
+    *num_entries = 0;
+    *end_of_dir = 1;
+    if (0 == max_entries) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    hg_bulk_t bulk;
+    void* buf = (void*) entries;
+    hg_size_t buf_size = (hg_size_t)max_entries * sizeof(unifyfs_dirent_t);
+    hg_return_t hret = margo_bulk_create(client_rpc_context->mid, 1,
+                                         &buf, &buf_size,
+                                         HG_BULK_WRITE_ONLY, &bulk);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_bulk_create() failed - %s", HG_Error_to_string(hret));
+        return UNIFYFS_ERROR_MARGO;
+    }
+
+    /* get handle to rpc function */
+    hg_handle_t handle = create_handle(client_rpc_context->rpcs.readdir_id);
+
+    /* fill in input struct */
+    unifyfs_readdir_in_t in;
+    in.app_id       = (int32_t) client->state.app_id;
+    in.client_id    = (int32_t) client->state.client_id;
+    in.gfid         = (int32_t) gfid;
+    in.start_gfid   = (int32_t) start_gfid;
+    in.max_entries  = (int32_t) max_entries;
+    in.bulk_entries = bulk;
+
+    /* call rpc function */
+    LOGDBG("invoking the readdir rpc function in client");
+    double timeout = client_rpc_context->timeout;
+    int ret = forward_to_server(handle, &in, timeout);
+    if (ret != UNIFYFS_SUCCESS) {
+        LOGERR("forward of readdir rpc to server failed");
+    } else {
+        /* decode response */
+        unifyfs_readdir_out_t out;
+        hret = margo_get_output(handle, &out);
+        if (hret == HG_SUCCESS) {
+            LOGDBG("Got response ret=%" PRIi32, out.ret);
+            ret = (int) out.ret;
+            if (ret == UNIFYFS_SUCCESS) {
+                *num_entries = (unsigned int) out.num_entries;
+                *end_of_dir  = (int) out.end_of_dir;
+            }
+            margo_free_output(handle, &out);
+        } else {
+            LOGERR("margo_get_output() failed - %s",
+                   HG_Error_to_string(hret));
+            ret = UNIFYFS_ERROR_MARGO;
+        }
+    }
+
+    /* free resources */
+    margo_bulk_free(bulk);
     margo_destroy(handle);
 
     return ret;
@@ -890,10 +1199,12 @@ int invoke_client_mread_rpc(unifyfs_client* client,
     return ret;
 }
 
-/* invokes the client metaget rpc function */
+/* invokes the client node-local extents rpc function, returns the
+ * extents stored on this node for the given file ranges in a newly
+ * allocated array, in the same order as the ranges */
 int invoke_client_node_local_extents_get_rpc(unifyfs_client* client,
-                                             int num_req,
-                                             extents_list_t* read_req,
+                                             size_t num_req,
+                                             unifyfs_extent_t* ranges,
                                              size_t* extent_count,
                                              unifyfs_client_index_t** extents)
 {
@@ -902,21 +1213,12 @@ int invoke_client_node_local_extents_get_rpc(unifyfs_client* client,
         return UNIFYFS_FAILURE;
     }
 
-    size_t extents_size = num_req * sizeof(unifyfs_extent_t);
-    void* buffer = malloc(extents_size);
-    if (NULL == buffer) {
-        return ENOMEM;
-    }
+    *extent_count = 0;
+    *extents = NULL;
+
+    hg_size_t extents_size = num_req * sizeof(unifyfs_extent_t);
+    void* buffer = (void*) ranges;
 
-    unifyfs_extent_t* int_extents = (unifyfs_extent_t*)buffer;
-    extents_list_t* cur = read_req;
-    for (int i = 0; i < num_req; i++) {
-        unifyfs_extent_t* ext = int_extents + i;
-        ext->gfid = cur->value.gfid;
-        ext->offset = cur->value.file_pos;
-        ext->length = cur->value.length;
-        cur = cur->next;
-    }
     /* get handle to rpc function */
     hg_handle_t handle = create_handle(
             client_rpc_context->rpcs.node_local_extents_get_id);
@@ -927,6 +1229,7 @@ int invoke_client_node_local_extents_get_rpc(unifyfs_client* client,
                                          1, &buffer, &extents_size,
                                          HG_BULK_READ_ONLY, &in.bulk_data);
     if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
         return UNIFYFS_ERROR_MARGO;
     }
     in.app_id = (int32_t) client->state.app_id;
@@ -939,7 +1242,8 @@ int invoke_client_node_local_extents_get_rpc(unifyfs_client* client,
     double timeout = client_rpc_context->timeout;
     int rc = forward_to_server(handle, &in, timeout);
     if (rc != UNIFYFS_SUCCESS) {
-        LOGERR("forward of metaget rpc to server failed");
+        LOGERR("forward of node_local_extents_get rpc to server failed");
+        margo_bulk_free(in.bulk_data);
         margo_destroy(handle);
         return rc;
     }
@@ -951,11 +1255,15 @@ int invoke_client_node_local_extents_get_rpc(unifyfs_client* client,
     if (hret == HG_SUCCESS) {
         LOGDBG("Got response ret=%" PRIi32, out.ret);
         ret = (int) out.ret;
-        if (ret == (int) UNIFYFS_SUCCESS) {
-            *extent_count = out.extent_count;
+        if ((ret == (int) UNIFYFS_SUCCESS) && (out.extent_count > 0)) {
             void* out_buffer = pull_margo_bulk_buffer(handle, out.bulk_data,
-                                                  out.bulk_size, NULL);
-            *extents = (unifyfs_client_index_t*) out_buffer;
+                                                      out.bulk_size, NULL);
+            if (NULL == out_buffer) {
+                ret = UNIFYFS_ERROR_MARGO;
+            } else {
+                *extent_count = out.extent_count;
+                *extents = (unifyfs_client_index_t*) out_buffer;
+            }
         }
         margo_free_output(handle, &out);
     } else {
@@ -965,10 +1273,9 @@ int invoke_client_node_local_extents_get_rpc(unifyfs_client* client,
     /* margo_forward serializes all data before
      * returning, and it's safe to free the rpc params */
     margo_bulk_free(in.bulk_data);
-    /* free resources */
 
+    /* free resources */
     margo_destroy(handle);
-    free(buffer);
     return ret;
 }
 
@@ -1086,7 +1393,7 @@ static void unifyfs_mread_req_data_rpc(hg_handle_t handle)
                         int i = 0;
                         hg_size_t offset, len;
                         hg_size_t remain = in.bulk_size;
-                        hg_size_t max_bulk = UNIFYFS_SERVER_MAX_BULK_TX_SIZE;
+                        hg_size_t max_bulk = unifyfs_get_bulk_tx_size();
                         do {
                             offset = i * max_bulk;
                             len = (remain < max_bulk) ? remain : max_bulk;
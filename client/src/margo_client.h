@@ -35,10 +35,13 @@ typedef struct ClientRpcIds {
     hg_id_t truncate_id;
     hg_id_t unlink_id;
     hg_id_t laminate_id;
+    hg_id_t list_files_id;
     hg_id_t fsync_id;
     hg_id_t mread_id;
+    hg_id_t readdir_id;
     hg_id_t node_local_extents_get_id;
     hg_id_t get_gfids_id;
+    hg_id_t stats_id;
 
     /* server-to-client */
     hg_id_t heartbeat_id;
@@ -83,6 +86,16 @@ int invoke_client_filesize_rpc(unifyfs_client* client,
 int invoke_client_laminate_rpc(unifyfs_client* client,
                                int gfid);
 
+int invoke_client_list_files_rpc(unifyfs_client* client,
+                                 const unifyfs_file_filter_t* filter,
+                                 int* cursor_rank,
+                                 int* cursor_gfid,
+                                 unsigned int max_files,
+                                 void* page,
+                                 size_t page_sz,
+                                 unsigned int* num_files,
+                                 size_t* page_used);
+
 int invoke_client_mread_rpc(unifyfs_client* client,
                             unsigned int reqid,
                             int read_count,
@@ -90,7 +103,22 @@ int invoke_client_mread_rpc(unifyfs_client* client,
                             void* extents_buffer);
 
 int invoke_client_sync_rpc(unifyfs_client* client,
-                           int gfid);
+                           int gfid,
+                           int index_slot,
+                           client_sync_request** sync_req);
+
+int wait_client_sync_rpc(client_sync_request* sync_req);
+
+int invoke_client_readdir_rpc(unifyfs_client* client,
+                              int gfid,
+                              int start_gfid,
+                              unsigned int max_entries,
+                              unifyfs_dirent_t* entries,
+                              unsigned int* num_entries,
+                              int* end_of_dir);
+
+int invoke_client_stats_rpc(unifyfs_client* client,
+                            char** report);
 
 int invoke_client_transfer_rpc(unifyfs_client* client,
                                int transfer_id,
@@ -105,10 +133,10 @@ int invoke_client_truncate_rpc(unifyfs_client* client,
 int invoke_client_unlink_rpc(unifyfs_client* client,
                              int gfid);
 
-
+/* get the extents stored on this node for the given file ranges */
 int invoke_client_node_local_extents_get_rpc(unifyfs_client* client,
-                                             int num_req,
-                                             extents_list_t* read_req,
+                                             size_t num_req,
+                                             unifyfs_extent_t* ranges,
                                              size_t* extent_count,
                                              unifyfs_client_index_t** extents);
 
@@ -88,6 +88,11 @@ static off_t unifyfs_min_offt;
 static off_t unifyfs_max_long;
 static off_t unifyfs_min_long;
 
+/* cached relation of posix_client->cwd to the mount point: -1 if not
+ * yet computed, 1 if cwd is neither within the mount point nor one of
+ * its ancestors, 0 otherwise */
+static int cwd_outside_mount = -1;
+
 
 /* -------------------------------
  * Utility functions
@@ -228,6 +233,95 @@ void unifyfs_normalize_path(const char* path, char* normalized)
 #endif /* USE_SPATH */
 }
 
+/* flags returned by scan_path() */
+#define PATH_HAS_DOTDOT   0x1 /* has a ".." component */
+#define PATH_NOT_REDUCED  0x2 /* has an empty or "." component,
+                               * or a trailing '/' */
+
+/* scan the components of path without copying it, returns a mask of
+ * PATH_* flags and sets len to the length of path */
+static int scan_path(const char* path, size_t* len)
+{
+    int flags = 0;
+    const char* comp = path;
+    const char* p;
+    for (p = path; ; p++) {
+        if ((*p != '/') && (*p != '\0')) {
+            continue;
+        }
+
+        size_t comp_len = (size_t)(p - comp);
+        if (comp_len == 0) {
+            /* the leading '/' of an absolute path is not a component */
+            if (p != path) {
+                flags |= PATH_NOT_REDUCED;
+            }
+        } else if (comp[0] == '.') {
+            if (comp_len == 1) {
+                flags |= PATH_NOT_REDUCED;
+            } else if ((comp_len == 2) && (comp[1] == '.')) {
+                flags |= PATH_HAS_DOTDOT;
+            }
+        }
+
+        if (*p == '\0') {
+            break;
+        }
+        comp = p + 1;
+    }
+    *len = (size_t)(p - path);
+    return flags;
+}
+
+/* returns 1 if path is the mount point or is below it, 0 otherwise */
+static inline int path_within_mount(const char* path)
+{
+    if (strncmp(path, unifyfs_mount_prefix, unifyfs_mount_prefixlen) != 0) {
+        return 0;
+    }
+
+    /* if we have another character, it must be '/' */
+    char next = path[unifyfs_mount_prefixlen];
+    return ((next == '\0') || (next == '/'));
+}
+
+/* returns 1 if a relative path without ".." components can not
+ * resolve to a path within the mount point, because the current
+ * working directory is neither within the mount point nor one of
+ * its ancestors */
+static int cwd_is_outside_mount(void)
+{
+    int outside = cwd_outside_mount;
+    if (outside != -1) {
+        return outside;
+    }
+
+    outside = 0;
+    const char* cwd = posix_client->cwd;
+    size_t cwd_len;
+    if ((cwd != NULL) && (cwd[0] == '/') &&
+        (scan_path(cwd, &cwd_len) == 0) &&
+        !path_within_mount(cwd)) {
+        /* root has a trailing '/', so it is never considered outside */
+        int ancestor = 0;
+        if ((cwd_len < unifyfs_mount_prefixlen) &&
+            (strncmp(unifyfs_mount_prefix, cwd, cwd_len) == 0) &&
+            (unifyfs_mount_prefix[cwd_len] == '/')) {
+            ancestor = 1;
+        }
+        outside = !ancestor;
+    }
+    cwd_outside_mount = outside;
+    return outside;
+}
+
+/* invalidate cached state derived from posix_client->cwd,
+ * must be called whenever the current working directory changes */
+void unifyfs_cwd_changed(void)
+{
+    cwd_outside_mount = -1;
+}
+
 /* Given a path, which may relative or absolute,
  * return 1 if we should intercept the path, 0 otherwise.
  * If path is to be intercepted, returned a normalized version in upath. */
@@ -238,23 +332,33 @@ int unifyfs_intercept_path(const char* path, char* upath)
         return 0;
     }
 
+    /* Most intercepted calls are for paths outside of UnifyFS, so first
+     * try to decide without building and normalizing a full path.
+     * An absolute path that is already reduced is its own normalized
+     * form. A relative path without ".." components stays below the
+     * current working directory. */
+    size_t len;
+    int flags = scan_path(path, &len);
+    if (path[0] == '/') {
+        if (flags == 0) {
+            if (!path_within_mount(path)) {
+                return 0;
+            }
+            if (len < UNIFYFS_MAX_FILENAME) {
+                memcpy(upath, path, len + 1);
+                return 1;
+            }
+        }
+    } else if (!(flags & PATH_HAS_DOTDOT) && cwd_is_outside_mount()) {
+        return 0;
+    }
+
     /* if we have a relative path, prepend the current working directory */
     char target[UNIFYFS_MAX_FILENAME];
     unifyfs_normalize_path(path, target);
 
     /* if the path starts with our mount point, intercept it */
-    int intercept = 0;
-    if (strncmp(target, unifyfs_mount_prefix, unifyfs_mount_prefixlen) == 0) {
-        /* characters in target up through mount point match,
-         * assume we match */
-        intercept = 1;
-
-        /* if we have another character, it must be '/' */
-        if (strlen(target) > unifyfs_mount_prefixlen &&
-            target[unifyfs_mount_prefixlen] != '/') {
-            intercept = 0;
-        }
-    }
+    int intercept = path_within_mount(target);
 
     /* copy normalized path into upath */
     if (intercept) {
@@ -465,6 +569,7 @@ int posix_client_init(void)
         assert(NULL != posix_client);
 
         posix_client->state.app_rank = client_rank;
+        unifyfs_cwd_changed();
 
 #ifdef UNIFYFS_GOTCHA
         rc = setup_gotcha_wrappers();
@@ -705,7 +810,13 @@ int transfer_file_serial(const char* src,
         LOGERR("failed to transfer data (ret=%d, %s)",
                ret, unifyfs_rc_enum_description(ret));
     } else {
-        UNIFYFS_WRAP(fsync)(fd_dst);
+        /* for a UnifyFS destination, this syncs the data to the server */
+        errno = 0;
+        if (UNIFYFS_WRAP(fsync)(fd_dst) != 0) {
+            ret = (0 != errno) ? errno : EIO;
+            LOGERR("failed to fsync() destination file %s (%s)",
+                   dst, strerror(ret));
+        }
     }
 
     UNIFYFS_WRAP(close)(fd_dst);
@@ -714,54 +825,291 @@ int transfer_file_serial(const char* src,
     return ret;
 }
 
+/* one side of a parallel transfer. UnifyFS files are accessed with the
+ * library API's batched I/O requests using their gfid, other files with
+ * pread()/pwrite() on their descriptor */
+typedef struct transfer_endpoint {
+    int fd;         /* file descriptor */
+    int gfid;       /* gfid of UnifyFS file */
+    int is_unify;   /* is this a UnifyFS file? */
+} transfer_endpoint;
+
+/* a batch of stripes in flight during a parallel transfer */
+typedef struct transfer_batch {
+    size_t n_stripes;
+    off_t offsets[UNIFYFS_TRANSFER_BATCH];
+    size_t lengths[UNIFYFS_TRANSFER_BATCH];
+    char* bufs[UNIFYFS_TRANSFER_BATCH];
+    unifyfs_io_request reqs[UNIFYFS_TRANSFER_BATCH];
+    int reads_pending;  /* dispatched reads not yet waited on */
+    int writes_pending; /* dispatched writes not yet waited on */
+} transfer_batch;
+
+static int transfer_endpoint_init(transfer_endpoint* ep, int fd)
+{
+    ep->fd = fd;
+    ep->gfid = 0;
+    ep->is_unify = 0;
+
+    int ufd = fd;
+    if (unifyfs_intercept_fd(&ufd)) {
+        int fid = unifyfs_get_fid_from_fd(ufd);
+        if (fid < 0) {
+            return EBADF;
+        }
+        ep->gfid = unifyfs_gfid_from_fid(posix_client, fid);
+        ep->is_unify = 1;
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+/* dispatch API requests for all stripes in the batch */
+static int transfer_batch_dispatch(transfer_batch* batch,
+                                   transfer_endpoint* ep,
+                                   unifyfs_ioreq_op op)
+{
+    for (size_t i = 0; i < batch->n_stripes; i++) {
+        unifyfs_io_request* req = batch->reqs + i;
+        memset(req, 0, sizeof(*req));
+        req->op       = op;
+        req->gfid     = ep->gfid;
+        req->offset   = batch->offsets[i];
+        req->nbytes   = batch->lengths[i];
+        req->user_buf = batch->bufs[i];
+    }
+    return unifyfs_dispatch_io(posix_client, batch->n_stripes, batch->reqs);
+}
+
+/* wait for dispatched API requests of the batch, and check that each
+ * stripe was fully transferred */
+static int transfer_batch_wait(transfer_batch* batch)
+{
+    int ret = unifyfs_wait_io(posix_client, batch->n_stripes,
+                              batch->reqs, 1);
+    if (UNIFYFS_SUCCESS != ret) {
+        return ret;
+    }
+    for (size_t i = 0; i < batch->n_stripes; i++) {
+        unifyfs_io_request* req = batch->reqs + i;
+        if (req->result.error) {
+            return req->result.error;
+        } else if (req->result.count != batch->lengths[i]) {
+            LOGERR("short transfer at offset %zu (%zu of %zu bytes)",
+                   (size_t)batch->offsets[i], req->result.count,
+                   batch->lengths[i]);
+            return EIO;
+        }
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+/* assign the next stripes of this client to the batch and start reading
+ * them. Reads of UnifyFS files are dispatched and complete later. */
+static int transfer_batch_fill(transfer_batch* batch,
+                               transfer_endpoint* src,
+                               uint64_t* next_stripe,
+                               uint64_t total_stripes,
+                               uint64_t size)
+{
+    int err;
+    batch->n_stripes = 0;
+    while ((batch->n_stripes < UNIFYFS_TRANSFER_BATCH) &&
+           (*next_stripe < total_stripes)) {
+        size_t ndx = batch->n_stripes++;
+        uint64_t offset = *next_stripe * UNIFYFS_TRANSFER_BUF_SIZE;
+        uint64_t len = size - offset;
+        if (len > UNIFYFS_TRANSFER_BUF_SIZE) {
+            len = UNIFYFS_TRANSFER_BUF_SIZE;
+        }
+        batch->offsets[ndx] = (off_t) offset;
+        batch->lengths[ndx] = (size_t) len;
+        *next_stripe += global_rank_cnt;
+    }
+    if (0 == batch->n_stripes) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    if (src->is_unify) {
+        batch->reads_pending = 1;
+        return transfer_batch_dispatch(batch, src, UNIFYFS_IOREQ_OP_READ);
+    }
+
+    for (size_t i = 0; i < batch->n_stripes; i++) {
+        size_t done = 0;
+        while (done < batch->lengths[i]) {
+            errno = 0;
+            ssize_t n = UNIFYFS_WRAP(pread)(src->fd, batch->bufs[i] + done,
+                                            batch->lengths[i] - done,
+                                            batch->offsets[i] + done);
+            err = errno;
+            if (n < 0) {
+                if (EINTR == err) {
+                    continue;
+                }
+                LOGERR("pread() failed (%d: %s)", err, strerror(err));
+                return err;
+            } else if (0 == n) {
+                LOGERR("unexpected EOF at offset %zu",
+                       (size_t)(batch->offsets[i] + done));
+                return EIO;
+            }
+            done += (size_t) n;
+        }
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+/* write the stripes of the batch once their reads have finished.
+ * Writes to UnifyFS files are dispatched and complete later. */
+static int transfer_batch_write(transfer_batch* batch,
+                                transfer_endpoint* dst)
+{
+    int err;
+    if (0 == batch->n_stripes) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    if (dst->is_unify) {
+        batch->writes_pending = 1;
+        return transfer_batch_dispatch(batch, dst, UNIFYFS_IOREQ_OP_WRITE);
+    }
+
+    for (size_t i = 0; i < batch->n_stripes; i++) {
+        size_t done = 0;
+        while (done < batch->lengths[i]) {
+            errno = 0;
+            ssize_t n = UNIFYFS_WRAP(pwrite)(dst->fd, batch->bufs[i] + done,
+                                             batch->lengths[i] - done,
+                                             batch->offsets[i] + done);
+            err = errno;
+            if (n < 0) {
+                if ((EINTR == err) || (EAGAIN == err)) {
+                    continue;
+                }
+                LOGERR("pwrite() failed (%d: %s)", err, strerror(err));
+                return err;
+            }
+            done += (size_t) n;
+        }
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+/* finish any dispatched requests of the batch */
+static int transfer_batch_complete(transfer_batch* batch)
+{
+    int ret = UNIFYFS_SUCCESS;
+    if (batch->reads_pending || batch->writes_pending) {
+        ret = transfer_batch_wait(batch);
+        batch->reads_pending = 0;
+        batch->writes_pending = 0;
+    }
+    return ret;
+}
+
+/* copy this client's stripes of the source file to the destination,
+ * using two batches so that the reads of one batch overlap with the
+ * writes of the other */
+static int do_transfer_stripes(transfer_endpoint* src,
+                               transfer_endpoint* dst,
+                               uint64_t size,
+                               uint64_t total_stripes)
+{
+    int ret = UNIFYFS_SUCCESS;
+    int rc;
+    transfer_batch batches[2];
+    memset(batches, 0, sizeof(batches));
+
+    for (int b = 0; b < 2; b++) {
+        for (int i = 0; i < UNIFYFS_TRANSFER_BATCH; i++) {
+            void* buf = NULL;
+            if (posix_memalign(&buf, UNIFYFS_TRANSFER_BUF_ALIGN,
+                               UNIFYFS_TRANSFER_BUF_SIZE) != 0) {
+                LOGERR("failed to allocate transfer buffer");
+                ret = ENOMEM;
+                goto out;
+            }
+            batches[b].bufs[i] = buf;
+        }
+    }
+
+    uint64_t next_stripe = (uint64_t) client_rank;
+    transfer_batch* cur = batches;
+    transfer_batch* nxt = batches + 1;
+    ret = transfer_batch_fill(cur, src, &next_stripe, total_stripes, size);
+    while ((UNIFYFS_SUCCESS == ret) && (cur->n_stripes > 0)) {
+        if (cur->reads_pending) {
+            ret = transfer_batch_complete(cur);
+            if (UNIFYFS_SUCCESS != ret) {
+                break;
+            }
+        }
+
+        if (src->is_unify) {
+            /* dispatch the next reads before writing this batch */
+            ret = transfer_batch_complete(nxt);
+            if (UNIFYFS_SUCCESS == ret) {
+                ret = transfer_batch_fill(nxt, src, &next_stripe,
+                                          total_stripes, size);
+            }
+            rc = transfer_batch_write(cur, dst);
+        } else {
+            /* dispatch this batch's writes before reading the next */
+            rc = transfer_batch_write(cur, dst);
+            if (UNIFYFS_SUCCESS == rc) {
+                rc = transfer_batch_complete(nxt);
+            }
+            if (UNIFYFS_SUCCESS == rc) {
+                rc = transfer_batch_fill(nxt, src, &next_stripe,
+                                         total_stripes, size);
+            }
+        }
+        if (UNIFYFS_SUCCESS == ret) {
+            ret = rc;
+        }
+
+        transfer_batch* tmp = cur;
+        cur = nxt;
+        nxt = tmp;
+    }
+
+out:
+    /* buffers may not be freed while requests are in flight */
+    for (int b = 0; b < 2; b++) {
+        rc = transfer_batch_complete(batches + b);
+        if (UNIFYFS_SUCCESS == ret) {
+            ret = rc;
+        }
+        for (int i = 0; i < UNIFYFS_TRANSFER_BATCH; i++) {
+            free(batches[b].bufs[i]);
+        }
+    }
+    return ret;
+}
+
 int transfer_file_parallel(const char* src,
                            const char* dst,
                            struct stat* sb_src,
                            int direction)
 {
-    /* NOTE: we currently do not use the @direction */
+    /* NOTE: we currently do not use the @direction, each side is
+     * checked for being a UnifyFS file instead */
 
     int err;
     int ret = UNIFYFS_SUCCESS;
     int fd_src = 0;
     int fd_dst = 0;
-    uint64_t total_chunks = 0;
-    uint64_t chunk_start = 0;
-    uint64_t n_chunks_remainder = 0;
-    uint64_t n_chunks_per_rank = 0;
-    uint64_t offset = 0;
-    uint64_t len = 0;
     uint64_t size = sb_src->st_size;
-    uint64_t last_chunk_size = 0;
-
-    /* calculate total number of chunk transfers */
-    total_chunks = size / UNIFYFS_TRANSFER_BUF_SIZE;
-    last_chunk_size = size % UNIFYFS_TRANSFER_BUF_SIZE;
-    if (last_chunk_size) {
-        total_chunks++;
-    }
-
-    /* calculate chunks per rank */
-    n_chunks_per_rank = total_chunks / global_rank_cnt;
-    n_chunks_remainder = total_chunks % global_rank_cnt;
-
-    /*
-     * if the file is smaller than (rank_count * transfer_size), just
-     * use the serial mode.
-     *
-     * FIXME: is this assumption fair even for the large rank count?
-     */
-    if (total_chunks <= (uint64_t)global_rank_cnt) {
-        if (client_rank == 0) {
-            LOGDBG("using serial transfer for small file");
-            ret = transfer_file_serial(src, dst, sb_src, direction);
-            if (ret) {
-                LOGERR("transfer_file_serial() failed");
-            }
-        } else {
-            ret = UNIFYFS_SUCCESS;
-        }
-        return ret;
+
+    /* stripes are assigned to clients round-robin, so that every client
+     * gets a share of the file and the remainder is spread evenly */
+    uint64_t total_stripes = size / UNIFYFS_TRANSFER_BUF_SIZE;
+    if (size % UNIFYFS_TRANSFER_BUF_SIZE) {
+        total_stripes++;
+    }
+    if ((uint64_t)client_rank >= total_stripes) {
+        /* nothing to do on this client */
+        return UNIFYFS_SUCCESS;
     }
 
     errno = 0;
@@ -781,42 +1129,55 @@ int transfer_file_parallel(const char* src,
         return err;
     }
 
-    chunk_start = n_chunks_per_rank * client_rank;
-    offset = chunk_start * UNIFYFS_TRANSFER_BUF_SIZE;
-    len = n_chunks_per_rank * UNIFYFS_TRANSFER_BUF_SIZE;
+    transfer_endpoint ep_src;
+    transfer_endpoint ep_dst;
+    ret = transfer_endpoint_init(&ep_src, fd_src);
+    if (UNIFYFS_SUCCESS == ret) {
+        ret = transfer_endpoint_init(&ep_dst, fd_dst);
+    }
+    if (UNIFYFS_SUCCESS != ret) {
+        LOGERR("failed to get gfid for transfer of %s to %s", src, dst);
+        goto close_files;
+    }
 
-    LOGDBG("parallel transfer (rank=%d of %d): "
-           "#chunks=%zu, offset=%zu, length=%zu",
+    uint64_t my_stripes = ((total_stripes - 1 - client_rank) /
+                           global_rank_cnt) + 1;
+    LOGDBG("parallel transfer (rank=%d of %d): #stripes=%zu of %zu",
            client_rank, global_rank_cnt,
-           (size_t)n_chunks_per_rank, (size_t)offset, (size_t)len);
+           (size_t)my_stripes, (size_t)total_stripes);
 
-    ret = do_transfer_data(fd_src, fd_dst, (off_t)offset, (size_t)len);
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+    ret = do_transfer_stripes(&ep_src, &ep_dst, size, total_stripes);
     if (ret) {
         LOGERR("failed to transfer data (ret=%d, %s)",
                ret, unifyfs_rc_enum_description(ret));
     } else {
-        if (n_chunks_remainder && (client_rank < n_chunks_remainder)) {
-            /* do single chunk transfer per rank of remainder portion */
-            len = UNIFYFS_TRANSFER_BUF_SIZE;
-            if (last_chunk_size && (client_rank == (n_chunks_remainder - 1))) {
-                len = last_chunk_size;
-            }
-            chunk_start = (total_chunks - n_chunks_remainder) + client_rank;
-            offset = chunk_start * UNIFYFS_TRANSFER_BUF_SIZE;
-
-            LOGDBG("parallel transfer (rank=%d of %d): "
-                   "#chunks=1, offset=%zu, length=%zu",
-                   client_rank, global_rank_cnt,
-                   (size_t)offset, (size_t)len);
-            ret = do_transfer_data(fd_src, fd_dst, (off_t)offset, (size_t)len);
-            if (ret) {
-                LOGERR("failed to transfer data (ret=%d, %s)",
-                       ret, unifyfs_rc_enum_description(ret));
-            }
+        /* for a UnifyFS destination, this syncs the data to the server */
+        errno = 0;
+        if (UNIFYFS_WRAP(fsync)(fd_dst) != 0) {
+            ret = (0 != errno) ? errno : EIO;
+            LOGERR("failed to fsync() destination file %s (%s)",
+                   dst, strerror(ret));
+            goto close_files;
+        }
+
+        /* report the bandwidth achieved by this client */
+        gettimeofday(&end, NULL);
+        double secs = timediff_sec(&start, &end);
+        uint64_t my_bytes = my_stripes * UNIFYFS_TRANSFER_BUF_SIZE;
+        if (((total_stripes - 1) % global_rank_cnt) ==
+            (uint64_t)client_rank) {
+            /* this client has the last, possibly partial, stripe */
+            my_bytes -= (total_stripes * UNIFYFS_TRANSFER_BUF_SIZE) - size;
         }
-        fsync(fd_dst);
+        double mib = (double)my_bytes / (double)MIB;
+        LOGINFO("parallel transfer (rank=%d of %d): %zu bytes in %.3f s "
+                "(%.1f MiB/s)", client_rank, global_rank_cnt,
+                (size_t)my_bytes, secs, (secs > 0.0) ? (mib / secs) : 0.0);
     }
 
+close_files:
     UNIFYFS_WRAP(close)(fd_dst);
     UNIFYFS_WRAP(close)(fd_src);
 
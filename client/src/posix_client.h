@@ -70,6 +70,17 @@ typedef struct {
     int fid;   /* local file id of directory for this stream */
     int fd;    /* file descriptor associated with stream */
     off_t pos; /* position within directory stream */
+
+    int gfid;        /* global file id of directory */
+    int parent_gfid; /* global file id of parent directory */
+
+    /* page of directory entries fetched from the server */
+    unifyfs_dirent_t* entries; /* buffer of entries (NULL until needed) */
+    unsigned int num_entries;  /* number of valid entries in buffer */
+    unsigned int next_entry;   /* index of next entry to return */
+    int end_of_dir;            /* set when no entries follow the buffer */
+
+    struct dirent dirent; /* entry returned by the last readdir() */
 } unifyfs_dirstream_t;
 
 
@@ -77,6 +88,15 @@ typedef struct {
 
 #define UNIFYFS_TRANSFER_BUF_SIZE (8 * MIB)
 
+/* number of transfer buffers in each batch of a parallel transfer. two
+ * batches are in flight, so reads of one batch overlap writes of the
+ * other, using 2 * UNIFYFS_TRANSFER_BATCH * UNIFYFS_TRANSFER_BUF_SIZE
+ * bytes of buffer memory per client */
+#define UNIFYFS_TRANSFER_BATCH (2)
+
+/* alignment of parallel transfer buffers */
+#define UNIFYFS_TRANSFER_BUF_ALIGN (4096)
+
 enum {
     UNIFYFS_TRANSFER_DIRECTION_OUT = 0,
     UNIFYFS_TRANSFER_DIRECTION_IN = 1
@@ -159,6 +179,10 @@ int unifyfs_would_overflow_long(long a, long b);
  * be a buffer of size UNIFYFS_MAX_FILENAME */
 int unifyfs_intercept_path(const char* path, char* upath);
 
+/* invalidate cached state derived from the current working directory,
+ * must be called whenever posix_client->cwd changes */
+void unifyfs_cwd_changed(void);
+
 /* given an fd, return 1 if we should intercept this file, 0 otherwise,
  * convert fd to new fd value if needed */
 int unifyfs_intercept_fd(int* fd);
@@ -200,7 +224,8 @@ int transfer_file_serial(const char* src,
                          struct stat* sb_src,
                          int direction);
 
-/* transfer src file to dst using all clients */
+/* transfer src file to dst using all clients, where each client copies
+ * every global_rank_cnt'th stripe of UNIFYFS_TRANSFER_BUF_SIZE bytes */
 int transfer_file_parallel(const char* src,
                            const char* dst,
                            struct stat* sb_src,
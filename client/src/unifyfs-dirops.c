@@ -15,6 +15,20 @@
 #include "unifyfs-sysio.h"
 #include "posix_client.h"
 #include "unifyfs_fid.h"
+#include "margo_client.h"
+
+/* number of entries fetched from the server per readdir rpc */
+#define UNIFYFS_DIRSTREAM_PAGE_ENTRIES 256
+
+/* directory stream positions, as returned by telldir(). positions 0 and
+ * 1 refer to the "." and ".." entries, which are not stored by servers.
+ * other positions are server read cursors (a child gfid) offset by 2.
+ * cursors are kept as off_t, since the cursor after the largest gfid
+ * (INT_MAX) does not fit in an int and marks the end of the directory */
+#define DIRSTREAM_POS_DOT    0
+#define DIRSTREAM_POS_DOTDOT 1
+#define DIRSTREAM_POS_TO_CURSOR(pos) ((off_t)(pos) - 2)
+#define DIRSTREAM_CURSOR_TO_POS(cursor) ((off_t)(cursor) + 2)
 
 /* given a file id corresponding to a directory,
  * allocate and initialize a directory stream */
@@ -69,6 +83,12 @@ static unifyfs_dirstream_t* unifyfs_dirstream_alloc(int fid)
 /* release resources allocated in unifyfs_dirstream_alloc */
 static int unifyfs_dirstream_free(unifyfs_dirstream_t* dirp)
 {
+    /* free buffer of directory entries */
+    if (NULL != dirp->entries) {
+        free(dirp->entries);
+        dirp->entries = NULL;
+    }
+
     /* reinit file descriptor to indicate that it's no longer in use,
      * not really necessary, but should help find bugs */
     unifyfs_fd_init(dirp->fd);
@@ -151,6 +171,18 @@ DIR* UNIFYFS_WRAP(opendir)(const char* name)
     meta->attrs.size = sb.st_size;
 
     unifyfs_dirstream_t* dirp = unifyfs_dirstream_alloc(fid);
+    if (NULL == dirp) {
+        return NULL;
+    }
+
+    /* record global ids used for directory entries and reads */
+    dirp->gfid = gfid;
+    dirp->parent_gfid = gfid;
+    char* slash = strrchr(upath, '/');
+    if ((NULL != slash) && (slash != upath)) {
+        *slash = '\0';
+        dirp->parent_gfid = unifyfs_generate_gfid(upath);
+    }
 
     return (DIR*) dirp;
 }
@@ -182,13 +214,110 @@ int UNIFYFS_WRAP(closedir)(DIR* dirp)
     }
 }
 
+/* discard buffered entries, so the next read fetches a page
+ * of entries starting at the current position */
+static void unifyfs_dirstream_reset(unifyfs_dirstream_t* dirp)
+{
+    dirp->num_entries = 0;
+    dirp->next_entry  = 0;
+    dirp->end_of_dir  = 0;
+}
+
+/* fill in the dirent of the stream, and return a pointer to it */
+static struct dirent* unifyfs_dirstream_set_dirent(unifyfs_dirstream_t* dirp,
+                                                   int gfid,
+                                                   uint32_t mode,
+                                                   const char* name)
+{
+    struct dirent* d = &(dirp->dirent);
+    memset(d, 0, sizeof(*d));
+    d->d_ino    = (ino_t) gfid;
+    d->d_off    = (off_t) dirp->pos;
+    d->d_reclen = sizeof(*d);
+    if (S_ISDIR(mode)) {
+        d->d_type = DT_DIR;
+    } else if (S_ISREG(mode)) {
+        d->d_type = DT_REG;
+    } else {
+        d->d_type = DT_UNKNOWN;
+    }
+    snprintf(d->d_name, sizeof(d->d_name), "%s", name);
+    return d;
+}
+
+/* return the next entry of the directory stream, or NULL at the end
+ * of the directory or on error (errno is set) */
+static struct dirent* unifyfs_dirstream_read(unifyfs_dirstream_t* dirp)
+{
+    if (DIRSTREAM_POS_DOT == dirp->pos) {
+        dirp->pos = DIRSTREAM_POS_DOTDOT;
+        return unifyfs_dirstream_set_dirent(dirp, dirp->gfid, S_IFDIR, ".");
+    }
+    if (DIRSTREAM_POS_DOTDOT == dirp->pos) {
+        dirp->pos = DIRSTREAM_CURSOR_TO_POS(0);
+        return unifyfs_dirstream_set_dirent(dirp, dirp->parent_gfid,
+                                            S_IFDIR, "..");
+    }
+
+    if (dirp->next_entry == dirp->num_entries) {
+        if (dirp->end_of_dir) {
+            return NULL;
+        }
+
+        /* no gfid follows INT_MAX */
+        off_t cursor = DIRSTREAM_POS_TO_CURSOR(dirp->pos);
+        if (cursor > INT_MAX) {
+            dirp->end_of_dir = 1;
+            return NULL;
+        }
+
+        /* fetch next page of entries from the server */
+        if (NULL == dirp->entries) {
+            dirp->entries = calloc(UNIFYFS_DIRSTREAM_PAGE_ENTRIES,
+                                   sizeof(unifyfs_dirent_t));
+            if (NULL == dirp->entries) {
+                errno = ENOMEM;
+                return NULL;
+            }
+        }
+        unsigned int n = 0;
+        int eod = 1;
+        int ret = invoke_client_readdir_rpc(posix_client, dirp->gfid,
+                                            (int) cursor,
+                                            UNIFYFS_DIRSTREAM_PAGE_ENTRIES,
+                                            dirp->entries, &n, &eod);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("readdir rpc for gfid=%d failed", dirp->gfid);
+            unifyfs_dirstream_reset(dirp);
+            errno = unifyfs_rc_errno(ret);
+            return NULL;
+        }
+        dirp->num_entries = n;
+        dirp->next_entry  = 0;
+        dirp->end_of_dir  = eod;
+        if (0 == n) {
+            return NULL;
+        }
+    }
+
+    unifyfs_dirent_t* ent = dirp->entries + dirp->next_entry;
+    dirp->next_entry++;
+
+    /* the next read resumes after the gfid of this entry */
+    dirp->pos = DIRSTREAM_CURSOR_TO_POS((off_t)ent->gfid + 1);
+    if (INT_MAX == ent->gfid) {
+        dirp->end_of_dir  = 1;
+        dirp->num_entries = dirp->next_entry;
+    }
+    return unifyfs_dirstream_set_dirent(dirp, ent->gfid, ent->mode,
+                                        ent->name);
+}
+
 struct dirent* UNIFYFS_WRAP(readdir)(DIR* dirp)
 {
     if (unifyfs_intercept_dirstream(dirp)) {
-        fprintf(stderr, "Function not yet supported @ %s:%d\n",
-                __FILE__, __LINE__);
-        errno = ENOSYS;
-        return NULL;
+        unifyfs_dirstream_t* d = (unifyfs_dirstream_t*) dirp;
+        return unifyfs_dirstream_read(d);
     } else {
         MAP_OR_FAIL(readdir);
         struct dirent* d = UNIFYFS_REAL(readdir)(dirp);
@@ -201,9 +330,8 @@ void UNIFYFS_WRAP(rewinddir)(DIR* dirp)
     if (unifyfs_intercept_dirstream(dirp)) {
         unifyfs_dirstream_t* _dirp = (unifyfs_dirstream_t*) dirp;
 
-        /* TODO: update the pos in the file descriptor (fd) via lseek */
-
-        _dirp->pos = 0;
+        _dirp->pos = DIRSTREAM_POS_DOT;
+        unifyfs_dirstream_reset(_dirp);
     } else {
         MAP_OR_FAIL(rewinddir);
         UNIFYFS_REAL(rewinddir)(dirp);
@@ -236,17 +364,68 @@ long UNIFYFS_WRAP(telldir)(DIR* dirp)
     }
 }
 
-int UNIFYFS_WRAP(scandir)(const char* path, struct dirent** namelist,
+int UNIFYFS_WRAP(scandir)(const char* path, struct dirent*** namelist,
                           int (*filter)(const struct dirent*),
                           int (*compar)(const struct dirent**,
                                         const struct dirent**))
 {
     char upath[UNIFYFS_MAX_FILENAME];
     if (unifyfs_intercept_path(path, upath)) {
-        fprintf(stderr, "Function not yet supported @ %s:%d\n",
-                __FILE__, __LINE__);
-        errno = ENOSYS;
-        return -1;
+        DIR* dirp = UNIFYFS_WRAP(opendir)(path);
+        if (NULL == dirp) {
+            return -1;
+        }
+
+        /* collect copies of the selected entries */
+        struct dirent** list = NULL;
+        size_t count = 0;
+        size_t max_count = 0;
+        int err = 0;
+        struct dirent* d;
+        errno = 0;
+        while (NULL != (d = UNIFYFS_WRAP(readdir)(dirp))) {
+            if ((NULL != filter) && !filter(d)) {
+                continue;
+            }
+            if (count == max_count) {
+                max_count = (0 == max_count) ? 32 : (2 * max_count);
+                struct dirent** tmp = realloc(list,
+                                              max_count * sizeof(*list));
+                if (NULL == tmp) {
+                    err = ENOMEM;
+                    break;
+                }
+                list = tmp;
+            }
+            list[count] = malloc(sizeof(struct dirent));
+            if (NULL == list[count]) {
+                err = ENOMEM;
+                break;
+            }
+            memcpy(list[count], d, sizeof(struct dirent));
+            count++;
+        }
+        if ((0 == err) && (0 != errno)) {
+            /* readdir failed */
+            err = errno;
+        }
+        UNIFYFS_WRAP(closedir)(dirp);
+
+        if (err) {
+            for (size_t i = 0; i < count; i++) {
+                free(list[i]);
+            }
+            free(list);
+            errno = err;
+            return -1;
+        }
+
+        if ((NULL != compar) && (count > 1)) {
+            qsort(list, count, sizeof(*list),
+                  (int (*)(const void*, const void*)) compar);
+        }
+        *namelist = list;
+        return (int) count;
     } else {
         MAP_OR_FAIL(scandir);
         long ret = UNIFYFS_REAL(scandir)(path, namelist, filter, compar);
@@ -257,9 +436,15 @@ int UNIFYFS_WRAP(scandir)(const char* path, struct dirent** namelist,
 void UNIFYFS_WRAP(seekdir)(DIR* dirp, long loc)
 {
     if (unifyfs_intercept_dirstream(dirp)) {
-        fprintf(stderr, "Function not yet supported @ %s:%d\n",
-                __FILE__, __LINE__);
-        errno = ENOSYS;
+        unifyfs_dirstream_t* d = (unifyfs_dirstream_t*) dirp;
+
+        /* positions are only valid if returned by telldir(), which
+         * never returns a negative value */
+        if (loc < 0) {
+            loc = DIRSTREAM_POS_DOT;
+        }
+        d->pos = (off_t) loc;
+        unifyfs_dirstream_reset(d);
     } else {
         MAP_OR_FAIL(seekdir);
         UNIFYFS_REAL(seekdir)(dirp, loc);
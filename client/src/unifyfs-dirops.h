@@ -43,7 +43,7 @@ UNIFYFS_DECL(readdir, struct dirent*, (DIR* dirp));
 UNIFYFS_DECL(rewinddir, void, (DIR* dirp));
 UNIFYFS_DECL(dirfd, int, (DIR* dirp));
 UNIFYFS_DECL(telldir, long, (DIR* dirp));
-UNIFYFS_DECL(scandir, int, (const char* dirp, struct dirent** namelist,
+UNIFYFS_DECL(scandir, int, (const char* dirp, struct dirent*** namelist,
                             int (*filter)(const struct dirent*),
                             int (*compar)(const struct dirent**,
                                     const struct dirent**)));
@@ -103,6 +103,7 @@
 #include "unifyfs_log.h"
 #include "unifyfs_logio.h"
 #include "unifyfs_meta.h"
+#include "unifyfs_stats.h"
 #include "unifyfs_shm.h"
 #include "seg_tree.h"
 
@@ -251,6 +251,7 @@ int UNIFYFS_WRAP(chdir)(const char* path)
             free(posix_client->cwd);
         }
         posix_client->cwd = upath_copy;
+        unifyfs_cwd_changed();
         errno = 0;
         return 0;
     } else {
@@ -268,6 +269,8 @@ int UNIFYFS_WRAP(chdir)(const char* path)
              * to get the current working directory */
             MAP_OR_FAIL(getcwd);
             char* cwd = UNIFYFS_REAL(getcwd)(NULL, 0);
+            posix_client->cwd = NULL;
+            unifyfs_cwd_changed();
             if (cwd != NULL) {
                 posix_client->cwd = cwd;
 
@@ -1775,6 +1778,84 @@ int UNIFYFS_WRAP(posix_fadvise)(int fd, off_t offset, off_t len, int advice)
 }
 #endif
 
+#ifdef HAVE_FALLOCATE
+int UNIFYFS_WRAP(fallocate)(int fd, int mode, off_t offset, off_t len)
+{
+    /* check whether we should intercept this file descriptor */
+    if (unifyfs_intercept_fd(&fd)) {
+        /* check that the file descriptor is valid */
+        int fid = unifyfs_get_fid_from_fd(fd);
+        if (fid < 0) {
+            errno = EBADF;
+            return -1;
+        }
+
+        /* check that file descriptor is open for write */
+        unifyfs_fd_t* filedesc = unifyfs_get_filedesc_from_fd(fd);
+        if (!filedesc->write) {
+            errno = EBADF;
+            return -1;
+        }
+
+        if ((offset < 0) || (len <= 0)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        int keep_size = (mode & FALLOC_FL_KEEP_SIZE);
+        int op = (mode & ~FALLOC_FL_KEEP_SIZE);
+        if ((op == FALLOC_FL_PUNCH_HOLE) && !keep_size) {
+            /* punching a hole must not change the file size */
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+        if ((op != 0) &&
+            (op != FALLOC_FL_PUNCH_HOLE) &&
+            (op != FALLOC_FL_ZERO_RANGE)) {
+            /* collapse, insert, and unshare ranges are not supported */
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+
+        /* log-based storage needs no preallocation, so the only effects
+         * are zeroing the range and possibly extending the file size.
+         * Both are done with hole extents, which use no log space. */
+        off_t start = offset;
+        off_t end = offset + len;
+        if ((op == 0) || keep_size) {
+            off_t filesize = unifyfs_fid_logical_size(posix_client, fid);
+            if (filesize < 0) {
+                errno = EIO;
+                return -1;
+            }
+            if ((op == 0) && (start < filesize)) {
+                /* only zero the part of the range past end of file */
+                start = filesize;
+            }
+            if (keep_size && (end > filesize)) {
+                /* only zero the part of the range within the file */
+                end = filesize;
+            }
+        }
+        if (start >= end) {
+            return 0;
+        }
+
+        int rc = unifyfs_fid_zero(posix_client, fid, start,
+                                  (size_t)(end - start));
+        if (rc != UNIFYFS_SUCCESS) {
+            errno = unifyfs_rc_errno(rc);
+            return -1;
+        }
+        return 0;
+    } else {
+        MAP_OR_FAIL(fallocate);
+        int ret = UNIFYFS_REAL(fallocate)(fd, mode, offset, len);
+        return ret;
+    }
+}
+#endif
+
 ssize_t UNIFYFS_WRAP(read)(int fd, void* buf, size_t count)
 {
     /* check whether we should intercept this file descriptor */
@@ -2185,6 +2266,7 @@ int UNIFYFS_WRAP(fchdir)(int fd)
             free(posix_client->cwd);
         }
         posix_client->cwd = strdup(path);
+        unifyfs_cwd_changed();
         errno = 0;
         return 0;
     } else {
@@ -2202,6 +2284,8 @@ int UNIFYFS_WRAP(fchdir)(int fd)
              * to get the current working directory */
             MAP_OR_FAIL(getcwd);
             char* cwd = UNIFYFS_REAL(getcwd)(NULL, 0);
+            posix_client->cwd = NULL;
+            unifyfs_cwd_changed();
             if (cwd != NULL) {
                 posix_client->cwd = cwd;
 
@@ -2559,6 +2643,9 @@ static int __chmod(int fid, mode_t mode)
             errno = unifyfs_rc_errno(ret);
             return -1;
         }
+
+        /* extents of a laminated file no longer change */
+        __atomic_store_n(&(meta->publish_extents), 1, __ATOMIC_SEQ_CST);
     }
 
     /* Clear out our old permission bits, and set the new ones in */
@@ -132,6 +132,7 @@ UNIFYFS_DECL(__fxstat, int, (int vers, int fd, struct stat* buf));
 UNIFYFS_DECL(__fxstat64, int, (int vers, int fd, struct stat64* buf));
 UNIFYFS_DECL(fstatfs, int, (int fd, struct statfs* fsbuf));
 UNIFYFS_DECL(posix_fadvise, int, (int fd, off_t offset, off_t len, int advice));
+UNIFYFS_DECL(fallocate, int, (int fd, int mode, off_t offset, off_t len));
 
 /*
  * Read 'count' bytes info 'buf' from file starting at offset 'pos'.
@@ -168,9 +168,10 @@ int unifyfs_get_global_file_meta(unifyfs_client* client,
  *  - array of unifyfs_filemeta structs, indexed by local
  *    file id
  *
- *  - count of number of active index entries
+ *  - count of number of active index entries for each index slot
  *  - array of index metadata to track physical offset
- *    of logical file data, of length max_write_index_entries,
+ *    of logical file data, of length max_write_index_entries
+ *    for each of the UNIFYFS_WRITE_INDEX_SLOTS index slots,
  *    entries added during write operations
  */
 
@@ -196,7 +197,8 @@ static size_t get_superblock_size(unifyfs_client* client)
 
     /* index region size */
     sb_size += get_page_size();
-    sb_size += client->max_write_index_entries * sizeof(unifyfs_index_t);
+    sb_size += UNIFYFS_WRITE_INDEX_SLOTS *
+               client->max_write_index_entries * sizeof(unifyfs_index_t);
 
     /* return number of bytes */
     return sb_size;
@@ -227,16 +229,17 @@ static void init_superblock_pointers(unifyfs_client* client,
 
     /* record pointers to number of index entries and entries array */
     size_t pgsz = get_page_size();
-    size_t entries_size =
+    size_t entries_size = UNIFYFS_WRITE_INDEX_SLOTS *
         client->max_write_index_entries * sizeof(unifyfs_index_t);
     size_t index_size = pgsz + entries_size;
 
     client->state.write_index.index_offset = (size_t)(ptr - super);
     client->state.write_index.index_size = index_size;
+    client->state.write_index.slot_entries = client->max_write_index_entries;
     client->state.write_index.ptr_num_entries = (size_t*)ptr;
     ptr += pgsz;
     client->state.write_index.index_entries = (unifyfs_index_t*)ptr;
-    ptr += client->max_write_index_entries * sizeof(unifyfs_index_t);
+    ptr += entries_size;
 
     /* compute size of memory we're using and check that
      * it matches what we allocated */
@@ -259,7 +262,9 @@ static int init_superblock_structures(unifyfs_client* client)
     unifyfs_stack_init(client->free_fid_stack, client->max_files);
 
     /* initialize count of key/value entries */
-    *(client->state.write_index.ptr_num_entries) = 0;
+    for (int i = 0; i < UNIFYFS_WRITE_INDEX_SLOTS; i++) {
+        *unifyfs_write_index_count(&(client->state.write_index), i) = 0;
+    }
 
     LOGDBG("Meta-stacks initialized!");
 
@@ -316,7 +321,9 @@ static int init_superblock_shm(unifyfs_client* client,
          * memory at this point. */
 
         /* initialize count of key/value entries */
-        *(client->state.write_index.ptr_num_entries) = 0;
+        for (int i = 0; i < UNIFYFS_WRITE_INDEX_SLOTS; i++) {
+            *unifyfs_write_index_count(&(client->state.write_index), i) = 0;
+        }
 
         unifyfs_filemeta_t* meta;
         for (int i = 0; i < client->max_files; i++) {
@@ -335,6 +342,11 @@ static int init_superblock_shm(unifyfs_client* client,
                     client->use_node_local_extents) {
                     seg_tree_init(&meta->extents);
                 }
+                meta->shared_extents = NULL;
+                meta->shared_extents_retry = 0;
+                memset(&(meta->shared_extents_readers), 0,
+                       sizeof(meta->shared_extents_readers));
+                meta->shared_extents_retired = NULL;
             }
         }
     }
@@ -391,6 +403,26 @@ int unifyfs_client_init(unifyfs_client* client)
             }
         }
 
+        // use the background log writer if requested, client messages
+        // go to stderr so they are always written as text
+        cfgval = client_cfg->log_async;
+        if (cfgval != NULL) {
+            bool enable = false;
+            rc = configurator_bool_val(cfgval, &enable);
+            if ((rc == 0) && enable) {
+                bool drop = false;
+                cfgval = client_cfg->log_async_drop;
+                if (cfgval != NULL) {
+                    configurator_bool_val(cfgval, &drop);
+                }
+                unifyfs_log_async_drop = (int)drop;
+                rc = unifyfs_log_async_start(0);
+                if (rc != UNIFYFS_SUCCESS) {
+                    LOGWARN("failed to start async log writer (rc=%d)", rc);
+                }
+            }
+        }
+
         /* determine the size of the superblock */
         size_t shm_super_size = get_superblock_size(client);
 
@@ -429,11 +461,31 @@ int unifyfs_client_init(unifyfs_client* client)
             return UNIFYFS_FAILURE;
         }
 
+        /* cache of node-local extent slices */
+        if (client->use_node_local_extents) {
+            client->extent_cache = calloc(client->extent_cache_slices,
+                                          sizeof(client_extent_slice));
+            if (NULL == client->extent_cache) {
+                LOGERR("failed to allocate node-local extent cache");
+                return ENOMEM;
+            }
+        }
+        pthread_mutex_init(&(client->extent_cache_sync), NULL);
+        client->extent_cache_clock = 0;
+
         pthread_mutexattr_t mux_recursive;
         pthread_mutexattr_init(&mux_recursive);
         pthread_mutexattr_settype(&mux_recursive, PTHREAD_MUTEX_RECURSIVE);
         pthread_mutex_init(&(client->sync), &mux_recursive);
 
+        /* no write index syncs are in flight yet */
+        pthread_mutex_init(&(client->write_index_sync), NULL);
+        client->write_index_slot = 0;
+        client->write_index_unsent = 0;
+        client->inflight_sync = NULL;
+        client->write_index_error = UNIFYFS_SUCCESS;
+        client->write_extents_coalesced = 0;
+
         /* remember that we've now initialized the library */
         client->state.initialized = 1;
     }
@@ -468,6 +520,9 @@ int unifyfs_client_fini(unifyfs_client* client)
         return UNIFYFS_FAILURE;
     }
 
+    LOGINFO("write coalescing saved %zu sync extents",
+            client->write_extents_coalesced);
+
     pthread_mutex_lock(&(client->sync));
 
     if (NULL != client->active_mreads) {
@@ -480,6 +535,13 @@ int unifyfs_client_fini(unifyfs_client* client)
 
     pthread_mutex_unlock(&(client->sync));
     pthread_mutex_destroy(&(client->sync));
+    pthread_mutex_destroy(&(client->write_index_sync));
+
+    if (NULL != client->extent_cache) {
+        free(client->extent_cache);
+        client->extent_cache = NULL;
+    }
+    pthread_mutex_destroy(&(client->extent_cache_sync));
 
     /* close spillover files */
     if (NULL != client->state.logio_ctx) {
@@ -529,18 +591,27 @@ int unifyfs_sync_files(unifyfs_client* client)
 {
     int ret = UNIFYFS_SUCCESS;
 
-    /* sync every active file */
+    int* fids = calloc(client->max_files, sizeof(int));
+    if (NULL == fids) {
+        return ENOMEM;
+    }
+
+    /* sync every active file, using as few sync rpcs as possible */
     pthread_mutex_lock(&(client->sync));
+    int num_fids = 0;
     for (int i = 0; i < client->max_files; i++) {
         if (client->unifyfs_filelist[i].in_use) {
-            /* got an active file, so sync this file id */
-            int rc = unifyfs_fid_sync_extents(client, i);
-            if (UNIFYFS_SUCCESS != rc) {
-                ret = rc;
-            }
+            /* got an active file, so add this file id */
+            fids[num_fids++] = i;
         }
     }
+    int rc = unifyfs_fid_sync_extents_list(client, num_fids, fids);
+    if (UNIFYFS_SUCCESS != rc) {
+        ret = rc;
+    }
     pthread_mutex_unlock(&(client->sync));
 
+    free(fids);
+
     return ret;
 }
@@ -15,6 +15,7 @@
 #include "unifyfs_api_internal.h"
 #include "unifyfs_fid.h"
 #include "margo_client.h"
+#include "unifyfs_rpc_util.h"
 
 /*
  * Public Methods
@@ -135,6 +136,26 @@ unifyfs_rc unifyfs_initialize(const char* mountpoint,
         }
     }
 
+    /* Node-local extents are fetched for slices of a file as they are
+     * read, and the extents of the least recently read slices are
+     * dropped to bound client memory */
+    client->extent_slice_size = UNIFYFS_CLIENT_EXTENT_SLICE_SIZE;
+    cfgval = client_cfg->client_node_local_extents_slice;
+    if (cfgval != NULL) {
+        rc = configurator_int_val(cfgval, &l);
+        if ((rc == 0) && (l > 0)) {
+            client->extent_slice_size = (size_t)l;
+        }
+    }
+    client->extent_cache_slices = UNIFYFS_CLIENT_EXTENT_CACHE_SLICES;
+    cfgval = client_cfg->client_node_local_extents_cache;
+    if (cfgval != NULL) {
+        rc = configurator_int_val(cfgval, &l);
+        if ((rc == 0) && (l > 0)) {
+            client->extent_cache_slices = (size_t)l;
+        }
+    }
+
     /* Create node-local private files, rather than globally shared files
      * when given O_EXCL during file open/create operations. */
     client->use_excl_private = true;
@@ -216,6 +237,15 @@ unifyfs_rc unifyfs_initialize(const char* mountpoint,
         }
     }
 
+    /* Maximum size of each bulk transfer of read data from the server */
+    cfgval = client_cfg->margo_bulk_tx_size;
+    if (cfgval != NULL) {
+        rc = configurator_int_val(cfgval, &l);
+        if (rc == 0) {
+            unifyfs_set_bulk_tx_size((size_t)l);
+        }
+    }
+
     // initialize k-v store access
     int kv_rank = 0;
     int kv_nranks = 1;
@@ -275,6 +305,15 @@ unifyfs_rc unifyfs_initialize(const char* mountpoint,
         }
     }
 
+    /* set up progress engine for asynchronous I/O requests, its thread
+     * is started by the first dispatch */
+    rc = unifyfs_io_engine_init(client);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to set up I/O progress engine");
+        unifyfs_client_fini(client);
+        return rc;
+    }
+
     unifyfs_handle client_hdl = (unifyfs_handle) client;
     *fshdl = client_hdl;
     return UNIFYFS_SUCCESS;
@@ -290,6 +329,9 @@ unifyfs_rc unifyfs_finalize(unifyfs_handle fshdl)
 
     int ret = UNIFYFS_SUCCESS;
 
+    /* complete any queued I/O requests and stop progress engine */
+    unifyfs_io_engine_fini(client);
+
     if (client->state.is_mounted) {
         /* sync any outstanding writes */
         LOGDBG("syncing data");
@@ -369,3 +411,40 @@ unifyfs_rc unifyfs_get_config(unifyfs_handle fshdl,
     }
     return ret;
 }
+
+/* Retrieve a text report of the client's and local server's stats */
+unifyfs_rc unifyfs_get_stats(unifyfs_handle fshdl,
+                             char** report)
+{
+    if ((UNIFYFS_INVALID_HANDLE == fshdl) || (NULL == report)) {
+        return EINVAL;
+    }
+    unifyfs_client* client = fshdl;
+
+    char* client_stats = NULL;
+    size_t client_len = 0;
+    int ret = unifyfs_stats_report(&client_stats, &client_len);
+    if (UNIFYFS_SUCCESS != ret) {
+        return ret;
+    }
+
+    char* server_stats = NULL;
+    ret = invoke_client_stats_rpc(client, &server_stats);
+    if (UNIFYFS_SUCCESS != ret) {
+        LOGERR("failed to get server stats");
+        free(client_stats);
+        return ret;
+    }
+
+    char* combined = NULL;
+    int len = asprintf(&combined, "client %d of app %d\n%s\n%s",
+                       client->state.client_id, client->state.app_id,
+                       client_stats, server_stats);
+    free(client_stats);
+    free(server_stats);
+    if (len < 0) {
+        return ENOMEM;
+    }
+    *report = combined;
+    return UNIFYFS_SUCCESS;
+}
@@ -169,6 +169,26 @@ typedef struct unifyfs_server_file_meta {
 
 } unifyfs_server_file_meta;
 
+/* Filter for unifyfs_list_files() */
+typedef struct unifyfs_file_filter {
+    /* only list files whose path starts with prefix (NULL for any) */
+    const char* path_prefix;
+
+    /* only list files owned by this server rank (-1 for any) */
+    int owner_rank;
+
+    /* 1 to only list laminated files, 0 to only list files that are
+     * not laminated, -1 for any */
+    int laminated;
+} unifyfs_file_filter;
+
+/* Position within a file listing, start a listing with
+ * UNIFYFS_LIST_CURSOR_START. A listing is complete when the cursor
+ * is set to UNIFYFS_LIST_CURSOR_END */
+typedef uint64_t unifyfs_list_cursor;
+#define UNIFYFS_LIST_CURSOR_START ((unifyfs_list_cursor)0)
+#define UNIFYFS_LIST_CURSOR_END ((unifyfs_list_cursor)UINT64_MAX)
+
 /*
  * Public Methods
  */
@@ -211,6 +231,18 @@ unifyfs_rc unifyfs_get_config(unifyfs_handle fshdl,
                               int* n_opts,
                               unifyfs_cfg_option** options);
 
+/*
+ * Retrieve a text report of the performance counters and RPC latency
+ * histograms of the client and its local UnifyFS server.
+ *
+ * @param[in]   fshdl       Client file system handle
+ * @param[out]  report      pointer to report string, caller must free
+ *
+ * @return      UnifyFS success or failure code
+ */
+unifyfs_rc unifyfs_get_stats(unifyfs_handle fshdl,
+                             char** report);
+
 /*
  * Create and open a new file in UnifyFS.
  *
@@ -290,7 +322,12 @@ unifyfs_rc unifyfs_remove(unifyfs_handle fshdl,
                           const char* filepath);
 
 /*
- * Dispatch a set of I/O requests to UnifyFS.
+ * Dispatch a set of I/O requests to UnifyFS. The requests are queued to
+ * a background progress engine, and this function returns without waiting
+ * for them to complete. Requests from separate dispatch calls are processed
+ * in dispatch order. The requests array and the user buffers must remain
+ * valid until the requests have completed or been canceled
+ * (see unifyfs_wait_io()).
  *
  * @param[in]   fshdl       Client file system handle
  * @param[in]   nreqs       Size of I/O requests array
@@ -304,7 +341,9 @@ unifyfs_rc unifyfs_dispatch_io(unifyfs_handle fshdl,
 
 /*
  * Cancel a set of outstanding I/O requests. Only requests that
- * are still in-progress will be canceled.
+ * are still in-progress, and that the progress engine has not yet
+ * started processing, will be canceled. Canceled requests have their
+ * state set to UNIFYFS_REQ_STATE_CANCELED and result error ECANCELED.
  *
  * @param[in]   fshdl       Client file system handle
  * @param[in]   nreqs       Size of I/O requests array
@@ -394,6 +433,31 @@ unifyfs_rc unifyfs_get_gfid_list(unifyfs_handle fshdl,
                                  unifyfs_gfid** gfid_list);
 
 
+/*
+ * Get metadata for the next page of files that match the filter.
+ *
+ * Each call returns up to max_files files and advances the cursor. Files
+ * are listed in order of their owner server, so listings of files created
+ * or removed during the listing may or may not include those files.
+ * The filename of each returned file is allocated by this function, the
+ * caller must free it.
+ *
+ * @param[in]     fshdl      Client file system handle
+ * @param[in]     filter     file filter (NULL for all files)
+ * @param[in,out] cursor     listing position
+ * @param[in]     max_files  size of files array
+ * @param[out]    files      array of file metadata
+ * @param[out]    num_files  number of files returned
+ *
+ * @return      UnifyFS success or failure code
+ */
+unifyfs_rc unifyfs_list_files(unifyfs_handle fshdl,
+                              const unifyfs_file_filter* filter,
+                              unifyfs_list_cursor* cursor,
+                              size_t max_files,
+                              unifyfs_server_file_meta* files,
+                              size_t* num_files);
+
 /* Get metadata for a specific gfid from the server */
 /* Note: This function differs from unifyfs_stat() above in that this function
  * goes directly to the server and doesn't bother checking for anything that
@@ -229,6 +229,12 @@ unifyfs_rc unifyfs_laminate(unifyfs_handle fshdl,
                 /* update local file metadata from global metadata */
                 unifyfs_fid_update_file_meta(client, fid, &attr);
             }
+
+            /* extents of a laminated file no longer change */
+            unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
+            if (NULL != meta) {
+                __atomic_store_n(&(meta->publish_extents), 1, __ATOMIC_SEQ_CST);
+            }
         }
     }
 
@@ -288,6 +294,103 @@ unifyfs_rc unifyfs_get_gfid_list(unifyfs_handle fshdl,
     return invoke_client_get_gfids_rpc(client, num_gfids, (int**)gfid_list);
 }
 
+/* size of the buffer for a page of file records from the server */
+#define UNIFYFS_LIST_FILES_PAGE_BYTES (256 * KIB)
+
+/* Get metadata for the next page of files that match the filter */
+unifyfs_rc unifyfs_list_files(unifyfs_handle fshdl,
+                              const unifyfs_file_filter* filter,
+                              unifyfs_list_cursor* cursor,
+                              size_t max_files,
+                              unifyfs_server_file_meta* files,
+                              size_t* num_files)
+{
+    if ((UNIFYFS_INVALID_HANDLE == fshdl) || (NULL == cursor) ||
+        (NULL == num_files) || ((max_files > 0) && (NULL == files))) {
+        return EINVAL;
+    }
+    *num_files = 0;
+    if ((UNIFYFS_LIST_CURSOR_END == *cursor) || (0 == max_files)) {
+        return UNIFYFS_SUCCESS;
+    }
+    if (max_files > INT32_MAX) {
+        max_files = INT32_MAX;
+    }
+
+    unifyfs_client* client = fshdl;
+    unifyfs_file_filter_t ffilter = {
+        .prefix = NULL,
+        .owner_rank = -1,
+        .laminated = -1
+    };
+    if (NULL != filter) {
+        ffilter.prefix = filter->path_prefix;
+        ffilter.owner_rank = filter->owner_rank;
+        ffilter.laminated = filter->laminated;
+    }
+
+    /* the cursor holds the owner server rank and the gfid to resume at */
+    int cursor_rank = (int)(*cursor >> 32);
+    int cursor_gfid = (int)(*cursor & 0xFFFFFFFF);
+
+    void* page = malloc(UNIFYFS_LIST_FILES_PAGE_BYTES);
+    if (NULL == page) {
+        return ENOMEM;
+    }
+
+    unsigned int n_recs = 0;
+    size_t page_used = 0;
+    int ret = invoke_client_list_files_rpc(client, &ffilter,
+                                           &cursor_rank, &cursor_gfid,
+                                           (unsigned int) max_files,
+                                           page, UNIFYFS_LIST_FILES_PAGE_BYTES,
+                                           &n_recs, &page_used);
+    if (ret == UNIFYFS_SUCCESS) {
+        /* unpack file records */
+        size_t off = 0;
+        unsigned int i;
+        for (i = 0; (i < n_recs) && (off < page_used); i++) {
+            unifyfs_file_rec_t* rec = (unifyfs_file_rec_t*)((char*)page + off);
+            if ((rec->rec_size < sizeof(*rec)) ||
+                ((off + rec->rec_size) > page_used)) {
+                LOGERR("invalid file record at page offset %zu", off);
+                ret = UNIFYFS_FAILURE;
+                break;
+            }
+            unifyfs_server_file_meta* fmeta = files + i;
+            fmeta->filename     = strdup(unifyfs_file_rec_path(rec));
+            fmeta->gfid         = rec->gfid;
+            fmeta->is_laminated = rec->is_laminated;
+            fmeta->is_shared    = rec->is_shared;
+            fmeta->mode         = rec->mode;
+            fmeta->uid          = rec->uid;
+            fmeta->gid          = rec->gid;
+            fmeta->size         = rec->size;
+            fmeta->atime        = rec->atime;
+            fmeta->mtime        = rec->mtime;
+            fmeta->ctime        = rec->ctime;
+            off += rec->rec_size;
+        }
+        if (ret == UNIFYFS_SUCCESS) {
+            *num_files = (size_t) i;
+            if (cursor_rank < 0) {
+                *cursor = UNIFYFS_LIST_CURSOR_END;
+            } else {
+                *cursor = ((uint64_t)cursor_rank << 32) |
+                          (uint64_t)(uint32_t)cursor_gfid;
+            }
+        } else {
+            /* release names of records we unpacked */
+            for (unsigned int j = 0; j < i; j++) {
+                free(files[j].filename);
+                files[j].filename = NULL;
+            }
+        }
+    }
+    free(page);
+    return ret;
+}
+
 /* Get metadata for a specific gfid from the server */
 /* Note: This function differs from unifyfs_stat() above in that this function
  * goes directly to the server and doesn't bother checking for anything that
@@ -24,11 +24,28 @@
 
 /* ---  types and structures --- */
 
+/* outstanding asynchronous sync of a write index slot (see margo_client.c) */
+typedef struct client_sync_request client_sync_request;
+
+/* batch of requests queued by unifyfs_dispatch_io() (see unifyfs_api_io.c) */
+typedef struct client_io_batch client_io_batch;
+
 enum unifyfs_file_storage {
     FILE_STORAGE_NULL = 0,
     FILE_STORAGE_LOGIO
 };
 
+/* detached shared extent index waiting for its readers (see
+ * client_read.c) */
+typedef struct client_retired_extents client_retired_extents;
+
+/* file slice with node-local extents in the client extent cache */
+typedef struct {
+    int gfid;                     /* global file id of slice */
+    size_t slice;                 /* slice index within file */
+    uint64_t last_use;            /* LRU clock value, 0 if entry unused */
+} client_extent_slice;
+
 /* Client file metadata */
 typedef struct {
     int fid;                      /* local file index in filemetas array */
@@ -37,11 +54,22 @@ typedef struct {
     int pending_unlink;           /* received unlink callback */
 
     int needs_writes_sync;               /* have unsynced writes */
-    int needs_reads_sync;       /* have unsynced read extents from server */
     struct seg_tree extents_sync; /* Segment tree containing our coalesced
                                    * writes between sync operations */
 
     struct seg_tree extents;      /* Segment tree of all local data extents */
+    int publish_extents;          /* publish a snapshot of extents for
+                                   * lock-free reads on next read, only
+                                   * accessed atomically */
+
+    shm_context* shared_extents;  /* server's shared extent index of
+                                   * laminated file, or NULL */
+    time_t shared_extents_retry;  /* time to retry attaching to index */
+
+    /* readers register here, so that a detached index is unmapped
+     * only after its readers are done */
+    reader_epoch shared_extents_readers;
+    client_retired_extents* shared_extents_retired;
 
     unifyfs_file_attr_t attrs;    /* UnifyFS and POSIX file attributes */
 } unifyfs_filemeta_t;
@@ -70,6 +98,8 @@ typedef struct unifyfs_client {
     bool use_local_extents;          /* enable tracking of local extents */
     bool use_node_local_extents;     /* enable tracking of extents within
                                       * node only for laminate files */
+    size_t extent_slice_size;        /* bytes per node-local extent slice */
+    size_t extent_cache_slices;      /* max slices in extent cache */
     bool use_write_sync;             /* sync for every write operation */
     bool use_unifyfs_magic;          /* return UNIFYFS (true) or TMPFS (false)
                                       * magic value from statfs() */
@@ -78,6 +108,18 @@ typedef struct unifyfs_client {
 
     size_t write_index_size;         /* size of metadata log */
     size_t max_write_index_entries;  /* max metadata log entries */
+    size_t write_extents_coalesced;  /* sync extents saved by coalescing
+                                      * file- and log-contiguous writes */
+
+    /* the write index is double-buffered, so that writes can keep adding
+     * extents while the server ingests the previously synced batch */
+    pthread_mutex_t write_index_sync;      /* serializes index syncs */
+    int write_index_slot;                  /* index slot for next sync */
+    int write_index_unsent;                /* slot holds extents whose
+                                            * sync rpc failed */
+    client_sync_request* inflight_sync;    /* in-flight sync, or NULL */
+    int write_index_error;                 /* first error of an async
+                                            * sync, not yet reported */
 
     size_t unlink_usecs;             /* micrcosecs to sleep after unlink */
 
@@ -87,6 +129,12 @@ typedef struct unifyfs_client {
     /* mutex for synchronizing updates to below state */
     pthread_mutex_t sync;
 
+    /* LRU cache of the file slices whose node-local extents have been
+     * fetched into the file extent trees (see client_read.c) */
+    pthread_mutex_t extent_cache_sync;
+    client_extent_slice* extent_cache;
+    uint64_t extent_cache_clock;
+
     /* an arraylist to maintain the active mread requests for the client */
     arraylist_t* active_mreads;
     unsigned int mread_id_generator; /* to generate unique mread ids */
@@ -95,6 +143,17 @@ typedef struct unifyfs_client {
     arraylist_t* active_transfers;
     unsigned int transfer_id_generator; /* to generate unique transfer ids */
 
+    /* background progress engine for dispatched I/O requests */
+    pthread_t io_thread;             /* engine thread */
+    pthread_mutex_t io_sync;         /* protects below and ioreq states */
+    pthread_cond_t io_cond;          /* signals new batches/completions */
+    client_io_batch* io_queue_head;  /* queued batches, in dispatch order */
+    client_io_batch* io_queue_tail;
+    client_io_batch* io_active;      /* batch being processed by engine */
+    bool io_thread_running;          /* engine thread was started */
+    bool io_thread_exit;             /* tells engine thread to exit */
+    struct unifyfs_client* io_engine_next; /* next client with an engine */
+
     /* per-file metadata */
     void* free_fid_stack;
     unifyfs_filename_t* unifyfs_filelist;
@@ -132,6 +191,12 @@ int unifyfs_get_global_file_meta(unifyfs_client* client,
 /* sync all writes for client files with the server */
 int unifyfs_sync_files(unifyfs_client* client);
 
+/* set up/stop the background progress engine for dispatched I/O requests.
+ * The engine thread is started by the first dispatch, and stopping the
+ * engine completes all queued requests first */
+int unifyfs_io_engine_init(unifyfs_client* client);
+int unifyfs_io_engine_fini(unifyfs_client* client);
+
 /* get current file size. if we have a local file corresponding to the
  * given gfid, we use the local metadata. otherwise, we use a global
  * metadata lookup */
@@ -12,8 +12,6 @@
  * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
  */
 
-#include <unistd.h> // usleep
-
 #include "unifyfs_api_internal.h"
 #include "client_read.h"
 
@@ -39,28 +37,22 @@ static int process_gfid_writes(unifyfs_client* client,
             continue;
         }
 
+        int rc;
         if (req->op == UNIFYFS_IOREQ_OP_ZERO) {
-            /* TODO: support OP_ZERO in a more efficient manner */
-            req->user_buf = calloc(1, req->nbytes);
-            if (NULL == req->user_buf) {
-                ret = ENOMEM;
-                continue;
+            /* record a hole extent rather than writing zeros to the log */
+            rc = unifyfs_fid_zero(client, fid, req->offset, req->nbytes);
+            if (rc == UNIFYFS_SUCCESS) {
+                req->result.count = req->nbytes;
             }
-        }
-
-        /* write user buffer to file */
-        int rc = unifyfs_fid_write(client, fid, req->offset, req->user_buf,
+        } else {
+            /* write user buffer to file */
+            rc = unifyfs_fid_write(client, fid, req->offset, req->user_buf,
                                    req->nbytes, &(req->result.count));
+        }
         if (rc != UNIFYFS_SUCCESS) {
             req->result.error = rc;
         }
         req->state = UNIFYFS_REQ_STATE_COMPLETED;
-
-        if (req->op == UNIFYFS_IOREQ_OP_ZERO) {
-            /* cleanup allocated OP_ZERO buffer */
-            free(req->user_buf);
-            req->user_buf = NULL;
-        }
     }
 
     return ret;
@@ -100,21 +92,41 @@ static int process_gfid_syncs(unifyfs_client* client,
     int rc;
     int data_sync_completed = 0;
     size_t i;
+
+    /* sync the extents of all requested files together */
+    int num_fids = 0;
+    int* fids = calloc(n_reqs, sizeof(int));
+    if (NULL == fids) {
+        return ENOMEM;
+    }
     for (i = 0; i < n_reqs; i++) {
         unifyfs_io_request* req = s_reqs + i;
-
         if (req->op == UNIFYFS_IOREQ_OP_SYNC_META) {
             int fid = unifyfs_fid_from_gfid(client, req->gfid);
             if (-1 == fid) {
                 req->state = UNIFYFS_REQ_STATE_COMPLETED;
                 req->result.error = EINVAL;
+            } else {
+                fids[num_fids++] = fid;
             }
+        }
+    }
+    int meta_rc = UNIFYFS_SUCCESS;
+    if (num_fids) {
+        meta_rc = unifyfs_fid_sync_extents_list(client, num_fids, fids);
+    }
+    free(fids);
 
-            rc = unifyfs_fid_sync_extents(client, fid);
-            if (rc != UNIFYFS_SUCCESS) {
-                req->result.error = rc;
+    for (i = 0; i < n_reqs; i++) {
+        unifyfs_io_request* req = s_reqs + i;
+
+        if (req->op == UNIFYFS_IOREQ_OP_SYNC_META) {
+            if (req->state != UNIFYFS_REQ_STATE_COMPLETED) {
+                if (meta_rc != UNIFYFS_SUCCESS) {
+                    req->result.error = meta_rc;
+                }
+                req->state = UNIFYFS_REQ_STATE_COMPLETED;
             }
-            req->state = UNIFYFS_REQ_STATE_COMPLETED;
         } else if (req->op == UNIFYFS_IOREQ_OP_SYNC_DATA) {
             /* logio_sync covers all files' data - only do it once */
             if (!data_sync_completed) {
@@ -134,26 +146,43 @@ static int process_gfid_syncs(unifyfs_client* client,
 
 
 /*
- * Public Methods
+ * Progress Engine
+ *
+ * unifyfs_dispatch_io() queues each array of requests as a batch, and a
+ * dedicated engine thread processes the batches in dispatch order. The
+ * thread is started by the first dispatch, so clients that never use the
+ * asynchronous API (e.g., POSIX-intercepted processes) do not get one.
+ * The request states are protected by client->io_sync, and client->io_cond
+ * is broadcast whenever a batch is queued or its requests complete.
+ *
+ * A forked child does not inherit the engine thread, so a fork handler
+ * resets the engine state of every client in the child. Requests that
+ * were outstanding at the fork are canceled in the child.
  */
 
-/* Dispatch an array of I/O requests */
-unifyfs_rc unifyfs_dispatch_io(unifyfs_handle fshdl,
-                               const size_t nreqs,
-                               unifyfs_io_request* reqs)
-{
-    if (UNIFYFS_INVALID_HANDLE == fshdl) {
-        return EINVAL;
-    }
+/* values for the internal _reqid field of dispatched requests */
+#define IOREQ_QUEUED  0  /* queued, may still be canceled */
+#define IOREQ_STARTED 1  /* claimed by progress engine */
 
-    if (0 == nreqs) {
-        return UNIFYFS_SUCCESS;
-    } else if (NULL == reqs) {
-        return EINVAL;
-    }
+struct client_io_batch {
+    unifyfs_io_request* reqs;   /* user's request array */
+    size_t nreqs;               /* size of request array */
+    client_io_batch* next;      /* next batch in queue */
+};
 
-    unifyfs_client* client = fshdl;
+/* returns true if the request has been claimed for processing */
+static inline bool ioreq_claimed(unifyfs_io_request* req)
+{
+    return (req->state == UNIFYFS_REQ_STATE_IN_PROGRESS) &&
+           (req->_reqid == IOREQ_STARTED);
+}
 
+/* Process the claimed requests in the given array. Results are stored
+ * and the requests are marked completed once all have been processed. */
+static int process_io_batch(unifyfs_client* client,
+                            unifyfs_io_request* reqs,
+                            size_t nreqs)
+{
     unifyfs_io_request* req;
 
     /* determine counts of various operations */
@@ -161,18 +190,14 @@ unifyfs_rc unifyfs_dispatch_io(unifyfs_handle fshdl,
     size_t n_write = 0;
     size_t n_trunc = 0;
     size_t n_sync = 0;
-    for (size_t i = 0; i < nreqs; i++) {
+    size_t i;
+    for (i = 0; i < nreqs; i++) {
         req = reqs + i;
-
-        /* set initial request result and state */
-        req->state = UNIFYFS_REQ_STATE_INVALID;
-        req->result.error = UNIFYFS_SUCCESS;
-        req->result.count = 0;
-        req->result.rc = 0;
+        if (!ioreq_claimed(req)) {
+            continue;
+        }
 
         switch (req->op) {
-        case UNIFYFS_IOREQ_NOP:
-            break;
         case UNIFYFS_IOREQ_OP_READ:
             n_read++;
             break;
@@ -188,56 +213,68 @@ unifyfs_rc unifyfs_dispatch_io(unifyfs_handle fshdl,
             n_trunc++;
             break;
         default:
-            LOGERR("invalid ioreq operation");
-            req->result.error = EINVAL;
-            return EINVAL;
+            break;
         }
     }
 
     /* construct per-op requests arrays */
+    int ret = UNIFYFS_SUCCESS;
     read_req_t* rd_reqs = NULL;
+    unifyfs_io_request* wr_reqs = NULL;
+    unifyfs_io_request* tr_reqs = NULL;
+    unifyfs_io_request* s_reqs = NULL;
     if (n_read) {
         rd_reqs = (read_req_t*) calloc(n_read, sizeof(read_req_t));
         if (NULL == rd_reqs) {
-            return ENOMEM;
+            ret = ENOMEM;
         }
     }
-    unifyfs_io_request* wr_reqs = NULL;
     if (n_write) {
         wr_reqs = (unifyfs_io_request*)
             calloc(n_write, sizeof(unifyfs_io_request));
         if (NULL == wr_reqs) {
-            return ENOMEM;
+            ret = ENOMEM;
         }
     }
-    unifyfs_io_request* tr_reqs = NULL;
     if (n_trunc) {
         tr_reqs = (unifyfs_io_request*)
             calloc(n_trunc, sizeof(unifyfs_io_request));
         if (NULL == tr_reqs) {
-            return ENOMEM;
+            ret = ENOMEM;
         }
     }
-    unifyfs_io_request* s_reqs = NULL;
     if (n_sync) {
         s_reqs = (unifyfs_io_request*)
             calloc(n_sync, sizeof(unifyfs_io_request));
         if (NULL == s_reqs) {
-            return ENOMEM;
+            ret = ENOMEM;
         }
     }
+    if (ret != UNIFYFS_SUCCESS) {
+        /* fail all the claimed requests */
+        pthread_mutex_lock(&(client->io_sync));
+        for (i = 0; i < nreqs; i++) {
+            req = reqs + i;
+            if (ioreq_claimed(req)) {
+                req->result.error = ret;
+                req->state = UNIFYFS_REQ_STATE_COMPLETED;
+            }
+        }
+        pthread_mutex_unlock(&(client->io_sync));
+        goto free_reqs;
+    }
 
-    size_t i;
     size_t rd_ndx = 0;
     size_t wr_ndx = 0;
     size_t tr_ndx = 0;
     size_t s_ndx = 0;
     for (i = 0; i < nreqs; i++) {
         req = reqs + i;
-        req->state = UNIFYFS_REQ_STATE_IN_PROGRESS;
+        if (!ioreq_claimed(req)) {
+            continue;
+        }
+
         switch (req->op) {
-        case UNIFYFS_IOREQ_NOP:
-            break;
         case UNIFYFS_IOREQ_OP_READ: {
             read_req_t* rd_req = rd_reqs + rd_ndx++;
             rd_req->gfid    = req->gfid;
@@ -312,17 +349,19 @@ unifyfs_rc unifyfs_dispatch_io(unifyfs_handle fshdl,
         }
     }
 
-    /* update ioreq state */
+    /* update ioreq results and state */
     rd_ndx = 0;
     wr_ndx = 0;
     tr_ndx = 0;
     s_ndx = 0;
+    pthread_mutex_lock(&(client->io_sync));
     for (i = 0; i < nreqs; i++) {
         req = reqs + i;
-        req->state = UNIFYFS_REQ_STATE_COMPLETED;
+        if (!ioreq_claimed(req)) {
+            continue;
+        }
+
         switch (req->op) {
-        case UNIFYFS_IOREQ_NOP:
-            break;
         case UNIFYFS_IOREQ_OP_READ: {
             read_req_t* rd_req = rd_reqs + rd_ndx++;
             req->result.count = rd_req->nread;
@@ -332,29 +371,336 @@ unifyfs_rc unifyfs_dispatch_io(unifyfs_handle fshdl,
         case UNIFYFS_IOREQ_OP_WRITE:
         case UNIFYFS_IOREQ_OP_ZERO: {
             unifyfs_io_request* wr_req = wr_reqs + wr_ndx++;
-            *req = *wr_req;
+            req->result = wr_req->result;
             break;
         }
         case UNIFYFS_IOREQ_OP_SYNC_DATA:
         case UNIFYFS_IOREQ_OP_SYNC_META: {
             unifyfs_io_request* s_req = s_reqs + s_ndx++;
-            *req = *s_req;
+            req->result = s_req->result;
             break;
         }
         case UNIFYFS_IOREQ_OP_TRUNC: {
             unifyfs_io_request* tr_req = tr_reqs + tr_ndx++;
-            *req = *tr_req;
+            req->result = tr_req->result;
             break;
         }
         default:
             break;
         }
+        req->state = UNIFYFS_REQ_STATE_COMPLETED;
     }
+    pthread_mutex_unlock(&(client->io_sync));
+
+free_reqs:
     if (rd_reqs) free(rd_reqs);
-    if (wr_reqs) free (wr_reqs);
-    if (tr_reqs) free (tr_reqs);
+    if (wr_reqs) free(wr_reqs);
+    if (tr_reqs) free(tr_reqs);
     if (s_reqs) free(s_reqs);
 
+    return ret;
+}
+
+/* Claim the requests of a batch that have not been canceled.
+ * Assumes caller holds client->io_sync. */
+static void claim_io_batch(unifyfs_io_request* reqs,
+                           size_t nreqs)
+{
+    for (size_t i = 0; i < nreqs; i++) {
+        unifyfs_io_request* req = reqs + i;
+        if (req->state == UNIFYFS_REQ_STATE_IN_PROGRESS) {
+            req->_reqid = IOREQ_STARTED;
+        }
+    }
+}
+
+/* Progress engine thread, processes queued batches until told to exit.
+ * Any batches still queued at exit are processed first. */
+static void* io_engine_thread(void* arg)
+{
+    unifyfs_client* client = (unifyfs_client*) arg;
+
+    pthread_mutex_lock(&(client->io_sync));
+    while (1) {
+        while ((NULL == client->io_queue_head) && !client->io_thread_exit) {
+            pthread_cond_wait(&(client->io_cond), &(client->io_sync));
+        }
+
+        client_io_batch* batch = client->io_queue_head;
+        if (NULL == batch) {
+            /* queue is empty and we were told to exit */
+            break;
+        }
+        client->io_queue_head = batch->next;
+        if (NULL == client->io_queue_head) {
+            client->io_queue_tail = NULL;
+        }
+        claim_io_batch(batch->reqs, batch->nreqs);
+        client->io_active = batch;
+        pthread_mutex_unlock(&(client->io_sync));
+
+        int rc = process_io_batch(client, batch->reqs, batch->nreqs);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("failed to process I/O request batch - rc=%d", rc);
+        }
+
+        /* wake any waiters */
+        pthread_mutex_lock(&(client->io_sync));
+        client->io_active = NULL;
+        free(batch);
+        pthread_cond_broadcast(&(client->io_cond));
+    }
+    pthread_mutex_unlock(&(client->io_sync));
+
+    return NULL;
+}
+
+/* Start the engine thread if it is not yet running.
+ * Assumes caller holds client->io_sync. */
+static int io_engine_start(unifyfs_client* client)
+{
+    if (client->io_thread_running) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    client->io_thread_exit = false;
+    int rc = pthread_create(&(client->io_thread), NULL,
+                            io_engine_thread, (void*) client);
+    if (rc != 0) {
+        LOGERR("failed to create I/O progress engine thread - %s",
+               strerror(rc));
+        return UNIFYFS_FAILURE;
+    }
+    client->io_thread_running = true;
+
+    return UNIFYFS_SUCCESS;
+}
+
+/* clients with an initialized engine, protected by io_engine_list_sync */
+static unifyfs_client* io_engine_list;
+static pthread_mutex_t io_engine_list_sync = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t io_engine_atfork_once = PTHREAD_ONCE_INIT;
+
+/* Cancel the outstanding requests of a batch in a forked child.
+ * Assumes caller holds client->io_sync. */
+static void cancel_io_batch(unifyfs_io_request* reqs,
+                            size_t nreqs)
+{
+    for (size_t i = 0; i < nreqs; i++) {
+        unifyfs_io_request* req = reqs + i;
+        if (req->state == UNIFYFS_REQ_STATE_IN_PROGRESS) {
+            req->result.error = ECANCELED;
+            req->state = UNIFYFS_REQ_STATE_CANCELED;
+        }
+    }
+}
+
+/* Take all engine locks before fork so the child sees consistent state */
+static void io_engine_atfork_prepare(void)
+{
+    pthread_mutex_lock(&io_engine_list_sync);
+    unifyfs_client* client;
+    for (client = io_engine_list; NULL != client;
+         client = client->io_engine_next) {
+        pthread_mutex_lock(&(client->io_sync));
+    }
+}
+
+static void io_engine_atfork_parent(void)
+{
+    unifyfs_client* client;
+    for (client = io_engine_list; NULL != client;
+         client = client->io_engine_next) {
+        pthread_mutex_unlock(&(client->io_sync));
+    }
+    pthread_mutex_unlock(&io_engine_list_sync);
+}
+
+/* The child has no engine threads, so drop the queued batches and cancel
+ * their requests. A later dispatch in the child starts a new engine. */
+static void io_engine_atfork_child(void)
+{
+    unifyfs_client* client;
+    for (client = io_engine_list; NULL != client;
+         client = client->io_engine_next) {
+        client_io_batch* batch = client->io_active;
+        if (NULL != batch) {
+            cancel_io_batch(batch->reqs, batch->nreqs);
+            free(batch);
+            client->io_active = NULL;
+        }
+        batch = client->io_queue_head;
+        while (NULL != batch) {
+            client_io_batch* next = batch->next;
+            cancel_io_batch(batch->reqs, batch->nreqs);
+            free(batch);
+            batch = next;
+        }
+        client->io_queue_head = NULL;
+        client->io_queue_tail = NULL;
+        client->io_thread_running = false;
+        client->io_thread_exit = false;
+
+        /* waiters on the condition did not survive the fork */
+        pthread_cond_init(&(client->io_cond), NULL);
+        pthread_mutex_unlock(&(client->io_sync));
+    }
+    pthread_mutex_unlock(&io_engine_list_sync);
+}
+
+static void io_engine_register_atfork(void)
+{
+    int rc = pthread_atfork(io_engine_atfork_prepare,
+                            io_engine_atfork_parent,
+                            io_engine_atfork_child);
+    if (rc != 0) {
+        LOGERR("failed to register I/O progress engine fork handlers - %s",
+               strerror(rc));
+    }
+}
+
+int unifyfs_io_engine_init(unifyfs_client* client)
+{
+    pthread_mutex_init(&(client->io_sync), NULL);
+    pthread_cond_init(&(client->io_cond), NULL);
+    client->io_queue_head = NULL;
+    client->io_queue_tail = NULL;
+    client->io_active = NULL;
+    client->io_thread_running = false;
+    client->io_thread_exit = false;
+
+    pthread_once(&io_engine_atfork_once, io_engine_register_atfork);
+
+    pthread_mutex_lock(&io_engine_list_sync);
+    client->io_engine_next = io_engine_list;
+    io_engine_list = client;
+    pthread_mutex_unlock(&io_engine_list_sync);
+
+    return UNIFYFS_SUCCESS;
+}
+
+int unifyfs_io_engine_fini(unifyfs_client* client)
+{
+    /* tell the engine to exit once the queue is empty */
+    pthread_mutex_lock(&(client->io_sync));
+    bool running = client->io_thread_running;
+    client->io_thread_exit = true;
+    pthread_cond_broadcast(&(client->io_cond));
+    pthread_mutex_unlock(&(client->io_sync));
+
+    if (running) {
+        int rc = pthread_join(client->io_thread, NULL);
+        if (rc != 0) {
+            LOGERR("failed to join I/O progress engine thread - %s",
+                   strerror(rc));
+        }
+        client->io_thread_running = false;
+    }
+
+    pthread_mutex_lock(&io_engine_list_sync);
+    unifyfs_client** link = &io_engine_list;
+    while (NULL != *link) {
+        if (*link == client) {
+            *link = client->io_engine_next;
+            break;
+        }
+        link = &((*link)->io_engine_next);
+    }
+    client->io_engine_next = NULL;
+    pthread_mutex_unlock(&io_engine_list_sync);
+
+    pthread_cond_destroy(&(client->io_cond));
+    pthread_mutex_destroy(&(client->io_sync));
+
+    return UNIFYFS_SUCCESS;
+}
+
+
+/*
+ * Public Methods
+ */
+
+/* Dispatch an array of I/O requests */
+unifyfs_rc unifyfs_dispatch_io(unifyfs_handle fshdl,
+                               const size_t nreqs,
+                               unifyfs_io_request* reqs)
+{
+    if (UNIFYFS_INVALID_HANDLE == fshdl) {
+        return EINVAL;
+    }
+
+    if (0 == nreqs) {
+        return UNIFYFS_SUCCESS;
+    } else if (NULL == reqs) {
+        return EINVAL;
+    }
+
+    unifyfs_client* client = fshdl;
+
+    /* check for invalid operations before queuing anything */
+    for (size_t i = 0; i < nreqs; i++) {
+        unifyfs_io_request* req = reqs + i;
+        switch (req->op) {
+        case UNIFYFS_IOREQ_NOP:
+        case UNIFYFS_IOREQ_OP_READ:
+        case UNIFYFS_IOREQ_OP_WRITE:
+        case UNIFYFS_IOREQ_OP_ZERO:
+        case UNIFYFS_IOREQ_OP_SYNC_DATA:
+        case UNIFYFS_IOREQ_OP_SYNC_META:
+        case UNIFYFS_IOREQ_OP_TRUNC:
+            break;
+        default:
+            LOGERR("invalid ioreq operation");
+            req->result.error = EINVAL;
+            return EINVAL;
+        }
+    }
+
+    client_io_batch* batch = (client_io_batch*) malloc(sizeof(*batch));
+    if (NULL == batch) {
+        return ENOMEM;
+    }
+    batch->reqs  = reqs;
+    batch->nreqs = nreqs;
+    batch->next  = NULL;
+
+    pthread_mutex_lock(&(client->io_sync));
+    if (io_engine_start(client) != UNIFYFS_SUCCESS) {
+        free(batch);
+        batch = NULL;
+    }
+
+    /* set initial request result and state */
+    for (size_t i = 0; i < nreqs; i++) {
+        unifyfs_io_request* req = reqs + i;
+        req->result.error = UNIFYFS_SUCCESS;
+        req->result.count = 0;
+        req->result.rc = 0;
+        req->_reqid = IOREQ_QUEUED;
+        if (req->op == UNIFYFS_IOREQ_NOP) {
+            req->state = UNIFYFS_REQ_STATE_COMPLETED;
+        } else {
+            req->state = UNIFYFS_REQ_STATE_IN_PROGRESS;
+        }
+    }
+
+    if (NULL == batch) {
+        /* no progress engine, process requests before returning */
+        claim_io_batch(reqs, nreqs);
+        pthread_mutex_unlock(&(client->io_sync));
+        return process_io_batch(client, reqs, nreqs);
+    }
+
+    /* queue the batch for the progress engine */
+    if (NULL == client->io_queue_tail) {
+        client->io_queue_head = batch;
+    } else {
+        client->io_queue_tail->next = batch;
+    }
+    client->io_queue_tail = batch;
+    pthread_cond_broadcast(&(client->io_cond));
+    pthread_mutex_unlock(&(client->io_sync));
+
     return UNIFYFS_SUCCESS;
 }
 
@@ -373,7 +719,23 @@ unifyfs_rc unifyfs_cancel_io(unifyfs_handle fshdl,
         return EINVAL;
     }
 
-    return UNIFYFS_ERROR_NYI;
+    unifyfs_client* client = fshdl;
+
+    /* cancel requests the progress engine has not yet claimed,
+     * requests that have been claimed will run to completion */
+    pthread_mutex_lock(&(client->io_sync));
+    for (size_t i = 0; i < nreqs; i++) {
+        unifyfs_io_request* req = reqs + i;
+        if ((req->state == UNIFYFS_REQ_STATE_IN_PROGRESS) &&
+            (req->_reqid == IOREQ_QUEUED)) {
+            req->result.error = ECANCELED;
+            req->state = UNIFYFS_REQ_STATE_CANCELED;
+        }
+    }
+    pthread_cond_broadcast(&(client->io_cond));
+    pthread_mutex_unlock(&(client->io_sync));
+
+    return UNIFYFS_SUCCESS;
 }
 
 /* Wait for an array of I/O requests to be completed/canceled */
@@ -392,7 +754,11 @@ unifyfs_rc unifyfs_wait_io(unifyfs_handle fshdl,
         return EINVAL;
     }
 
+    unifyfs_client* client = fshdl;
+
+    int ret = UNIFYFS_SUCCESS;
     size_t i, n_done;
+    pthread_mutex_lock(&(client->io_sync));
     while (1) {
         n_done = 0;
         for (i = 0; i < nreqs; i++) {
@@ -400,8 +766,16 @@ unifyfs_rc unifyfs_wait_io(unifyfs_handle fshdl,
             if ((req->state == UNIFYFS_REQ_STATE_CANCELED) ||
                 (req->state == UNIFYFS_REQ_STATE_COMPLETED)) {
                 n_done++;
+            } else if (req->state == UNIFYFS_REQ_STATE_INVALID) {
+                /* request was never dispatched, so it will never
+                 * complete */
+                ret = EINVAL;
+                break;
             }
         }
+        if (ret != UNIFYFS_SUCCESS) {
+            break;
+        }
         if (waitall) {
             /* for waitall, all reqs must be done to finish */
             if (n_done == nreqs) {
@@ -411,10 +785,9 @@ unifyfs_rc unifyfs_wait_io(unifyfs_handle fshdl,
             /* at least one req is done */
             break;
         }
-        usleep(1000); /* sleep 1 ms */
+        pthread_cond_wait(&(client->io_cond), &(client->io_sync));
     }
+    pthread_mutex_unlock(&(client->io_sync));
 
-    return UNIFYFS_SUCCESS;
+    return ret;
 }
-
-
@@ -16,6 +16,7 @@
 #include <unistd.h>
 
 #include "unifyfs_fid.h"
+#include "client_read.h"
 #include "margo_client.h"
 
 /* ---------------------------------------
@@ -100,6 +101,10 @@ static int fid_storage_free(unifyfs_client* client,
             seg_tree_rdlock(&meta->extents_sync);
             struct seg_tree_node* node = NULL;
             while ((node = seg_tree_iter(&meta->extents_sync, node))) {
+                if (node->ptr == SEG_TREE_HOLE_PTR) {
+                    /* holes have no log allocation */
+                    continue;
+                }
                 size_t nbytes = (size_t) (node->end - node->start + 1);
                 off_t log_offset = (off_t) node->ptr;
                 int rc = unifyfs_logio_free(client->state.logio_ctx,
@@ -116,7 +121,12 @@ static int fid_storage_free(unifyfs_client* client,
             /* Free our write seg_tree */
             seg_tree_destroy(&meta->extents_sync);
 
-            /* Free our extent seg_tree */
+            /* Free our extent seg_tree, after dropping its cached
+             * node-local slices so they are not evicted from it */
+            if (client->use_node_local_extents) {
+                client_drop_extent_slices(client, meta->attrs.gfid);
+            }
+            client_detach_shared_extents(client, meta);
             if (client->use_local_extents || client->use_node_local_extents) {
                 seg_tree_destroy(&meta->extents);
             }
@@ -253,8 +263,9 @@ int unifyfs_fid_create_file(unifyfs_client* client,
     meta->fid            = fid;
     meta->storage        = FILE_STORAGE_NULL;
     meta->needs_writes_sync     = 0;
-    /* first time we read a laminated file we want to sync extents */
-    meta->needs_reads_sync     = 1;
+    meta->publish_extents       = 0;
+    meta->shared_extents        = NULL;
+    meta->shared_extents_retry  = 0;
     meta->pending_unlink = 0;
 
     return fid;
@@ -641,6 +652,14 @@ int unifyfs_fid_unlink(unifyfs_client* client,
     /* invoke unlink rpc */
     int gfid = unifyfs_gfid_from_fid(client, fid);
 
+    /* make sure the server is done with any extents we synced for
+     * the file before we remove it */
+    rc = unifyfs_fid_sync_wait(client);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to sync extents before unlink of gfid=%d", gfid);
+        return rc;
+    }
+
     /* finalize the storage we're using for this file */
     rc = unifyfs_fid_delete(client, fid);
     if (rc != UNIFYFS_SUCCESS) {
@@ -957,14 +976,19 @@ int unifyfs_fid_truncate(unifyfs_client* client,
 }
 
 /*
- * Clear all entries in the write log index.  This only clears the metadata,
- * not the data itself.
+ * Clear all entries in the given slot of the write log index.  This only
+ * clears the metadata, not the data itself.
  */
-static void clear_index(unifyfs_client* client)
+static void clear_index(unifyfs_client* client,
+                        int slot)
 {
-    *(client->state.write_index.ptr_num_entries) = 0;
+    *unifyfs_write_index_count(&(client->state.write_index), slot) = 0;
 }
 
+static int fid_sync_extents(unifyfs_client* client,
+                            unifyfs_filemeta_t* meta,
+                            int wait_for_server);
+
 /* Add the metadata for a single write to the index */
 static int add_write_meta_to_index(unifyfs_client* client,
                                    unifyfs_filemeta_t* meta,
@@ -972,64 +996,86 @@ static int add_write_meta_to_index(unifyfs_client* client,
                                    off_t log_pos,
                                    size_t length)
 {
-    /* add write extent to our segment trees */
-    if (client->use_local_extents) {
-        /* record write extent in our local cache */
-        seg_tree_add(&meta->extents,
-                     file_pos,
-                     file_pos + length - 1,
-                     log_pos,
-                     client->state.client_id);
-    }
-
     /*
      * We want to make sure this write will not overflow the maximum
      * number of index entries we can sync with server. A write can at most
      * create two new nodes in the seg_tree. If we're close to potentially
-     * filling up the index, sync it out.
+     * filling up the index, sync it out. We don't wait for the server to
+     * process the synced extents, so writing can continue while the server
+     * ingests them. Errors of the asynchronous sync are reported by the
+     * next sync that waits for the server, but if the extents could not
+     * be synced, the write cannot be recorded.
      */
     unsigned long count_before = seg_tree_count(&meta->extents_sync);
     if (count_before >= (client->max_write_index_entries - 2)) {
         /* this will flush our segments, sync them, and set the running
          * segment count back to 0 */
-        unifyfs_fid_sync_extents(client, meta->fid);
+        int rc = fid_sync_extents(client, meta, 0);
+        if ((rc != UNIFYFS_SUCCESS) &&
+            (seg_tree_count(&meta->extents_sync) >=
+             (client->max_write_index_entries - 2))) {
+            LOGERR("failed to sync write index for gfid=%d",
+                   meta->attrs.gfid);
+            return rc;
+        }
+    }
+
+    /* add write extent to our segment trees */
+    if (client->use_local_extents) {
+        /* the extents are changing, so do not publish a snapshot
+         * until the next sync */
+        __atomic_store_n(&(meta->publish_extents), 0, __ATOMIC_SEQ_CST);
+
+        /* record write extent in our local cache */
+        seg_tree_add(&meta->extents,
+                     file_pos,
+                     file_pos + length - 1,
+                     log_pos,
+                     client->state.client_id);
     }
 
-    /* store the write in our segment tree used for syncing with server. */
+    /* store the write in our segment tree used for syncing with server.
+     * A write that is contiguous with the previous one, both in the file
+     * and in the log, extends the existing segment rather than adding a
+     * new one, so sequential writes produce a single extent to sync. */
+    unsigned long coalesced = seg_tree_coalesced(&meta->extents_sync);
     seg_tree_add(&meta->extents_sync,
                  file_pos,
                  file_pos + length - 1,
                  log_pos,
                  client->state.client_id);
+    client->write_extents_coalesced +=
+        seg_tree_coalesced(&meta->extents_sync) - coalesced;
 
     return UNIFYFS_SUCCESS;
 }
 
 /*
- * Remove all entries in the current index and re-write it using the write
- * metadata stored in the target file's extents_sync segment tree. This only
- * re-writes the metadata in the index. All the actual data is still kept
+ * Append the write metadata stored in the target file's extents_sync
+ * segment tree to the entries already in the given index slot. This only
+ * writes the metadata in the index. All the actual data is still kept
  * in the write log and will be referenced correctly by the new metadata.
  *
- * After this function is done, 'state.write_index' will have been totally
- * re-written. The writes in the index will be flattened, non-overlapping,
- * and sequential. The extents_sync segment tree will be cleared.
+ * Callers clear the slot before adding the first file. The writes added
+ * for each file will be flattened, non-overlapping, and sequential, and
+ * entries for different files are kept in separate contiguous runs.
+ * The extents_sync segment tree will be cleared.
  *
  * This function is called when we sync our extents with the server.
  *
  * Returns maximum write log offset for synced extents.
  */
 static off_t rewrite_index_from_seg_tree(unifyfs_client* client,
-                                         unifyfs_filemeta_t* meta)
+                                         unifyfs_filemeta_t* meta,
+                                         int slot)
 {
     /* get pointer to index buffer */
-    unifyfs_index_t* indexes = client->state.write_index.index_entries;
+    unifyfs_write_index* wr_index = &(client->state.write_index);
+    unifyfs_index_t* indexes = unifyfs_write_index_slot(wr_index, slot);
 
-    /* Erase the index before we re-write it */
-    clear_index(client);
-
-    /* count up number of entries we wrote to buffer */
-    unsigned long idx = 0;
+    /* count up number of entries in the buffer, including those
+     * already added for other files */
+    unsigned long idx = *unifyfs_write_index_count(wr_index, slot);
 
     /* record maximum write log offset */
     off_t max_log_offset = 0;
@@ -1054,11 +1100,198 @@ static off_t rewrite_index_from_seg_tree(unifyfs_client* client,
     seg_tree_clear(&meta->extents_sync);
 
     /* record total number of entries in index buffer */
-    *(client->state.write_index.ptr_num_entries) = idx;
+    *unifyfs_write_index_count(wr_index, slot) = idx;
 
     return max_log_offset;
 }
 
+/* Record the error of an asynchronous sync, so that it is reported by
+ * the next sync that waits for the server even if the caller that hit
+ * it does not wait. Caller must hold client->write_index_sync. */
+static void set_index_sync_error(unifyfs_client* client,
+                                 int rc)
+{
+    if (UNIFYFS_SUCCESS == client->write_index_error) {
+        client->write_index_error = rc;
+    }
+}
+
+/* Return and clear the recorded asynchronous sync error.
+ * Caller must hold client->write_index_sync. */
+static int take_index_sync_error(unifyfs_client* client)
+{
+    int ret = client->write_index_error;
+    client->write_index_error = UNIFYFS_SUCCESS;
+    return ret;
+}
+
+/* Wait for the outstanding sync of a write index slot (if any) to be
+ * processed by the server. Caller must hold client->write_index_sync. */
+static int wait_index_sync(unifyfs_client* client)
+{
+    int ret = UNIFYFS_SUCCESS;
+    if (NULL != client->inflight_sync) {
+        ret = wait_client_sync_rpc(client->inflight_sync);
+        client->inflight_sync = NULL;
+        if (UNIFYFS_SUCCESS != ret) {
+            LOGERR("asynchronous write index sync failed (rc=%d)", ret);
+            set_index_sync_error(client, ret);
+        }
+    }
+    return ret;
+}
+
+/*
+ * Ask the server to ingest the extents in the current write index slot,
+ * without waiting for it to process them. Syncs are issued in order, so
+ * we first wait for any previously issued sync to complete. The gfid is
+ * that of the synced file, or INVALID_GFID if the slot holds extents for
+ * several files. If the rpc fails, the slot keeps its extents, so that
+ * the next sync sends them again. Caller must hold
+ * client->write_index_sync.
+ */
+static int issue_index_sync(unifyfs_client* client,
+                            int gfid)
+{
+    int ret = UNIFYFS_SUCCESS;
+
+    /* the server must ingest the previous batch before this one */
+    int rc = wait_index_sync(client);
+    if (UNIFYFS_SUCCESS != rc) {
+        ret = rc;
+    }
+
+    /* data for the new extents that is still staged for a write-behind
+     * spill write must be in the spill file before the server reads it */
+    rc = unifyfs_logio_flush(client->state.logio_ctx);
+    if (UNIFYFS_SUCCESS != rc) {
+        LOGERR("failed to flush staged spill data (rc=%d)", rc);
+        ret = rc;
+    }
+
+    /* tell the server to grab our new extents */
+    int slot = client->write_index_slot;
+    rc = invoke_client_sync_rpc(client, gfid, slot,
+                                &(client->inflight_sync));
+    if (UNIFYFS_SUCCESS != rc) {
+        /* something went wrong when trying to flush extents */
+        LOGERR("failed to flush write index to server for gfid=%d", gfid);
+        set_index_sync_error(client, rc);
+        client->write_index_unsent = 1;
+        return rc;
+    }
+
+    /* next sync uses the other slot, while the server works on this
+     * one, and the slot starts out empty */
+    client->write_index_unsent = 0;
+    client->write_index_slot = (slot + 1) % UNIFYFS_WRITE_INDEX_SLOTS;
+    clear_index(client, client->write_index_slot);
+
+    return ret;
+}
+
+/*
+ * Copy the unsynced extents of the given files into free write index
+ * slots and ask the server to ingest them. As many files as fit in a slot
+ * are synced with a single rpc. When wait_for_server is set, we also wait
+ * for the server to process the newly synced extents before returning,
+ * and report any error of an earlier asynchronous sync.
+ */
+static int fid_sync_extents_list(unifyfs_client* client,
+                                 int num_metas,
+                                 unifyfs_filemeta_t** metas,
+                                 int wait_for_server)
+{
+    /* assume we'll succeed */
+    int ret = UNIFYFS_SUCCESS;
+    int rc;
+
+    pthread_mutex_lock(&(client->write_index_sync));
+
+    /* the current slot may still hold extents from a failed sync rpc,
+     * which are sent again with the new ones */
+    unifyfs_write_index* wr_index = &(client->state.write_index);
+    size_t* num_entries =
+        unifyfs_write_index_count(wr_index, client->write_index_slot);
+    if (!client->write_index_unsent) {
+        clear_index(client, client->write_index_slot);
+    }
+
+    int batch_gfid = INVALID_GFID;
+    int batch_files = (*num_entries > 0) ? 1 : 0;
+    for (int i = 0; i < num_metas; i++) {
+        unifyfs_filemeta_t* meta = metas[i];
+
+        /* sync with server if we need to */
+        if (!meta->needs_writes_sync) {
+            continue;
+        }
+
+        /* if this file's extents do not fit in the current slot,
+         * send what we have so far and continue in the next slot */
+        size_t file_entries = seg_tree_count(&meta->extents_sync);
+        if ((*num_entries > 0) &&
+            ((*num_entries + file_entries) > wr_index->slot_entries)) {
+            rc = issue_index_sync(client, batch_gfid);
+            if (UNIFYFS_SUCCESS != rc) {
+                ret = rc;
+            }
+            num_entries =
+                unifyfs_write_index_count(wr_index, client->write_index_slot);
+            if ((*num_entries + file_entries) > wr_index->slot_entries) {
+                /* the rpc failed and the slot is still full, keep the
+                 * remaining files marked as needing a sync */
+                break;
+            }
+            batch_files = 0;
+        }
+
+        /* write contents from segment tree to free index buffer slot */
+        rewrite_index_from_seg_tree(client, meta, client->write_index_slot);
+        if (file_entries > 0) {
+            batch_gfid = (0 == batch_files) ? meta->attrs.gfid : INVALID_GFID;
+            batch_files++;
+        }
+
+        /* the extents are in the index, and a slot whose rpc fails is
+         * sent again, so mark this file as being up-to-date */
+        meta->needs_writes_sync = 0;
+
+        /* reads of local extents can use a snapshot until the next write */
+        if (client->use_local_extents) {
+            __atomic_store_n(&(meta->publish_extents), 1, __ATOMIC_SEQ_CST);
+        }
+    }
+
+    /* if there are no index entries, we've got nothing more to sync */
+    if (*num_entries > 0) {
+        rc = issue_index_sync(client, batch_gfid);
+        if (UNIFYFS_SUCCESS != rc) {
+            ret = rc;
+        }
+    }
+
+    if (wait_for_server) {
+        wait_index_sync(client);
+        rc = take_index_sync_error(client);
+        if (UNIFYFS_SUCCESS != rc) {
+            ret = rc;
+        }
+    }
+
+    pthread_mutex_unlock(&(client->write_index_sync));
+
+    return ret;
+}
+
+/* Sync the unsynced extents of a single file, see fid_sync_extents_list() */
+static int fid_sync_extents(unifyfs_client* client,
+                            unifyfs_filemeta_t* meta,
+                            int wait_for_server)
+{
+    return fid_sync_extents_list(client, 1, &meta, wait_for_server);
+}
+
 /* Sync extent data for file to storage */
 int unifyfs_fid_sync_data(unifyfs_client* client,
                           int fid)
@@ -1101,40 +1334,62 @@ int unifyfs_fid_sync_extents(unifyfs_client* client,
         return UNIFYFS_FAILURE;
     }
 
-    /* assume we'll succeed */
-    int ret = UNIFYFS_SUCCESS;
+    /* sync with server, and wait for any outstanding syncs */
+    return fid_sync_extents(client, meta, 1);
+}
 
-    /* sync with server if we need to */
-    if (meta->needs_writes_sync) {
-        int rc;
+/* Sync extent metadata for the given files to the server, using a single
+ * sync rpc for as many of the files as fit in the write index */
+int unifyfs_fid_sync_extents_list(unifyfs_client* client,
+                                  int num_fids,
+                                  const int* fids)
+{
+    if (num_fids <= 0) {
+        return unifyfs_fid_sync_wait(client);
+    }
 
-        /* write contents from segment tree to index buffer */
-        rewrite_index_from_seg_tree(client, meta);
+    unifyfs_filemeta_t** metas = calloc(num_fids, sizeof(*metas));
+    if (NULL == metas) {
+        return ENOMEM;
+    }
 
-        /* if there are no index entries, we've got nothing to sync */
-        if (*(client->state.write_index.ptr_num_entries) == 0) {
-            /* consider that we've sync'd successfully */
-            meta->needs_writes_sync = 0;
-            return UNIFYFS_SUCCESS;
+    /* gather metadata for the files before locking the write index */
+    int num_metas = 0;
+    for (int i = 0; i < num_fids; i++) {
+        int fid = fids[i];
+        unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
+        if ((NULL == meta) || (meta->fid != fid)) {
+            LOGDBG("no filemeta for fid=%d", fid);
+            continue;
         }
-
-        /* tell the server to grab our new extents */
-        rc = invoke_client_sync_rpc(client, meta->attrs.gfid);
-        if (UNIFYFS_SUCCESS != rc) {
-            /* something went wrong when trying to flush extents */
-            LOGERR("failed to flush write index to server for gfid=%d",
-                   meta->attrs.gfid);
-            ret = rc;
+        if (meta->storage == FILE_STORAGE_LOGIO) {
+            metas[num_metas++] = meta;
         }
+    }
 
-        /* we've sync'd, so mark this file as being up-to-date */
-        meta->needs_writes_sync = 0;
+    /* sync with server, and wait for any outstanding syncs */
+    int ret = fid_sync_extents_list(client, num_metas, metas, 1);
 
-        /* flushed, clear buffer and refresh number of entries
-         * and number remaining */
-        clear_index(client);
-    }
+    free(metas);
+
+    return ret;
+}
 
+/* Wait for any outstanding asynchronous extent sync to complete */
+int unifyfs_fid_sync_wait(unifyfs_client* client)
+{
+    pthread_mutex_lock(&(client->write_index_sync));
+    int ret = UNIFYFS_SUCCESS;
+    if (client->write_index_unsent) {
+        /* send the extents of a failed sync rpc again */
+        ret = issue_index_sync(client, INVALID_GFID);
+    }
+    wait_index_sync(client);
+    int rc = take_index_sync_error(client);
+    if (UNIFYFS_SUCCESS != rc) {
+        ret = rc;
+    }
+    pthread_mutex_unlock(&(client->write_index_sync));
     return ret;
 }
 
@@ -1186,8 +1441,13 @@ static int fid_logio_write(
                fid, gfid, (size_t)pos, (size_t)log_off, count);
     }
 
-    /* update our write metadata for this write */
+    /* update our write metadata for this write, the data is not
+     * reachable if that fails */
     rc = add_write_meta_to_index(client, meta, pos, log_off, *nwritten);
+    if (rc != UNIFYFS_SUCCESS) {
+        unifyfs_logio_free(client->state.logio_ctx, log_off, count);
+        *nwritten = 0;
+    }
     return rc;
 }
 
@@ -1249,3 +1509,59 @@ int unifyfs_fid_write(
     return rc;
 }
 
+/* Zero count bytes of the file starting at offset pos. The range is
+ * recorded as a hole extent, which takes no space in the write log and
+ * is filled with zeros when read.
+ *
+ * Returns UNIFYFS_SUCCESS, or an error code */
+int unifyfs_fid_zero(
+    unifyfs_client* client,
+    int fid,      /* local file id to zero */
+    off_t pos,    /* starting position in file */
+    size_t count) /* number of bytes to zero */
+{
+    int rc;
+
+    /* short-circuit a 0-byte range */
+    if (count == 0) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* get meta for this file id */
+    unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
+    assert(meta != NULL);
+
+    if (meta->attrs.is_laminated) {
+        /* attempt to write to laminated file, return read-only filesystem */
+        return EROFS;
+    }
+
+    if (meta->storage != FILE_STORAGE_LOGIO) {
+        LOGERR("unknown storage type for fid=%d", fid);
+        return EIO;
+    }
+
+    LOGDBG("fid=%d gfid=%d - zeroing range pos=%zu count=%zu",
+           fid, meta->attrs.gfid, (size_t)pos, count);
+
+    /* record the hole, it supersedes any data previously written
+     * to the range just like a write would */
+    rc = add_write_meta_to_index(client, meta, pos, UNIFYFS_HOLE_LOG_POS,
+                                 count);
+    if (rc == UNIFYFS_SUCCESS) {
+        /* remember that we have new extents to sync with the server */
+        meta->needs_writes_sync = 1;
+
+        /* optionally sync after every write */
+        if (client->use_write_sync) {
+            int ret = unifyfs_fid_sync_extents(client, fid);
+            if (ret != UNIFYFS_SUCCESS) {
+                LOGERR("client sync after zero failed");
+                rc = ret;
+            }
+        }
+    }
+
+    return rc;
+}
+
@@ -146,6 +146,15 @@ int unifyfs_fid_write(
     size_t* nwritten /* returns number of bytes written */
 );
 
+/* Zero count bytes of file starting at offset pos, without using
+ * any space in the write log */
+int unifyfs_fid_zero(
+    unifyfs_client* client,
+    int fid,     /* local file id to zero */
+    off_t pos,   /* starting offset within file */
+    size_t count /* number of bytes to zero */
+);
+
 /* Truncate file to given length. Removes or truncates file extents
  * in metadata that are past the given length. */
 int unifyfs_fid_truncate(unifyfs_client* client,
@@ -156,10 +165,21 @@ int unifyfs_fid_truncate(unifyfs_client* client,
 int unifyfs_fid_sync_data(unifyfs_client* client,
                           int fid);
 
-/* Sync extent metadata for file to server if needed */
+/* Sync extent metadata for file to server if needed. Returns once the
+ * server has processed all extents synced by this client. */
 int unifyfs_fid_sync_extents(unifyfs_client* client,
                              int fid);
 
+/* Sync extent metadata for the given files to the server, using a single
+ * sync rpc for as many of the files as fit in the write index. Returns
+ * once the server has processed all extents synced by this client. */
+int unifyfs_fid_sync_extents_list(unifyfs_client* client,
+                                  int num_fids,
+                                  const int* fids);
+
+/* Wait for any outstanding asynchronous extent sync to complete */
+int unifyfs_fid_sync_wait(unifyfs_client* client);
+
 /* Given a file name, allocate a gfid entry on the server for the file.
  * Returns UNIFYFS_SUCCESS if successful. */
 int unifyfs_gfid_create(
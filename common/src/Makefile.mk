@@ -10,6 +10,11 @@ UNIFYFS_COMMON_BASE_SRCS = \
   %reldir%/compare_fn.c \
   %reldir%/ini.h \
   %reldir%/ini.c \
+  %reldir%/lz_block.h \
+  %reldir%/lz_block.c \
+  %reldir%/node_pool.h \
+  %reldir%/node_pool.c \
+  %reldir%/reader_epoch.h \
   %reldir%/rm_enumerator.h \
   %reldir%/rm_enumerator.c \
   %reldir%/seg_tree.h \
@@ -42,6 +47,8 @@ UNIFYFS_COMMON_BASE_SRCS = \
   %reldir%/unifyfs_rc.c \
   %reldir%/unifyfs_shm.h \
   %reldir%/unifyfs_shm.c \
+  %reldir%/unifyfs_stats.h \
+  %reldir%/unifyfs_stats.c \
   %reldir%/unifyfs-stack.h \
   %reldir%/unifyfs-stack.c
 
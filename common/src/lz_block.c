@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include "lz_block.h"
+
+#include <stdint.h>  // uint8_t, uint32_t
+#include <string.h>  // memcpy(), memset()
+
+#define LZ_MIN_MATCH     4     /* shortest encoded match */
+#define LZ_MAX_OFFSET    65535 /* farthest back-reference */
+#define LZ_LAST_LITERALS 5     /* block always ends with these literals */
+#define LZ_MATCH_LIMIT   12    /* no match may start in the last bytes */
+#define LZ_HASH_BITS     13    /* hash table has 8192 entries */
+#define LZ_SKIP_SHIFT    6     /* search faster through incompressible data */
+
+static inline uint32_t read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hash32(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+/* write a length extension, returns NULL if it does not fit */
+static inline uint8_t* put_length(uint8_t* op, uint8_t* oend, size_t len)
+{
+    while (len >= 255) {
+        if (op >= oend) {
+            return NULL;
+        }
+        *op++ = 255;
+        len -= 255;
+    }
+    if (op >= oend) {
+        return NULL;
+    }
+    *op++ = (uint8_t) len;
+    return op;
+}
+
+/* write a sequence of literals followed by a match (when match_len is
+ * non-zero), returns NULL if it does not fit */
+static uint8_t* put_sequence(uint8_t* op,
+                             uint8_t* oend,
+                             const uint8_t* lit,
+                             size_t lit_len,
+                             size_t offset,
+                             size_t match_len)
+{
+    if (op >= oend) {
+        return NULL;
+    }
+    uint8_t* token = op++;
+    *token = (uint8_t)((lit_len < 15 ? lit_len : 15) << 4);
+    if (lit_len >= 15) {
+        op = put_length(op, oend, lit_len - 15);
+        if (NULL == op) {
+            return NULL;
+        }
+    }
+    if ((size_t)(oend - op) < lit_len) {
+        return NULL;
+    }
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+
+    if (match_len) {
+        if ((oend - op) < 2) {
+            return NULL;
+        }
+        *op++ = (uint8_t)(offset & 0xff);
+        *op++ = (uint8_t)(offset >> 8);
+        size_t ml = match_len - LZ_MIN_MATCH;
+        *token |= (uint8_t)(ml < 15 ? ml : 15);
+        if (ml >= 15) {
+            op = put_length(op, oend, ml - 15);
+        }
+    }
+    return op;
+}
+
+size_t lz_block_compress(const void* src,
+                         size_t src_len,
+                         void* dst,
+                         size_t dst_cap)
+{
+    const uint8_t* base = (const uint8_t*) src;
+    const uint8_t* ip = base;
+    const uint8_t* anchor = base;
+    const uint8_t* iend = base + src_len;
+    uint8_t* op = (uint8_t*) dst;
+    uint8_t* oend = op + dst_cap;
+
+    if (src_len > LZ_MATCH_LIMIT) {
+        const uint8_t* mflimit = iend - LZ_MATCH_LIMIT;
+        const uint8_t* matchlimit = iend - LZ_LAST_LITERALS;
+        uint32_t table[1 << LZ_HASH_BITS];
+        memset(table, 0, sizeof(table));
+
+        while (ip < mflimit) {
+            uint32_t seq = read32(ip);
+            uint32_t h = hash32(seq);
+            const uint8_t* ref = base + table[h];
+            table[h] = (uint32_t)(ip - base);
+
+            if ((ref >= ip) || ((size_t)(ip - ref) > LZ_MAX_OFFSET) ||
+                (read32(ref) != seq)) {
+                ip += 1 + ((size_t)(ip - anchor) >> LZ_SKIP_SHIFT);
+                continue;
+            }
+
+            /* extend the match forward, then backward over literals */
+            const uint8_t* mp = ip + LZ_MIN_MATCH;
+            const uint8_t* rp = ref + LZ_MIN_MATCH;
+            while ((mp < matchlimit) && (*mp == *rp)) {
+                mp++;
+                rp++;
+            }
+            while ((ip > anchor) && (ref > base) && (ip[-1] == ref[-1])) {
+                ip--;
+                ref--;
+            }
+
+            op = put_sequence(op, oend, anchor, (size_t)(ip - anchor),
+                              (size_t)(ip - ref), (size_t)(mp - ip));
+            if (NULL == op) {
+                return 0;
+            }
+            ip = mp;
+            anchor = ip;
+        }
+    }
+
+    /* remaining input is stored as literals */
+    op = put_sequence(op, oend, anchor, (size_t)(iend - anchor), 0, 0);
+    if (NULL == op) {
+        return 0;
+    }
+    return (size_t)(op - (uint8_t*)dst);
+}
+
+/* read a length extension, returns -1 if input ends first */
+static inline int get_length(const uint8_t** pip,
+                             const uint8_t* iend,
+                             size_t* len)
+{
+    const uint8_t* ip = *pip;
+    uint8_t b;
+    do {
+        if (ip >= iend) {
+            return -1;
+        }
+        b = *ip++;
+        *len += b;
+    } while (b == 255);
+    *pip = ip;
+    return 0;
+}
+
+ssize_t lz_block_decompress(const void* src,
+                            size_t src_len,
+                            void* dst,
+                            size_t dst_cap)
+{
+    const uint8_t* ip = (const uint8_t*) src;
+    const uint8_t* iend = ip + src_len;
+    uint8_t* obase = (uint8_t*) dst;
+    uint8_t* op = obase;
+    uint8_t* oend = obase + dst_cap;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        /* literals */
+        size_t lit_len = token >> 4;
+        if ((lit_len == 15) && (get_length(&ip, iend, &lit_len) != 0)) {
+            return -1;
+        }
+        if ((size_t)(iend - ip) < lit_len) {
+            return -1;
+        }
+        if ((size_t)(oend - op) <= lit_len) {
+            size_t n = (size_t)(oend - op);
+            memcpy(op, ip, n);
+            return (ssize_t) dst_cap;
+        }
+        memcpy(op, ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+
+        if (ip == iend) {
+            /* last literals end the block */
+            break;
+        }
+
+        /* match */
+        if ((iend - ip) < 2) {
+            return -1;
+        }
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if ((0 == offset) || (offset > (size_t)(op - obase))) {
+            return -1;
+        }
+        size_t match_len = token & 15;
+        if ((match_len == 15) && (get_length(&ip, iend, &match_len) != 0)) {
+            return -1;
+        }
+        match_len += LZ_MIN_MATCH;
+
+        int done = 0;
+        if ((size_t)(oend - op) <= match_len) {
+            match_len = (size_t)(oend - op);
+            done = 1;
+        }
+        const uint8_t* ref = op - offset;
+        if (offset >= match_len) {
+            memcpy(op, ref, match_len);
+            op += match_len;
+        } else {
+            /* overlapping copy repeats the last offset bytes */
+            for (size_t i = 0; i < match_len; i++) {
+                *op++ = *ref++;
+            }
+        }
+        if (done) {
+            return (ssize_t) dst_cap;
+        }
+    }
+    return (ssize_t)(op - obase);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#ifndef LZ_BLOCK_H
+#define LZ_BLOCK_H
+
+#include <sys/types.h>  // size_t, ssize_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* lz_block, a small and fast LZ77 codec for independent blocks.
+ *
+ * Compressed blocks use the LZ4 block format: a sequence of literal
+ * runs, each followed by a back-reference (2-byte offset, match length)
+ * into the previous 64 KiB of output. Compression uses a single hash
+ * probe per position, trading ratio for speed. Decompression checks all
+ * bounds, so corrupt input never reads or writes outside the buffers. */
+
+/* worst-case compressed size for given input size */
+#define LZ_BLOCK_BOUND(n) ((n) + ((n) / 255) + 16)
+
+/**
+ * Compress a block.
+ *
+ * @param src     input data
+ * @param src_len input size in bytes
+ * @param dst     output buffer
+ * @param dst_cap size of output buffer
+ * @return compressed size, or 0 if it would exceed dst_cap
+ */
+size_t lz_block_compress(const void* src,
+                         size_t src_len,
+                         void* dst,
+                         size_t dst_cap);
+
+/**
+ * Decompress a block, or only its first dst_cap bytes.
+ *
+ * @param src     compressed data
+ * @param src_len compressed size in bytes
+ * @param dst     output buffer
+ * @param dst_cap number of bytes to decompress
+ * @return number of bytes decompressed (at most dst_cap),
+ *         or -1 if the compressed data is corrupt
+ */
+ssize_t lz_block_decompress(const void* src,
+                            size_t src_len,
+                            void* dst,
+                            size_t dst_cap);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LZ_BLOCK_H
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include "node_pool.h"
+
+#include <stdlib.h>  // malloc(), free()
+#include <string.h>  // memset()
+
+/* header at the start of each slab, padded so the nodes that follow
+ * are suitably aligned for any type */
+typedef union node_slab {
+    union node_slab* next;
+    long double align;
+} node_slab;
+
+/* free nodes are linked through their first word */
+typedef struct free_node {
+    struct free_node* next;
+} free_node;
+
+#define SLAB_NODE(pool, slab, i) \
+    ((char*)((node_slab*)(slab) + 1) + ((i) * (pool)->node_size))
+
+/* Add all nodes of the given slab to the free list */
+static void push_slab_nodes(node_pool* pool,
+                            node_slab* slab)
+{
+    /* push in reverse order so nodes are handed out by ascending address */
+    for (size_t i = pool->slab_nodes; i > 0; i--) {
+        free_node* fn = (free_node*) SLAB_NODE(pool, slab, i - 1);
+        fn->next = (free_node*) pool->free_nodes;
+        pool->free_nodes = fn;
+    }
+}
+
+void node_pool_init(node_pool* pool,
+                    size_t node_size,
+                    size_t slab_nodes)
+{
+    /* round node size up so each node is suitably aligned and can hold
+     * the free list link */
+    size_t align = sizeof(long double);
+    if (node_size < sizeof(free_node)) {
+        node_size = sizeof(free_node);
+    }
+    node_size = ((node_size + align - 1) / align) * align;
+
+    memset(pool, 0, sizeof(*pool));
+    pool->node_size = node_size;
+    pool->slab_nodes = (slab_nodes ? slab_nodes
+                                   : NODE_POOL_DEFAULT_SLAB_NODES);
+}
+
+void* node_pool_alloc(node_pool* pool)
+{
+    if (NULL == pool->free_nodes) {
+        /* allocate a new slab */
+        node_slab* slab = malloc(sizeof(node_slab) +
+                                 (pool->slab_nodes * pool->node_size));
+        if (NULL == slab) {
+            return NULL;
+        }
+        slab->next = (node_slab*) pool->slabs;
+        pool->slabs = slab;
+        pool->num_slabs++;
+        push_slab_nodes(pool, slab);
+    }
+
+    free_node* fn = (free_node*) pool->free_nodes;
+    pool->free_nodes = fn->next;
+    pool->used_nodes++;
+
+    memset(fn, 0, pool->node_size);
+    return fn;
+}
+
+void node_pool_free(node_pool* pool,
+                    void* node)
+{
+    if (NULL == node) {
+        return;
+    }
+
+    free_node* fn = (free_node*) node;
+    fn->next = (free_node*) pool->free_nodes;
+    pool->free_nodes = fn;
+    pool->used_nodes--;
+}
+
+void node_pool_reset(node_pool* pool)
+{
+    node_slab* keep = (node_slab*) pool->slabs;
+    if (NULL == keep) {
+        return;
+    }
+
+    /* free all but the most recent slab */
+    node_slab* slab = keep->next;
+    while (NULL != slab) {
+        node_slab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    keep->next = NULL;
+    pool->slabs = keep;
+    pool->num_slabs = 1;
+
+    /* rebuild the free list from the kept slab */
+    pool->free_nodes = NULL;
+    pool->used_nodes = 0;
+    push_slab_nodes(pool, keep);
+}
+
+void node_pool_destroy(node_pool* pool)
+{
+    node_slab* slab = (node_slab*) pool->slabs;
+    while (NULL != slab) {
+        node_slab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    pool->slabs = NULL;
+    pool->free_nodes = NULL;
+    pool->num_slabs = 0;
+    pool->used_nodes = 0;
+}
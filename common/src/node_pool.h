@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <sys/types.h>  // size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* default number of nodes carved from each slab */
+#define NODE_POOL_DEFAULT_SLAB_NODES 512
+
+/* node pool, a simple slab allocator for fixed-size tree nodes.
+ * Nodes are carved from large slabs and recycled through a free list,
+ * and all nodes may be released at once with node_pool_reset().
+ *
+ * The pool does no locking. Callers must serialize access, e.g., by
+ * holding the write lock of the tree that owns the pool. */
+typedef struct node_pool {
+    size_t node_size;    /* size of each node in bytes */
+    size_t slab_nodes;   /* number of nodes per slab */
+    void* slabs;         /* list of allocated slabs, most recent first */
+    void* free_nodes;    /* list of free nodes */
+    size_t num_slabs;    /* number of allocated slabs */
+    size_t used_nodes;   /* number of nodes currently allocated */
+} node_pool;
+
+/**
+ * Initialize a node pool. No memory is allocated until the first
+ * node is requested.
+ *
+ * @param pool pointer to node_pool structure
+ * @param node_size size of each node in bytes
+ * @param slab_nodes number of nodes per slab (0 for default)
+ */
+void node_pool_init(node_pool* pool,
+                    size_t node_size,
+                    size_t slab_nodes);
+
+/**
+ * Allocate a zero-filled node from the pool.
+ *
+ * @param pool valid node_pool pointer
+ *
+ * @return pointer to node, or NULL if a new slab could not be allocated
+ */
+void* node_pool_alloc(node_pool* pool);
+
+/**
+ * Return a node allocated by node_pool_alloc() to the pool.
+ *
+ * @param pool valid node_pool pointer
+ * @param node pointer to node
+ */
+void node_pool_free(node_pool* pool,
+                    void* node);
+
+/**
+ * Release all nodes in the pool at once. The most recent slab is kept
+ * for reuse, all other slabs are freed.
+ *
+ * @param pool valid node_pool pointer
+ */
+void node_pool_reset(node_pool* pool);
+
+/**
+ * Free all slabs of the pool. The pool may be reused afterwards.
+ *
+ * @param pool valid node_pool pointer
+ */
+void node_pool_destroy(node_pool* pool);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // NODE_POOL_H
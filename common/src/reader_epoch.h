@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#ifndef READER_EPOCH_H
+#define READER_EPOCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Reader counts for data that is read without locking and replaced by a
+ * writer, e.g., a published pointer. Readers register in the counter of
+ * the current epoch parity while they use the data. A writer that
+ * replaces the data advances the epoch, so new readers move to the other
+ * counter, and retires the old data instead of freeing it.
+ *
+ * A reader of the old data registered before the writer unpublished it,
+ * but that may have been in either parity, so retired data is freed only
+ * once each counter has been seen empty after the data was retired. The
+ * counters need not be empty at the same time. Callers track the
+ * parities seen empty in a mask per retired item:
+ *
+ *   writer: reader_epoch_advance(); unpublish; item->drained = 0;
+ *   reclaim: item->drained |= reader_epoch_drained();
+ *            free item if item->drained == READER_EPOCH_DRAINED
+ *
+ * Works in shared memory, as all accesses are atomic. */
+typedef struct reader_epoch {
+    unsigned long epoch;      /* current epoch */
+    unsigned long readers[2]; /* reader counts of each epoch parity */
+} reader_epoch;
+
+/* value of a drained mask once both counters have been seen empty */
+#define READER_EPOCH_DRAINED 3u
+
+/* Register as a reader and return the ticket to pass to
+ * reader_epoch_exit(). Load the published data after this returns. */
+static inline unsigned long reader_epoch_enter(reader_epoch* re)
+{
+    /* retry if the epoch advanced before we registered, so that a busy
+     * counter does not keep readers of a later epoch */
+    for (;;) {
+        unsigned long epoch = __atomic_load_n(&(re->epoch),
+                                              __ATOMIC_SEQ_CST);
+        unsigned long* readers = &(re->readers[epoch & 1]);
+        __atomic_add_fetch(readers, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&(re->epoch), __ATOMIC_SEQ_CST) == epoch) {
+            return epoch & 1;
+        }
+        __atomic_sub_fetch(readers, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+/* Unregister a reader, returns the number of readers left in its
+ * counter */
+static inline unsigned long reader_epoch_exit(reader_epoch* re,
+                                              unsigned long ticket)
+{
+    return __atomic_sub_fetch(&(re->readers[ticket & 1]), 1,
+                              __ATOMIC_SEQ_CST);
+}
+
+/* Advance the epoch, before unpublishing data. Writers must be
+ * serialized by the caller */
+static inline void reader_epoch_advance(reader_epoch* re)
+{
+    __atomic_add_fetch(&(re->epoch), 1, __ATOMIC_SEQ_CST);
+}
+
+/* Return the mask of epoch parities whose counters are empty now */
+static inline unsigned int reader_epoch_drained(reader_epoch* re)
+{
+    unsigned int mask = 0;
+    if (__atomic_load_n(&(re->readers[0]), __ATOMIC_SEQ_CST) == 0) {
+        mask |= 1u;
+    }
+    if (__atomic_load_n(&(re->readers[1]), __ATOMIC_SEQ_CST) == 0) {
+        mask |= 2u;
+    }
+    return mask;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // READER_EPOCH_H
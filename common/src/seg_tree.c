@@ -53,12 +53,63 @@ stn_compare_func(struct seg_tree_node* node1,
 RB_PROTOTYPE(inttree, seg_tree_node, entry, stn_compare_func)
 RB_GENERATE(inttree, seg_tree_node, entry, stn_compare_func)
 
+/* Free the withdrawn snapshots that no reader can still be using. A
+ * reader of a snapshot registered before it was withdrawn, in either
+ * epoch parity, so it is freed once both reader counters have been seen
+ * empty since. Assumes the tree is write locked */
+static void seg_tree_snapshot_reclaim(struct seg_tree* seg_tree)
+{
+    unsigned int drained = reader_epoch_drained(&seg_tree->snapshot_readers);
+    struct seg_tree_snapshot** prev = &seg_tree->retired;
+    struct seg_tree_snapshot* snap = seg_tree->retired;
+    while (NULL != snap) {
+        struct seg_tree_snapshot* next = snap->next;
+        snap->drained |= drained;
+        if (READER_EPOCH_DRAINED == snap->drained) {
+            *prev = next;
+            free(snap);
+        } else {
+            prev = &snap->next;
+        }
+        snap = next;
+    }
+}
+
+/* Replace the published snapshot with snap (may be NULL). The epoch is
+ * advanced first, so readers move to the other counter and the counter
+ * of the old snapshot's readers drains. The old snapshot is retired until
+ * its readers are done, rather than waiting for them here. Assumes the
+ * tree is write locked, which serializes all replacements */
+static void seg_tree_snapshot_replace(struct seg_tree* seg_tree,
+                                      struct seg_tree_snapshot* snap)
+{
+    reader_epoch_advance(&seg_tree->snapshot_readers);
+    struct seg_tree_snapshot* old =
+        __atomic_exchange_n(&seg_tree->snapshot, snap, __ATOMIC_SEQ_CST);
+    if (NULL != old) {
+        old->drained = 0;
+        old->next = seg_tree->retired;
+        seg_tree->retired = old;
+    }
+    seg_tree_snapshot_reclaim(seg_tree);
+}
+
+/* Withdraw the published snapshot before the tree changes.
+ * Assumes the tree is write locked */
+static inline void seg_tree_snapshot_withdraw(struct seg_tree* seg_tree)
+{
+    if (NULL != __atomic_load_n(&seg_tree->snapshot, __ATOMIC_RELAXED)) {
+        seg_tree_snapshot_replace(seg_tree, NULL);
+    }
+}
+
 /* Returns 0 on success, positive non-zero error code otherwise */
 int seg_tree_init(struct seg_tree* seg_tree)
 {
     memset(seg_tree, 0, sizeof(*seg_tree));
     ABT_rwlock_create(&(seg_tree->rwlock));
     RB_INIT(&seg_tree->head);
+    node_pool_init(&(seg_tree->pool), sizeof(struct seg_tree_node), 0);
 
     return 0;
 }
@@ -68,20 +119,30 @@ int seg_tree_init(struct seg_tree* seg_tree)
  */
 void seg_tree_destroy(struct seg_tree* seg_tree)
 {
+    /* clearing also withdraws the published snapshot, and there are no
+     * readers left to wait for */
     seg_tree_clear(seg_tree);
+    while (NULL != seg_tree->retired) {
+        struct seg_tree_snapshot* snap = seg_tree->retired;
+        seg_tree->retired = snap->next;
+        free(snap);
+    }
+    node_pool_destroy(&(seg_tree->pool));
     ABT_rwlock_free(&(seg_tree->rwlock));
 }
 
-/* Allocate a node for the range tree.  Free node with free() when finished */
+/* Allocate a node for the range tree from the tree's node pool.  Free node
+ * with seg_tree_node_free() when finished.  Assumes the tree is write locked */
 static struct seg_tree_node*
-seg_tree_node_alloc(unsigned long start,
+seg_tree_node_alloc(struct seg_tree* seg_tree,
+                    unsigned long start,
                     unsigned long end,
                     unsigned long ptr,
                     int client_id)
 {
     /* allocate a new node structure */
     struct seg_tree_node* node;
-    node = calloc(1, sizeof(*node));
+    node = node_pool_alloc(&(seg_tree->pool));
     if (!node) {
         return NULL;
     }
@@ -95,6 +156,13 @@ seg_tree_node_alloc(unsigned long start,
     return node;
 }
 
+/* Return a node to the tree's node pool.  Assumes the tree is write locked */
+static void seg_tree_node_free(struct seg_tree* seg_tree,
+                               struct seg_tree_node* node)
+{
+    node_pool_free(&(seg_tree->pool), node);
+}
+
 /*
  * Given two start/end ranges, return a new range from start1/end1 that
  * does not overlap start2/end2.  The non-overlapping range is stored
@@ -168,15 +236,36 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
     unsigned long ptr_end;
     int ret;
 
+    /* Lock the tree so we can modify it */
+    seg_tree_wrlock(seg_tree);
+    seg_tree_snapshot_withdraw(seg_tree);
+
+    /*
+     * Fast path for sequential writes: if the new range immediately follows
+     * the last segment in the tree, both in logical offset and in the log,
+     * just extend that segment in place. No other segment can overlap the
+     * extended range, since none start after the last segment.
+     */
+    node = RB_MAX(inttree, &seg_tree->head);
+    if ((node != NULL) &&
+        (node->client_id == client_id) &&
+        ((node->end + 1) == start) &&
+        (seg_tree_ptr_offset(node->ptr,
+                              node->end - node->start + 1) == ptr)) {
+        node->end = end;
+        seg_tree->max = MAX(seg_tree->max, end);
+        seg_tree->coalesced++;
+        seg_tree_unlock(seg_tree);
+        return 0;
+    }
+
     /* Create our range */
-    node = seg_tree_node_alloc(start, end, ptr, client_id);
+    node = seg_tree_node_alloc(seg_tree, start, end, ptr, client_id);
     if (!node) {
+        seg_tree_unlock(seg_tree);
         return ENOMEM;
     }
 
-    /* Lock the tree so we can modify it */
-    seg_tree_wrlock(seg_tree);
-
     /*
      * Try to insert our range into the RB tree.  If it overlaps with any other
      * range, then it is not inserted, and the overlapping range node is
@@ -200,7 +289,7 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
              * non-overlapping range.  Delete the existing range.
              */
             RB_REMOVE(inttree, &seg_tree->head, overlap);
-            free(overlap);
+            seg_tree_node_free(seg_tree, overlap);
             seg_tree->count--;
         } else {
             /*
@@ -210,10 +299,11 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
              * inserted without issue.  The remaining section will be processed
              * on the next pass of this while() loop.
              */
-            resized = seg_tree_node_alloc(new_start, new_end,
-                overlap->ptr + (new_start - overlap->start), client_id);
+            resized = seg_tree_node_alloc(seg_tree, new_start, new_end,
+                seg_tree_ptr_offset(overlap->ptr, new_start - overlap->start),
+                client_id);
             if (!resized) {
-                free(node);
+                seg_tree_node_free(seg_tree, node);
                 rc = ENOMEM;
                 goto release_add;
             }
@@ -230,14 +320,15 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
                  * There's still a remaining section after the non-overlapping
                  * part.  Add it in.
                  */
-                remaining = seg_tree_node_alloc(
+                remaining = seg_tree_node_alloc(seg_tree,
                     resized->end + 1,
                     overlap->end,
-                    overlap->ptr + (resized->end + 1 - overlap->start),
+                    seg_tree_ptr_offset(overlap->ptr,
+                                        resized->end + 1 - overlap->start),
                     client_id);
                 if (!remaining) {
-                    free(node);
-                    free(resized);
+                    seg_tree_node_free(seg_tree, node);
+                    seg_tree_node_free(seg_tree, resized);
                     rc = ENOMEM;
                     goto release_add;
                 }
@@ -245,7 +336,7 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
 
             /* Remove our old range */
             RB_REMOVE(inttree, &seg_tree->head, overlap);
-            free(overlap);
+            seg_tree_node_free(seg_tree, overlap);
             seg_tree->count--;
 
             /* Insert the non-overlapping part of the new range */
@@ -278,12 +369,14 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
 
     /* Check whether we can coalesce new extent with any preceding extent. */
     prev = RB_PREV(inttree, &seg_tree->head, target);
-    if ((prev != NULL) && ((prev->end + 1) == target->start)) {
+    if ((prev != NULL) && ((prev->end + 1) == target->start) &&
+        (prev->client_id == target->client_id)) {
         /*
          * We found a extent that ends just before the new extent starts.
          * Check whether they are also contiguous in the log.
          */
-        ptr_end = prev->ptr + (prev->end - prev->start + 1);
+        ptr_end = seg_tree_ptr_offset(prev->ptr,
+                                      prev->end - prev->start + 1);
         if (ptr_end == target->ptr) {
             /*
              * The preceding extent describes a log position adjacent to
@@ -294,8 +387,9 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
 
             /* Delete new extent from the tree and free it. */
             RB_REMOVE(inttree, &seg_tree->head, target);
-            free(target);
+            seg_tree_node_free(seg_tree, target);
             seg_tree->count--;
+            seg_tree->coalesced++;
 
             /*
              * Update target to point at previous extent since we just
@@ -307,12 +401,14 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
 
     /* Check whether we can coalesce new extent with any trailing extent. */
     next = RB_NEXT(inttree, &seg_tree->head, target);
-    if ((next != NULL) && ((target->end + 1) == next->start)) {
+    if ((next != NULL) && ((target->end + 1) == next->start) &&
+        (next->client_id == target->client_id)) {
         /*
          * We found a extent that starts just after the new extent ends.
          * Check whether they are also contiguous in the log.
          */
-        ptr_end = target->ptr + (target->end - target->start + 1);
+        ptr_end = seg_tree_ptr_offset(target->ptr,
+                                      target->end - target->start + 1);
         if (ptr_end == next->ptr) {
             /*
              * The target extent describes a log position adjacent to
@@ -323,8 +419,9 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
 
             /* Delete next extent from the tree and free it. */
             RB_REMOVE(inttree, &seg_tree->head, next);
-            free(next);
+            seg_tree_node_free(seg_tree, next);
             seg_tree->count--;
+            seg_tree->coalesced++;
         }
     }
 
@@ -351,6 +448,7 @@ int seg_tree_remove(
     LOGDBG("removing extents overlapping [%lu, %lu]", start, end);
 
     seg_tree_wrlock(seg_tree);
+    seg_tree_snapshot_withdraw(seg_tree);
     node = seg_tree_find_nolock(seg_tree, start, end);
     while (node != NULL) {
         if (start <= node->start) {
@@ -359,7 +457,7 @@ int seg_tree_remove(
                  * remove whole extent */
                 LOGDBG("removing node [%lu, %lu]", node->start, node->end);
                 RB_REMOVE(inttree, &seg_tree->head, node);
-                free(node);
+                seg_tree_node_free(seg_tree, node);
                 seg_tree->count--;
             } else {
                 /* start <= node_s <= end < node_e
@@ -367,7 +465,8 @@ int seg_tree_remove(
                 LOGDBG("updating node start from %lu to %lu",
                        node->start, (end + 1));
 
-                node->ptr += (end + 1 - node->start);
+                node->ptr = seg_tree_ptr_offset(node->ptr,
+                                                end + 1 - node->start);
                 node->start = end + 1;
             }
         } else if (node->start < start) {
@@ -383,7 +482,8 @@ int seg_tree_remove(
                  * representing before/after region */
                 unsigned long a_end = node->end;
                 unsigned long a_start = end + 1;
-                unsigned long a_ptr = node->ptr + (a_start - node->start);
+                unsigned long a_ptr = seg_tree_ptr_offset(node->ptr,
+                                                  a_start - node->start);
 
                 /* truncate existing (before) node */
                 LOGDBG("updating before node end from %lu to %lu",
@@ -425,18 +525,18 @@ struct seg_tree_node* seg_tree_find_nolock(
     unsigned long start,
     unsigned long end)
 {
-    /* Create a range of just our starting byte offset */
-    struct seg_tree_node* node = seg_tree_node_alloc(start, start, 0, 0);
-    if (!node) {
-        return NULL;
-    }
+    /* Create a range of just our starting byte offset.  This only serves
+     * as a search key, so it lives on the stack rather than in the node
+     * pool, which must not be used while holding just a read lock. */
+    struct seg_tree_node key;
+    memset(&key, 0, sizeof(key));
+    key.start = start;
+    key.end = start;
 
     /* Search tree for either a range that overlaps with
      * the target range (starting byte), or otherwise the
      * node for the next biggest starting byte. */
-    struct seg_tree_node* next = RB_NFIND(inttree, &seg_tree->head, node);
-
-    free(node);
+    struct seg_tree_node* next = RB_NFIND(inttree, &seg_tree->head, &key);
 
     /* We may have found a node that doesn't include our starting
      * byte offset, but it would be the range with the lowest
@@ -565,29 +665,14 @@ seg_tree_unlock(struct seg_tree* seg_tree)
  */
 void seg_tree_clear(struct seg_tree* seg_tree)
 {
-    struct seg_tree_node* node = NULL;
-    struct seg_tree_node* oldnode = NULL;
-
     seg_tree_wrlock(seg_tree);
+    seg_tree_snapshot_withdraw(seg_tree);
 
-    if (RB_EMPTY(&seg_tree->head)) {
-        /* seg_tree is empty, nothing to do */
-        seg_tree_unlock(seg_tree);
-        return;
-    }
-
-    /* Remove and free each node in the tree */
-    while ((node = seg_tree_iter(seg_tree, node))) {
-        if (oldnode) {
-            RB_REMOVE(inttree, &seg_tree->head, oldnode);
-            free(oldnode);
-        }
-        oldnode = node;
-    }
-    if (oldnode) {
-        RB_REMOVE(inttree, &seg_tree->head, oldnode);
-        free(oldnode);
-    }
+    /* All nodes come from the tree's node pool, so there is no need to
+     * remove them one at a time. Just reset the tree and release all
+     * the nodes back to the pool at once. */
+    RB_INIT(&seg_tree->head);
+    node_pool_reset(&(seg_tree->pool));
 
     seg_tree->count = 0;
     seg_tree->max = 0;
@@ -612,3 +697,97 @@ unsigned long seg_tree_max(struct seg_tree* seg_tree)
     seg_tree_unlock(seg_tree);
     return max;
 }
+
+/* Return the number of added ranges that were coalesced with existing
+ * segments */
+unsigned long seg_tree_coalesced(struct seg_tree* seg_tree)
+{
+    seg_tree_rdlock(seg_tree);
+    unsigned long coalesced = seg_tree->coalesced;
+    seg_tree_unlock(seg_tree);
+    return coalesced;
+}
+
+/*
+ * Publish a snapshot of the current segments, which readers can use
+ * without locking until the tree next changes.
+ *
+ * Returns 0 on success, ENOMEM if the snapshot could not be allocated.
+ */
+int seg_tree_snapshot_publish(struct seg_tree* seg_tree)
+{
+    /* the write lock keeps the tree from changing while we copy it, and
+     * serializes this with other replacements of the snapshot */
+    seg_tree_wrlock(seg_tree);
+
+    unsigned long count = seg_tree->count;
+    struct seg_tree_snapshot* snap = malloc(sizeof(*snap) +
+        (count * sizeof(struct seg_tree_extent)));
+    if (NULL == snap) {
+        seg_tree_unlock(seg_tree);
+        return ENOMEM;
+    }
+
+    unsigned long i = 0;
+    struct seg_tree_node* node;
+    RB_FOREACH(node, inttree, &seg_tree->head) {
+        struct seg_tree_extent* seg = snap->segs + i;
+        seg->start = node->start;
+        seg->end = node->end;
+        seg->ptr = node->ptr;
+        seg->client_id = node->client_id;
+        i++;
+    }
+    snap->count = i;
+
+    seg_tree_snapshot_replace(seg_tree, snap);
+
+    seg_tree_unlock(seg_tree);
+    return 0;
+}
+
+/*
+ * Return the published snapshot of the tree without locking, or NULL if
+ * there is none. A returned snapshot stays valid until it is released
+ * with seg_tree_snapshot_put(), passing the ticket set here.
+ */
+const struct seg_tree_snapshot* seg_tree_snapshot_get(
+    struct seg_tree* seg_tree,
+    unsigned long* ticket)
+{
+    unsigned long t = reader_epoch_enter(&seg_tree->snapshot_readers);
+    struct seg_tree_snapshot* snap =
+        __atomic_load_n(&seg_tree->snapshot, __ATOMIC_SEQ_CST);
+    if (NULL == snap) {
+        reader_epoch_exit(&seg_tree->snapshot_readers, t);
+        return NULL;
+    }
+    *ticket = t;
+    return snap;
+}
+
+/* Release a snapshot returned by seg_tree_snapshot_get() */
+void seg_tree_snapshot_put(struct seg_tree* seg_tree, unsigned long ticket)
+{
+    reader_epoch_exit(&seg_tree->snapshot_readers, ticket);
+}
+
+/*
+ * Return the index of the first segment in the snapshot that ends at or
+ * after offset, or snap->count if there is none.
+ */
+unsigned long seg_tree_snapshot_find(const struct seg_tree_snapshot* snap,
+                                     unsigned long offset)
+{
+    unsigned long lo = 0;
+    unsigned long hi = snap->count;
+    while (lo < hi) {
+        unsigned long mid = lo + ((hi - lo) / 2);
+        if (snap->segs[mid].end < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
@@ -16,6 +16,8 @@
 #define __SEG_TREE_H__
 
 #include <abt.h>
+#include "node_pool.h"
+#include "reader_epoch.h"
 #include "tree.h"
 
 struct seg_tree_node {
@@ -26,11 +28,58 @@ struct seg_tree_node {
     int client_id; /* client id of the owner of the log */
 };
 
+/* Log pointer of a hole segment, which has no data in the log and reads
+ * as zeros (matches UNIFYFS_HOLE_LOG_POS) */
+#define SEG_TREE_HOLE_PTR (~0UL)
+
+/* Return the log pointer that is 'delta' bytes past 'ptr'. Every byte of
+ * a hole segment maps to SEG_TREE_HOLE_PTR, so adjacent holes coalesce and
+ * splitting a hole yields holes. */
+static inline unsigned long seg_tree_ptr_offset(unsigned long ptr,
+                                                unsigned long delta)
+{
+    if (ptr == SEG_TREE_HOLE_PTR) {
+        return ptr;
+    }
+    return ptr + delta;
+}
+
+/* a segment in a seg_tree snapshot */
+struct seg_tree_extent {
+    unsigned long start; /* starting logical offset of range */
+    unsigned long end;   /* ending logical offset of range */
+    unsigned long ptr;   /* physical offset of data in log */
+    int client_id;       /* client id of the owner of the log */
+};
+
+/* Immutable copy of the segments of a tree, sorted by offset. Readers
+ * use a published snapshot without locking the tree, see
+ * seg_tree_snapshot_get() */
+struct seg_tree_snapshot {
+    struct seg_tree_snapshot* next; /* next withdrawn snapshot to free */
+    unsigned long drained;          /* reader counters seen empty since
+                                     * it was withdrawn */
+    unsigned long count;            /* number of segments */
+    struct seg_tree_extent segs[];  /* segments sorted by start offset */
+};
+
 struct seg_tree {
     RB_HEAD(inttree, seg_tree_node) head;
     ABT_rwlock rwlock;
     unsigned long count;     /* number of segments stored in tree */
     unsigned long max;       /* maximum logical offset value in the tree */
+    unsigned long coalesced; /* number of added ranges that were merged with
+                              * an existing segment (not reset on clear) */
+
+    node_pool pool;          /* allocator for tree nodes */
+
+    /* published snapshot (or NULL), withdrawn when the tree changes.
+     * Readers register in snapshot_readers, so that a withdrawn snapshot
+     * can be freed once the readers that may still use it are done.
+     * Withdrawn snapshots wait in the retired list until then */
+    struct seg_tree_snapshot* snapshot;
+    struct seg_tree_snapshot* retired;
+    reader_epoch snapshot_readers;
 };
 
 /* Returns 0 on success, positive non-zero error code otherwise */
@@ -113,6 +162,40 @@ unsigned long seg_tree_count(struct seg_tree* seg_tree);
 /* Return the maximum ending logical offset in the tree */
 unsigned long seg_tree_max(struct seg_tree* seg_tree);
 
+/* Return the number of added ranges that were coalesced with existing
+ * segments, i.e., the number of segments saved by coalescing */
+unsigned long seg_tree_coalesced(struct seg_tree* seg_tree);
+
+/*
+ * Publish a snapshot of the current segments, which readers can use
+ * without locking until the tree next changes. Any change to the tree
+ * withdraws the snapshot, so publish after a batch of changes (e.g., when
+ * extents are synced or the file is laminated).
+ *
+ * Returns 0 on success, ENOMEM if the snapshot could not be allocated.
+ */
+int seg_tree_snapshot_publish(struct seg_tree* seg_tree);
+
+/*
+ * Return the published snapshot of the tree without locking, or NULL if
+ * there is none. A returned snapshot stays valid until it is released
+ * with seg_tree_snapshot_put(), passing the ticket set here.
+ */
+const struct seg_tree_snapshot* seg_tree_snapshot_get(
+    struct seg_tree* seg_tree,
+    unsigned long* ticket
+);
+
+/* Release a snapshot returned by seg_tree_snapshot_get() */
+void seg_tree_snapshot_put(struct seg_tree* seg_tree, unsigned long ticket);
+
+/*
+ * Return the index of the first segment in the snapshot that ends at or
+ * after offset, or snap->count if there is none.
+ */
+unsigned long seg_tree_snapshot_find(const struct seg_tree_snapshot* snap,
+                                     unsigned long offset);
+
 /*
  * Locking functions for use with seg_tree_iter().  They allow you to lock the
  * tree to iterate over it:
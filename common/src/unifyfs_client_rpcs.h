@@ -38,10 +38,12 @@ typedef enum {
     UNIFYFS_CLIENT_RPC_FILESIZE,
     UNIFYFS_CLIENT_RPC_GET_GFIDS,
     UNIFYFS_CLIENT_RPC_LAMINATE,
+    UNIFYFS_CLIENT_RPC_LIST_FILES,
     UNIFYFS_CLIENT_RPC_METAGET,
     UNIFYFS_CLIENT_RPC_METASET,
     UNIFYFS_CLIENT_RPC_MOUNT,
     UNIFYFS_CLIENT_RPC_READ,
+    UNIFYFS_CLIENT_RPC_READDIR,
     UNIFYFS_CLIENT_RPC_SYNC,
     UNIFYFS_CLIENT_RPC_TRANSFER,
     UNIFYFS_CLIENT_RPC_TRUNCATE,
@@ -131,12 +133,13 @@ DECLARE_MARGO_RPC_HANDLER(unifyfs_metaget_rpc)
 /* unifyfs_fsync_rpc (client => server)
  *
  * given a client identified by (app_id, client_id) as input, read the write
- * extents for one or more of the client's files from the shared memory index
- * and update the global metadata for the file(s) */
+ * extents for one or more of the client's files from the given slot of the
+ * shared memory index and update the global metadata for the file(s) */
 MERCURY_GEN_PROC(unifyfs_fsync_in_t,
                  ((int32_t)(app_id))
                  ((int32_t)(client_id))
-                 ((int32_t)(gfid)))
+                 ((int32_t)(gfid))
+                 ((int32_t)(index_slot)))
 MERCURY_GEN_PROC(unifyfs_fsync_out_t, ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(unifyfs_fsync_rpc)
 
@@ -333,6 +336,65 @@ MERCURY_GEN_PROC(unifyfs_get_gfids_out_t,
                 )
 DECLARE_MARGO_RPC_HANDLER(unifyfs_get_gfids_rpc)
 
+/* unifyfs_list_files_rpc (client => server)
+ *
+ * returns a page of file records (see unifyfs_file_rec_t) for files
+ * matching the filter in the client's bulk buffer, starting at the
+ * cursor (owner server rank and gfid). Files are listed by owner rank,
+ * then by gfid. The returned cursor resumes the listing, a next_rank
+ * of -1 means there are no more files */
+MERCURY_GEN_PROC(unifyfs_list_files_in_t,
+                 ((int32_t)(app_id))
+                 ((int32_t)(client_id))
+                 ((int32_t)(cursor_rank))
+                 ((int32_t)(cursor_gfid))
+                 ((int32_t)(max_files))
+                 ((int32_t)(owner_rank))
+                 ((int32_t)(laminated))
+                 ((hg_const_string_t)(prefix))
+                 ((hg_size_t)(bulk_size))
+                 ((hg_bulk_t)(bulk_page)))
+MERCURY_GEN_PROC(unifyfs_list_files_out_t,
+                 ((int32_t)(ret))
+                 ((int32_t)(num_files))
+                 ((hg_size_t)(page_used))
+                 ((int32_t)(next_rank))
+                 ((int32_t)(next_gfid)))
+DECLARE_MARGO_RPC_HANDLER(unifyfs_list_files_rpc)
+
+/* unifyfs_readdir_rpc (client => server)
+ *
+ * given a directory gfid, returns up to max_entries directory entries
+ * with their attributes in the client's bulk buffer, starting at the
+ * entry with gfid start_gfid in gfid order */
+MERCURY_GEN_PROC(unifyfs_readdir_in_t,
+                 ((int32_t)(app_id))
+                 ((int32_t)(client_id))
+                 ((int32_t)(gfid))
+                 ((int32_t)(start_gfid))
+                 ((int32_t)(max_entries))
+                 ((hg_bulk_t)(bulk_entries)))
+MERCURY_GEN_PROC(unifyfs_readdir_out_t,
+                 ((int32_t)(ret))
+                 ((int32_t)(num_entries))
+                 ((int32_t)(end_of_dir)))
+DECLARE_MARGO_RPC_HANDLER(unifyfs_readdir_rpc)
+
+/* unifyfs_stats_rpc (client => server)
+ *
+ * returns a text report of the server's performance counters in the
+ * client's bulk buffer. If the buffer is too small, the report is
+ * truncated and report_size gives the size needed */
+MERCURY_GEN_PROC(unifyfs_stats_in_t,
+                 ((int32_t)(app_id))
+                 ((int32_t)(client_id))
+                 ((hg_size_t)(bulk_size))
+                 ((hg_bulk_t)(bulk_report)))
+MERCURY_GEN_PROC(unifyfs_stats_out_t,
+                 ((int32_t)(ret))
+                 ((hg_size_t)(report_size)))
+DECLARE_MARGO_RPC_HANDLER(unifyfs_stats_rpc)
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
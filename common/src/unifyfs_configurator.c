@@ -1072,3 +1072,47 @@ int configurator_directory_check(const char* s,
         }
     }
 }
+
+int configurator_positive_int_check(const char* s,
+                                    const char* k,
+                                    const char* val,
+                                    char** o)
+{
+    long l;
+
+    if (val == NULL) {
+        // unset is OK
+        return 0;
+    }
+
+    int rc = configurator_int_check(s, k, val, o);
+    if (rc == 0) {
+        rc = configurator_int_val(val, &l);
+        if ((rc == 0) && (l <= 0)) {
+            rc = EINVAL;
+        }
+    }
+    return rc;
+}
+
+int configurator_size_check(const char* s,
+                            const char* k,
+                            const char* val,
+                            char** o)
+{
+    long l;
+
+    if (val == NULL) {
+        // unset is OK
+        return 0;
+    }
+
+    int rc = configurator_int_check(s, k, val, o);
+    if (rc == 0) {
+        rc = configurator_int_val(val, &l);
+        if ((rc == 0) && (l < UNIFYFS_MIN_TX_SIZE)) {
+            rc = EINVAL;
+        }
+    }
+    return rc;
+}
@@ -74,6 +74,10 @@
     UNIFYFS_CFG(client, local_extents, BOOL, off, "use client-cached extents to service local reads without consulting local server", NULL) \
     UNIFYFS_CFG(client, node_local_extents, BOOL, off, \
         "use node-local extents to service node-local reads", NULL) \
+    UNIFYFS_CFG(client, node_local_extents_cache, INT, UNIFYFS_CLIENT_EXTENT_CACHE_SLICES, \
+        "max number of file slices with cached node-local extents", NULL) \
+    UNIFYFS_CFG(client, node_local_extents_slice, INT, UNIFYFS_CLIENT_EXTENT_SLICE_SIZE, \
+        "size of file slices whose node-local extents are fetched together", NULL) \
     UNIFYFS_CFG(client, max_files, INT, UNIFYFS_CLIENT_MAX_FILES, "client max file count", NULL) \
     UNIFYFS_CFG(client, super_magic, BOOL, on, "return UnifyFS super magic from statfs, TMPFS otherwise", NULL) \
     UNIFYFS_CFG(client, unlink_usecs, INT, 0, "number of microsecs to sleep after initiating unlink rpc", NULL) \
@@ -83,22 +87,40 @@
     UNIFYFS_CFG_CLI(log, file, STRING, unifyfsd.log, "log file name", NULL, 'l', "specify log file name") \
     UNIFYFS_CFG_CLI(log, dir, STRING, LOGDIR, "log file directory", configurator_directory_check, 'L', "specify full path to directory to contain log file") \
     UNIFYFS_CFG(log, on_error, BOOL, off, "turn on verbose logging when an error is encountered", NULL) \
+    UNIFYFS_CFG(log, async, BOOL, off, "queue log messages for a background writer thread", NULL) \
+    UNIFYFS_CFG(log, async_drop, BOOL, off, "drop low-priority log messages rather than wait when a log queue is full (requires log.async)", NULL) \
+    UNIFYFS_CFG(log, binary, BOOL, off, "write server log in binary format (requires log.async)", NULL) \
     UNIFYFS_CFG(logio, chunk_size, INT, UNIFYFS_LOGIO_CHUNK_SIZE, "log-based I/O data chunk size", NULL) \
     UNIFYFS_CFG(logio, shmem_size, INT, UNIFYFS_LOGIO_SHMEM_SIZE, "log-based I/O shared memory region size", NULL) \
+    UNIFYFS_CFG(logio, shmem_hugepages, BOOL, off, "back log-based I/O shared memory with transparent huge pages", NULL) \
+    UNIFYFS_CFG(logio, shmem_numa_local, BOOL, off, "place log-based I/O shared memory on the NUMA node of the client CPU", NULL) \
     UNIFYFS_CFG(logio, spill_size, INT, UNIFYFS_LOGIO_SPILL_SIZE, "log-based I/O spillover file size", NULL) \
     UNIFYFS_CFG(logio, spill_dir, STRING, NULLSTRING, "spillover directory", configurator_directory_check) \
+    UNIFYFS_CFG(logio, spill_direct, BOOL, off, "use O_DIRECT with write-behind staging for spillover writes", NULL) \
+    UNIFYFS_CFG(logio, spill_compress, BOOL, off, "compress spillover data chunks", NULL) \
+    UNIFYFS_CFG(logio, spill_stage_size, INT, UNIFYFS_LOGIO_SPILL_STAGE_SIZE, "size of each O_DIRECT spillover staging buffer", NULL) \
+    UNIFYFS_CFG(logio, tier_interval, INT, 0, "seconds between server migrations of cold shmem chunks to spillover (0 disables)", NULL) \
+    UNIFYFS_CFG(logio, tier_cold_secs, INT, UNIFYFS_LOGIO_TIER_COLD_SECS, "seconds without access before a shmem chunk may be migrated", NULL) \
+    UNIFYFS_CFG(logio, tier_batch, INT, UNIFYFS_LOGIO_TIER_BATCH, "maximum chunks migrated per client log in each tiering pass", NULL) \
+    UNIFYFS_CFG(margo, bulk_tx_size, INT, UNIFYFS_SERVER_MAX_BULK_TX_SIZE, "maximum size (B) of each bulk data transfer", configurator_size_check) \
     UNIFYFS_CFG(margo, client_pool_size, INT, UNIFYFS_MARGO_POOL_SZ, "size of server's ULT pool for client-server RPCs", NULL) \
     UNIFYFS_CFG(margo, client_timeout, INT, UNIFYFS_MARGO_CLIENT_SERVER_TIMEOUT_MSEC, "timeout in milliseconds for client-server RPCs", NULL) \
     UNIFYFS_CFG(margo, lazy_connect, BOOL, on, "wait until first communication with server to resolve its connection address", NULL) \
     UNIFYFS_CFG(margo, server_pool_size, INT, UNIFYFS_MARGO_POOL_SZ, "size of server's ULT pool for server-server RPCs", NULL) \
     UNIFYFS_CFG(margo, server_timeout, INT, UNIFYFS_MARGO_SERVER_SERVER_TIMEOUT_MSEC, "timeout in milliseconds for server-server RPCs", NULL) \
     UNIFYFS_CFG(margo, tcp, BOOL, on, "use TCP for server-to-server margo RPCs", NULL) \
+    UNIFYFS_CFG(margo, tune_tx_size, BOOL, off, "measure bulk transfer throughput at server start to choose bulk and data transfer sizes", NULL) \
     UNIFYFS_CFG(meta, range_size, INT, UNIFYFS_META_DEFAULT_SLICE_SZ, "metadata range size", NULL) \
     UNIFYFS_CFG_CLI(runstate, dir, STRING, RUNDIR, "runstate file directory", configurator_directory_check, 'R', "specify full path to directory to contain server-local state") \
     UNIFYFS_CFG_CLI(server, hostfile, STRING, NULLSTRING, "server hostfile name", NULL, 'H', "specify full path to server hostfile") \
     UNIFYFS_CFG_CLI(server, init_timeout, INT, UNIFYFS_DEFAULT_INIT_TIMEOUT, "timeout of waiting for server initialization", NULL, 't', "timeout in seconds to wait for servers to be ready for clients") \
+    UNIFYFS_CFG(server, data_tx_size, INT, UNIFYFS_SERVER_MAX_DATA_TX_SIZE, "maximum size (B) of read data sent to a client in each rpc", configurator_size_check) \
     UNIFYFS_CFG(server, local_extents, BOOL, off, "use server-cached extents to service local reads without consulting file owner", NULL) \
     UNIFYFS_CFG(server, max_app_clients, INT, UNIFYFS_SERVER_MAX_APP_CLIENTS, "maximum number of clients per application", NULL) \
+    UNIFYFS_CFG(server, max_reads, INT, UNIFYFS_SERVER_MAX_READS, "maximum number of active read requests per client", configurator_positive_int_check) \
+    UNIFYFS_CFG(server, read_coalesce_usec, INT, 0, "microseconds to wait to gather concurrent chunk reads for coalescing (0 disables)", NULL) \
+    UNIFYFS_CFG(server, shared_extents, BOOL, off, "publish node-local extents of laminated files in shared memory for local clients", NULL) \
+    UNIFYFS_CFG(server, transfer_buffer, INT, UNIFYFS_TRANSFER_MAX_BUFFER, "maximum size (B) of memory buffer for file transfer data", configurator_size_check) \
     UNIFYFS_CFG_CLI(sharedfs, dir, STRING, NULLSTRING, "shared file system directory", configurator_directory_check, 'S', "specify full path to directory to contain server shared files") \
 
 #ifdef __cplusplus
@@ -211,6 +233,18 @@ int configurator_int_check(const char* section,
                            const char* val,
                            char** oval);
 
+/* checks for an integer greater than zero */
+int configurator_positive_int_check(const char* section,
+                                    const char* key,
+                                    const char* val,
+                                    char** oval);
+
+/* checks for a size (B) of at least UNIFYFS_MIN_TX_SIZE */
+int configurator_size_check(const char* section,
+                            const char* key,
+                            const char* val,
+                            char** oval);
+
 int configurator_file_check(const char* section,
                             const char* key,
                             const char* val,
@@ -45,6 +45,9 @@
 // General
 #define UNIFYFS_MAX_FILENAME KIB
 #define UNIFYFS_MAX_HOSTNAME 64
+#define UNIFYFS_DIRENT_NAME_MAX 256 /* max directory entry name (with NUL) */
+#define UNIFYFS_READDIR_MAX_ENTRIES 4096 /* max entries per readdir rpc */
+#define UNIFYFS_LIST_FILES_MAX_BYTES MIB /* max page size of file listing */
 
 // Client
 #define UNIFYFS_CLIENT_MAX_FILES 128
@@ -53,11 +56,28 @@
 #define UNIFYFS_CLIENT_MAX_READ_COUNT 1000     /* max # active read requests */
 #define UNIFYFS_CLIENT_READ_TIMEOUT_SECONDS 60
 #define UNIFYFS_CLIENT_MAX_ACTIVE_REQUESTS 256 /* max concurrent client reqs */
+#define UNIFYFS_CLIENT_EXTENT_SLICE_SIZE (64 * MIB) /* node-local extent
+                                                      * prefetch unit */
+#define UNIFYFS_CLIENT_EXTENT_CACHE_SLICES 256 /* max cached extent slices */
+#define UNIFYFS_CLIENT_SHARED_EXTENTS_RETRY_SECONDS 1 /* wait to retry
+                                                        * shared extents */
 
 // Log-based I/O Default Values
+#define UNIFYFS_LOG_RING_SIZE (256 * KIB) /* per-thread async log buffer */
+#define UNIFYFS_LOG_MSG_MAX 4096 /* max log message length */
+#define UNIFYFS_LOG_WRITER_MSEC 50 /* async log writer polling interval */
+
 #define UNIFYFS_LOGIO_CHUNK_SIZE (4 * MIB)
 #define UNIFYFS_LOGIO_SHMEM_SIZE (256 * MIB)
 #define UNIFYFS_LOGIO_SPILL_SIZE (4 * GIB)
+#define UNIFYFS_LOGIO_SPILL_STAGE_SIZE (4 * MIB)
+#define UNIFYFS_LOGIO_DIRECT_ALIGN 4096 /* O_DIRECT offset/size alignment */
+#define UNIFYFS_LOGIO_TIER_COLD_SECS 10
+#define UNIFYFS_LOGIO_TIER_BATCH 8
+#define UNIFYFS_LOGIO_TIER_HIGH_WATER 75 /* percent of shmem in use */
+#define UNIFYFS_LOGIO_COMPRESS_RATIO 4 /* max spill chunks per chunk of space */
+#define UNIFYFS_LOGIO_COMPRESS_BLOCK 4096 /* spill space allocation unit */
+#define UNIFYFS_SHMEM_MAX_NUMA_NODES 1024 /* NUMA node mask size for mbind() */
 
 // Margo Default Values
 #define UNIFYFS_MARGO_POOL_SZ 4
@@ -73,6 +93,14 @@
 #define UNIFYFS_SERVER_MAX_NUM_APPS 64   /* max # apps/mountpoints supported */
 #define UNIFYFS_SERVER_MAX_APP_CLIENTS 256  /* max # clients per application */
 #define UNIFYFS_SERVER_MAX_READS 2048   /* max # server read reqs per reqmgr */
+#define UNIFYFS_SERVER_READ_COALESCE_MAX (16 * MIB) /* max merged log read */
+#define UNIFYFS_TRANSFER_MAX_BUFFER (512 * MIB) /* max transfer copy buffer */
+
+// Transfer Size Tuning
+#define UNIFYFS_MIN_TX_SIZE (4 * KIB)          /* min configured transfer size */
+#define UNIFYFS_TX_TUNE_MIN_SIZE (256 * KIB)   /* smallest size probed */
+#define UNIFYFS_TX_TUNE_MAX_SIZE (32 * MIB)    /* largest size probed */
+#define UNIFYFS_TX_TUNE_BYTES (64 * MIB)       /* bytes moved per size probed */
 
 // Utilities
 #define UNIFYFS_DEFAULT_INIT_TIMEOUT 120    /* server init timeout (seconds) */
@@ -31,9 +31,14 @@
 #include "unifyfs_log.h"
 
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/syscall.h>
+#include <sys/time.h>
 #include <sys/types.h>
 
 /* one of the loglevel values */
@@ -50,6 +55,10 @@ time_t unifyfs_log_time;
 struct tm* unifyfs_log_ltime;
 char unifyfs_log_timestamp[256];
 
+/* set while messages are queued for the asynchronous log writer */
+volatile int unifyfs_log_async; // = 0
+int unifyfs_log_async_drop; // = 0
+
 /* used to reduce source file pathname length */
 int unifyfs_log_source_base_len; // = 0
 static const char* this_file = __FILE__;
@@ -116,6 +125,9 @@ void unifyfs_log_print(time_t now,
  * returns UNIFYFS_SUCCESS on success */
 int unifyfs_log_close(void)
 {
+    /* write any queued messages before closing the stream */
+    unifyfs_log_async_stop();
+
     /* if stream is open, and its not stderr, close it */
     if (NULL != unifyfs_log_stream) {
         if (unifyfs_log_stream != stderr) {
@@ -154,3 +166,655 @@ pid_t unifyfs_gettid(void)
 #endif
     return 0;
 }
+
+/* ---------------------------------------------------------------------
+ * Asynchronous logging
+ *
+ * Each thread formats its messages directly into its own ring buffer.
+ * The ring has a single producer (the owning thread) and a single
+ * consumer (the writer thread), so head and tail are only updated with
+ * atomic stores and need no lock. The writer thread periodically drains
+ * all rings and writes the messages to the log stream, in the usual
+ * text format or as compact binary records.
+ * --------------------------------------------------------------------- */
+
+/* header of a message in a ring, followed by the NUL-terminated
+ * message text. An entry with a NULL site pads to the end of the ring */
+typedef struct {
+    uint32_t len;      /* total entry length, multiple of 8 */
+    int32_t level;
+    int32_t tid;
+    uint32_t unused;
+    uint64_t time_ns;
+    unifyfs_log_site* site;
+} log_entry;
+
+#define LOG_ENTRY_ALIGN(x) (((x) + 7) & ~((size_t)7))
+#define LOG_ENTRY_MAX LOG_ENTRY_ALIGN(sizeof(log_entry) + UNIFYFS_LOG_MSG_MAX)
+
+typedef struct log_ring {
+    struct log_ring* next;  /* next ring in registry */
+    char* buf;
+    uint64_t head;          /* total bytes written by producer */
+    uint64_t tail;          /* total bytes consumed by writer */
+    uint64_t dropped;       /* messages dropped while ring was full */
+    int busy;               /* set while producer is enqueuing */
+    int orphaned;           /* set when the owning thread has exited */
+} log_ring;
+
+/* registry of all rings, rings are never freed while the process runs
+ * so that the writer can safely walk the list without a lock */
+static log_ring* log_rings; // = NULL
+
+static __thread log_ring* my_ring; // = NULL
+static __thread pid_t my_tid; // = 0
+
+static pthread_once_t log_async_once = PTHREAD_ONCE_INIT;
+static pthread_key_t log_ring_key;
+
+static pthread_mutex_t log_writer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_writer_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t log_flush_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t log_writer_thread;
+static int log_writer_running; // = 0
+static int log_writer_exit; // = 0
+static int log_writer_binary; // = 0
+static unsigned long log_flush_requests; // = 0
+static unsigned long log_flush_done; // = 0
+static unsigned int log_next_site_id = 1;
+
+/* sites described in the current binary log */
+static unifyfs_log_site** log_sites; // = NULL
+static size_t log_sites_count; // = 0
+static size_t log_sites_size; // = 0
+
+/* used by writer to report dropped messages */
+static unifyfs_log_site log_drop_site = {
+    __FILE__, "unifyfs_log_writer", __LINE__, 0
+};
+
+/* owning thread exited, allow its ring to be reused by a new thread */
+static void log_ring_release(void* arg)
+{
+    log_ring* ring = (log_ring*) arg;
+    __atomic_store_n(&ring->orphaned, 1, __ATOMIC_RELEASE);
+}
+
+/* a forked child has neither the writer thread nor the parent's tid */
+static void log_atfork_child(void)
+{
+    unifyfs_log_async = 0;
+    log_writer_running = 0;
+    my_tid = 0;
+}
+
+static void log_async_init(void)
+{
+    pthread_key_create(&log_ring_key, log_ring_release);
+    pthread_atfork(NULL, NULL, log_atfork_child);
+}
+
+/* return the calling thread's ring, or NULL on allocation failure */
+static log_ring* log_get_ring(void)
+{
+    if (NULL != my_ring) {
+        return my_ring;
+    }
+
+    /* reuse the ring of an exited thread if there is one */
+    log_ring* ring;
+    for (ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+         NULL != ring; ring = ring->next) {
+        int expected = 1;
+        if (__atomic_compare_exchange_n(&ring->orphaned, &expected, 0, 0,
+                                        __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    if (NULL == ring) {
+        ring = calloc(1, sizeof(log_ring));
+        if (NULL == ring) {
+            return NULL;
+        }
+        ring->buf = malloc(UNIFYFS_LOG_RING_SIZE);
+        if (NULL == ring->buf) {
+            free(ring);
+            return NULL;
+        }
+
+        /* push new ring onto registry */
+        log_ring* first = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+        do {
+            ring->next = first;
+        } while (!__atomic_compare_exchange_n(&log_rings, &first, ring, 1,
+                                              __ATOMIC_RELEASE,
+                                              __ATOMIC_ACQUIRE));
+    }
+
+    pthread_setspecific(log_ring_key, ring);
+    my_ring = ring;
+    return ring;
+}
+
+/* wake the writer thread */
+static void log_writer_signal(void)
+{
+    pthread_mutex_lock(&log_writer_lock);
+    pthread_cond_signal(&log_writer_cond);
+    pthread_mutex_unlock(&log_writer_lock);
+}
+
+/* queue one message for the asynchronous log writer */
+void unifyfs_log_enqueue(int level,
+                         unifyfs_log_site* site,
+                         const char* fmt, ...)
+{
+    va_list args;
+    const size_t size = UNIFYFS_LOG_RING_SIZE;
+
+    if (0 == my_tid) {
+        my_tid = unifyfs_gettid();
+    }
+
+    log_ring* ring = log_get_ring();
+    if (NULL != ring) {
+        /* the writer will not stop while we are busy, see
+         * unifyfs_log_async_stop() */
+        __atomic_store_n(&ring->busy, 1, __ATOMIC_SEQ_CST);
+    }
+    while ((NULL != ring) && unifyfs_log_async) {
+        uint64_t head = ring->head;
+        uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        size_t used = (size_t)(head - tail);
+        size_t pos = (size_t)(head % size);
+        size_t contig = size - pos;
+
+        /* reserve room for the longest message, wrapping if needed */
+        size_t pad = 0;
+        if (contig < LOG_ENTRY_MAX) {
+            pad = contig;
+        }
+        if ((used + pad + LOG_ENTRY_MAX) > size) {
+            log_writer_signal();
+            if (unifyfs_log_async_drop && (level > LOG_ERR)) {
+                /* drop the message rather than wait */
+                __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+                break;
+            }
+            /* errors are never dropped, wait for the writer */
+            usleep(100);
+            continue;
+        }
+
+        if (pad) {
+            /* too little room at end of ring, skip to start */
+            if (pad >= sizeof(log_entry)) {
+                log_entry* padent = (log_entry*)(ring->buf + pos);
+                padent->len = (uint32_t) pad;
+                padent->site = NULL;
+            }
+            pos = 0;
+        }
+
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+
+        log_entry* ent = (log_entry*)(ring->buf + pos);
+        char* msg = (char*)(ent + 1);
+        va_start(args, fmt);
+        int n = vsnprintf(msg, UNIFYFS_LOG_MSG_MAX, fmt, args);
+        va_end(args);
+        if (n < 0) {
+            n = 0;
+            msg[0] = '\0';
+        } else if (n >= UNIFYFS_LOG_MSG_MAX) {
+            n = UNIFYFS_LOG_MSG_MAX - 1;
+        }
+        size_t len = LOG_ENTRY_ALIGN(sizeof(log_entry) + (size_t)n + 1);
+        ent->len = (uint32_t) len;
+        ent->level = level;
+        ent->tid = (int32_t) my_tid;
+        ent->time_ns = ((uint64_t)ts.tv_sec * 1000000000ULL) +
+                       (uint64_t)ts.tv_nsec;
+        ent->site = site;
+
+        /* publish the message to the writer */
+        __atomic_store_n(&ring->head, head + pad + len, __ATOMIC_RELEASE);
+
+        if ((used + pad + len) > ((size / 4) * 3)) {
+            /* ring is getting full, wake the writer */
+            log_writer_signal();
+        }
+        __atomic_store_n(&ring->busy, 0, __ATOMIC_RELEASE);
+        return;
+    }
+    if (NULL != ring) {
+        __atomic_store_n(&ring->busy, 0, __ATOMIC_RELEASE);
+        if (unifyfs_log_async) {
+            return; /* message dropped */
+        }
+    }
+
+    /* async logging stopped or no ring available, print directly */
+    if (NULL == unifyfs_log_stream) {
+        unifyfs_log_stream = stderr;
+    }
+    char msg[UNIFYFS_LOG_MSG_MAX];
+    va_start(args, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+    unifyfs_log_print(time(NULL), site->file, site->line, site->func, msg);
+}
+
+/* write one message as text, reusing the formatted timestamp while
+ * the time in seconds does not change */
+static void log_write_text(FILE* out,
+                           uint64_t time_ns,
+                           long tid,
+                           const char* file,
+                           int line,
+                           const char* func,
+                           const char* msg,
+                           time_t* last_secs,
+                           char* timestamp,
+                           size_t ts_size)
+{
+    time_t secs = (time_t)(time_ns / 1000000000ULL);
+    if ((secs != *last_secs) || ('\0' == timestamp[0])) {
+        struct tm ltime;
+        localtime_r(&secs, &ltime);
+        strftime(timestamp, ts_size, "%Y-%m-%dT%H:%M:%S", &ltime);
+        *last_secs = secs;
+    }
+    if (NULL == func) {
+        func = null_func;
+    }
+    fprintf(out, "%s tid=%ld @ %s() [%s:%d] %s\n",
+            timestamp, tid, func, file, line, msg);
+}
+
+/* writer state for the text timestamp cache */
+static time_t log_writer_secs; // = 0
+static char log_writer_timestamp[64];
+
+/* write one queued message to the log stream */
+static void log_writer_emit(uint64_t time_ns,
+                            int level,
+                            long tid,
+                            unifyfs_log_site* site,
+                            const char* msg,
+                            size_t msg_len)
+{
+    FILE* out = unifyfs_log_stream;
+    const char* file = site->file;
+    if (NULL == file) {
+        file = "";
+    } else if (strlen(file) > (size_t)unifyfs_log_source_base_len) {
+        file += unifyfs_log_source_base_len;
+    }
+
+    if (!log_writer_binary) {
+        log_write_text(out, time_ns, tid, file, site->line, site->func, msg,
+                       &log_writer_secs, log_writer_timestamp,
+                       sizeof(log_writer_timestamp));
+        return;
+    }
+
+    unifyfs_log_rec_hdr hdr;
+    if (0 == site->id) {
+        /* first message from this site, describe it */
+        const char* func = (NULL != site->func) ? site->func : null_func;
+        size_t file_len = strlen(file) + 1;
+        size_t func_len = strlen(func) + 1;
+        unifyfs_log_site_rec srec;
+        if (log_sites_count == log_sites_size) {
+            size_t n = (log_sites_size) ? (2 * log_sites_size) : 256;
+            void* tmp = realloc(log_sites, n * sizeof(*log_sites));
+            if (NULL == tmp) {
+                return;
+            }
+            log_sites = tmp;
+            log_sites_size = n;
+        }
+        log_sites[log_sites_count++] = site;
+        site->id = log_next_site_id++;
+        srec.id = site->id;
+        srec.line = (uint32_t) site->line;
+        hdr.type = UNIFYFS_LOG_REC_SITE;
+        hdr.len = (uint32_t)(sizeof(srec) + file_len + func_len);
+        fwrite(&hdr, sizeof(hdr), 1, out);
+        fwrite(&srec, sizeof(srec), 1, out);
+        fwrite(file, file_len, 1, out);
+        fwrite(func, func_len, 1, out);
+    }
+
+    unifyfs_log_msg_rec mrec;
+    mrec.time_ns = time_ns;
+    mrec.site_id = site->id;
+    mrec.tid = (uint32_t) tid;
+    mrec.level = (uint32_t) level;
+    mrec.msg_len = (uint32_t) msg_len;
+    hdr.type = UNIFYFS_LOG_REC_MSG;
+    hdr.len = (uint32_t)(sizeof(mrec) + msg_len);
+    fwrite(&hdr, sizeof(hdr), 1, out);
+    fwrite(&mrec, sizeof(mrec), 1, out);
+    fwrite(msg, msg_len, 1, out);
+}
+
+/* write all messages queued in all rings, returns number written */
+static size_t log_writer_drain(void)
+{
+    const size_t size = UNIFYFS_LOG_RING_SIZE;
+    size_t count = 0;
+
+    log_ring* ring;
+    for (ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+         NULL != ring; ring = ring->next) {
+        uint64_t tail = ring->tail;
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        while (tail < head) {
+            size_t pos = (size_t)(tail % size);
+            size_t contig = size - pos;
+            if (contig < sizeof(log_entry)) {
+                /* implicit pad at end of ring */
+                tail += contig;
+                continue;
+            }
+            log_entry* ent = (log_entry*)(ring->buf + pos);
+            if (NULL != ent->site) {
+                const char* msg = (const char*)(ent + 1);
+                log_writer_emit(ent->time_ns, ent->level, ent->tid,
+                                ent->site, msg, strlen(msg));
+                count++;
+            }
+            tail += ent->len;
+        }
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+        uint64_t dropped = __atomic_exchange_n(&ring->dropped, 0,
+                                               __ATOMIC_RELAXED);
+        if (dropped) {
+            char msg[128];
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+            int n = snprintf(msg, sizeof(msg),
+                             "dropped %llu log messages, log ring was full",
+                             (unsigned long long) dropped);
+            log_writer_emit(((uint64_t)ts.tv_sec * 1000000000ULL) +
+                            (uint64_t)ts.tv_nsec, LOG_WARN,
+                            (long)unifyfs_gettid(), &log_drop_site,
+                            msg, (size_t)n);
+        }
+    }
+
+    if (count) {
+        fflush(unifyfs_log_stream);
+    }
+    return count;
+}
+
+static void* log_writer_main(void* arg)
+{
+    pthread_mutex_lock(&log_writer_lock);
+    while (1) {
+        unsigned long flush_req = log_flush_requests;
+        int exiting = log_writer_exit;
+        pthread_mutex_unlock(&log_writer_lock);
+
+        log_writer_drain();
+
+        pthread_mutex_lock(&log_writer_lock);
+        if (flush_req != log_flush_done) {
+            log_flush_done = flush_req;
+            pthread_cond_broadcast(&log_flush_cond);
+        }
+        if (exiting) {
+            break;
+        }
+        if ((flush_req == log_flush_requests) && !log_writer_exit) {
+            struct timeval now;
+            struct timespec timeout;
+            gettimeofday(&now, NULL);
+            long nsec = (now.tv_usec * 1000L) +
+                        (UNIFYFS_LOG_WRITER_MSEC * 1000000L);
+            timeout.tv_sec = now.tv_sec + (nsec / 1000000000L);
+            timeout.tv_nsec = nsec % 1000000000L;
+            pthread_cond_timedwait(&log_writer_cond, &log_writer_lock,
+                                   &timeout);
+        }
+    }
+    pthread_mutex_unlock(&log_writer_lock);
+    return NULL;
+}
+
+/* start a background thread that writes the log messages queued by
+ * each thread, in text or compact binary format.
+ * returns UNIFYFS_SUCCESS on success */
+int unifyfs_log_async_start(int binary)
+{
+    pthread_once(&log_async_once, log_async_init);
+
+    if (NULL == unifyfs_log_stream) {
+        unifyfs_log_stream = stderr;
+    }
+
+    pthread_mutex_lock(&log_writer_lock);
+    if (log_writer_running) {
+        pthread_mutex_unlock(&log_writer_lock);
+        return UNIFYFS_SUCCESS;
+    }
+
+    log_writer_binary = binary;
+    if (binary) {
+        uint32_t vers[2] = { UNIFYFS_LOG_BINARY_VERSION, 0 };
+        fwrite(UNIFYFS_LOG_BINARY_MAGIC, 8, 1, unifyfs_log_stream);
+        fwrite(vers, sizeof(vers), 1, unifyfs_log_stream);
+        fflush(unifyfs_log_stream);
+
+        /* ids are only meaningful within one binary log, so sites
+         * described in an earlier log are described again */
+        for (size_t i = 0; i < log_sites_count; i++) {
+            log_sites[i]->id = 0;
+        }
+        log_sites_count = 0;
+        log_next_site_id = 1;
+    }
+
+    log_writer_exit = 0;
+    int rc = pthread_create(&log_writer_thread, NULL, log_writer_main, NULL);
+    if (rc != 0) {
+        pthread_mutex_unlock(&log_writer_lock);
+        return rc;
+    }
+    log_writer_running = 1;
+    unifyfs_log_async = 1;
+    pthread_mutex_unlock(&log_writer_lock);
+
+    return UNIFYFS_SUCCESS;
+}
+
+/* write all queued messages and stop the log writer thread. Later
+ * messages are written directly to the log stream.
+ * returns UNIFYFS_SUCCESS on success */
+int unifyfs_log_async_stop(void)
+{
+    pthread_mutex_lock(&log_writer_lock);
+    if (!log_writer_running) {
+        pthread_mutex_unlock(&log_writer_lock);
+        return UNIFYFS_SUCCESS;
+    }
+    log_writer_running = 0;
+    pthread_mutex_unlock(&log_writer_lock);
+
+    /* stop new messages from being queued, then wait for any thread
+     * in the middle of queuing one */
+    __atomic_store_n(&unifyfs_log_async, 0, __ATOMIC_SEQ_CST);
+    log_ring* ring;
+    for (ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+         NULL != ring; ring = ring->next) {
+        while (__atomic_load_n(&ring->busy, __ATOMIC_SEQ_CST)) {
+            sched_yield();
+        }
+    }
+
+    /* writer drains remaining messages before exiting */
+    pthread_mutex_lock(&log_writer_lock);
+    log_writer_exit = 1;
+    pthread_cond_signal(&log_writer_cond);
+    pthread_mutex_unlock(&log_writer_lock);
+    pthread_join(log_writer_thread, NULL);
+
+    log_writer_binary = 0;
+    return UNIFYFS_SUCCESS;
+}
+
+/* wait until all messages queued so far have been written */
+void unifyfs_log_flush(void)
+{
+    pthread_mutex_lock(&log_writer_lock);
+    if (log_writer_running) {
+        unsigned long req = ++log_flush_requests;
+        pthread_cond_signal(&log_writer_cond);
+        while ((long)(log_flush_done - req) < 0) {
+            pthread_cond_wait(&log_flush_cond, &log_writer_lock);
+        }
+    }
+    pthread_mutex_unlock(&log_writer_lock);
+}
+
+/* decode a binary log from the input stream, writing it as text.
+ * returns UNIFYFS_SUCCESS on success */
+int unifyfs_log_decode(FILE* in, FILE* out)
+{
+    const size_t magic_len = strlen(UNIFYFS_LOG_BINARY_MAGIC);
+    int rc = UNIFYFS_SUCCESS;
+    int found = 0;
+    size_t matched = 0;
+    int c;
+
+    /* copy through any text logged before the binary log started */
+    while (!found && (EOF != (c = fgetc(in)))) {
+        if (c == UNIFYFS_LOG_BINARY_MAGIC[matched]) {
+            matched++;
+            found = (matched == magic_len);
+        } else {
+            fwrite(UNIFYFS_LOG_BINARY_MAGIC, matched, 1, out);
+            matched = 0;
+            if (c == UNIFYFS_LOG_BINARY_MAGIC[0]) {
+                matched = 1;
+            } else {
+                fputc(c, out);
+            }
+        }
+    }
+    if (!found) {
+        fwrite(UNIFYFS_LOG_BINARY_MAGIC, matched, 1, out);
+        return EINVAL;
+    }
+
+    uint32_t vers[2];
+    if ((fread(vers, sizeof(vers), 1, in) != 1) ||
+        (vers[0] != UNIFYFS_LOG_BINARY_VERSION)) {
+        return EINVAL;
+    }
+
+    /* site table indexed by id, each entry holds "file\0func\0" */
+    char** sites = NULL;
+    int* site_lines = NULL;
+    size_t n_sites = 0;
+    char* data = NULL;
+    size_t data_size = 0;
+    time_t last_secs = 0;
+    char timestamp[64] = {0};
+
+    unifyfs_log_rec_hdr hdr;
+    while (fread(&hdr, sizeof(hdr), 1, in) == 1) {
+        if ((NULL == data) || (hdr.len > data_size)) {
+            void* tmp = realloc(data, (size_t)hdr.len + 1);
+            if (NULL == tmp) {
+                rc = ENOMEM;
+                break;
+            }
+            data = tmp;
+            data_size = hdr.len;
+        }
+        if ((hdr.len > 0) && (fread(data, hdr.len, 1, in) != 1)) {
+            /* truncated record, e.g., process was killed */
+            rc = EIO;
+            break;
+        }
+        data[hdr.len] = '\0';
+
+        if (hdr.type == UNIFYFS_LOG_REC_SITE) {
+            unifyfs_log_site_rec srec;
+            if (hdr.len < sizeof(srec)) {
+                rc = EINVAL;
+                break;
+            }
+            memcpy(&srec, data, sizeof(srec));
+            if (srec.id >= n_sites) {
+                size_t n = (size_t)srec.id + 256;
+                char** tmp_sites = realloc(sites, n * sizeof(char*));
+                if (NULL != tmp_sites) {
+                    sites = tmp_sites;
+                }
+                int* tmp_lines = realloc(site_lines, n * sizeof(int));
+                if (NULL != tmp_lines) {
+                    site_lines = tmp_lines;
+                }
+                if ((NULL == tmp_sites) || (NULL == tmp_lines)) {
+                    rc = ENOMEM;
+                    break;
+                }
+                memset(sites + n_sites, 0, (n - n_sites) * sizeof(char*));
+                n_sites = n;
+            }
+            size_t names_len = hdr.len - sizeof(srec);
+            char* names = malloc(names_len + 2);
+            if (NULL == names) {
+                rc = ENOMEM;
+                break;
+            }
+            memcpy(names, data + sizeof(srec), names_len);
+            names[names_len] = '\0';
+            names[names_len + 1] = '\0';
+            free(sites[srec.id]);
+            sites[srec.id] = names;
+            site_lines[srec.id] = (int) srec.line;
+        } else if (hdr.type == UNIFYFS_LOG_REC_MSG) {
+            unifyfs_log_msg_rec mrec;
+            if (hdr.len < sizeof(mrec)) {
+                rc = EINVAL;
+                break;
+            }
+            memcpy(&mrec, data, sizeof(mrec));
+            const char* msg = data + sizeof(mrec);
+            const char* file = "?file?";
+            const char* func = null_func;
+            int line = 0;
+            if ((mrec.site_id < n_sites) && (NULL != sites[mrec.site_id])) {
+                file = sites[mrec.site_id];
+                func = file + strlen(file) + 1;
+                line = site_lines[mrec.site_id];
+            }
+            log_write_text(out, mrec.time_ns, (long)(int32_t)mrec.tid,
+                           file, line, func, msg, &last_secs,
+                           timestamp, sizeof(timestamp));
+        } else {
+            /* skip unknown record types */
+            continue;
+        }
+    }
+
+    for (size_t i = 0; i < n_sites; i++) {
+        free(sites[i]);
+    }
+    free(sites);
+    free(site_lines);
+    free(data);
+    fflush(out);
+
+    return rc;
+}
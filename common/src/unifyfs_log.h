@@ -30,6 +30,7 @@
 #ifndef __UNIFYFS_LOG_H__
 #define __UNIFYFS_LOG_H__
 
+#include <stdint.h>
 #include <stdio.h>
 #include <time.h>
 #include <sys/types.h>
@@ -53,8 +54,62 @@ extern unifyfs_log_level_t unifyfs_log_level;
 extern int unifyfs_log_on_error;
 extern FILE* unifyfs_log_stream;
 
+/* set while messages are queued for the asynchronous log writer */
+extern volatile int unifyfs_log_async;
+
+/* when set, debug, info and warning messages are dropped (and counted)
+ * rather than waiting for the writer when a thread's queue is full */
+extern int unifyfs_log_async_drop;
+
+/* source location of a LOG() call. Each call site has one static
+ * instance, so binary log records can refer to it by id */
+typedef struct unifyfs_log_site {
+    const char* file;
+    const char* func;
+    int line;
+    unsigned int id;    /* binary log site id, assigned by the writer */
+} unifyfs_log_site;
+
+/* Binary log format: a file header followed by records that each start
+ * with a unifyfs_log_rec_hdr. A SITE record, holding its id, line, and
+ * NUL-terminated file and function names, precedes the first MSG record
+ * that refers to that site. Values are in host byte order. */
+#define UNIFYFS_LOG_BINARY_MAGIC "UNIFYLOG"
+#define UNIFYFS_LOG_BINARY_VERSION 1
+
+enum {
+    UNIFYFS_LOG_REC_SITE = 1,
+    UNIFYFS_LOG_REC_MSG  = 2
+};
+
+typedef struct {
+    uint32_t type;      /* UNIFYFS_LOG_REC_xxx */
+    uint32_t len;       /* bytes of record data following header */
+} unifyfs_log_rec_hdr;
+
+typedef struct {
+    uint32_t id;
+    uint32_t line;
+    /* followed by file and function names */
+} unifyfs_log_site_rec;
+
+typedef struct {
+    uint64_t time_ns;   /* CLOCK_REALTIME nanoseconds */
+    uint32_t site_id;
+    uint32_t tid;
+    uint32_t level;
+    uint32_t msg_len;
+    /* followed by msg_len bytes of message text */
+} unifyfs_log_msg_rec;
+
 pid_t unifyfs_gettid(void);
 
+/* queue one message for the asynchronous log writer */
+void unifyfs_log_enqueue(int level,
+                         unifyfs_log_site* site,
+                         const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
 /* print one message to debug file stream */
 void unifyfs_log_print(time_t now,
                        const char* srcfile,
@@ -73,12 +128,35 @@ int unifyfs_log_close(void);
 /* set log level */
 void unifyfs_set_log_level(unifyfs_log_level_t lvl);
 
+/* start a background thread that writes the log messages queued by
+ * each thread, in text or compact binary format.
+ * returns UNIFYFS_SUCCESS on success */
+int unifyfs_log_async_start(int binary);
+
+/* write all queued messages and stop the log writer thread. Later
+ * messages are written directly to the log stream.
+ * returns UNIFYFS_SUCCESS on success */
+int unifyfs_log_async_stop(void);
+
+/* wait until all messages queued so far have been written */
+void unifyfs_log_flush(void);
+
+/* decode a binary log from the input stream, writing it as text.
+ * returns UNIFYFS_SUCCESS on success */
+int unifyfs_log_decode(FILE* in, FILE* out);
+
 /* enable verbose logging upon error */
 void unifyfs_set_log_on_error(void);
 
 #define LOG(level, ...) \
     do { \
         if (level <= unifyfs_log_level) { \
+            if (unifyfs_log_async) { \
+                static unifyfs_log_site log_site = \
+                    { __FILE__, __func__, __LINE__, 0 }; \
+                unifyfs_log_enqueue(level, &log_site, __VA_ARGS__); \
+                break; \
+            } \
             if (NULL == unifyfs_log_stream) { \
                 unifyfs_log_stream = stderr; \
             } \
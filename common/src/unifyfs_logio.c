@@ -18,15 +18,23 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
 
 #include "unifyfs_log.h"
 #include "unifyfs_logio.h"
 #include "unifyfs_meta.h"
 #include "unifyfs_shm.h"
+#include "unifyfs_stats.h"
+#include "lz_block.h"
+#include "reader_epoch.h"
 #include "slotmap.h"
 
 #define LOGIO_SHMEM_FMTSTR "logio_mem.%d.%d"
@@ -40,6 +48,10 @@ typedef struct log_header {
     size_t reserved_sz;        /* reserved data bytes */
     size_t chunk_sz;           /* data chunk size */
     off_t  data_offset;        /* file/memory offset where data chunks start */
+    size_t tier_offset;        /* header offset of tier map (0 if none) */
+    size_t zmap_offset;        /* header offset of compressed chunk map
+                                * (0 if none) */
+    int    shmem_flags;        /* shmem placement flags (SHMEM_xxx) */
 
     volatile int updating;     /* flag to prevent client/server update races */
 } log_header;
@@ -191,6 +203,1163 @@ static void* map_spillfile(int spill_fd,
     return addr;
 }
 
+/* ---- O_DIRECT spill writes with write-behind staging ----
+ *
+ * Spill data is written with O_DIRECT to keep it out of the page cache.
+ * Writes are copied into an aligned staging buffer, and a full buffer is
+ * handed to a helper thread to write while the other buffer is filled.
+ * Log allocations are whole chunks, and the chunk size is a multiple of
+ * the O_DIRECT alignment, so padding a staged write up to the alignment
+ * only touches unused space at the end of the write's own last chunk. */
+
+/* a staging buffer for a contiguous range of the spill file */
+typedef struct logio_stage {
+    char*  buf;    /* aligned staging buffer */
+    off_t  offset; /* spill file offset of first staged byte */
+    size_t len;    /* number of staged bytes */
+} logio_stage;
+
+typedef struct logio_direct {
+    int fd;                   /* spill file descriptor opened with O_DIRECT */
+    size_t chunk_sz;          /* log chunk size */
+    off_t data_offset;        /* spill file offset of first chunk */
+    size_t stage_sz;          /* size of each staging buffer */
+    logio_stage stages[2];    /* staging buffers */
+    logio_stage* active;      /* buffer accepting new writes */
+    logio_stage* flushing;    /* buffer being written by helper, or NULL */
+    int flush_err;            /* error from an asynchronous flush */
+    int exit;                 /* set to ask the helper thread to exit */
+    pthread_t thrd;           /* write-behind helper thread */
+    pthread_mutex_t mutex;    /* protects all the fields above */
+    pthread_cond_t cond;      /* signals changes of flushing or exit */
+} logio_direct;
+
+static inline size_t direct_align(size_t len)
+{
+    size_t align = UNIFYFS_LOGIO_DIRECT_ALIGN;
+    return ((len + align - 1) / align) * align;
+}
+
+/* write staged data to the spill file, padded to the O_DIRECT alignment */
+static int direct_write_stage(logio_direct* d,
+                              logio_stage* st)
+{
+    int ret = UNIFYFS_SUCCESS;
+    size_t total = direct_align(st->len);
+    size_t done = 0;
+    while (done < total) {
+        ssize_t rc = pwrite(d->fd, st->buf + done, total - done,
+                            st->offset + (off_t)done);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ret = errno;
+            LOGERR("pwrite(O_DIRECT spillfile, off=%zu, sz=%zu) failed: %s",
+                   (size_t)(st->offset + done), total - done, strerror(ret));
+            break;
+        }
+        done += (size_t) rc;
+    }
+    st->len = 0;
+    return ret;
+}
+
+static void* direct_flush_thread(void* arg)
+{
+    logio_direct* d = (logio_direct*) arg;
+
+    pthread_mutex_lock(&(d->mutex));
+    while (!d->exit) {
+        if (NULL == d->flushing) {
+            pthread_cond_wait(&(d->cond), &(d->mutex));
+            continue;
+        }
+
+        /* write out the handed off buffer without holding the lock */
+        logio_stage* st = d->flushing;
+        pthread_mutex_unlock(&(d->mutex));
+        int rc = direct_write_stage(d, st);
+        pthread_mutex_lock(&(d->mutex));
+
+        if ((rc != UNIFYFS_SUCCESS) && (d->flush_err == UNIFYFS_SUCCESS)) {
+            d->flush_err = rc;
+        }
+        d->flushing = NULL;
+        pthread_cond_broadcast(&(d->cond));
+    }
+    pthread_mutex_unlock(&(d->mutex));
+    return NULL;
+}
+
+/* wait for the helper to finish writing the handed off buffer,
+ * caller must hold the mutex */
+static void direct_wait_flushing(logio_direct* d)
+{
+    while (NULL != d->flushing) {
+        pthread_cond_wait(&(d->cond), &(d->mutex));
+    }
+}
+
+/* hand the active buffer to the helper thread and switch to the other
+ * buffer, caller must hold the mutex */
+static void direct_handoff(logio_direct* d)
+{
+    direct_wait_flushing(d);
+    if (d->active->len == 0) {
+        return;
+    }
+    d->flushing = d->active;
+    if (d->active == &(d->stages[0])) {
+        d->active = &(d->stages[1]);
+    } else {
+        d->active = &(d->stages[0]);
+    }
+    d->active->len = 0;
+    pthread_cond_broadcast(&(d->cond));
+}
+
+/* copy data for the spill file at the given offset into staging buffers */
+static void direct_stage_write(logio_direct* d,
+                               off_t offset,
+                               const char* buf,
+                               size_t len)
+{
+    pthread_mutex_lock(&(d->mutex));
+    while (len > 0) {
+        logio_stage* st = d->active;
+        if (st->len > 0) {
+            off_t st_end = st->offset + (off_t)st->len;
+            size_t end_chunk = bytes_to_chunks(st_end - d->data_offset,
+                                               d->chunk_sz);
+            off_t next_chunk = d->data_offset +
+                               (off_t)(end_chunk * d->chunk_sz);
+            if ((offset != st_end) &&
+                ((offset != next_chunk) ||
+                 ((size_t)(offset - st->offset) >= d->stage_sz))) {
+                /* not contiguous with staged data */
+                direct_handoff(d);
+                continue;
+            }
+            /* a write that starts the next chunk pads the staged data
+             * to the chunk boundary */
+            st->len = (size_t)(offset - st->offset);
+        } else {
+            st->offset = offset;
+        }
+
+        size_t space = d->stage_sz - st->len;
+        size_t n = (len < space) ? len : space;
+        memcpy(st->buf + st->len, buf, n);
+        st->len += n;
+        offset += (off_t) n;
+        buf += n;
+        len -= n;
+
+        if (st->len == d->stage_sz) {
+            direct_handoff(d);
+        }
+    }
+    pthread_mutex_unlock(&(d->mutex));
+}
+
+/* write any staged data that overlaps the given spill range, so that it
+ * can be read from the spill file */
+static void direct_flush_range(logio_direct* d,
+                               off_t offset,
+                               size_t len)
+{
+    off_t end = offset + (off_t)len;
+    pthread_mutex_lock(&(d->mutex));
+    logio_stage* st = d->flushing;
+    if ((NULL != st) &&
+        (offset < (st->offset + (off_t)st->len)) && (st->offset < end)) {
+        direct_wait_flushing(d);
+    }
+    st = d->active;
+    if ((st->len > 0) &&
+        (offset < (st->offset + (off_t)st->len)) && (st->offset < end)) {
+        int rc = direct_write_stage(d, st);
+        if ((rc != UNIFYFS_SUCCESS) && (d->flush_err == UNIFYFS_SUCCESS)) {
+            d->flush_err = rc;
+        }
+    }
+    pthread_mutex_unlock(&(d->mutex));
+}
+
+/* write all staged data, and return any error from earlier flushes */
+static int direct_flush(logio_direct* d)
+{
+    pthread_mutex_lock(&(d->mutex));
+    direct_wait_flushing(d);
+    int ret = d->flush_err;
+    if (d->active->len > 0) {
+        int rc = direct_write_stage(d, d->active);
+        if (ret == UNIFYFS_SUCCESS) {
+            ret = rc;
+        }
+    }
+    d->flush_err = UNIFYFS_SUCCESS;
+    pthread_mutex_unlock(&(d->mutex));
+    return ret;
+}
+
+static void direct_fini(logio_direct* d)
+{
+    if (NULL == d) {
+        return;
+    }
+
+    int rc = direct_flush(d);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to flush O_DIRECT spill staging buffers");
+    }
+
+    pthread_mutex_lock(&(d->mutex));
+    d->exit = 1;
+    pthread_cond_broadcast(&(d->cond));
+    pthread_mutex_unlock(&(d->mutex));
+    pthread_join(d->thrd, NULL);
+
+    pthread_cond_destroy(&(d->cond));
+    pthread_mutex_destroy(&(d->mutex));
+    free(d->stages[0].buf);
+    free(d->stages[1].buf);
+    close(d->fd);
+    free(d);
+}
+
+/* Open the spill file for O_DIRECT writes and start the write-behind
+ * helper. Returns NULL if O_DIRECT cannot be used, in which case
+ * buffered writes are used instead. */
+static logio_direct* direct_init(const char* path,
+                                 size_t chunk_sz,
+                                 off_t data_offset,
+                                 size_t stage_sz)
+{
+    size_t align = UNIFYFS_LOGIO_DIRECT_ALIGN;
+    if ((chunk_sz % align) || (data_offset % align)) {
+        LOGWARN("O_DIRECT spill disabled - chunk size (%zu) and data offset "
+                "(%zu) must be multiples of %zu",
+                chunk_sz, (size_t)data_offset, align);
+        return NULL;
+    }
+
+    int fd = open(path, O_WRONLY | O_DIRECT);
+    if (fd < 0) {
+        LOGWARN("O_DIRECT spill disabled - open(%s) failed: %s",
+                path, strerror(errno));
+        return NULL;
+    }
+
+    logio_direct* d = (logio_direct*) calloc(1, sizeof(logio_direct));
+    if (NULL == d) {
+        close(fd);
+        return NULL;
+    }
+    d->fd = fd;
+    d->chunk_sz = chunk_sz;
+    d->data_offset = data_offset;
+    d->stage_sz = direct_align(stage_sz);
+    for (int i = 0; i < 2; i++) {
+        void* buf = NULL;
+        if (posix_memalign(&buf, align, d->stage_sz) != 0) {
+            LOGWARN("O_DIRECT spill disabled - failed to allocate "
+                    "staging buffer");
+            free(d->stages[0].buf);
+            free(d);
+            close(fd);
+            return NULL;
+        }
+        d->stages[i].buf = (char*) buf;
+    }
+    d->active = &(d->stages[0]);
+    pthread_mutex_init(&(d->mutex), NULL);
+    pthread_cond_init(&(d->cond), NULL);
+
+    int rc = pthread_create(&(d->thrd), NULL, direct_flush_thread, d);
+    if (rc != 0) {
+        LOGWARN("O_DIRECT spill disabled - failed to create write-behind "
+                "thread: %s", strerror(rc));
+        pthread_cond_destroy(&(d->cond));
+        pthread_mutex_destroy(&(d->mutex));
+        free(d->stages[0].buf);
+        free(d->stages[1].buf);
+        free(d);
+        close(fd);
+        return NULL;
+    }
+
+    LOGDBG("using O_DIRECT spill writes (staging buffers = 2 x %zu B)",
+           d->stage_sz);
+    return d;
+}
+
+/* ---- compressed spill chunks ----
+ *
+ * With spill compression, each spill chunk is compressed as a whole and
+ * stored at the start of the chunk's slot in the spill file. The rest of
+ * the slot is left as a hole, so the slots of a sparse spill file can
+ * cover UNIFYFS_LOGIO_COMPRESS_RATIO times the configured spill size.
+ * A chunk map in the spill header pages records the stored size and
+ * data length of each chunk, so reading part of a chunk only reads and
+ * decompresses the chunk up to the end of the requested range. Writes
+ * decompress any existing chunk data they do not replace, then store
+ * the whole chunk again. Chunks that do not compress are stored as is.
+ *
+ * The spill space in use is tracked in the chunk map. Allocated chunks
+ * hold a whole chunk of space until they are written, after which they
+ * hold their stored size (rounded up to UNIFYFS_LOGIO_COMPRESS_BLOCK).
+ * New spill allocations fail with ENOSPC once the space is used, and a
+ * rewrite that makes a chunk compress worse fails the same way.
+ *
+ * Each chunk has a generation count that is odd while the chunk is
+ * rewritten. Readers retry when the count changes during their read. */
+
+/* chunk flags */
+#define LOG_ZCHUNK_RAW 0x1 /* chunk is stored uncompressed */
+
+/* state of a spill chunk */
+typedef struct log_zchunk {
+    volatile uint32_t gen; /* odd while chunk is rewritten */
+    uint32_t flags;        /* LOG_ZCHUNK_xxx */
+    size_t stored;         /* bytes stored at start of chunk slot */
+    size_t len;            /* bytes of chunk data */
+    size_t charge;         /* spill space held by chunk */
+} log_zchunk;
+
+/* chunk map header, followed by log_zchunk chunks[n_chunks] */
+typedef struct log_zmap {
+    size_t n_chunks;              /* number of spill chunks */
+    size_t space;                 /* spill space available for chunks */
+    volatile size_t used;         /* spill space in use */
+    volatile size_t data_bytes;   /* bytes of chunk data */
+    volatile size_t stored_bytes; /* bytes stored for chunk data */
+} log_zmap;
+
+/* buffers for decompressed and compressed chunk data */
+typedef struct logio_zbuf {
+    struct logio_zbuf* next;
+    char* data;
+    char* comp;
+} logio_zbuf;
+
+typedef struct logio_zspill {
+    log_zmap* zmap;        /* chunk map in spill header */
+    int fd;                /* spill file descriptor */
+    size_t chunk_sz;       /* log chunk size */
+    off_t data_offset;     /* spill file offset of first chunk */
+    size_t comp_cap;       /* size of compressed data buffers */
+    logio_zbuf* bufs;      /* free buffers */
+    pthread_mutex_t mutex; /* protects bufs */
+} logio_zspill;
+
+static inline size_t zmap_size(size_t n_chunks)
+{
+    return sizeof(log_zmap) + (n_chunks * sizeof(log_zchunk));
+}
+
+static inline log_zchunk* zmap_chunks(log_zmap* zmap)
+{
+    return (log_zchunk*)((char*)zmap + sizeof(log_zmap));
+}
+
+static inline size_t zspill_round(size_t bytes)
+{
+    size_t blk = UNIFYFS_LOGIO_COMPRESS_BLOCK;
+    return ((bytes + blk - 1) / blk) * blk;
+}
+
+static void zmap_init(log_zmap* zmap, size_t n_chunks)
+{
+    memset(zmap, 0, zmap_size(n_chunks));
+    zmap->n_chunks = n_chunks;
+}
+
+static logio_zspill* zspill_init(log_header* spill_hdr, int fd)
+{
+    logio_zspill* z = (logio_zspill*) calloc(1, sizeof(logio_zspill));
+    if (NULL == z) {
+        LOGERR("failed to allocate spill compression state");
+        return NULL;
+    }
+    z->zmap = (log_zmap*)((char*)spill_hdr + spill_hdr->zmap_offset);
+    z->fd = fd;
+    z->chunk_sz = spill_hdr->chunk_sz;
+    z->data_offset = spill_hdr->data_offset;
+    z->comp_cap = LZ_BLOCK_BOUND(z->chunk_sz);
+    pthread_mutex_init(&(z->mutex), NULL);
+    LOGDBG("using compressed spill chunks (space=%zu B, chunks=%zu)",
+           z->zmap->space, z->zmap->n_chunks);
+    return z;
+}
+
+static void zspill_fini(logio_zspill* z)
+{
+    while (NULL != z->bufs) {
+        logio_zbuf* zb = z->bufs;
+        z->bufs = zb->next;
+        free(zb->data);
+        free(zb->comp);
+        free(zb);
+    }
+    pthread_mutex_destroy(&(z->mutex));
+    free(z);
+}
+
+static logio_zbuf* zspill_get_buf(logio_zspill* z)
+{
+    pthread_mutex_lock(&(z->mutex));
+    logio_zbuf* zb = z->bufs;
+    if (NULL != zb) {
+        z->bufs = zb->next;
+    }
+    pthread_mutex_unlock(&(z->mutex));
+
+    if (NULL == zb) {
+        zb = (logio_zbuf*) calloc(1, sizeof(logio_zbuf));
+        if (NULL != zb) {
+            zb->data = malloc(z->chunk_sz);
+            zb->comp = malloc(z->comp_cap);
+            if ((NULL == zb->data) || (NULL == zb->comp)) {
+                free(zb->data);
+                free(zb->comp);
+                free(zb);
+                zb = NULL;
+            }
+        }
+        if (NULL == zb) {
+            LOGERR("failed to allocate spill compression buffers");
+        }
+    }
+    return zb;
+}
+
+static void zspill_put_buf(logio_zspill* z, logio_zbuf* zb)
+{
+    if (NULL != zb) {
+        pthread_mutex_lock(&(z->mutex));
+        zb->next = z->bufs;
+        z->bufs = zb;
+        pthread_mutex_unlock(&(z->mutex));
+    }
+}
+
+/* take spill space, returns ENOSPC if not available */
+static int zspill_charge(log_zmap* zmap, size_t bytes)
+{
+    while (1) {
+        size_t used = zmap->used;
+        if ((used + bytes) > zmap->space) {
+            return ENOSPC;
+        }
+        if (__sync_bool_compare_and_swap(&(zmap->used), used,
+                                         used + bytes)) {
+            return UNIFYFS_SUCCESS;
+        }
+    }
+}
+
+/* pread()/pwrite() all bytes, returns UNIFYFS_SUCCESS or error code */
+static int zspill_io(int fd, char* buf, size_t nbytes, off_t offset,
+                     int is_write)
+{
+    size_t done = 0;
+    while (done < nbytes) {
+        ssize_t rc;
+        if (is_write) {
+            rc = pwrite(fd, buf + done, nbytes - done, offset + done);
+        } else {
+            rc = pread(fd, buf + done, nbytes - done, offset + done);
+        }
+        if (-1 == rc) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        } else if (0 == rc) {
+            return EIO;
+        }
+        done += (size_t) rc;
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+/* read the first nbytes of chunk data into zb->data, caller makes sure
+ * the chunk is not being rewritten */
+static int zchunk_load(logio_zspill* z, logio_zbuf* zb, log_zchunk* e,
+                       off_t slot_off, size_t nbytes)
+{
+    if (e->flags & LOG_ZCHUNK_RAW) {
+        return zspill_io(z->fd, zb->data, nbytes, slot_off, 0);
+    }
+    int rc = zspill_io(z->fd, zb->comp, e->stored, slot_off, 0);
+    if (rc == UNIFYFS_SUCCESS) {
+        ssize_t n = lz_block_decompress(zb->comp, e->stored,
+                                        zb->data, nbytes);
+        if (n != (ssize_t)nbytes) {
+            rc = EIO;
+        }
+    }
+    return rc;
+}
+
+/* read n bytes at offset a of a spill chunk */
+static int zchunk_read(logio_zspill* z, logio_zbuf** pzb, size_t chunk,
+                       size_t a, size_t n, char* out)
+{
+    log_zchunk* e = zmap_chunks(z->zmap) + chunk;
+    off_t slot_off = z->data_offset + (off_t)(chunk * z->chunk_sz);
+    while (1) {
+        uint32_t gen = e->gen;
+        if (gen & 1) {
+            usleep(10);
+            continue;
+        }
+        __sync_synchronize();
+
+        /* bytes past the chunk data are zero */
+        size_t len = e->len;
+        size_t valid = 0;
+        if (a < len) {
+            valid = ((len - a) < n) ? (len - a) : n;
+        }
+
+        int rc = UNIFYFS_SUCCESS;
+        if (valid && (e->flags & LOG_ZCHUNK_RAW)) {
+            rc = zspill_io(z->fd, out, valid, slot_off + a, 0);
+        } else if (valid) {
+            if (NULL == *pzb) {
+                *pzb = zspill_get_buf(z);
+                if (NULL == *pzb) {
+                    return ENOMEM;
+                }
+            }
+            rc = zchunk_load(z, *pzb, e, slot_off, a + valid);
+            if (rc == UNIFYFS_SUCCESS) {
+                memcpy(out, (*pzb)->data + a, valid);
+            }
+        }
+
+        __sync_synchronize();
+        if (e->gen != gen) {
+            /* chunk was rewritten during the read */
+            continue;
+        }
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("failed to read spill chunk %zu (%s)", chunk, strerror(rc));
+            return rc;
+        }
+        memset(out + valid, 0, n - valid);
+        return UNIFYFS_SUCCESS;
+    }
+}
+
+/* write n bytes at offset a of a spill chunk */
+static int zchunk_write(logio_zspill* z, logio_zbuf* zb, size_t chunk,
+                        size_t a, size_t n, const char* in)
+{
+    log_zmap* zmap = z->zmap;
+    log_zchunk* e = zmap_chunks(zmap) + chunk;
+    off_t slot_off = z->data_offset + (off_t)(chunk * z->chunk_sz);
+
+    /* lock chunk by making its generation odd */
+    uint32_t gen;
+    while (1) {
+        gen = e->gen;
+        if (!(gen & 1) &&
+            __sync_bool_compare_and_swap(&(e->gen), gen, gen + 1)) {
+            break;
+        }
+        usleep(10);
+    }
+
+    /* merge new data with the existing chunk data it does not replace */
+    int rc = UNIFYFS_SUCCESS;
+    size_t len = e->len;
+    size_t new_len = ((a + n) > len) ? (a + n) : len;
+    size_t keep = len;
+    if ((a + n) >= len) {
+        keep = (a < len) ? a : len;
+    }
+    if (keep) {
+        rc = zchunk_load(z, zb, e, slot_off, keep);
+    }
+    if (a > len) {
+        memset(zb->data + len, 0, a - len);
+    }
+    memcpy(zb->data + a, in, n);
+
+    /* store compressed data if it takes less space */
+    const char* src = zb->data;
+    size_t stored = new_len;
+    uint32_t flags = LOG_ZCHUNK_RAW;
+    if (rc == UNIFYFS_SUCCESS) {
+        size_t clen = lz_block_compress(zb->data, new_len,
+                                        zb->comp, z->comp_cap);
+        if (clen && (zspill_round(clen) < zspill_round(new_len))) {
+            src = zb->comp;
+            stored = clen;
+            flags = 0;
+        }
+    }
+
+    /* take any additional space before writing */
+    size_t charge = zspill_round(stored);
+    if ((rc == UNIFYFS_SUCCESS) && (charge > e->charge)) {
+        rc = zspill_charge(zmap, charge - e->charge);
+        if (rc == UNIFYFS_SUCCESS) {
+            e->charge = charge;
+        }
+    }
+    if (rc == UNIFYFS_SUCCESS) {
+        rc = zspill_io(z->fd, (char*)src, stored, slot_off, 1);
+    }
+
+    if (rc == UNIFYFS_SUCCESS) {
+        /* release the space past the new stored data */
+        size_t old_alloc = zspill_round(e->stored);
+        if (old_alloc > charge) {
+            int prc = fallocate(z->fd,
+                                FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                                slot_off + (off_t)charge,
+                                (off_t)(old_alloc - charge));
+            if (prc != 0) {
+                LOGDBG("fallocate(PUNCH_HOLE) of spill chunk failed: %s",
+                       strerror(errno));
+            }
+        }
+        if (e->charge > charge) {
+            __sync_fetch_and_sub(&(zmap->used), e->charge - charge);
+            e->charge = charge;
+        }
+        __sync_fetch_and_add(&(zmap->data_bytes), new_len - len);
+        __sync_fetch_and_add(&(zmap->stored_bytes), stored);
+        __sync_fetch_and_sub(&(zmap->stored_bytes), e->stored);
+        e->stored = stored;
+        e->len = new_len;
+        e->flags = flags;
+    } else {
+        LOGERR("failed to write spill chunk %zu (%s)", chunk, strerror(rc));
+    }
+
+    __sync_synchronize();
+    e->gen = gen + 2;
+    return rc;
+}
+
+/* read from spill file offset, like pread() */
+static ssize_t zspill_pread(logio_zspill* z, char* buf, size_t nbytes,
+                            off_t offset)
+{
+    logio_zbuf* zb = NULL;
+    size_t done = 0;
+    int rc = UNIFYFS_SUCCESS;
+    while (done < nbytes) {
+        size_t rel = (size_t)(offset - z->data_offset) + done;
+        size_t chunk = rel / z->chunk_sz;
+        size_t a = rel % z->chunk_sz;
+        size_t n = z->chunk_sz - a;
+        if (n > (nbytes - done)) {
+            n = nbytes - done;
+        }
+        if (chunk >= z->zmap->n_chunks) {
+            break;
+        }
+        rc = zchunk_read(z, &zb, chunk, a, n, buf + done);
+        if (rc != UNIFYFS_SUCCESS) {
+            break;
+        }
+        done += n;
+    }
+    zspill_put_buf(z, zb);
+    if ((0 == done) && (rc != UNIFYFS_SUCCESS)) {
+        errno = rc;
+        return -1;
+    }
+    return (ssize_t) done;
+}
+
+/* write to spill file offset, like pwrite() */
+static ssize_t zspill_pwrite(logio_zspill* z, const char* buf, size_t nbytes,
+                             off_t offset)
+{
+    logio_zbuf* zb = zspill_get_buf(z);
+    if (NULL == zb) {
+        errno = ENOMEM;
+        return -1;
+    }
+    size_t done = 0;
+    int rc = UNIFYFS_SUCCESS;
+    while (done < nbytes) {
+        size_t rel = (size_t)(offset - z->data_offset) + done;
+        size_t chunk = rel / z->chunk_sz;
+        size_t a = rel % z->chunk_sz;
+        size_t n = z->chunk_sz - a;
+        if (n > (nbytes - done)) {
+            n = nbytes - done;
+        }
+        if (chunk >= z->zmap->n_chunks) {
+            break;
+        }
+        rc = zchunk_write(z, zb, chunk, a, n, buf + done);
+        if (rc != UNIFYFS_SUCCESS) {
+            break;
+        }
+        done += n;
+    }
+    zspill_put_buf(z, zb);
+    if ((0 == done) && (rc != UNIFYFS_SUCCESS)) {
+        errno = rc;
+        return -1;
+    }
+    return (ssize_t) done;
+}
+
+/* take a whole chunk of space for each newly reserved spill chunk,
+ * caller holds spill header lock */
+static int zspill_reserve(logio_zspill* z, size_t first_chunk,
+                          size_t n_chunks)
+{
+    int rc = zspill_charge(z->zmap, n_chunks * z->chunk_sz);
+    if (rc == UNIFYFS_SUCCESS) {
+        log_zchunk* chunks = zmap_chunks(z->zmap);
+        for (size_t c = first_chunk; c < (first_chunk + n_chunks); c++) {
+            chunks[c].charge = z->chunk_sz;
+        }
+    }
+    return rc;
+}
+
+/* drop data and space of released spill chunks */
+static void zspill_release(logio_zspill* z, size_t first_chunk,
+                           size_t n_chunks)
+{
+    log_zmap* zmap = z->zmap;
+    log_zchunk* chunks = zmap_chunks(zmap);
+    for (size_t c = first_chunk; c < (first_chunk + n_chunks); c++) {
+        log_zchunk* e = chunks + c;
+        if (e->stored) {
+            off_t slot_off = z->data_offset + (off_t)(c * z->chunk_sz);
+            int rc = fallocate(z->fd,
+                               FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                               slot_off, (off_t) zspill_round(e->stored));
+            if (rc != 0) {
+                LOGDBG("fallocate(PUNCH_HOLE) of spill chunk failed: %s",
+                       strerror(errno));
+            }
+        }
+        __sync_fetch_and_sub(&(zmap->used), e->charge);
+        __sync_fetch_and_sub(&(zmap->data_bytes), e->len);
+        __sync_fetch_and_sub(&(zmap->stored_bytes), e->stored);
+        e->charge = 0;
+        e->stored = 0;
+        e->len = 0;
+        e->flags = 0;
+    }
+}
+
+
+/* ---- shmem-to-spill tiering ----
+ *
+ * When a log has both shmem and spill storage, the log offsets handed out
+ * by unifyfs_logio_alloc() name log chunks, and the data of each chunk may
+ * be stored in either tier. A tier map kept in the shmem header pages
+ * records the storage slot of each allocated chunk and the owner of each
+ * storage slot. Storage slots use the same numbering as log chunks (shmem
+ * slots first), and a chunk that has never moved is stored in the slot
+ * with its own index. While no chunk has moved, log offsets are used
+ * directly as storage offsets.
+ *
+ * The server periodically migrates cold shmem chunks to free spill slots
+ * (see unifyfs_logio_tier_migrate()). Once the server has enabled tiering
+ * for a log, new allocations prefer free shmem slots, so the shmem tier
+ * keeps holding the recently written data after the shmem chunk offsets
+ * are all in use. Tier map updates are done while holding the shmem log
+ * header lock.
+ *
+ * Log reads and writes resolve storage slots without the lock, so they
+ * register as readers of the tier map while they access storage. A slot
+ * vacated by a migration may still be accessed through its old mapping,
+ * so it is only freed by a later pass once the readers are done.
+ */
+
+/* storage slot owner values, other than a log chunk index */
+#define TIER_SLOT_FREE    (-1) /* slot holds no data */
+#define TIER_SLOT_BUSY    (-2) /* slot is the target of a migration copy */
+#define TIER_SLOT_VACATED (-3) /* data migrated away, free once readers of
+                                * the old mapping are done */
+
+/* state of a storage slot */
+typedef struct log_tier_slot {
+    int32_t  owner;     /* log chunk stored in slot, or TIER_SLOT_xxx */
+    uint32_t access;    /* time (in secs) of last access to slot data */
+    uint8_t  written;   /* set when slot data has been written */
+    uint8_t  migrating; /* set while slot data is copied to spill */
+    uint16_t drained;   /* reader counters seen empty since vacated */
+} log_tier_slot;
+
+/* tier map header, followed by:
+ *   int32_t       chunk_slot[max_chunks]; storage slot of each log chunk
+ *   log_tier_slot slots[max_chunks];      state of each storage slot */
+typedef struct log_tier {
+    size_t max_chunks;       /* capacity of the tables */
+    size_t n_mem;            /* number of shmem chunks */
+    size_t n_spill;          /* number of spill chunks */
+    size_t n_mem_used;       /* shmem slots not free */
+    size_t n_moved;          /* chunks not stored in their own slot */
+    size_t spill_cursor;     /* next spill slot to consider for migration */
+    volatile int enabled;    /* set once server starts tiering this log */
+    reader_epoch readers;    /* log accesses that may use a slot mapping */
+    logio_tier_stats stats;  /* tier usage counters */
+} log_tier;
+
+static inline size_t tier_map_size(size_t max_chunks)
+{
+    return sizeof(log_tier) +
+           (max_chunks * (sizeof(int32_t) + sizeof(log_tier_slot)));
+}
+
+static inline int32_t* tier_chunk_slots(log_tier* tier)
+{
+    return (int32_t*)((char*)tier + sizeof(log_tier));
+}
+
+static inline log_tier_slot* tier_slots(log_tier* tier)
+{
+    char* tables = (char*)tier + sizeof(log_tier);
+    return (log_tier_slot*)(tables + (tier->max_chunks * sizeof(int32_t)));
+}
+
+/* return the tier map of the log, or NULL if the log has no tiers */
+static inline log_tier* logio_get_tier(logio_context* ctx)
+{
+    if ((NULL == ctx->shmem) || (NULL == ctx->spill_hdr)) {
+        return NULL;
+    }
+    log_header* hdr = (log_header*) ctx->shmem->addr;
+    if (0 == hdr->tier_offset) {
+        return NULL;
+    }
+    return (log_tier*)((char*)hdr + hdr->tier_offset);
+}
+
+/* register as a reader of the tier map of the log (if any) while
+ * resolving and accessing storage, returns the ticket for tier_exit() */
+static inline unsigned long tier_enter(log_tier* tier)
+{
+    if (NULL == tier) {
+        return 0;
+    }
+    return reader_epoch_enter(&(tier->readers));
+}
+
+static inline void tier_exit(log_tier* tier, unsigned long ticket)
+{
+    if (NULL != tier) {
+        reader_epoch_exit(&(tier->readers), ticket);
+    }
+}
+
+static inline uint32_t tier_now(void)
+{
+    return (uint32_t) time(NULL);
+}
+
+/* return storage slot of log chunk */
+static inline size_t tier_chunk_to_slot(log_tier* tier, size_t chunk)
+{
+    int32_t slot = tier_chunk_slots(tier)[chunk];
+    if (slot < 0) {
+        return chunk;
+    }
+    return (size_t) slot;
+}
+
+/* set owner of storage slot, keeping the shmem usage count */
+static void tier_set_owner(log_tier* tier, size_t slot, int32_t owner)
+{
+    log_tier_slot* slots = tier_slots(tier);
+    if (slot < tier->n_mem) {
+        if ((TIER_SLOT_FREE == slots[slot].owner) &&
+            (TIER_SLOT_FREE != owner)) {
+            tier->n_mem_used++;
+        } else if ((TIER_SLOT_FREE != slots[slot].owner) &&
+                   (TIER_SLOT_FREE == owner)) {
+            tier->n_mem_used--;
+        }
+    }
+    slots[slot].owner = owner;
+}
+
+/* initialize tier map for given chunk counts */
+static void tier_init(log_tier* tier,
+                      size_t max_chunks,
+                      size_t n_mem,
+                      size_t n_spill)
+{
+    memset(tier, 0, sizeof(log_tier));
+    tier->max_chunks = max_chunks;
+    tier->n_mem = n_mem;
+    tier->n_spill = n_spill;
+
+    int32_t* chunk_slots = tier_chunk_slots(tier);
+    log_tier_slot* slots = tier_slots(tier);
+    for (size_t i = 0; i < max_chunks; i++) {
+        chunk_slots[i] = -1;
+        memset(slots + i, 0, sizeof(log_tier_slot));
+        slots[i].owner = TIER_SLOT_FREE;
+    }
+}
+
+/* find a free storage slot for a newly allocated log chunk */
+static ssize_t tier_find_slot(log_tier* tier, size_t chunk)
+{
+    log_tier_slot* slots = tier_slots(tier);
+    size_t n_total = tier->n_mem + tier->n_spill;
+    size_t i;
+
+    /* a shmem chunk's own slot */
+    if ((chunk < tier->n_mem) && (TIER_SLOT_FREE == slots[chunk].owner)) {
+        return (ssize_t) chunk;
+    }
+
+    /* any free shmem slot, when tiering */
+    if (tier->enabled && (tier->n_mem_used < tier->n_mem)) {
+        for (i = 0; i < tier->n_mem; i++) {
+            if (TIER_SLOT_FREE == slots[i].owner) {
+                return (ssize_t) i;
+            }
+        }
+    }
+
+    /* a spill chunk's own slot, else any free slot */
+    if ((chunk < n_total) && (TIER_SLOT_FREE == slots[chunk].owner)) {
+        return (ssize_t) chunk;
+    }
+    for (i = n_total; i > 0; i--) {
+        if (TIER_SLOT_FREE == slots[i - 1].owner) {
+            return (ssize_t)(i - 1);
+        }
+    }
+
+    /* vacated slots are not reused until the migration pass frees them,
+     * as readers may still be using the old copy */
+    return -1;
+}
+
+/* release storage slots of log chunks, caller holds shmem header lock */
+static void tier_release_locked(log_tier* tier,
+                                size_t first_chunk,
+                                size_t n_chunks)
+{
+    int32_t* chunk_slots = tier_chunk_slots(tier);
+    log_tier_slot* slots = tier_slots(tier);
+    for (size_t c = first_chunk; c < (first_chunk + n_chunks); c++) {
+        int32_t slot = chunk_slots[c];
+        if (slot < 0) {
+            continue;
+        }
+        chunk_slots[c] = -1;
+        if ((size_t)slot != c) {
+            tier->n_moved--;
+        }
+        if (slots[slot].owner == (int32_t)c) {
+            tier_set_owner(tier, (size_t)slot, TIER_SLOT_FREE);
+            slots[slot].written = 0;
+            slots[slot].migrating = 0;
+        }
+    }
+}
+
+/* assign storage slots to newly allocated log chunks */
+static int tier_assign(logio_context* ctx,
+                       log_tier* tier,
+                       off_t log_offset,
+                       size_t nbytes)
+{
+    log_header* shmem_hdr = (log_header*) ctx->shmem->addr;
+    size_t chunk_sz = shmem_hdr->chunk_sz;
+    size_t first_chunk = (size_t)log_offset / chunk_sz;
+    size_t n_chunks = bytes_to_chunks(nbytes, chunk_sz);
+    int32_t* chunk_slots = tier_chunk_slots(tier);
+    log_tier_slot* slots = tier_slots(tier);
+    uint32_t now = tier_now();
+
+    LOCK_LOG_HEADER(shmem_hdr);
+    for (size_t c = first_chunk; c < (first_chunk + n_chunks); c++) {
+        ssize_t slot = tier_find_slot(tier, c);
+        if (-1 == slot) {
+            LOGERR("no free storage slot for log chunk %zu", c);
+            tier_release_locked(tier, first_chunk, c - first_chunk);
+            UNLOCK_LOG_HEADER(shmem_hdr);
+            return ENOSPC;
+        }
+        tier_set_owner(tier, (size_t)slot, (int32_t)c);
+        slots[slot].written = 0;
+        slots[slot].migrating = 0;
+        slots[slot].access = now;
+        chunk_slots[c] = (int32_t) slot;
+        if ((size_t)slot != c) {
+            tier->n_moved++;
+        }
+    }
+    UNLOCK_LOG_HEADER(shmem_hdr);
+    return UNIFYFS_SUCCESS;
+}
+
+/* release storage slots of freed log chunks */
+static void tier_release(logio_context* ctx,
+                         log_tier* tier,
+                         off_t log_offset,
+                         size_t nbytes)
+{
+    log_header* shmem_hdr = (log_header*) ctx->shmem->addr;
+    size_t chunk_sz = shmem_hdr->chunk_sz;
+    size_t first_chunk = (size_t)log_offset / chunk_sz;
+    size_t last_chunk = ((size_t)log_offset + nbytes - 1) / chunk_sz;
+
+    LOCK_LOG_HEADER(shmem_hdr);
+    tier_release_locked(tier, first_chunk, (last_chunk - first_chunk) + 1);
+    UNLOCK_LOG_HEADER(shmem_hdr);
+}
+
+/* record an access to storage, where sz_in_mem bytes of the range
+ * starting at storage offset are in shmem */
+static void tier_note_access(log_tier* tier,
+                             size_t chunk_sz,
+                             off_t offset,
+                             size_t sz_in_mem,
+                             size_t sz_in_spill,
+                             int is_write)
+{
+    if (is_write) {
+        __sync_fetch_and_add(&(tier->stats.mem_write_bytes), sz_in_mem);
+        __sync_fetch_and_add(&(tier->stats.spill_write_bytes), sz_in_spill);
+    } else {
+        __sync_fetch_and_add(&(tier->stats.mem_read_bytes), sz_in_mem);
+        __sync_fetch_and_add(&(tier->stats.spill_read_bytes), sz_in_spill);
+    }
+
+    if (sz_in_mem > 0) {
+        log_tier_slot* slots = tier_slots(tier);
+        uint32_t now = tier_now();
+        size_t first = (size_t)offset / chunk_sz;
+        size_t last = ((size_t)offset + sz_in_mem - 1) / chunk_sz;
+        for (size_t i = first; i <= last; i++) {
+            slots[i].access = now;
+            if (is_write) {
+                slots[i].written = 1;
+            }
+        }
+    }
+}
+
+static int logio_transferv(logio_context* ctx,
+                           const int n_iov,
+                           logio_iovec* iov,
+                           int is_write);
+
+/* Transfer log ranges of a log with moved chunks. Each range is split
+ * into pieces that are contiguous in storage. */
+static int tier_transferv(logio_context* ctx,
+                          log_tier* tier,
+                          const int n_iov,
+                          logio_iovec* iov,
+                          int is_write)
+{
+    log_header* shmem_hdr = (log_header*) ctx->shmem->addr;
+    size_t chunk_sz = shmem_hdr->chunk_sz;
+
+    /* each range needs at most one piece per chunk it touches */
+    size_t max_pieces = 0;
+    int i;
+    for (i = 0; i < n_iov; i++) {
+        if (iov[i].nbytes > 0) {
+            size_t first = (size_t)iov[i].log_offset / chunk_sz;
+            size_t last = ((size_t)iov[i].log_offset + iov[i].nbytes - 1) /
+                          chunk_sz;
+            max_pieces += (last - first) + 1;
+        }
+    }
+    if (0 == max_pieces) {
+        return logio_transferv(ctx, n_iov, iov, is_write);
+    }
+
+    logio_iovec* pieces = (logio_iovec*) calloc(max_pieces, sizeof(*pieces));
+    int* piece_iov = (int*) calloc(max_pieces, sizeof(int));
+    if ((NULL == pieces) || (NULL == piece_iov)) {
+        LOGERR("failed to allocate tier pieces");
+        free(pieces);
+        free(piece_iov);
+        return ENOMEM;
+    }
+
+    int n_pieces = 0;
+    for (i = 0; i < n_iov; i++) {
+        logio_iovec* v = iov + i;
+        size_t done = 0;
+        while (done < v->nbytes) {
+            size_t log_off = (size_t)v->log_offset + done;
+            size_t chunk = log_off / chunk_sz;
+            size_t in_chunk = log_off % chunk_sz;
+            size_t len = chunk_sz - in_chunk;
+            if (len > (v->nbytes - done)) {
+                len = v->nbytes - done;
+            }
+            size_t slot = tier_chunk_to_slot(tier, chunk);
+            off_t storage_off = (off_t)((slot * chunk_sz) + in_chunk);
+
+            logio_iovec* prev = NULL;
+            if ((n_pieces > 0) && (piece_iov[n_pieces - 1] == i)) {
+                prev = pieces + (n_pieces - 1);
+            }
+            if ((NULL != prev) &&
+                ((prev->log_offset + (off_t)prev->nbytes) == storage_off)) {
+                prev->nbytes += len;
+            } else {
+                logio_iovec* p = pieces + n_pieces;
+                p->log_offset = storage_off;
+                p->nbytes = len;
+                p->buf = v->buf + done;
+                piece_iov[n_pieces] = i;
+                n_pieces++;
+            }
+            done += len;
+        }
+    }
+
+    logio_transferv(ctx, n_pieces, pieces, is_write);
+
+    /* gather the piece results for each range */
+    for (i = 0; i < n_iov; i++) {
+        iov[i].obytes = 0;
+        iov[i].rc = UNIFYFS_SUCCESS;
+    }
+    for (int j = 0; j < n_pieces; j++) {
+        logio_iovec* v = iov + piece_iov[j];
+        v->obytes += pieces[j].obytes;
+        if ((pieces[j].rc != UNIFYFS_SUCCESS) &&
+            (v->rc == UNIFYFS_SUCCESS)) {
+            v->rc = pieces[j].rc;
+        }
+    }
+    free(pieces);
+    free(piece_iov);
+
+    int ret = UNIFYFS_SUCCESS;
+    for (i = 0; i < n_iov; i++) {
+        logio_iovec* v = iov + i;
+        if (v->obytes > 0) {
+            v->rc = UNIFYFS_SUCCESS;
+        } else if ((v->rc != UNIFYFS_SUCCESS) && (ret == UNIFYFS_SUCCESS)) {
+            ret = v->rc;
+        }
+    }
+    return ret;
+}
+
+
 /* Initialize logio context for server */
 int unifyfs_logio_init(const int app_id,
                        const int client_id,
@@ -219,6 +1388,11 @@ int unifyfs_logio_init(const int app_id,
         hdr = (log_header*) shm_ctx->addr;
         LOGDBG("shmem header - hdr_sz=%zu, data_sz=%zu, data_offset=%zu",
                hdr->hdr_sz, hdr->data_sz, hdr->data_offset);
+
+        /* use huge pages in our mapping of the client region, too */
+        if (hdr->shmem_flags & SHMEM_HUGEPAGES) {
+            unifyfs_shm_use_hugepages(shm_ctx);
+        }
     }
 
     char spillfile[UNIFYFS_MAX_FILENAME];
@@ -263,6 +1437,16 @@ int unifyfs_logio_init(const int app_id,
     ctx->spill_sz = spill_size;
     if (spill_size) {
         ctx->spill_file = strdup(spillfile);
+        log_header* spill_hdr = (log_header*) spill_mapping;
+        if (spill_hdr->zmap_offset) {
+            ctx->spill_z = zspill_init(spill_hdr, spill_fd);
+            if (NULL == ctx->spill_z) {
+                free(ctx->spill_file);
+                free(ctx);
+                *pctx = NULL;
+                return ENOMEM;
+            }
+        }
     }
     *pctx = ctx;
     LOGDBG("logio_context for client [%d:%d] - "
@@ -273,11 +1457,16 @@ int unifyfs_logio_init(const int app_id,
 }
 
 
-/* initialize the log header page for given log region and size
+/* initialize the log header page for given log region and size. When
+ * tier_chunks is non-zero, a tier map for the region's chunks plus that
+ * many spill chunks is placed at the end of the header pages. Otherwise,
+ * when compress is set, the compressed chunk map is placed there
  * (note: intended for client use only) */
 static int init_log_header(char* log_region,
                            size_t region_size,
-                           size_t chunk_size)
+                           size_t chunk_size,
+                           size_t tier_chunks,
+                           int compress)
 {
     size_t pgsz = get_page_size();
 
@@ -293,10 +1482,24 @@ static int init_log_header(char* log_region,
     /* chunk slot map immediately follows header */
     char* slotmap = log_region + sizeof(log_header);
 
+    /* size the tier map for the most chunks the region could hold */
+    size_t tier_max = 0;
+    size_t tier_sz = 0;
+    size_t zmap_max = 0;
+    if (tier_chunks) {
+        tier_max = (region_size / chunk_size) + tier_chunks;
+        tier_sz = tier_map_size(tier_max);
+    } else if (compress) {
+        zmap_max = region_size / chunk_size;
+        tier_sz = zmap_size(zmap_max);
+    }
+
     /* determine number of pages necessary to hold chunkmap */
     size_t hdr_pages = 1;
     size_t hdr_size = 0;
     size_t data_size = 0;
+    size_t tier_offset = 0;
+    size_t n_chunks = 0;
     while (1) {
         hdr_size = (hdr_pages * pgsz);
         if (hdr_size >= region_size) {
@@ -305,12 +1508,23 @@ static int init_log_header(char* log_region,
             return UNIFYFS_FAILURE;
         }
 
+        /* tier map occupies the end of the header pages */
+        size_t map_end = hdr_size;
+        if (tier_sz) {
+            if ((tier_sz + sizeof(log_header)) >= hdr_size) {
+                hdr_pages++;
+                continue;
+            }
+            tier_offset = (hdr_size - tier_sz) & ~((size_t)7);
+            map_end = tier_offset;
+        }
+
         /* chunk data starts after header pages */
         size_t data_space = region_size - hdr_size;
-        size_t n_chunks = data_space / chunk_size;
+        n_chunks = data_space / chunk_size;
 
         /* try to init chunk slotmap */
-        size_t slotmap_size = hdr_size - sizeof(log_header);
+        size_t slotmap_size = map_end - sizeof(log_header);
         slot_map* chunkmap = slotmap_init(n_chunks, slotmap, slotmap_size);
         if (NULL == chunkmap) {
             LOGDBG("chunk slotmap init failed (sz=%zu, #chunks=%zu)",
@@ -329,6 +1543,16 @@ static int init_log_header(char* log_region,
     hdr->data_sz = data_size;
     hdr->data_offset = (off_t)hdr_size;
 
+    if (tier_max) {
+        log_tier* tier = (log_tier*)(log_region + tier_offset);
+        tier_init(tier, tier_max, n_chunks, tier_chunks);
+        hdr->tier_offset = tier_offset;
+    } else if (zmap_max) {
+        log_zmap* zmap = (log_zmap*)(log_region + tier_offset);
+        zmap_init(zmap, n_chunks);
+        hdr->zmap_offset = tier_offset;
+    }
+
     return UNIFYFS_SUCCESS;
 }
 
@@ -368,13 +1592,60 @@ int unifyfs_logio_init_client(const int app_id,
         }
     }
 
+    /* will we use spillover to store the files? */
+    size_t spill_size = 0;
+    cfgval = client_cfg->logio_spill_size;
+    if (cfgval != NULL) {
+        long l;
+        rc = configurator_int_val(cfgval, &l);
+        if (rc == 0) {
+            spill_size = (size_t)l;
+        }
+    }
+
+    /* compress spillover data? */
+    bool spill_compress = false;
+    cfgval = client_cfg->logio_spill_compress;
+    if ((cfgval != NULL) && spill_size) {
+        rc = configurator_bool_val(cfgval, &spill_compress);
+        if (rc != 0) {
+            spill_compress = false;
+        }
+    }
+
+    /* with both shmem and spill, the shmem header holds a tier map
+     * covering the spill chunks. Compressed spill chunks are not
+     * used as migration targets, so there is no tier map with them. */
+    size_t tier_chunks = 0;
+    if (memlog_size && spill_size && !spill_compress) {
+        tier_chunks = spill_size / chunk_size;
+    }
+
+    /* shmem placement options */
+    int shm_flags = 0;
+    bool b;
+    cfgval = client_cfg->logio_shmem_hugepages;
+    if (cfgval != NULL) {
+        rc = configurator_bool_val(cfgval, &b);
+        if ((rc == 0) && b) {
+            shm_flags |= SHMEM_HUGEPAGES;
+        }
+    }
+    cfgval = client_cfg->logio_shmem_numa_local;
+    if (cfgval != NULL) {
+        rc = configurator_bool_val(cfgval, &b);
+        if ((rc == 0) && b) {
+            shm_flags |= SHMEM_NUMA_LOCAL;
+        }
+    }
+
     shm_context* shm_ctx = NULL;
     if (memlog_size) {
         /* allocate logio shared memory buffer */
         char shm_name[SHMEM_NAME_LEN] = {0};
         snprintf(shm_name, sizeof(shm_name), LOGIO_SHMEM_FMTSTR,
                  app_id, client_id);
-        shm_ctx = unifyfs_shm_alloc(shm_name, memlog_size);
+        shm_ctx = unifyfs_shm_alloc_flags(shm_name, memlog_size, shm_flags);
         if (NULL == shm_ctx) {
             LOGERR("Failed to create logio shmem buffer!");
             return UNIFYFS_ERROR_SHMEM;
@@ -382,31 +1653,48 @@ int unifyfs_logio_init_client(const int app_id,
 
         /* initialize shmem log header */
         char* memlog = (char*) shm_ctx->addr;
-        rc = init_log_header(memlog, memlog_size, chunk_size);
+        rc = init_log_header(memlog, memlog_size, chunk_size,
+                             tier_chunks, 0);
         if (rc != UNIFYFS_SUCCESS) {
             LOGERR("Failed to initialize shmem logio header");
             return rc;
         }
         log_header* hdr = (log_header*) memlog;
+        hdr->shmem_flags = shm_ctx->flags;
         LOGDBG("shmem header - hdr_sz=%zu, data_sz=%zu, data_offset=%zu",
                hdr->hdr_sz, hdr->data_sz, hdr->data_offset);
     }
 
-    /* will we use spillover to store the files? */
-    size_t spill_size = 0;
-    cfgval = client_cfg->logio_spill_size;
+    int unifyfs_use_spillover = 0;
+    if (spill_size > 0) {
+        LOGDBG("using spillover - size = %zu B", spill_size);
+        unifyfs_use_spillover = 1;
+    }
+
+    /* write spillover data with O_DIRECT? */
+    bool spill_direct = false;
+    cfgval = client_cfg->logio_spill_direct;
+    if (cfgval != NULL) {
+        rc = configurator_bool_val(cfgval, &spill_direct);
+        if (rc != 0) {
+            spill_direct = false;
+        }
+    }
+    if (spill_direct && spill_compress) {
+        LOGWARN("logio.spill_direct is not used with logio.spill_compress");
+        spill_direct = false;
+    }
+    size_t stage_size = UNIFYFS_LOGIO_SPILL_STAGE_SIZE;
+    cfgval = client_cfg->logio_spill_stage_size;
     if (cfgval != NULL) {
         long l;
         rc = configurator_int_val(cfgval, &l);
-        if (rc == 0) {
-            spill_size = (size_t)l;
+        if ((rc == 0) && (l > 0)) {
+            stage_size = (size_t)l;
         }
     }
-    int unifyfs_use_spillover = 0;
-    if (spill_size > 0) {
-        LOGDBG("using spillover - size = %zu B", spill_size);
-        unifyfs_use_spillover = 1;
-    }
+    struct logio_direct* direct = NULL;
+    struct logio_zspill* zspill = NULL;
 
     void* spill_mapping = NULL;
     int spill_fd = -1;
@@ -424,18 +1712,28 @@ int unifyfs_logio_init_client(const int app_id,
         snprintf(spillfile, sizeof(spillfile), LOGIO_SPILL_FMTSTR,
                  cfgval, app_id, client_id);
 
+        /* a compressed spill file is sparse, and its chunk slots can
+         * cover more than the spill size */
+        size_t spill_file_size = spill_size;
+        if (spill_compress) {
+            spill_file_size *= UNIFYFS_LOGIO_COMPRESS_RATIO;
+        }
+
         /* create the spill-over file */
-        spill_fd = get_spillfile(spillfile, spill_size);
+        spill_fd = get_spillfile(spillfile, spill_file_size);
         if (spill_fd < 0) {
             LOGERR("Failed to open logio spill file!");
             return UNIFYFS_FAILURE;
         } else {
             /* estimate header size based on number of chunks */
             size_t pgsz = get_page_size();
-            size_t n_chunks = spill_size / chunk_size;
+            size_t n_chunks = spill_file_size / chunk_size;
             size_t chunks_per_page = pgsz * 8; /* 8 chunks per map byte */
             size_t n_pages = n_chunks / chunks_per_page;
             n_pages++; /* +1 to account for logio metadata */
+            if (spill_compress) {
+                n_pages += (zmap_size(n_chunks) / pgsz) + 1;
+            }
 
             /* map start of the spill-over file, which contains log header
              * and chunk slot_map. client needs read and write access. */
@@ -448,7 +1746,8 @@ int unifyfs_logio_init_client(const int app_id,
 
             /* initialize spill log header */
             char* spill = (char*) spill_mapping;
-            rc = init_log_header(spill, spill_size, chunk_size);
+            rc = init_log_header(spill, spill_file_size, chunk_size,
+                                 0, (int)spill_compress);
             if (rc != UNIFYFS_SUCCESS) {
                 LOGERR("Failed to initialize spill logio header");
                 return rc;
@@ -456,6 +1755,35 @@ int unifyfs_logio_init_client(const int app_id,
             log_header* hdr = (log_header*) spill;
             LOGDBG("spill header - hdr_sz=%zu, data_sz=%zu, data_offset=%zu",
                    hdr->hdr_sz, hdr->data_sz, hdr->data_offset);
+
+            if (NULL != shm_ctx) {
+                /* set the tier map spill chunk count, which depends on
+                 * the spill header size */
+                log_header* mem_hdr = (log_header*) shm_ctx->addr;
+                if (mem_hdr->tier_offset) {
+                    log_tier* tier = (log_tier*)((char*)mem_hdr +
+                                                 mem_hdr->tier_offset);
+                    tier->n_spill = hdr->data_sz / chunk_size;
+                }
+            }
+
+            if (spill_direct) {
+                direct = direct_init(spillfile, chunk_size,
+                                     hdr->data_offset, stage_size);
+            }
+
+            if (hdr->zmap_offset) {
+                /* chunk space is limited to the configured spill size */
+                log_zmap* zmap = (log_zmap*)(spill + hdr->zmap_offset);
+                zmap->space = 0;
+                if (spill_size > hdr->hdr_sz) {
+                    zmap->space = spill_size - hdr->hdr_sz;
+                }
+                zspill = zspill_init(hdr, spill_fd);
+                if (NULL == zspill) {
+                    return ENOMEM;
+                }
+            }
         }
     }
 
@@ -468,6 +1796,8 @@ int unifyfs_logio_init_client(const int app_id,
     ctx->spill_hdr = spill_mapping;
     ctx->spill_fd = spill_fd;
     ctx->spill_sz = spill_size;
+    ctx->spill_direct = direct;
+    ctx->spill_z = zspill;
     *pctx = ctx;
 
     return UNIFYFS_SUCCESS;
@@ -494,6 +1824,15 @@ int unifyfs_logio_close(logio_context* ctx,
     }
 
     if (ctx->spill_sz) {
+        if (NULL != ctx->spill_direct) {
+            /* write out staged data and stop the write-behind thread */
+            direct_fini(ctx->spill_direct);
+            ctx->spill_direct = NULL;
+        }
+        if (NULL != ctx->spill_z) {
+            zspill_fini(ctx->spill_z);
+            ctx->spill_z = NULL;
+        }
         if (NULL != ctx->spill_hdr) {
             /* unmap log header page */
             rc = munmap(ctx->spill_hdr, get_page_size());
@@ -531,10 +1870,40 @@ int unifyfs_logio_close(logio_context* ctx,
     return UNIFYFS_SUCCESS;
 }
 
-/* Allocate write space from logio context */
-int unifyfs_logio_alloc(logio_context* ctx,
-                        const size_t nbytes,
-                        off_t* log_offset)
+/* reserve spill chunks, which also takes their space when spill chunks
+ * are compressed. Caller holds spill header lock. */
+static ssize_t spill_reserve(logio_context* ctx,
+                             slot_map* chunkmap,
+                             size_t n_chunks)
+{
+    ssize_t slot = slotmap_reserve(chunkmap, n_chunks);
+    if ((-1 != slot) && (NULL != ctx->spill_z)) {
+        int rc = zspill_reserve(ctx->spill_z, (size_t)slot, n_chunks);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGDBG("no spill space for %zu compressed chunks", n_chunks);
+            slotmap_release(chunkmap, (size_t)slot, n_chunks);
+            return -1;
+        }
+    }
+    return slot;
+}
+
+/* release spill chunks, caller holds spill header lock */
+static int spill_release(logio_context* ctx,
+                         slot_map* chunkmap,
+                         size_t slot,
+                         size_t n_chunks)
+{
+    if (NULL != ctx->spill_z) {
+        zspill_release(ctx->spill_z, slot, n_chunks);
+    }
+    return slotmap_release(chunkmap, slot, n_chunks);
+}
+
+/* Reserve log chunks for write space from logio context */
+static int logio_reserve(logio_context* ctx,
+                         const size_t nbytes,
+                         off_t* log_offset)
 {
     if ((NULL == ctx) ||
         ((nbytes > 0) && (NULL == log_offset))) {
@@ -628,7 +1997,7 @@ int unifyfs_logio_alloc(logio_context* ctx,
 
         /* reserve the rest of the chunks from spill file */
         res_chunks = needed_chunks;
-        res_slot = slotmap_reserve(chunkmap, res_chunks);
+        res_slot = spill_reserve(ctx, chunkmap, res_chunks);
         if (-1 != res_slot) {
             allocated_bytes = res_chunks * chunk_sz;
             if (0 == mem_res_at_end) {
@@ -650,7 +2019,8 @@ int unifyfs_logio_alloc(logio_context* ctx,
                      * and try to get the full allocation from spill */
 
                     /* release the spill chunks we just got */
-                    int rc = slotmap_release(chunkmap, res_slot, res_chunks);
+                    int rc = spill_release(ctx, chunkmap, res_slot,
+                                           res_chunks);
                     if (rc != UNIFYFS_SUCCESS) {
                         LOGERR("slotmap_release() for logio shmem failed");
                     }
@@ -670,7 +2040,7 @@ int unifyfs_logio_alloc(logio_context* ctx,
                     chunkmap = log_header_to_chunkmap(spill_hdr);
                     needed_chunks = bytes_to_chunks(nbytes, chunk_sz);
                     res_chunks = needed_chunks;
-                    res_slot = slotmap_reserve(chunkmap, res_chunks);
+                    res_slot = spill_reserve(ctx, chunkmap, res_chunks);
                     if (-1 != res_slot) {
                         /* success, full reservation in spill */
                         allocated_bytes = res_chunks * chunk_sz;
@@ -713,10 +2083,34 @@ int unifyfs_logio_alloc(logio_context* ctx,
     return ENOSPC;
 }
 
-/* Release previously allocated write space from logio context */
-int unifyfs_logio_free(logio_context* ctx,
-                       const off_t log_offset,
-                       const size_t nbytes)
+/* Allocate write space from logio context */
+int unifyfs_logio_alloc(logio_context* ctx,
+                        const size_t nbytes,
+                        off_t* log_offset)
+{
+    int rc = logio_reserve(ctx, nbytes, log_offset);
+    if ((rc == UNIFYFS_SUCCESS) && (nbytes > 0)) {
+        log_tier* tier = logio_get_tier(ctx);
+        if (NULL != tier) {
+            /* pick storage for the reserved chunks */
+            rc = tier_assign(ctx, tier, *log_offset, nbytes);
+            if (rc != UNIFYFS_SUCCESS) {
+                unifyfs_logio_free(ctx, *log_offset, nbytes);
+            }
+        }
+    }
+    if (rc == UNIFYFS_SUCCESS) {
+        unifyfs_stats_add(UNIFYFS_STAT_LOGIO_ALLOC_BYTES, (int64_t)nbytes);
+    } else {
+        unifyfs_stats_add(UNIFYFS_STAT_LOGIO_ALLOC_FAIL, 1);
+    }
+    return rc;
+}
+
+/* Release log chunks of previously reserved write space */
+static int logio_release(logio_context* ctx,
+                         const off_t log_offset,
+                         const size_t nbytes)
 {
     if (NULL == ctx) {
         return EINVAL;
@@ -773,7 +2167,7 @@ int unifyfs_logio_free(logio_context* ctx,
         num_chunks = bytes_to_chunks(sz_in_spill, chunk_sz);
         released_bytes = chunk_sz * num_chunks;
         chunkmap = log_header_to_chunkmap(spill_hdr);
-        rc = slotmap_release(chunkmap, chunk_slot, num_chunks);
+        rc = spill_release(ctx, chunkmap, chunk_slot, num_chunks);
         if (rc != UNIFYFS_SUCCESS) {
             LOGERR("slotmap_release() for logio spill failed");
         }
@@ -783,6 +2177,28 @@ int unifyfs_logio_free(logio_context* ctx,
     return rc;
 }
 
+/* Release previously allocated write space from logio context */
+int unifyfs_logio_free(logio_context* ctx,
+                       const off_t log_offset,
+                       const size_t nbytes)
+{
+    if (NULL == ctx) {
+        return EINVAL;
+    }
+
+    log_tier* tier = logio_get_tier(ctx);
+    if ((NULL != tier) && (nbytes > 0)) {
+        if (NULL != ctx->spill_direct) {
+            /* freed spill slots may be reused by server migrations, so
+             * staged data for them must be written first */
+            direct_flush(ctx->spill_direct);
+        }
+        tier_release(ctx, tier, log_offset, nbytes);
+    }
+    unifyfs_stats_add(UNIFYFS_STAT_LOGIO_FREE_BYTES, (int64_t)nbytes);
+    return logio_release(ctx, log_offset, nbytes);
+}
+
 /* Read data from logio context */
 int unifyfs_logio_read(logio_context* ctx,
                        const off_t log_offset,
@@ -811,6 +2227,27 @@ int unifyfs_logio_read(logio_context* ctx,
         mem_size = (off_t) shmem_hdr->data_sz;
     }
 
+    log_tier* tier = logio_get_tier(ctx);
+    unsigned long ticket = tier_enter(tier);
+    if ((NULL != tier) && (tier->n_moved > 0)) {
+        /* some chunks are not stored at their log offset */
+        logio_iovec v = {
+            .log_offset = log_offset,
+            .nbytes = nbytes,
+            .buf = obuf
+        };
+        int rc = tier_transferv(ctx, tier, 1, &v, 0);
+        tier_exit(tier, ticket);
+        if (rc == UNIFYFS_SUCCESS) {
+            unifyfs_stats_add(UNIFYFS_STAT_LOGIO_READ_BYTES,
+                              (int64_t)v.obytes);
+            if (NULL != obytes) {
+                *obytes = v.obytes;
+            }
+        }
+        return rc;
+    }
+
     /* prepare read operations based on log offset */
     size_t nread = 0;
     size_t sz_in_mem = 0;
@@ -834,9 +2271,20 @@ int unifyfs_logio_read(logio_context* ctx,
         log_header* spill_hdr = (log_header*) ctx->spill_hdr;
         spill_offset += spill_hdr->data_offset;
 
+        if (NULL != ctx->spill_direct) {
+            /* make sure staged data for this range is in the file */
+            direct_flush_range(ctx->spill_direct, spill_offset, sz_in_spill);
+        }
+
         /* read data from spillover file */
-        ssize_t rc = pread(ctx->spill_fd, (obuf + sz_in_mem),
-                           sz_in_spill, spill_offset);
+        ssize_t rc;
+        if (NULL != ctx->spill_z) {
+            rc = zspill_pread(ctx->spill_z, (obuf + sz_in_mem),
+                              sz_in_spill, spill_offset);
+        } else {
+            rc = pread(ctx->spill_fd, (obuf + sz_in_mem),
+                       sz_in_spill, spill_offset);
+        }
         if (-1 == rc) {
             err_rc = errno;
             LOGERR("pread(spillfile) failed: %s", strerror(err_rc));
@@ -845,10 +2293,17 @@ int unifyfs_logio_read(logio_context* ctx,
         }
     }
 
+    if (NULL != tier) {
+        tier_note_access(tier, shmem_hdr->chunk_sz, log_offset,
+                         sz_in_mem, sz_in_spill, 0);
+    }
+    tier_exit(tier, ticket);
+
     if (nread) {
         if (nread != nbytes) {
             LOGDBG("partial log read: %zu of %zu bytes", nread, nbytes);
         }
+        unifyfs_stats_add(UNIFYFS_STAT_LOGIO_READ_BYTES, (int64_t)nread);
         if (NULL != obytes) {
             *obytes = nread;
         }
@@ -886,6 +2341,27 @@ int unifyfs_logio_write(logio_context* ctx,
         mem_size = (off_t) shmem_hdr->data_sz;
     }
 
+    log_tier* tier = logio_get_tier(ctx);
+    unsigned long ticket = tier_enter(tier);
+    if ((NULL != tier) && (tier->n_moved > 0)) {
+        /* some chunks are not stored at their log offset */
+        logio_iovec v = {
+            .log_offset = log_offset,
+            .nbytes = nbytes,
+            .buf = (char*) ibuf
+        };
+        int rc = tier_transferv(ctx, tier, 1, &v, 1);
+        tier_exit(tier, ticket);
+        if (rc == UNIFYFS_SUCCESS) {
+            unifyfs_stats_add(UNIFYFS_STAT_LOGIO_WRITE_BYTES,
+                              (int64_t)v.obytes);
+            if (NULL != obytes) {
+                *obytes = v.obytes;
+            }
+        }
+        return rc;
+    }
+
     /* prepare write operations based on log offset */
     size_t nwrite = 0;
     size_t sz_in_mem = 0;
@@ -910,8 +2386,19 @@ int unifyfs_logio_write(logio_context* ctx,
         spill_offset += spill_hdr->data_offset;
 
         /* write data to spillover file */
-        ssize_t rc = pwrite(ctx->spill_fd, (ibuf + sz_in_mem),
-                            sz_in_spill, spill_offset);
+        ssize_t rc;
+        if (NULL != ctx->spill_direct) {
+            /* stage the data for a write-behind O_DIRECT write */
+            direct_stage_write(ctx->spill_direct, spill_offset,
+                               (ibuf + sz_in_mem), sz_in_spill);
+            rc = (ssize_t) sz_in_spill;
+        } else if (NULL != ctx->spill_z) {
+            rc = zspill_pwrite(ctx->spill_z, (ibuf + sz_in_mem),
+                               sz_in_spill, spill_offset);
+        } else {
+            rc = pwrite(ctx->spill_fd, (ibuf + sz_in_mem),
+                        sz_in_spill, spill_offset);
+        }
         if (-1 == rc) {
             err_rc = errno;
             LOGERR("pwrite(spillfile) failed: %s", strerror(err_rc));
@@ -920,11 +2407,18 @@ int unifyfs_logio_write(logio_context* ctx,
         }
     }
 
+    if (NULL != tier) {
+        tier_note_access(tier, shmem_hdr->chunk_sz, log_offset,
+                         sz_in_mem, sz_in_spill, 1);
+    }
+    tier_exit(tier, ticket);
+
     /* update output parameter if we wrote anything */
     if (nwrite) {
         if (nwrite != nbytes) {
             LOGDBG("partial log write: %zu of %zu bytes", nwrite, nbytes);
         }
+        unifyfs_stats_add(UNIFYFS_STAT_LOGIO_WRITE_BYTES, (int64_t)nwrite);
 
         if (NULL != obytes) {
             /* obytes is set to the number of bytes actually written */
@@ -936,9 +2430,320 @@ int unifyfs_logio_write(logio_context* ctx,
     }
 }
 
+/* part of a vectored I/O range that lives in the spillover file */
+typedef struct spill_piece {
+    off_t  offset;  /* spill file offset */
+    size_t nbytes;  /* number of bytes */
+    char*  buf;     /* data buffer for this piece */
+    int    iov_ndx; /* index of the range this piece belongs to */
+} spill_piece;
+
+static int compare_spill_piece(const void* a, const void* b)
+{
+    const spill_piece* pa = (const spill_piece*) a;
+    const spill_piece* pb = (const spill_piece*) b;
+    if (pa->offset < pb->offset) {
+        return -1;
+    } else if (pa->offset > pb->offset) {
+        return 1;
+    }
+    return 0;
+}
+
+/* transfer a run of contiguous spill pieces to or from compressed
+ * chunks, returns bytes transferred like preadv()/pwritev() */
+static ssize_t zspill_transfer_run(logio_zspill* z,
+                                   spill_piece* pieces,
+                                   int n_pieces,
+                                   int is_write)
+{
+    size_t done = 0;
+    for (int i = 0; i < n_pieces; i++) {
+        ssize_t rc;
+        if (is_write) {
+            rc = zspill_pwrite(z, pieces[i].buf, pieces[i].nbytes,
+                               pieces[i].offset);
+        } else {
+            rc = zspill_pread(z, pieces[i].buf, pieces[i].nbytes,
+                              pieces[i].offset);
+        }
+        if (-1 == rc) {
+            return (done > 0) ? (ssize_t)done : -1;
+        }
+        done += (size_t) rc;
+        if ((size_t)rc != pieces[i].nbytes) {
+            break;
+        }
+    }
+    return (ssize_t) done;
+}
+
+/* Transfer data between buffers and a logio context for many ranges,
+ * where log offsets are storage offsets (see tier_transferv() for logs
+ * with moved chunks). Shared memory data is copied directly. Spill pieces are sorted by
+ * file offset, and each run of contiguous pieces is transferred with a
+ * single preadv() or pwritev() */
+static int logio_transferv(logio_context* ctx,
+                           const int n_iov,
+                           logio_iovec* iov,
+                           int is_write)
+{
+    if ((NULL == ctx) || (n_iov < 0) ||
+        ((n_iov > 0) && (NULL == iov))) {
+        return EINVAL;
+    }
+
+    log_header* shmem_hdr = NULL;
+    char* shmem_data = NULL;
+    off_t mem_size = 0;
+    if (NULL != ctx->shmem) {
+        shmem_hdr = (log_header*) ctx->shmem->addr;
+        shmem_data = (char*)(ctx->shmem->addr) + shmem_hdr->data_offset;
+        mem_size = (off_t) shmem_hdr->data_sz;
+    }
+
+    off_t spill_data_offset = 0;
+    if (NULL != ctx->spill_hdr) {
+        log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+        spill_data_offset = spill_hdr->data_offset;
+    }
+
+    log_tier* tier = logio_get_tier(ctx);
+
+    /* copy shared memory data, and gather the spill pieces */
+    spill_piece* pieces = NULL;
+    int n_pieces = 0;
+    int i;
+    for (i = 0; i < n_iov; i++) {
+        logio_iovec* v = iov + i;
+        v->obytes = 0;
+        v->rc = UNIFYFS_SUCCESS;
+        if ((v->nbytes > 0) && (NULL == v->buf)) {
+            v->rc = EINVAL;
+            continue;
+        }
+
+        size_t sz_in_mem = 0;
+        size_t sz_in_spill = 0;
+        off_t spill_offset = 0;
+        get_log_sizes(v->log_offset, v->nbytes, mem_size,
+                      &sz_in_mem, &sz_in_spill, &spill_offset);
+        if (NULL != tier) {
+            tier_note_access(tier, shmem_hdr->chunk_sz, v->log_offset,
+                             sz_in_mem, sz_in_spill, is_write);
+        }
+
+        if (sz_in_mem > 0) {
+            char* log_ptr = shmem_data + v->log_offset;
+            if (is_write) {
+                memcpy(log_ptr, v->buf, sz_in_mem);
+            } else {
+                memcpy(v->buf, log_ptr, sz_in_mem);
+            }
+            v->obytes += sz_in_mem;
+        }
+        if (sz_in_spill > 0) {
+            if (NULL == pieces) {
+                pieces = (spill_piece*) calloc(n_iov - i, sizeof(*pieces));
+                if (NULL == pieces) {
+                    LOGERR("failed to allocate spill pieces");
+                    v->rc = ENOMEM;
+                    continue;
+                }
+            }
+            spill_piece* p = pieces + n_pieces;
+            n_pieces++;
+            p->offset  = spill_offset + spill_data_offset;
+            p->nbytes  = sz_in_spill;
+            p->buf     = v->buf + sz_in_mem;
+            p->iov_ndx = i;
+        }
+    }
+
+    if (n_pieces > 0) {
+        qsort(pieces, (size_t) n_pieces, sizeof(*pieces),
+              compare_spill_piece);
+
+        int max_run = IOV_MAX;
+        if (n_pieces < max_run) {
+            max_run = n_pieces;
+        }
+        struct iovec* vec = calloc(max_run, sizeof(*vec));
+        if (NULL == vec) {
+            LOGERR("failed to allocate spill iovec");
+            for (i = 0; i < n_pieces; i++) {
+                iov[pieces[i].iov_ndx].rc = ENOMEM;
+            }
+            n_pieces = 0;
+        }
+
+        int run_start = 0;
+        while (run_start < n_pieces) {
+            /* find run of pieces that are contiguous in the spill file */
+            size_t run_bytes = pieces[run_start].nbytes;
+            int run_end = run_start + 1;
+            while ((run_end < n_pieces) &&
+                   ((run_end - run_start) < max_run) &&
+                   (pieces[run_end].offset ==
+                    (pieces[run_end - 1].offset +
+                     (off_t)pieces[run_end - 1].nbytes))) {
+                run_bytes += pieces[run_end].nbytes;
+                run_end++;
+            }
+            int run_len = run_end - run_start;
+            for (i = 0; i < run_len; i++) {
+                vec[i].iov_base = pieces[run_start + i].buf;
+                vec[i].iov_len  = pieces[run_start + i].nbytes;
+            }
+
+            off_t run_offset = pieces[run_start].offset;
+            ssize_t rc;
+            if (is_write && (NULL != ctx->spill_direct)) {
+                /* stage the data for a write-behind O_DIRECT write */
+                for (i = run_start; i < run_end; i++) {
+                    direct_stage_write(ctx->spill_direct, pieces[i].offset,
+                                       pieces[i].buf, pieces[i].nbytes);
+                }
+                rc = (ssize_t) run_bytes;
+            } else if (NULL != ctx->spill_z) {
+                /* compressed chunks are transferred piece by piece */
+                rc = zspill_transfer_run(ctx->spill_z, pieces + run_start,
+                                         run_len, is_write);
+            } else if (is_write) {
+                rc = pwritev(ctx->spill_fd, vec, run_len, run_offset);
+            } else {
+                if (NULL != ctx->spill_direct) {
+                    /* make sure staged data for this run is in the file */
+                    direct_flush_range(ctx->spill_direct, run_offset,
+                                       run_bytes);
+                }
+                rc = preadv(ctx->spill_fd, vec, run_len, run_offset);
+            }
+            LOGDBG("%s(spill_off=%zu, pieces=%d, bytes=%zu) = %zd",
+                   (is_write ? "pwritev" : "preadv"), (size_t)run_offset,
+                   run_len, run_bytes, rc);
+
+            if (-1 == rc) {
+                int err = errno;
+                LOGERR("%s(spillfile) failed: %s",
+                       (is_write ? "pwritev" : "preadv"), strerror(err));
+                for (i = run_start; i < run_end; i++) {
+                    iov[pieces[i].iov_ndx].rc = err;
+                }
+            } else {
+                /* credit transferred bytes to pieces in order, a short
+                 * transfer leaves the trailing pieces partially done */
+                size_t remaining = (size_t) rc;
+                for (i = run_start; i < run_end; i++) {
+                    size_t done = pieces[i].nbytes;
+                    if (remaining < done) {
+                        done = remaining;
+                    }
+                    iov[pieces[i].iov_ndx].obytes += done;
+                    remaining -= done;
+                }
+            }
+            run_start = run_end;
+        }
+        free(vec);
+    }
+    free(pieces);
+
+    /* like the single range calls, a range that transferred any data
+     * succeeds, possibly partially */
+    int ret = UNIFYFS_SUCCESS;
+    for (i = 0; i < n_iov; i++) {
+        logio_iovec* v = iov + i;
+        if (v->obytes > 0) {
+            if (v->obytes != v->nbytes) {
+                LOGDBG("partial log %s: %zu of %zu bytes",
+                       (is_write ? "write" : "read"), v->obytes, v->nbytes);
+            }
+            v->rc = UNIFYFS_SUCCESS;
+        } else if ((v->rc != UNIFYFS_SUCCESS) && (ret == UNIFYFS_SUCCESS)) {
+            ret = v->rc;
+        }
+    }
+    return ret;
+}
+
+/* count bytes transferred by a vectored read or write */
+static void logio_count_iov(const int n_iov,
+                            logio_iovec* iov,
+                            unifyfs_stat_e stat)
+{
+    size_t total = 0;
+    for (int i = 0; i < n_iov; i++) {
+        total += iov[i].obytes;
+    }
+    unifyfs_stats_add(stat, (int64_t)total);
+}
+
+/* Read data for many ranges from logio context */
+int unifyfs_logio_readv(logio_context* ctx,
+                        const int n_iov,
+                        logio_iovec* iov)
+{
+    if (NULL == ctx) {
+        return EINVAL;
+    }
+    int rc;
+    log_tier* tier = logio_get_tier(ctx);
+    unsigned long ticket = tier_enter(tier);
+    if ((NULL != tier) && (tier->n_moved > 0)) {
+        rc = tier_transferv(ctx, tier, n_iov, iov, 0);
+    } else {
+        rc = logio_transferv(ctx, n_iov, iov, 0);
+    }
+    tier_exit(tier, ticket);
+    logio_count_iov(n_iov, iov, UNIFYFS_STAT_LOGIO_READ_BYTES);
+    return rc;
+}
+
+/* Write data for many ranges to logio context */
+int unifyfs_logio_writev(logio_context* ctx,
+                         const int n_iov,
+                         logio_iovec* iov)
+{
+    if (NULL == ctx) {
+        return EINVAL;
+    }
+    int rc;
+    log_tier* tier = logio_get_tier(ctx);
+    unsigned long ticket = tier_enter(tier);
+    if ((NULL != tier) && (tier->n_moved > 0)) {
+        rc = tier_transferv(ctx, tier, n_iov, iov, 1);
+    } else {
+        rc = logio_transferv(ctx, n_iov, iov, 1);
+    }
+    tier_exit(tier, ticket);
+    logio_count_iov(n_iov, iov, UNIFYFS_STAT_LOGIO_WRITE_BYTES);
+    return rc;
+}
+
+/* Write out spill data held in O_DIRECT staging buffers */
+int unifyfs_logio_flush(logio_context* ctx)
+{
+    if (NULL == ctx) {
+        return EINVAL;
+    }
+    if (NULL != ctx->spill_direct) {
+        return direct_flush(ctx->spill_direct);
+    }
+    return UNIFYFS_SUCCESS;
+}
+
 /* Sync any spill data to disk for given logio context */
 int unifyfs_logio_sync(logio_context* ctx)
 {
+    if (NULL != ctx->spill_direct) {
+        /* staged data must be written before it can be synced */
+        int rc = direct_flush(ctx->spill_direct);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("Failed to flush logio spill staging buffers");
+            return rc;
+        }
+    }
     if ((ctx->spill_sz) && (-1 != ctx->spill_fd)) {
         /* fsync spill file */
         int rc = fsync(ctx->spill_fd);
@@ -979,3 +2784,233 @@ int unifyfs_logio_get_sizes(logio_context* ctx,
 
     return UNIFYFS_SUCCESS;
 }
+
+/* Migrate cold chunks from shmem to spill */
+int unifyfs_logio_tier_migrate(logio_context* ctx,
+                               const unsigned int cold_secs,
+                               const size_t max_chunks,
+                               size_t* n_migrated)
+{
+    if (NULL == ctx) {
+        return EINVAL;
+    }
+    if (NULL != n_migrated) {
+        *n_migrated = 0;
+    }
+
+    log_tier* tier = logio_get_tier(ctx);
+    if (NULL == tier) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    log_header* shmem_hdr = (log_header*) ctx->shmem->addr;
+    log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+    size_t chunk_sz = shmem_hdr->chunk_sz;
+    char* shmem_data = (char*)(ctx->shmem->addr) + shmem_hdr->data_offset;
+    int32_t* chunk_slots = tier_chunk_slots(tier);
+    log_tier_slot* slots = tier_slots(tier);
+
+    size_t n_max = max_chunks + 1;
+    size_t* src = (size_t*) calloc(n_max, sizeof(size_t));
+    size_t* dst = (size_t*) calloc(n_max, sizeof(size_t));
+    int32_t* owner = (int32_t*) calloc(n_max, sizeof(int32_t));
+    int* copied = (int*) calloc(n_max, sizeof(int));
+    if ((NULL == src) || (NULL == dst) || (NULL == owner) ||
+        (NULL == copied)) {
+        free(src);
+        free(dst);
+        free(owner);
+        free(copied);
+        return ENOMEM;
+    }
+
+    size_t i, n_cand = 0;
+    uint32_t now = tier_now();
+
+    LOCK_LOG_HEADER(shmem_hdr);
+    tier->enabled = 1;
+
+    /* free the vacated slots whose old mapping can no longer be in use,
+     * i.e., both reader counters have been seen empty since they were
+     * vacated. If some must wait, advance the epoch so that the counter
+     * new readers use now can drain by a later pass */
+    unsigned int drained = reader_epoch_drained(&(tier->readers));
+    int n_waiting = 0;
+    size_t n_total = tier->n_mem + tier->n_spill;
+    for (i = 0; i < n_total; i++) {
+        if (TIER_SLOT_VACATED == slots[i].owner) {
+            slots[i].drained |= (uint16_t) drained;
+            if (READER_EPOCH_DRAINED == slots[i].drained) {
+                tier_set_owner(tier, i, TIER_SLOT_FREE);
+                slots[i].drained = 0;
+            } else {
+                n_waiting++;
+            }
+        }
+    }
+    if (n_waiting) {
+        reader_epoch_advance(&(tier->readers));
+    }
+
+    size_t high_water = (tier->n_mem * UNIFYFS_LOGIO_TIER_HIGH_WATER) / 100;
+    if ((max_chunks > 0) && (tier->n_mem_used >= high_water)) {
+        /* pick the least recently accessed shmem chunks that are
+         * written and have been cold for long enough */
+        for (i = 0; i < tier->n_mem; i++) {
+            log_tier_slot* s = slots + i;
+            if ((s->owner < 0) || !s->written || s->migrating ||
+                ((now - s->access) < cold_secs)) {
+                continue;
+            }
+            size_t pos = n_cand;
+            if (n_cand == max_chunks) {
+                if (s->access >= slots[src[n_cand - 1]].access) {
+                    continue;
+                }
+                pos = n_cand - 1;
+            } else {
+                n_cand++;
+            }
+            /* insertion sort by access time */
+            while ((pos > 0) && (slots[src[pos - 1]].access > s->access)) {
+                src[pos] = src[pos - 1];
+                pos--;
+            }
+            src[pos] = i;
+        }
+
+        /* reserve a free spill slot for each candidate */
+        size_t n_reserved = 0;
+        size_t cursor = tier->spill_cursor;
+        for (i = 0; (i < tier->n_spill) && (n_reserved < n_cand); i++) {
+            size_t slot = tier->n_mem + ((cursor + i) % tier->n_spill);
+            if (TIER_SLOT_FREE == slots[slot].owner) {
+                tier_set_owner(tier, slot, TIER_SLOT_BUSY);
+                dst[n_reserved] = slot;
+                owner[n_reserved] = slots[src[n_reserved]].owner;
+                slots[src[n_reserved]].migrating = 1;
+                n_reserved++;
+                tier->spill_cursor = (slot - tier->n_mem) + 1;
+            }
+        }
+        n_cand = n_reserved;
+    }
+    UNLOCK_LOG_HEADER(shmem_hdr);
+
+    if (0 == n_cand) {
+        free(src);
+        free(dst);
+        free(owner);
+        free(copied);
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* copy chunk data to the spill slots */
+    int ret = UNIFYFS_SUCCESS;
+    for (i = 0; i < n_cand; i++) {
+        char* data = shmem_data + (src[i] * chunk_sz);
+        off_t spill_off = spill_hdr->data_offset +
+                          (off_t)((dst[i] - tier->n_mem) * chunk_sz);
+        size_t done = 0;
+        while (done < chunk_sz) {
+            ssize_t rc = pwrite(ctx->spill_fd, data + done,
+                                chunk_sz - done, spill_off + (off_t)done);
+            if (rc <= 0) {
+                ret = errno;
+                LOGERR("pwrite(spillfile) of migrated chunk failed: %s",
+                       strerror(ret));
+                break;
+            }
+            done += (size_t) rc;
+        }
+        copied[i] = (done == chunk_sz);
+    }
+
+    /* point the chunks at their new slots, unless they were freed or
+     * reallocated during the copy. The epoch is advanced first, so that
+     * the readers that may still use the old mappings can drain */
+    size_t n_done = 0;
+    LOCK_LOG_HEADER(shmem_hdr);
+    reader_epoch_advance(&(tier->readers));
+    for (i = 0; i < n_cand; i++) {
+        log_tier_slot* from = slots + src[i];
+        int32_t c = owner[i];
+        if (copied[i] && (from->owner == c) && from->migrating &&
+            (chunk_slots[c] == (int32_t)src[i])) {
+            chunk_slots[c] = (int32_t) dst[i];
+            if (src[i] == (size_t)c) {
+                tier->n_moved++;
+            } else if (dst[i] == (size_t)c) {
+                tier->n_moved--;
+            }
+            tier_set_owner(tier, dst[i], c);
+            slots[dst[i]].written = 1;
+            slots[dst[i]].migrating = 0;
+            slots[dst[i]].access = from->access;
+
+            /* readers may still be using the old copy, so the slot is
+             * only freed by a later pass once they are done */
+            tier_set_owner(tier, src[i], TIER_SLOT_VACATED);
+            from->written = 0;
+            from->migrating = 0;
+            from->drained = 0;
+            n_done++;
+        } else {
+            tier_set_owner(tier, dst[i], TIER_SLOT_FREE);
+            if (from->owner == c) {
+                from->migrating = 0;
+            }
+        }
+    }
+    tier->stats.migrated_chunks += n_done;
+    unifyfs_stats_add(UNIFYFS_STAT_LOGIO_MIGRATED_CHUNKS, (int64_t)n_done);
+    UNLOCK_LOG_HEADER(shmem_hdr);
+
+    LOGDBG("migrated %zu of %zu cold shmem chunks to spill", n_done, n_cand);
+    if (NULL != n_migrated) {
+        *n_migrated = n_done;
+    }
+
+    free(src);
+    free(dst);
+    free(owner);
+    free(copied);
+    return ret;
+}
+
+/* Get the spill compression statistics of a log */
+int unifyfs_logio_get_compress_stats(logio_context* ctx,
+                                     logio_compress_stats* stats)
+{
+    if ((NULL == ctx) || (NULL == stats)) {
+        return EINVAL;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    if (NULL != ctx->spill_z) {
+        log_zmap* zmap = ctx->spill_z->zmap;
+        stats->data_bytes = zmap->data_bytes;
+        stats->stored_bytes = zmap->stored_bytes;
+        stats->used_bytes = zmap->used;
+        stats->space_bytes = zmap->space;
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+/* Get the tier usage statistics of a log */
+int unifyfs_logio_get_tier_stats(logio_context* ctx,
+                                 logio_tier_stats* stats)
+{
+    if ((NULL == ctx) || (NULL == stats)) {
+        return EINVAL;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    log_tier* tier = logio_get_tier(ctx);
+    if (NULL != tier) {
+        *stats = tier->stats;
+        stats->mem_chunks_used = tier->n_mem_used;
+        stats->mem_chunks_total = tier->n_mem;
+    }
+    return UNIFYFS_SUCCESS;
+}
@@ -27,6 +27,12 @@ extern "C" {
 /* convenience method to return system page size */
 size_t get_page_size(void);
 
+/* O_DIRECT spillover write state */
+struct logio_direct;
+
+/* compressed spillover chunk state */
+struct logio_zspill;
+
 /* log-based I/O context structure */
 typedef struct logio_context {
     shm_context* shmem;   /* shmem region for memory storage */
@@ -34,6 +40,10 @@ typedef struct logio_context {
     char*  spill_file;    /* pathname of spillover file */
     size_t spill_sz;      /* size of spillover file */
     int    spill_fd;      /* spillover file descriptor */
+    struct logio_direct* spill_direct; /* O_DIRECT write-behind state for
+                                        * spillover data (NULL if unused) */
+    struct logio_zspill* spill_z;      /* compression state for spillover
+                                        * chunks (NULL if unused) */
 } logio_context;
 
 /**
@@ -134,6 +144,52 @@ int unifyfs_logio_write(logio_context* ctx,
                         const char* buf,
                         size_t* obytes);
 
+/* describes one data range for vectored logio reads and writes */
+typedef struct logio_iovec {
+    off_t  log_offset; /* log offset of data */
+    size_t nbytes;     /* number of bytes to transfer */
+    char*  buf;        /* data buffer */
+    size_t obytes;     /* set to number of bytes actually transferred */
+    int    rc;         /* set to UNIFYFS_SUCCESS, or error code */
+} logio_iovec;
+
+/**
+ * Read data for many ranges from logio context. Data held in shared
+ * memory is copied directly. Ranges in the spillover file are sorted by
+ * offset, and contiguous ranges are read using a single preadv().
+ *
+ * @param ctx pointer to logio context
+ * @param n_iov number of ranges
+ * @param iov array of ranges, sets obytes and rc for each range
+ * @return UNIFYFS_SUCCESS if all ranges were read, else first error code
+ */
+int unifyfs_logio_readv(logio_context* ctx,
+                        const int n_iov,
+                        logio_iovec* iov);
+
+/**
+ * Write data for many ranges to logio context. Data for shared memory is
+ * copied directly. Ranges in the spillover file are sorted by offset, and
+ * contiguous ranges are written using a single pwritev().
+ *
+ * @param ctx pointer to logio context
+ * @param n_iov number of ranges
+ * @param iov array of ranges, sets obytes and rc for each range
+ * @return UNIFYFS_SUCCESS if all ranges were written, else first error code
+ */
+int unifyfs_logio_writev(logio_context* ctx,
+                         const int n_iov,
+                         logio_iovec* iov);
+
+/**
+ * Write out any spill data held in O_DIRECT staging buffers, so that
+ * other processes reading the spill file will see it.
+ *
+ * @param ctx pointer to logio context
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_logio_flush(logio_context* ctx);
+
 /**
  * Sync any spill data to disk for given logio context.
  *
@@ -154,6 +210,66 @@ int unifyfs_logio_get_sizes(logio_context* ctx,
                             off_t* shmem_sz,
                             off_t* spill_sz);
 
+/* shmem and spill tier usage of a log with both tiers */
+typedef struct logio_tier_stats {
+    size_t mem_read_bytes;    /* bytes read from shmem */
+    size_t spill_read_bytes;  /* bytes read from spill */
+    size_t mem_write_bytes;   /* bytes written to shmem */
+    size_t spill_write_bytes; /* bytes written to spill */
+    size_t migrated_chunks;   /* chunks migrated from shmem to spill */
+    size_t mem_chunks_used;   /* shmem chunks holding data */
+    size_t mem_chunks_total;  /* shmem chunks in log */
+} logio_tier_stats;
+
+/**
+ * Migrate cold chunks from shmem to free spill chunks (for server use).
+ * Chunks are only migrated while the share of used shmem chunks is at
+ * least UNIFYFS_LOGIO_TIER_HIGH_WATER percent, starting with the least
+ * recently accessed. Reads and writes of migrated chunks use their new
+ * location, and the freed shmem chunks are used for new allocations.
+ *
+ * @param ctx pointer to logio context
+ * @param cold_secs minimum seconds since last access of a migrated chunk
+ * @param max_chunks maximum number of chunks to migrate
+ * @param[out] n_migrated if non-NULL, set to number of chunks migrated
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_logio_tier_migrate(logio_context* ctx,
+                               const unsigned int cold_secs,
+                               const size_t max_chunks,
+                               size_t* n_migrated);
+
+/**
+ * Get the tier usage statistics of a log. All counts are zero for logs
+ * that do not have both shmem and spill storage.
+ *
+ * @param ctx pointer to logio context
+ * @param[out] stats set to tier usage statistics
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_logio_get_tier_stats(logio_context* ctx,
+                                 logio_tier_stats* stats);
+
+/* space usage of a log with compressed spill chunks */
+typedef struct logio_compress_stats {
+    size_t data_bytes;   /* bytes of data written to spill chunks */
+    size_t stored_bytes; /* bytes stored for that data */
+    size_t used_bytes;   /* spill space in use, including space held for
+                          * allocated chunks that have not been written */
+    size_t space_bytes;  /* spill space available for chunks */
+} logio_compress_stats;
+
+/**
+ * Get the spill compression statistics of a log. All counts are zero
+ * for logs that do not compress spill chunks.
+ *
+ * @param ctx pointer to logio context
+ * @param[out] stats set to compression statistics
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_logio_get_compress_stats(logio_context* ctx,
+                                     logio_compress_stats* stats);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -58,6 +58,14 @@ typedef struct {
     int gfid;
 } unifyfs_extent_t;
 
+/* Write log position recorded for a hole extent, i.e., a zero-filled
+ * range of a file that occupies no space in the write log. Readers fill
+ * hole extents with zeros rather than reading the log. */
+#define UNIFYFS_HOLE_LOG_POS ((off_t)(-1))
+
+#define unifyfs_is_hole_log_pos(pos) \
+    ((off_t)(pos) == UNIFYFS_HOLE_LOG_POS)
+
 /* write-log metadata index structures */
 typedef struct {
     off_t file_pos; /* start offset of data in file */
@@ -76,22 +84,38 @@ typedef struct {
     int log_client_id; /* client id associated with log */
 } unifyfs_client_index_t;
 
-/* array list for dynamic extents for read requests*/
-typedef struct extents_list {
-    unifyfs_client_index_t value;
-    struct extents_list* next;
-} extents_list_t;
-
-typedef struct extents_list extents_list;
+/* The write index region is split into UNIFYFS_WRITE_INDEX_SLOTS slots
+ * of equal size, so that the client can fill one slot while the server
+ * is still ingesting the extents from another. The first page of the
+ * region holds the per-slot entry counts, followed by the entries of
+ * each slot in order. */
+#define UNIFYFS_WRITE_INDEX_SLOTS 2
 
 typedef struct {
     size_t  index_size;    /* size of index metadata region in bytes */
     size_t  index_offset;  /* superblock offset of index metadata region */
+    size_t  slot_entries;  /* max number of index entries per slot */
 
-    size_t* ptr_num_entries;         /* pointer to number of index entries */
+    size_t* ptr_num_entries;         /* pointer to per-slot entry counts */
     unifyfs_index_t* index_entries;  /* pointer to first unifyfs_index_t */
 } unifyfs_write_index;
 
+/* return pointer to the number of index entries in the given slot */
+static inline
+size_t* unifyfs_write_index_count(unifyfs_write_index* wr_index,
+                                  int slot)
+{
+    return wr_index->ptr_num_entries + slot;
+}
+
+/* return pointer to the first index entry of the given slot */
+static inline
+unifyfs_index_t* unifyfs_write_index_slot(unifyfs_write_index* wr_index,
+                                          int slot)
+{
+    return wr_index->index_entries + (slot * wr_index->slot_entries);
+}
+
 /* UnifyFS file attributes */
 typedef struct {
     char* filename;
@@ -116,6 +140,127 @@ typedef struct {
     time_t last_update;
 } unifyfs_file_attr_t;
 
+/* directory entry with the attributes of the child file (readdirplus) */
+typedef struct {
+    int gfid;
+    int is_laminated;
+    uint32_t mode;
+    uint32_t uid;
+    uint32_t gid;
+    uint64_t size;
+    struct timespec atime;
+    struct timespec mtime;
+    struct timespec ctime;
+    char name[UNIFYFS_DIRENT_NAME_MAX];
+} unifyfs_dirent_t;
+
+/* copy the attributes of a file into its directory entry */
+static inline
+void unifyfs_dirent_set_attr(unifyfs_dirent_t* ent,
+                             const unifyfs_file_attr_t* attr)
+{
+    ent->gfid         = attr->gfid;
+    ent->is_laminated = attr->is_laminated;
+    ent->mode         = attr->mode;
+    ent->uid          = attr->uid;
+    ent->gid          = attr->gid;
+    ent->size         = attr->size;
+    ent->atime        = attr->atime;
+    ent->mtime        = attr->mtime;
+    ent->ctime        = attr->ctime;
+}
+
+/* file metadata record used to return pages of file listings. Records
+ * are packed back to back in a page, each one followed by the
+ * NUL-terminated file path and padded so the next record is aligned */
+typedef struct {
+    uint32_t rec_size; /* bytes used by record, including path and padding */
+    int gfid;
+    int is_laminated;
+    int is_shared;
+    uint32_t mode;
+    uint32_t uid;
+    uint32_t gid;
+    uint64_t size;
+    struct timespec atime;
+    struct timespec mtime;
+    struct timespec ctime;
+} unifyfs_file_rec_t;
+
+/* filter for file listings, matching files whose path starts with
+ * prefix (if not NULL or empty), that are owned by server owner_rank
+ * (if not -1), and whose lamination state equals laminated (if not -1) */
+typedef struct {
+    const char* prefix;
+    int owner_rank;
+    int laminated;
+} unifyfs_file_filter_t;
+
+/* return bytes used by a file record for a path of length path_len */
+static inline
+size_t unifyfs_file_rec_size(size_t path_len)
+{
+    size_t sz = sizeof(unifyfs_file_rec_t) + path_len + 1;
+    return (sz + 7) & ~((size_t)7);
+}
+
+/* return pointer to the path of a file record */
+static inline
+char* unifyfs_file_rec_path(unifyfs_file_rec_t* rec)
+{
+    return (char*)(rec + 1);
+}
+
+/* return nonzero if file attributes match the filter, other than
+ * the owner which is checked by selecting servers */
+static inline
+int unifyfs_file_filter_match(const unifyfs_file_filter_t* filter,
+                              const unifyfs_file_attr_t* attr)
+{
+    if ((filter->laminated != -1) &&
+        (filter->laminated != (attr->is_laminated ? 1 : 0))) {
+        return 0;
+    }
+    if ((NULL != filter->prefix) && ('\0' != filter->prefix[0])) {
+        if ((NULL == attr->filename) ||
+            (0 != strncmp(attr->filename, filter->prefix,
+                          strlen(filter->prefix)))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* pack attributes of a file into a record at rec, if there are at least
+ * avail bytes. returns bytes used, or 0 if the record does not fit */
+static inline
+size_t unifyfs_file_rec_pack(const unifyfs_file_attr_t* attr,
+                             void* rec_buf,
+                             size_t avail)
+{
+    const char* path = (NULL != attr->filename) ? attr->filename : "";
+    size_t len = strlen(path);
+    size_t sz = unifyfs_file_rec_size(len);
+    if (sz > avail) {
+        return 0;
+    }
+    unifyfs_file_rec_t* rec = (unifyfs_file_rec_t*) rec_buf;
+    memset(rec, 0, sz);
+    rec->rec_size     = (uint32_t) sz;
+    rec->gfid         = attr->gfid;
+    rec->is_laminated = attr->is_laminated;
+    rec->is_shared    = attr->is_shared;
+    rec->mode         = attr->mode;
+    rec->uid          = attr->uid;
+    rec->gid          = attr->gid;
+    rec->size         = attr->size;
+    rec->atime        = attr->atime;
+    rec->mtime        = attr->mtime;
+    rec->ctime        = attr->ctime;
+    memcpy(unifyfs_file_rec_path(rec), path, len);
+    return sz;
+}
+
 enum {
     UNIFYFS_STAT_DEFAULT_DEV = 0,
     UNIFYFS_STAT_DEFAULT_BLKSIZE = 4096,
@@ -21,12 +21,16 @@
 #include <config.h>
 #include <margo.h>
 #include <assert.h>
+#include "unifyfs_const.h"
 #include "unifyfs_log.h"
 #include "unifyfs_keyval.h"
 #include "unifyfs_rpc_util.h"
 
 #define LOCAL_RPC_ADDR_FILE "/tmp/unifyfsd.margo-shm"
 
+/* maximum size of each bulk transfer */
+static size_t bulk_tx_size = UNIFYFS_SERVER_MAX_BULK_TX_SIZE;
+
 /* publishes client-server RPC address */
 void rpc_publish_local_server_addr(const char* addr)
 {
@@ -125,6 +129,20 @@ void rpc_clean_local_server_addr(void)
     }
 }
 
+/* Get the maximum size in bytes of each bulk transfer */
+size_t unifyfs_get_bulk_tx_size(void)
+{
+    return __atomic_load_n(&bulk_tx_size, __ATOMIC_RELAXED);
+}
+
+/* Set the maximum size in bytes of each bulk transfer */
+void unifyfs_set_bulk_tx_size(size_t tx_size)
+{
+    if (tx_size > 0) {
+        __atomic_store_n(&bulk_tx_size, tx_size, __ATOMIC_RELAXED);
+    }
+}
+
 /* Use passed bulk handle to pull data into a newly allocated buffer.
  * If local_bulk is not NULL, will set to local bulk handle on success.
  * Returns bulk buffer, or NULL on failure. */
@@ -167,7 +185,7 @@ void* pull_margo_bulk_buffer(hg_handle_t rpc_hdl,
      * transfer size that the underlying transport supports, and a
      * large bulk transfer may result in failure. */
     int i = 0;
-    hg_size_t max_bulk = UNIFYFS_SERVER_MAX_BULK_TX_SIZE;
+    hg_size_t max_bulk = unifyfs_get_bulk_tx_size();
     hg_size_t remain = bulk_sz;
     do {
         hg_size_t offset = i * max_bulk;
@@ -201,3 +219,58 @@ void* pull_margo_bulk_buffer(hg_handle_t rpc_hdl,
     }
 }
 
+int push_margo_bulk_buffer(hg_handle_t rpc_hdl,
+                           hg_bulk_t bulk_remote,
+                           void* buffer,
+                           hg_size_t bulk_sz)
+{
+    if (0 == bulk_sz) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* get mercury info to set up bulk transfer */
+    const struct hg_info* hgi = margo_get_info(rpc_hdl);
+    assert(hgi);
+    margo_instance_id mid = margo_hg_handle_get_instance(rpc_hdl);
+    assert(mid != MARGO_INSTANCE_NULL);
+
+    /* register local source buffer for bulk access */
+    hg_bulk_t bulk_local;
+    hg_return_t hret = margo_bulk_create(mid, 1, &buffer, &bulk_sz,
+                                         HG_BULK_READ_ONLY, &bulk_local);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_bulk_create() failed");
+        return UNIFYFS_ERROR_MARGO;
+    }
+
+    /* execute the transfer to push data from our local buffer
+     * into the remote side, in pieces the transport supports */
+    int i = 0;
+    hg_size_t max_bulk = unifyfs_get_bulk_tx_size();
+    hg_size_t remain = bulk_sz;
+    do {
+        hg_size_t offset = i * max_bulk;
+        hg_size_t len = (remain < max_bulk) ? remain : max_bulk;
+        hret = margo_bulk_transfer(mid, HG_BULK_PUSH, hgi->addr,
+                                   bulk_remote, offset,
+                                   bulk_local, offset, len);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_bulk_transfer(buf_offset=%zu, len=%zu) failed",
+                   (size_t)offset, (size_t)len);
+            break;
+        }
+        remain -= len;
+        i++;
+    } while (remain > 0);
+
+    /* deregister our bulk transfer buffer */
+    margo_bulk_free(bulk_local);
+
+    if (hret != HG_SUCCESS) {
+        LOGERR("failed bulk transfer - transferred %zu of %zu bytes",
+               (bulk_sz - remain), bulk_sz);
+        return UNIFYFS_ERROR_MARGO;
+    }
+    LOGDBG("successful bulk transfer (%zu bytes)", bulk_sz);
+    return UNIFYFS_SUCCESS;
+}
@@ -32,6 +32,13 @@ char* rpc_lookup_remote_server_addr(int srv_rank);
 /* remove server rpc address file */
 void rpc_clean_local_server_addr(void);
 
+/* get the maximum size in bytes of each bulk transfer. larger transfers
+ * are done in pieces of at most this size */
+size_t unifyfs_get_bulk_tx_size(void);
+
+/* set the maximum size in bytes of each bulk transfer */
+void unifyfs_set_bulk_tx_size(size_t tx_size);
+
 /* use passed bulk handle to pull data into a newly allocated buffer.
  * returns buffer, or NULL on failure. */
 void* pull_margo_bulk_buffer(hg_handle_t rpc_hdl,
@@ -39,6 +46,13 @@ void* pull_margo_bulk_buffer(hg_handle_t rpc_hdl,
                              hg_size_t bulk_sz,
                              hg_bulk_t* local_bulk);
 
+/* use passed bulk handle to push data from the given buffer into the
+ * requester's buffer. returns UNIFYFS_SUCCESS on success */
+int push_margo_bulk_buffer(hg_handle_t rpc_hdl,
+                           hg_bulk_t bulk_remote,
+                           void* buffer,
+                           hg_size_t bulk_sz);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -40,8 +40,10 @@ typedef enum {
     UNIFYFS_SERVER_RPC_EXTENTS_FIND,
     UNIFYFS_SERVER_RPC_FILESIZE,
     UNIFYFS_SERVER_RPC_LAMINATE,
+    UNIFYFS_SERVER_RPC_LIST_FILES,
     UNIFYFS_SERVER_RPC_METAGET,
     UNIFYFS_SERVER_RPC_METASET,
+    UNIFYFS_SERVER_RPC_READDIR,
     UNIFYFS_SERVER_RPC_TRANSFER,
     UNIFYFS_SERVER_RPC_TRUNCATE,
     UNIFYFS_SERVER_BCAST_RPC_BOOTSTRAP,
@@ -102,10 +104,12 @@ MERCURY_GEN_PROC(chunk_read_response_out_t,
                  ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(chunk_read_response_rpc)
 
-/* Add file extents at owner */
+/* Add extents of one or more files at their owner. The extents bulk
+ * holds num_files (gfid, extent count) pairs, followed by the extents of
+ * each file in the same order */
 MERCURY_GEN_PROC(add_extents_in_t,
                  ((int32_t)(src_rank))
-                 ((int32_t)(gfid))
+                 ((int32_t)(num_files))
                  ((int32_t)(num_extents))
                  ((hg_bulk_t)(extents)))
 MERCURY_GEN_PROC(add_extents_out_t,
@@ -156,6 +160,37 @@ MERCURY_GEN_PROC(metaset_out_t,
                  ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(metaset_rpc)
 
+/* Read directory entries from directory owner, which pushes
+ * up to max_entries entries into the requester's bulk buffer */
+MERCURY_GEN_PROC(readdir_in_t,
+                 ((int32_t)(gfid))
+                 ((int32_t)(start_gfid))
+                 ((int32_t)(max_entries))
+                 ((hg_bulk_t)(entries)))
+MERCURY_GEN_PROC(readdir_out_t,
+                 ((int32_t)(num_entries))
+                 ((int32_t)(end_of_dir))
+                 ((int32_t)(ret)))
+DECLARE_MARGO_RPC_HANDLER(readdir_rpc)
+
+/* List files owned by a server that match the filter, starting at
+ * start_gfid. The server pushes a page of up to max_files file records
+ * (see unifyfs_file_rec_t) into the requester's bulk buffer */
+MERCURY_GEN_PROC(list_files_in_t,
+                 ((int32_t)(start_gfid))
+                 ((int32_t)(max_files))
+                 ((int32_t)(laminated))
+                 ((hg_const_string_t)(prefix))
+                 ((hg_size_t)(page_size))
+                 ((hg_bulk_t)(page)))
+MERCURY_GEN_PROC(list_files_out_t,
+                 ((int32_t)(num_files))
+                 ((hg_size_t)(page_used))
+                 ((int32_t)(next_gfid))
+                 ((int32_t)(end_of_list))
+                 ((int32_t)(ret)))
+DECLARE_MARGO_RPC_HANDLER(list_files_rpc)
+
 /* Transfer file */
 MERCURY_GEN_PROC(transfer_in_t,
                  ((int32_t)(src_rank))
@@ -21,31 +21,21 @@
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 
+#ifdef HAVE_LINUX_MEMPOLICY_H
+#include <linux/mempolicy.h>
+#endif
+
 #include "unifyfs_const.h"
 #include "unifyfs_log.h"
 #include "unifyfs_shm.h"
 
-/* Allocate a shared memory region with given name and size,
- * and map it into memory.
- * Returns a pointer to shm_context for region if successful,
- * or NULL on error */
-shm_context* unifyfs_shm_alloc(const char* name, size_t size)
+/* set size of shared memory region, reserving its memory if possible */
+static int shm_set_size(int fd, const char* name, size_t size)
 {
     int ret;
-
-    /* open shared memory file */
-    errno = 0;
-    int fd = shm_open(name, O_RDWR | O_CREAT, 0770);
-    if (fd == -1) {
-        /* failed to open shared memory */
-        LOGERR("Failed to open shared memory %s (%s)",
-               name, strerror(errno));
-        return NULL;
-    }
-
-    /* set size of shared memory region */
 #ifdef HAVE_POSIX_FALLOCATE
     do { /* this loop handles syscall interruption for large allocations */
         int try_count = 0;
@@ -56,8 +46,7 @@ shm_context* unifyfs_shm_alloc(const char* name, size_t size)
             if ((ret != EINTR) || (try_count >= 5)) {
                 LOGERR("posix_fallocate failed for %s (%s)",
                     name, strerror(ret));
-                close(fd);
-                return NULL;
+                return ret;
             }
         }
     } while (ret != 0);
@@ -66,12 +55,110 @@ shm_context* unifyfs_shm_alloc(const char* name, size_t size)
     ret = ftruncate(fd, size);
     if (ret == -1) {
         /* failed to set size of shared memory */
+        ret = errno;
         LOGERR("ftruncate failed for %s (%s)",
+               name, strerror(ret));
+        return ret;
+    }
+#endif
+    return UNIFYFS_SUCCESS;
+}
+
+/* prefer the NUMA node of the calling thread's CPU for pages of the
+ * mapped region. For shared memory, the policy is kept with the region,
+ * so it also applies to pages allocated when setting the region size. */
+static void shm_bind_local_node(void* addr, size_t size, const char* name)
+{
+#if defined(HAVE_LINUX_MEMPOLICY_H) && defined(SYS_mbind) && \
+    defined(SYS_getcpu)
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) {
+        LOGWARN("getcpu() failed for %s (%s) - NUMA placement disabled",
+                name, strerror(errno));
+        return;
+    }
+
+    unsigned long nbits = sizeof(unsigned long) * 8;
+    unsigned long mask[(UNIFYFS_SHMEM_MAX_NUMA_NODES / nbits) + 1];
+    if (node >= (sizeof(mask) * 8)) {
+        LOGWARN("NUMA node %u of %s is out of range", node, name);
+        return;
+    }
+    memset(mask, 0, sizeof(mask));
+    mask[node / nbits] = 1UL << (node % nbits);
+
+    /* the kernel expects one more than the number of mask bits */
+    unsigned long maxnode = (sizeof(mask) * 8) + 1;
+    if (syscall(SYS_mbind, addr, size, MPOL_PREFERRED,
+                mask, maxnode, 0) != 0) {
+        LOGWARN("mbind() failed for %s (%s) - NUMA placement disabled",
+                name, strerror(errno));
+        return;
+    }
+    LOGDBG("shared memory %s placed on NUMA node %u (cpu=%u)",
+           name, node, cpu);
+#else
+    LOGWARN("NUMA placement is not supported - ignored for %s", name);
+#endif
+}
+
+/* ask for transparent huge pages for the mapped region, returns
+ * UNIFYFS_SUCCESS if the kernel accepted the advice */
+static int shm_advise_hugepages(void* addr, size_t size, const char* name)
+{
+#ifdef MADV_HUGEPAGE
+    if (madvise(addr, size, MADV_HUGEPAGE) != 0) {
+        int err = errno;
+        LOGWARN("madvise(MADV_HUGEPAGE) failed for %s (%s)",
+                name, strerror(err));
+        return err;
+    }
+    return UNIFYFS_SUCCESS;
+#else
+    LOGWARN("huge pages are not supported - ignored for %s", name);
+    return ENOTSUP;
+#endif
+}
+
+/* Allocate a shared memory region with given name and size,
+ * and map it into memory.
+ * Returns a pointer to shm_context for region if successful,
+ * or NULL on error */
+shm_context* unifyfs_shm_alloc(const char* name, size_t size)
+{
+    return unifyfs_shm_alloc_flags(name, size, 0);
+}
+
+/* Allocate a shared memory region with given name, size, and placement
+ * flags, and map it into memory.
+ * Returns a pointer to shm_context for region if successful,
+ * or NULL on error */
+shm_context* unifyfs_shm_alloc_flags(const char* name, size_t size,
+                                     int flags)
+{
+    int ret;
+
+    /* open shared memory file */
+    errno = 0;
+    int fd = shm_open(name, O_RDWR | O_CREAT, 0770);
+    if (fd == -1) {
+        /* failed to open shared memory */
+        LOGERR("Failed to open shared memory %s (%s)",
                name, strerror(errno));
-        close(fd);
         return NULL;
     }
-#endif
+
+    /* with placement flags, the policies are set on the mapping before
+     * any pages are allocated, so the size is set after mapping */
+    if (0 == flags) {
+        /* set size of shared memory region */
+        ret = shm_set_size(fd, name, size);
+        if (ret != UNIFYFS_SUCCESS) {
+            close(fd);
+            return NULL;
+        }
+    }
 
     /* map shared memory region into address space */
     errno = 0;
@@ -85,6 +172,47 @@ shm_context* unifyfs_shm_alloc(const char* name, size_t size)
         return NULL;
     }
 
+    if (0 != flags) {
+        if (flags & SHMEM_NUMA_LOCAL) {
+            shm_bind_local_node(addr, size, name);
+        }
+
+        int populated = 0;
+        if ((flags & SHMEM_HUGEPAGES) &&
+            (shm_advise_hugepages(addr, size, name) == UNIFYFS_SUCCESS)) {
+#ifdef MADV_POPULATE_WRITE
+            /* unlike posix_fallocate(), faulting in the pages through the
+             * mapping lets the kernel use huge pages */
+            ret = ftruncate(fd, size);
+            if (ret == 0) {
+                ret = madvise(addr, size, MADV_POPULATE_WRITE);
+                if (ret == 0) {
+                    populated = 1;
+                } else if (errno != EINVAL) {
+                    LOGERR("Failed to populate shared memory %s (%s)",
+                           name, strerror(errno));
+                    munmap(addr, size);
+                    close(fd);
+                    return NULL;
+                }
+            }
+#endif
+            if (!populated) {
+                LOGWARN("cannot populate %s through its mapping - huge pages "
+                        "depend on the system shmem_enabled setting", name);
+            }
+        }
+
+        if (!populated) {
+            ret = shm_set_size(fd, name, size);
+            if (ret != UNIFYFS_SUCCESS) {
+                munmap(addr, size);
+                close(fd);
+                return NULL;
+            }
+        }
+    }
+
     /* safe to close file descriptor now */
     errno = 0;
     ret = close(fd);
@@ -102,7 +230,80 @@ shm_context* unifyfs_shm_alloc(const char* name, size_t size)
         snprintf(ctx->name, sizeof(ctx->name), "%s", name);
         ctx->addr = addr;
         ctx->size = size;
+        ctx->flags = flags;
+    }
+    return ctx;
+}
+
+/* Ask for huge pages in an attached shared memory region created
+ * with SHMEM_HUGEPAGES */
+int unifyfs_shm_use_hugepages(shm_context* ctx)
+{
+    if ((NULL == ctx) || (NULL == ctx->addr)) {
+        return EINVAL;
+    }
+    int ret = shm_advise_hugepages(ctx->addr, ctx->size, ctx->name);
+    if (ret == UNIFYFS_SUCCESS) {
+        ctx->flags |= SHMEM_HUGEPAGES;
+    }
+    return ret;
+}
+
+/* Attach to an existing shared memory region with given name, and map
+ * it read-only. Returns a pointer to shm_context for region if
+ * successful, or NULL with errno set on error */
+shm_context* unifyfs_shm_attach_readonly(const char* name)
+{
+    /* open existing shared memory file */
+    errno = 0;
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd == -1) {
+        int err = errno;
+        if (ENOENT != err) {
+            LOGERR("Failed to open shared memory %s (%s)",
+                   name, strerror(err));
+        }
+        errno = err;
+        return NULL;
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) == -1) {
+        int err = errno;
+        LOGERR("Failed to stat shared memory %s (%s)",
+               name, strerror(err));
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+    size_t size = (size_t) sb.st_size;
+    if (0 == size) {
+        /* region is still being created */
+        close(fd);
+        errno = EAGAIN;
+        return NULL;
+    }
+
+    /* map shared memory region into address space */
+    void* addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    int err = errno;
+    close(fd);
+    if (addr == MAP_FAILED) {
+        LOGERR("Failed to mmap shared memory %s (%s)",
+               name, strerror(err));
+        errno = err;
+        return NULL;
+    }
+
+    shm_context* ctx = (shm_context*) calloc(1, sizeof(shm_context));
+    if (NULL == ctx) {
+        munmap(addr, size);
+        errno = ENOMEM;
+        return NULL;
     }
+    snprintf(ctx->name, sizeof(ctx->name), "%s", name);
+    ctx->addr = addr;
+    ctx->size = size;
     return ctx;
 }
 
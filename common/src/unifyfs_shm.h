@@ -30,6 +30,15 @@
 #define SHMEM_DATA_FMTSTR  "%d-data-%d"
 #define SHMEM_SUPER_FMTSTR "%d-super-%d"
 
+/* printf() format string used by both client and server to name the
+ * shared extent index of a laminated file. First %d is application id,
+ * second is global file id. */
+#define SHMEM_EXTENTS_FMTSTR "%d-extents-%d"
+
+/* Placement flags for unifyfs_shm_alloc_flags() */
+#define SHMEM_HUGEPAGES  0x1 /* back region with transparent huge pages */
+#define SHMEM_NUMA_LOCAL 0x2 /* place region on NUMA node of calling CPU */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -67,12 +76,27 @@ typedef enum {
     volatile shm_data_state_e state;
 } shm_data_header;
 
+/* Header for a shared extent index, which a server publishes for the
+ * clients on its node once a file is laminated. The header is followed by
+ * a struct seg_tree_snapshot holding the extents of the file whose data
+ * is in the logs of the application's clients on the node (and any holes),
+ * sorted by offset. Clients map the region read-only.
+ *   ready - set by server once the extents are written
+ *   gfid  - global file id
+ *   size  - total bytes of shmem region */
+typedef struct shm_extents_header {
+    volatile int ready;
+    int gfid;
+    size_t size;
+} shm_extents_header;
+
 /* Context structure for maintaining state on an active
  * shared memory region */
 typedef struct shm_context {
     char   name[SHMEM_NAME_LEN];
     void*  addr;  /* base address of shmem region mapping */
     size_t size;  /* size of shmem region */
+    int    flags; /* placement flags (SHMEM_HUGEPAGES, SHMEM_NUMA_LOCAL) */
 } shm_context;
 
 /**
@@ -84,6 +108,38 @@ typedef struct shm_context {
  */
 shm_context* unifyfs_shm_alloc(const char* name, size_t size);
 
+/**
+ * Allocate a shared memory region with given name and size, and map it
+ * into memory. The placement flags apply when the region is created:
+ * with SHMEM_NUMA_LOCAL, pages prefer the NUMA node of the calling
+ * thread's CPU, and with SHMEM_HUGEPAGES, the region is populated through
+ * a mapping advised to use transparent huge pages. Placement failures
+ * are logged, and the region is still created.
+ * @param name region name
+ * @param size region size in bytes
+ * @param flags placement flags (bitwise OR of SHMEM_xxx flags, or 0)
+ * @return shmem context pointer (NULL on failure)
+ */
+shm_context* unifyfs_shm_alloc_flags(const char* name, size_t size,
+                                     int flags);
+
+/**
+ * Advise an attached shared memory region, which was created with
+ * SHMEM_HUGEPAGES, to use huge pages in this process's mapping.
+ * @param ctx shmem context pointer
+ * @return UNIFYFS_SUCCESS or error code
+ */
+int unifyfs_shm_use_hugepages(shm_context* ctx);
+
+/**
+ * Attach to an existing shared memory region with given name, and map
+ * it read-only into memory. The region size is that of the existing
+ * region. A missing region is not logged as an error.
+ * @param name region name
+ * @return shmem context pointer (NULL on failure, with errno set)
+ */
+shm_context* unifyfs_shm_attach_readonly(const char* name);
+
 /**
  * Unmaps shared memory region and frees its context. Context pointer
  * is set to NULL on success.
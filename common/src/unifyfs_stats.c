@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include "unifyfs_stats.h"
+#include "unifyfs_rc.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* names and descriptions of counters */
+static const char* stat_names[UNIFYFS_STAT_MAX] = {
+#define STAT(id, name, desc) #name,
+    UNIFYFS_STATS_COUNTERS
+#undef STAT
+};
+
+/* per-thread histogram data */
+typedef struct {
+    uint64_t count;
+    uint64_t sum_usec;
+    uint64_t max_usec;
+    uint64_t buckets[UNIFYFS_STATS_HIST_BUCKETS];
+} stats_hist_data;
+
+/* per-thread copy of all counters and histograms. Only the owning
+ * thread updates a block, but other threads read it while taking a
+ * snapshot, so all accesses use (relaxed) atomic loads and stores */
+typedef struct stats_block {
+    struct stats_block* next;   /* next block in registry */
+    int orphaned;               /* set when owning thread has exited */
+    int64_t counters[UNIFYFS_STAT_MAX];
+    stats_hist_data hists[UNIFYFS_STATS_MAX_HISTS];
+} stats_block;
+
+/* registry of all blocks, never freed so counts of exited threads are
+ * kept, and a new thread reuses the block of an exited thread */
+static stats_block* stats_blocks; // = NULL
+
+static __thread stats_block* my_block; // = NULL
+
+static pthread_once_t stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t stats_block_key;
+
+/* histogram registry, n_hists is only increased after an entry is
+ * filled in, so entries below it can be read without the lock */
+static pthread_mutex_t stats_hist_lock = PTHREAD_MUTEX_INITIALIZER;
+static int n_hists; // = 0
+static uint64_t hist_keys[UNIFYFS_STATS_MAX_HISTS];
+static char hist_names[UNIFYFS_STATS_MAX_HISTS][UNIFYFS_STATS_NAME_LEN];
+
+#define STATS_LOAD(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define STATS_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+
+static void stats_block_release(void* arg)
+{
+    stats_block* blk = (stats_block*) arg;
+    __atomic_store_n(&blk->orphaned, 1, __ATOMIC_RELEASE);
+}
+
+static void stats_init(void)
+{
+    pthread_key_create(&stats_block_key, stats_block_release);
+}
+
+/* return calling thread's block, or NULL on allocation failure */
+static stats_block* stats_get_block(void)
+{
+    if (NULL != my_block) {
+        return my_block;
+    }
+
+    pthread_once(&stats_once, stats_init);
+
+    /* reuse the block of an exited thread if there is one */
+    stats_block* blk;
+    for (blk = __atomic_load_n(&stats_blocks, __ATOMIC_ACQUIRE);
+         NULL != blk; blk = blk->next) {
+        int expected = 1;
+        if (__atomic_compare_exchange_n(&blk->orphaned, &expected, 0, 0,
+                                        __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    if (NULL == blk) {
+        blk = calloc(1, sizeof(stats_block));
+        if (NULL == blk) {
+            return NULL;
+        }
+
+        /* push new block onto registry */
+        stats_block* first = __atomic_load_n(&stats_blocks, __ATOMIC_ACQUIRE);
+        do {
+            blk->next = first;
+        } while (!__atomic_compare_exchange_n(&stats_blocks, &first, blk, 1,
+                                              __ATOMIC_RELEASE,
+                                              __ATOMIC_ACQUIRE));
+    }
+
+    pthread_setspecific(stats_block_key, blk);
+    my_block = blk;
+    return blk;
+}
+
+/* add value to calling thread's copy of a counter */
+void unifyfs_stats_add(unifyfs_stat_e stat, int64_t val)
+{
+    if ((stat < 0) || (stat >= UNIFYFS_STAT_MAX)) {
+        return;
+    }
+    stats_block* blk = stats_get_block();
+    if (NULL != blk) {
+        STATS_STORE(blk->counters[stat], STATS_LOAD(blk->counters[stat]) + val);
+    }
+}
+
+/* return current monotonic time in usecs, for timing operations */
+uint64_t unifyfs_stats_now_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000ULL) +
+           ((uint64_t)ts.tv_nsec / 1000ULL);
+}
+
+/* create a latency histogram with the given name for operations
+ * identified by key (e.g., an RPC id).
+ * returns UNIFYFS_SUCCESS on success */
+int unifyfs_stats_hist_register(uint64_t key, const char* name)
+{
+    if (NULL == name) {
+        return EINVAL;
+    }
+
+    int rc = UNIFYFS_SUCCESS;
+    pthread_mutex_lock(&stats_hist_lock);
+    int i;
+    for (i = 0; i < n_hists; i++) {
+        if (hist_keys[i] == key) {
+            break;
+        }
+    }
+    if (i == n_hists) {
+        if (n_hists == UNIFYFS_STATS_MAX_HISTS) {
+            rc = ENOSPC;
+        } else {
+            hist_keys[i] = key;
+            snprintf(hist_names[i], UNIFYFS_STATS_NAME_LEN, "%s", name);
+            __atomic_store_n(&n_hists, i + 1, __ATOMIC_RELEASE);
+        }
+    }
+    pthread_mutex_unlock(&stats_hist_lock);
+    return rc;
+}
+
+/* record latency of an operation that started at start_usec,
+ * ignored if no histogram is registered for key */
+void unifyfs_stats_hist_record(uint64_t key, uint64_t start_usec)
+{
+    uint64_t usecs = unifyfs_stats_now_usec() - start_usec;
+    int n = __atomic_load_n(&n_hists, __ATOMIC_ACQUIRE);
+    int i;
+    for (i = 0; i < n; i++) {
+        if (hist_keys[i] == key) {
+            break;
+        }
+    }
+    if (i == n) {
+        return;
+    }
+
+    stats_block* blk = stats_get_block();
+    if (NULL == blk) {
+        return;
+    }
+
+    int b = 0;
+    while ((b < (UNIFYFS_STATS_HIST_BUCKETS - 1)) &&
+           (usecs >= ((uint64_t)1 << b))) {
+        b++;
+    }
+
+    stats_hist_data* h = blk->hists + i;
+    STATS_STORE(h->count, STATS_LOAD(h->count) + 1);
+    STATS_STORE(h->sum_usec, STATS_LOAD(h->sum_usec) + usecs);
+    STATS_STORE(h->buckets[b], STATS_LOAD(h->buckets[b]) + 1);
+    if (usecs > STATS_LOAD(h->max_usec)) {
+        STATS_STORE(h->max_usec, usecs);
+    }
+}
+
+/* sum counters and histograms of all threads into stats */
+void unifyfs_stats_snapshot(unifyfs_stats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    int n = __atomic_load_n(&n_hists, __ATOMIC_ACQUIRE);
+    stats->n_hists = n;
+    for (int i = 0; i < n; i++) {
+        memcpy(stats->hists[i].name, hist_names[i], UNIFYFS_STATS_NAME_LEN);
+    }
+
+    stats_block* blk;
+    for (blk = __atomic_load_n(&stats_blocks, __ATOMIC_ACQUIRE);
+         NULL != blk; blk = blk->next) {
+        for (int c = 0; c < UNIFYFS_STAT_MAX; c++) {
+            stats->counters[c] += STATS_LOAD(blk->counters[c]);
+        }
+        for (int i = 0; i < n; i++) {
+            stats_hist_data* h = blk->hists + i;
+            unifyfs_stats_hist* sh = stats->hists + i;
+            sh->count += STATS_LOAD(h->count);
+            sh->sum_usec += STATS_LOAD(h->sum_usec);
+            uint64_t max = STATS_LOAD(h->max_usec);
+            if (max > sh->max_usec) {
+                sh->max_usec = max;
+            }
+            for (int b = 0; b < UNIFYFS_STATS_HIST_BUCKETS; b++) {
+                sh->buckets[b] += STATS_LOAD(h->buckets[b]);
+            }
+        }
+    }
+}
+
+/* estimate latency percentile as the upper bound of its bucket */
+static uint64_t hist_percentile(const unifyfs_stats_hist* h, int pct)
+{
+    uint64_t target = ((h->count * (uint64_t)pct) + 99) / 100;
+    uint64_t seen = 0;
+    for (int b = 0; b < UNIFYFS_STATS_HIST_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if ((seen >= target) && (seen > 0)) {
+            if (b == (UNIFYFS_STATS_HIST_BUCKETS - 1)) {
+                return h->max_usec;
+            }
+            return (uint64_t)1 << b;
+        }
+    }
+    return h->max_usec;
+}
+
+/* write a text report of stats to the given stream */
+void unifyfs_stats_print(const unifyfs_stats* stats, FILE* out)
+{
+    fprintf(out, "counters:\n");
+    for (int c = 0; c < UNIFYFS_STAT_MAX; c++) {
+        fprintf(out, "  %-28s %lld\n", stat_names[c],
+                (long long) stats->counters[c]);
+    }
+
+    fprintf(out, "latency (usec):\n");
+    fprintf(out, "  %-36s %10s %10s %10s %10s %10s\n",
+            "operation", "count", "mean", "p50", "p99", "max");
+    for (int i = 0; i < stats->n_hists; i++) {
+        const unifyfs_stats_hist* h = stats->hists + i;
+        if (0 == h->count) {
+            continue;
+        }
+        fprintf(out, "  %-36s %10llu %10llu %10llu %10llu %10llu\n",
+                h->name, (unsigned long long) h->count,
+                (unsigned long long)(h->sum_usec / h->count),
+                (unsigned long long) hist_percentile(h, 50),
+                (unsigned long long) hist_percentile(h, 99),
+                (unsigned long long) h->max_usec);
+        fprintf(out, "    buckets:");
+        for (int b = 0; b < UNIFYFS_STATS_HIST_BUCKETS; b++) {
+            if (h->buckets[b]) {
+                if (b == (UNIFYFS_STATS_HIST_BUCKETS - 1)) {
+                    fprintf(out, " >=%llu:%llu",
+                            (unsigned long long)1 << (b - 1),
+                            (unsigned long long) h->buckets[b]);
+                } else {
+                    fprintf(out, " <%llu:%llu",
+                            (unsigned long long)1 << b,
+                            (unsigned long long) h->buckets[b]);
+                }
+            }
+        }
+        fprintf(out, "\n");
+    }
+}
+
+/* return a newly allocated text report of current stats in report,
+ * with its length (excluding NUL) in report_len. The caller must free
+ * the report. returns UNIFYFS_SUCCESS on success */
+int unifyfs_stats_report(char** report, size_t* report_len)
+{
+    if ((NULL == report) || (NULL == report_len)) {
+        return EINVAL;
+    }
+
+    unifyfs_stats* stats = malloc(sizeof(unifyfs_stats));
+    if (NULL == stats) {
+        return ENOMEM;
+    }
+    unifyfs_stats_snapshot(stats);
+
+    char* buf = NULL;
+    size_t len = 0;
+    FILE* out = open_memstream(&buf, &len);
+    if (NULL == out) {
+        free(stats);
+        return errno;
+    }
+    unifyfs_stats_print(stats, out);
+    fclose(out);
+    free(stats);
+
+    *report = buf;
+    *report_len = len;
+    return UNIFYFS_SUCCESS;
+}
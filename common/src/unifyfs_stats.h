@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#ifndef UNIFYFS_STATS_H
+#define UNIFYFS_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Runtime performance counters and latency histograms.
+ *
+ * Each thread updates its own copy of the counters without locks or
+ * atomic read-modify-write operations. A snapshot sums the copies of all
+ * threads. Counters may be decremented, so a counter can also track a
+ * current value (e.g., a queue depth) by adding and subtracting. */
+
+/* STAT(id, name, description) */
+#define UNIFYFS_STATS_COUNTERS \
+    STAT(LOGIO_ALLOC_BYTES, logio_alloc_bytes, \
+         "log bytes allocated") \
+    STAT(LOGIO_ALLOC_FAIL, logio_alloc_fail, \
+         "failed log allocations") \
+    STAT(LOGIO_FREE_BYTES, logio_free_bytes, \
+         "log bytes freed") \
+    STAT(LOGIO_WRITE_BYTES, logio_write_bytes, \
+         "bytes written to logs") \
+    STAT(LOGIO_READ_BYTES, logio_read_bytes, \
+         "bytes read from logs") \
+    STAT(LOGIO_MIGRATED_CHUNKS, logio_migrated_chunks, \
+         "log chunks migrated from shmem to spill") \
+    STAT(CLIENT_READ_LOCAL_BYTES, client_read_local_bytes, \
+         "bytes read by client without server") \
+    STAT(CLIENT_READ_SERVER_BYTES, client_read_server_bytes, \
+         "bytes read by client from server") \
+    STAT(SERVER_INODES, server_inodes, \
+         "inodes held by server") \
+    STAT(SERVER_EXTENTS, server_extents, \
+         "extents in server inode extent trees") \
+    STAT(SERVER_RM_QUEUE, server_rm_queue, \
+         "client requests queued for request managers") \
+    STAT(SERVER_RM_REQUESTS, server_rm_requests, \
+         "client requests submitted to request managers") \
+    STAT(SERVER_SM_QUEUE, server_sm_queue, \
+         "requests queued for service manager") \
+    STAT(SERVER_SM_REQUESTS, server_sm_requests, \
+         "requests submitted to service manager") \
+    STAT(SERVER_CLIENT_DATA_BYTES, server_client_data_bytes, \
+         "read data bytes sent to local clients") \
+    STAT(SERVER_PEER_DATA_BYTES, server_peer_data_bytes, \
+         "read data bytes sent to other servers")
+
+typedef enum {
+#define STAT(id, name, desc) UNIFYFS_STAT_##id,
+    UNIFYFS_STATS_COUNTERS
+#undef STAT
+    UNIFYFS_STAT_MAX
+} unifyfs_stat_e;
+
+/* histogram bucket i counts latencies in [2^(i-1), 2^i) usecs,
+ * the last bucket counts all larger latencies */
+#define UNIFYFS_STATS_HIST_BUCKETS 24
+#define UNIFYFS_STATS_MAX_HISTS 64
+#define UNIFYFS_STATS_NAME_LEN 48
+
+typedef struct {
+    char name[UNIFYFS_STATS_NAME_LEN];
+    uint64_t count;
+    uint64_t sum_usec;
+    uint64_t max_usec;
+    uint64_t buckets[UNIFYFS_STATS_HIST_BUCKETS];
+} unifyfs_stats_hist;
+
+typedef struct {
+    int64_t counters[UNIFYFS_STAT_MAX];
+    int n_hists;
+    unifyfs_stats_hist hists[UNIFYFS_STATS_MAX_HISTS];
+} unifyfs_stats;
+
+/* add value to calling thread's copy of a counter */
+void unifyfs_stats_add(unifyfs_stat_e stat, int64_t val);
+
+/* return current monotonic time in usecs, for timing operations */
+uint64_t unifyfs_stats_now_usec(void);
+
+/* create a latency histogram with the given name for operations
+ * identified by key (e.g., an RPC id).
+ * returns UNIFYFS_SUCCESS on success */
+int unifyfs_stats_hist_register(uint64_t key, const char* name);
+
+/* record latency of an operation that started at start_usec,
+ * ignored if no histogram is registered for key */
+void unifyfs_stats_hist_record(uint64_t key, uint64_t start_usec);
+
+/* sum counters and histograms of all threads into stats */
+void unifyfs_stats_snapshot(unifyfs_stats* stats);
+
+/* write a text report of stats to the given stream */
+void unifyfs_stats_print(const unifyfs_stats* stats, FILE* out);
+
+/* return a newly allocated text report of current stats in report,
+ * with its length (excluding NUL) in report_len. The caller must free
+ * the report. returns UNIFYFS_SUCCESS on success */
+int unifyfs_stats_report(char** report, size_t* report_len);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* UNIFYFS_STATS_H */
@@ -0,0 +1,851 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/* read-bench: This program measures read performance for controlled
+ * placements of the data being read. It uses the UnifyFS library API, so
+ * that the client log storage configuration can be chosen per run.
+ *
+ * Each rank writes its own region of a shared file, with the data held in
+ * client shared memory, in a spillover file, or split across both (see
+ * --tier). Each rank then reads from a region written by:
+ *   self   - the same client
+ *   node   - another client on the same node
+ *   remote - a client on another node
+ *   all    - every rank in turn, mixing local and remote data
+ * using each combination of I/O size and access pattern (sequential,
+ * strided, random). One line of results is printed per case, as JSON or
+ * CSV, with bandwidth, IOPS, and read latency percentiles.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <libgen.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mpi.h>
+#include <unifyfs_api.h>
+
+#define DEFAULT_MOUNTPOINT "/unifyfs"
+
+#ifndef KIB
+# define KIB (1024)
+#endif
+
+#ifndef MIB
+# define MIB (1048576)
+#endif
+
+/* extra log space for headers and partial chunks, beyond the data
+ * written */
+#define LOG_HEADER_SLACK (8 * MIB)
+
+/* size of each write used to fill a rank's region */
+#define FILL_WRITE_SIZE (1 * MIB)
+
+enum placement {
+    PLACE_SELF = 0,
+    PLACE_NODE,
+    PLACE_REMOTE,
+    PLACE_ALL,
+    PLACE_MAX
+};
+
+static const char* placement_names[PLACE_MAX] = {
+    "self", "node", "remote", "all"
+};
+
+enum pattern {
+    PATTERN_SEQ = 0,
+    PATTERN_STRIDED,
+    PATTERN_RANDOM,
+    PATTERN_MAX
+};
+
+static const char* pattern_names[PATTERN_MAX] = {
+    "seq", "strided", "random"
+};
+
+enum tier {
+    TIER_SHMEM = 0,
+    TIER_SPILL,
+    TIER_MIXED,
+    TIER_MAX
+};
+
+static const char* tier_names[TIER_MAX] = {
+    "shmem", "spill", "mixed"
+};
+
+static int rank;
+static int total_ranks;
+static int local_rank;
+static int local_ranks;
+static int num_nodes;
+
+/* world rank of the writer read by each placement, or -1 if the
+ * placement is not possible with this job layout */
+static int partner[PLACE_MAX];
+
+/* options */
+static char mountpoint[PATH_MAX];
+static char filename[PATH_MAX];
+static uint64_t region_size = 64 * MIB;
+static uint64_t io_sizes[32];
+static int num_io_sizes;
+static int use_placement[PLACE_MAX];
+static int use_pattern[PATTERN_MAX];
+static enum tier tier = TIER_SHMEM;
+static uint64_t num_reads = 1000;
+static uint64_t stride_blocks = 8;
+static int queue_depth = 1;
+static int laminate;
+static int check;
+static int csv;
+
+static unifyfs_handle fshdl = UNIFYFS_INVALID_HANDLE;
+static unifyfs_gfid gfid;
+
+static uint64_t rand_state = 88172645463325252ULL;
+
+/* xorshift64, seeded per rank so ranks read different random blocks */
+static uint64_t next_rand(void)
+{
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 7;
+    rand_state ^= rand_state << 17;
+    return rand_state;
+}
+
+/* fill buf with the 8-byte file offsets of its words */
+static void fill_pattern(char* buf, uint64_t len, uint64_t offset)
+{
+    uint64_t i;
+    for (i = 0; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t val = offset + i;
+        memcpy(buf + i, &val, sizeof(val));
+    }
+}
+
+/* returns 0 if buf holds the data written at offset */
+static int check_pattern(const char* buf, uint64_t len, uint64_t offset)
+{
+    uint64_t i;
+    for (i = 0; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t val;
+        memcpy(&val, buf + i, sizeof(val));
+        if (val != (offset + i)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+/* value at the given percentile of sorted vals */
+static double percentile(const double* vals, uint64_t count, int pct)
+{
+    if (0 == count) {
+        return 0.0;
+    }
+    uint64_t idx = ((count * (uint64_t)pct) + 99) / 100;
+    if (idx > 0) {
+        idx--;
+    }
+    return vals[idx];
+}
+
+/* parse a comma-separated list of names, setting flags[i] for each
+ * name matching names[i]. returns 0 on success */
+static int parse_names(char* list, const char** names, int n, int* flags)
+{
+    char* saveptr = NULL;
+    char* tok;
+    memset(flags, 0, n * sizeof(int));
+    for (tok = strtok_r(list, ",", &saveptr); NULL != tok;
+         tok = strtok_r(NULL, ",", &saveptr)) {
+        int i;
+        for (i = 0; i < n; i++) {
+            if (strcmp(tok, names[i]) == 0) {
+                flags[i] = 1;
+                break;
+            }
+        }
+        if (i == n) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* parse a size with an optional K, M, or G suffix */
+static uint64_t parse_size(const char* str)
+{
+    char* end = NULL;
+    uint64_t val = strtoull(str, &end, 0);
+    switch (*end) {
+    case 'k':
+    case 'K':
+        val *= KIB;
+        break;
+    case 'm':
+    case 'M':
+        val *= MIB;
+        break;
+    case 'g':
+    case 'G':
+        val *= (1024ULL * MIB);
+        break;
+    default:
+        break;
+    }
+    return val;
+}
+
+/* find the writers read by each placement. The node placement reads
+ * the next rank on the same node, and the remote placement reads the
+ * rank with the same local rank on the next node. */
+static void find_partners(void)
+{
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+                        MPI_INFO_NULL, &node_comm);
+    MPI_Comm_rank(node_comm, &local_rank);
+    MPI_Comm_size(node_comm, &local_ranks);
+
+    int is_leader = (local_rank == 0);
+    MPI_Allreduce(&is_leader, &num_nodes, 1, MPI_INT, MPI_SUM,
+                  MPI_COMM_WORLD);
+
+    partner[PLACE_SELF] = rank;
+    partner[PLACE_ALL] = rank;
+
+    partner[PLACE_NODE] = -1;
+    if (local_ranks > 1) {
+        int* node_ranks = calloc(local_ranks, sizeof(int));
+        MPI_Allgather(&rank, 1, MPI_INT, node_ranks, 1, MPI_INT, node_comm);
+        partner[PLACE_NODE] = node_ranks[(local_rank + 1) % local_ranks];
+        free(node_ranks);
+    }
+
+    /* ranks with the same local rank, one per node */
+    MPI_Comm cross_comm;
+    MPI_Comm_split(MPI_COMM_WORLD, local_rank, rank, &cross_comm);
+    int cross_rank, cross_ranks;
+    MPI_Comm_rank(cross_comm, &cross_rank);
+    MPI_Comm_size(cross_comm, &cross_ranks);
+
+    partner[PLACE_REMOTE] = -1;
+    if (cross_ranks > 1) {
+        int* cross_world = calloc(cross_ranks, sizeof(int));
+        MPI_Allgather(&rank, 1, MPI_INT, cross_world, 1, MPI_INT, cross_comm);
+        partner[PLACE_REMOTE] = cross_world[(cross_rank + 1) % cross_ranks];
+        free(cross_world);
+    }
+
+    MPI_Comm_free(&cross_comm);
+    MPI_Comm_free(&node_comm);
+}
+
+/* initialize the client with log storage for the requested tier */
+static int init_client(void)
+{
+    char shmem_size[32];
+    char spill_size[32];
+    uint64_t shmem = 0;
+    uint64_t spill = 0;
+
+    switch (tier) {
+    case TIER_SHMEM:
+        shmem = region_size + LOG_HEADER_SLACK;
+        break;
+    case TIER_SPILL:
+        spill = region_size + LOG_HEADER_SLACK;
+        break;
+    case TIER_MIXED:
+        /* first half of the region fits in shmem, the rest spills */
+        shmem = (region_size / 2) + LOG_HEADER_SLACK;
+        spill = region_size + LOG_HEADER_SLACK;
+        break;
+    default:
+        break;
+    }
+    snprintf(shmem_size, sizeof(shmem_size), "%" PRIu64, shmem);
+    snprintf(spill_size, sizeof(spill_size), "%" PRIu64, spill);
+
+    unifyfs_cfg_option options[] = {
+        { .opt_name = "logio.shmem_size", .opt_value = shmem_size },
+        { .opt_name = "logio.spill_size", .opt_value = spill_size },
+    };
+    int n_opts = sizeof(options) / sizeof(options[0]);
+
+    unifyfs_rc urc = unifyfs_initialize(mountpoint, options, n_opts, &fshdl);
+    if (UNIFYFS_SUCCESS != urc) {
+        fprintf(stderr, "[%d] unifyfs_initialize(%s) failed - %s\n",
+                rank, mountpoint, unifyfs_rc_enum_description(urc));
+        return -1;
+    }
+    return 0;
+}
+
+/* write this rank's region of the shared file, then sync so the data
+ * is visible to other clients */
+static int write_region(void)
+{
+    unifyfs_rc urc;
+    int ret = 0;
+
+    if (rank == 0) {
+        urc = unifyfs_create(fshdl, 0, filename, &gfid);
+        if (UNIFYFS_SUCCESS != urc) {
+            fprintf(stderr, "[%d] unifyfs_create(%s) failed - %s\n",
+                    rank, filename, unifyfs_rc_enum_description(urc));
+            ret = -1;
+        }
+    }
+    MPI_Bcast(&ret, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (ret) {
+        return ret;
+    }
+    if (rank != 0) {
+        urc = unifyfs_open(fshdl, O_RDWR, filename, &gfid);
+        if (UNIFYFS_SUCCESS != urc) {
+            fprintf(stderr, "[%d] unifyfs_open(%s) failed - %s\n",
+                    rank, filename, unifyfs_rc_enum_description(urc));
+            ret = -1;
+        }
+    }
+
+    char* buf = malloc(FILL_WRITE_SIZE);
+    if (NULL == buf) {
+        ret = -1;
+    }
+
+    uint64_t base = (uint64_t)rank * region_size;
+    uint64_t off;
+    for (off = 0; (ret == 0) && (off < region_size);
+         off += FILL_WRITE_SIZE) {
+        uint64_t len = region_size - off;
+        if (len > FILL_WRITE_SIZE) {
+            len = FILL_WRITE_SIZE;
+        }
+        fill_pattern(buf, len, base + off);
+
+        unifyfs_io_request req = {0};
+        req.op = UNIFYFS_IOREQ_OP_WRITE;
+        req.gfid = gfid;
+        req.user_buf = buf;
+        req.nbytes = len;
+        req.offset = (off_t)(base + off);
+        urc = unifyfs_dispatch_io(fshdl, 1, &req);
+        if (UNIFYFS_SUCCESS == urc) {
+            urc = unifyfs_wait_io(fshdl, 1, &req, 1);
+        }
+        if ((UNIFYFS_SUCCESS != urc) || req.result.error) {
+            fprintf(stderr, "[%d] write of %" PRIu64 " bytes at offset %"
+                    PRIu64 " failed - %s\n", rank, len, base + off,
+                    (UNIFYFS_SUCCESS != urc) ?
+                    unifyfs_rc_enum_description(urc) :
+                    strerror(req.result.error));
+            ret = -1;
+        }
+    }
+    free(buf);
+
+    if (ret == 0) {
+        urc = unifyfs_sync(fshdl, gfid);
+        if (UNIFYFS_SUCCESS != urc) {
+            fprintf(stderr, "[%d] unifyfs_sync() failed - %s\n",
+                    rank, unifyfs_rc_enum_description(urc));
+            ret = -1;
+        }
+    }
+
+    int all_ret;
+    MPI_Allreduce(&ret, &all_ret, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (all_ret) {
+        return all_ret;
+    }
+
+    if (laminate && (rank == 0)) {
+        urc = unifyfs_laminate(fshdl, filename);
+        if (UNIFYFS_SUCCESS != urc) {
+            fprintf(stderr, "[%d] unifyfs_laminate(%s) failed - %s\n",
+                    rank, filename, unifyfs_rc_enum_description(urc));
+            ret = -1;
+        }
+    }
+    MPI_Bcast(&ret, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    return ret;
+}
+
+/* offset of the i-th read of io_size bytes for the given case */
+static uint64_t read_offset(enum placement place, enum pattern pat,
+                            uint64_t io_size, uint64_t i)
+{
+    uint64_t nblocks = region_size / io_size;
+    uint64_t block = 0;
+    int writer = partner[place];
+
+    switch (pat) {
+    case PATTERN_SEQ:
+        block = i % nblocks;
+        break;
+    case PATTERN_STRIDED: {
+        /* every stride_blocks-th block, shifting by one block each
+         * time the stride wraps around the region */
+        uint64_t pos = i * stride_blocks;
+        block = (pos + (pos / nblocks)) % nblocks;
+        break;
+    }
+    case PATTERN_RANDOM:
+        block = next_rand() % nblocks;
+        break;
+    default:
+        break;
+    }
+
+    if (place == PLACE_ALL) {
+        writer = (int)((rank + i) % total_ranks);
+    }
+    return ((uint64_t)writer * region_size) + (block * io_size);
+}
+
+/* run one case, and have rank 0 print its results */
+static int run_case(enum placement place, enum pattern pat, uint64_t io_size,
+                    char* buf, unifyfs_io_request* reqs, double* lat)
+{
+    uint64_t nbatches = (num_reads + queue_depth - 1) / queue_depth;
+    uint64_t nreads = nbatches * queue_depth;
+    uint64_t errors = 0;
+    uint64_t b;
+    int q;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+
+    for (b = 0; b < nbatches; b++) {
+        for (q = 0; q < queue_depth; q++) {
+            unifyfs_io_request* req = reqs + q;
+            memset(req, 0, sizeof(*req));
+            req->op = UNIFYFS_IOREQ_OP_READ;
+            req->gfid = gfid;
+            req->user_buf = buf + ((uint64_t)q * io_size);
+            req->nbytes = io_size;
+            req->offset = (off_t) read_offset(place, pat, io_size,
+                                              (b * queue_depth) + q);
+        }
+
+        double t0 = MPI_Wtime();
+        unifyfs_rc urc = unifyfs_dispatch_io(fshdl, queue_depth, reqs);
+        if (UNIFYFS_SUCCESS == urc) {
+            urc = unifyfs_wait_io(fshdl, queue_depth, reqs, 1);
+        }
+        double elapsed = MPI_Wtime() - t0;
+
+        for (q = 0; q < queue_depth; q++) {
+            unifyfs_io_request* req = reqs + q;
+            lat[(b * queue_depth) + q] = elapsed;
+            if ((UNIFYFS_SUCCESS != urc) || req->result.error ||
+                (req->result.count != io_size)) {
+                errors++;
+            } else if (check &&
+                       check_pattern(req->user_buf, io_size,
+                                     (uint64_t) req->offset)) {
+                errors++;
+            }
+        }
+    }
+
+    double my_time = MPI_Wtime() - start;
+    double max_time;
+    uint64_t total_errors;
+    MPI_Reduce(&my_time, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+    MPI_Reduce(&errors, &total_errors, 1, MPI_UINT64_T, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+
+    /* gather all latencies to compute percentiles */
+    double* all_lat = NULL;
+    uint64_t total_reads = nreads * (uint64_t)total_ranks;
+    if (rank == 0) {
+        all_lat = malloc(total_reads * sizeof(double));
+        if (NULL == all_lat) {
+            fprintf(stderr, "failed to allocate latency buffer\n");
+            MPI_Abort(MPI_COMM_WORLD, ENOMEM);
+        }
+    }
+    MPI_Gather(lat, (int)nreads, MPI_DOUBLE,
+               all_lat, (int)nreads, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        qsort(all_lat, total_reads, sizeof(double), cmp_double);
+        double sum = 0.0;
+        uint64_t i;
+        for (i = 0; i < total_reads; i++) {
+            sum += all_lat[i];
+        }
+
+        double bytes = (double)total_reads * (double)io_size;
+        double mibps = (bytes / (double)MIB) / max_time;
+        double iops = (double)total_reads / max_time;
+        double lat_mean = (sum / (double)total_reads) * 1e6;
+        double lat_p50 = percentile(all_lat, total_reads, 50) * 1e6;
+        double lat_p99 = percentile(all_lat, total_reads, 99) * 1e6;
+        double lat_max = all_lat[total_reads - 1] * 1e6;
+
+        if (csv) {
+            printf("%s,%s,%s,%" PRIu64 ",%d,%d,%d,%d,%" PRIu64 ",%" PRIu64
+                   ",%.6f,%.2f,%.1f,%.1f,%.1f,%.1f,%.1f,%" PRIu64 "\n",
+                   tier_names[tier], placement_names[place],
+                   pattern_names[pat], io_size, queue_depth, laminate,
+                   total_ranks, num_nodes, total_reads, (uint64_t)bytes,
+                   max_time, mibps, iops, lat_mean, lat_p50, lat_p99,
+                   lat_max, total_errors);
+        } else {
+            printf("{\"tier\":\"%s\",\"placement\":\"%s\",\"pattern\":\"%s\","
+                   "\"io_size\":%" PRIu64 ",\"queue_depth\":%d,"
+                   "\"laminated\":%d,\"ranks\":%d,\"nodes\":%d,"
+                   "\"reads\":%" PRIu64 ",\"bytes\":%" PRIu64 ","
+                   "\"seconds\":%.6f,\"bandwidth_mibps\":%.2f,\"iops\":%.1f,"
+                   "\"lat_mean_usec\":%.1f,\"lat_p50_usec\":%.1f,"
+                   "\"lat_p99_usec\":%.1f,\"lat_max_usec\":%.1f,"
+                   "\"errors\":%" PRIu64 "}\n",
+                   tier_names[tier], placement_names[place],
+                   pattern_names[pat], io_size, queue_depth, laminate,
+                   total_ranks, num_nodes, total_reads, (uint64_t)bytes,
+                   max_time, mibps, iops, lat_mean, lat_p50, lat_p99,
+                   lat_max, total_errors);
+        }
+        fflush(stdout);
+        free(all_lat);
+    }
+    return 0;
+}
+
+static struct option long_opts[] = {
+    { "help", 0, 0, 'h' },
+    { "check", 0, 0, 'c' },
+    { "csv", 0, 0, 'C' },
+    { "mount", 1, 0, 'm' },
+    { "file", 1, 0, 'f' },
+    { "region-size", 1, 0, 'r' },
+    { "io-sizes", 1, 0, 's' },
+    { "placements", 1, 0, 'p' },
+    { "patterns", 1, 0, 'P' },
+    { "tier", 1, 0, 't' },
+    { "reads", 1, 0, 'n' },
+    { "stride", 1, 0, 'S' },
+    { "queue-depth", 1, 0, 'q' },
+    { "laminate", 0, 0, 'l' },
+    { 0, 0, 0, 0},
+};
+
+static char* short_opts = "hcCm:f:r:s:p:P:t:n:S:q:l";
+
+static const char* usage_str =
+"\n"
+"Usage: %s [options...]\n"
+"\n"
+"Benchmark reads of data placed in the same client, another client on the\n"
+"same node, or a client on another node, held in shared memory or in a\n"
+"spillover file. Each rank writes --region-size bytes of a shared file,\n"
+"then reads it back with each combination of placement, I/O size, and\n"
+"access pattern. Prints one result line per case, as JSON or CSV.\n"
+"Placements that need more than one rank per node (node) or more than one\n"
+"node (remote) are skipped when the job does not have them.\n"
+"\n"
+"Available options:\n"
+" -h, --help                 help message\n"
+" -c, --check                verify data content of reads\n"
+" -C, --csv                  print CSV instead of JSON lines\n"
+" -m, --mount=<mountpoint>   use <mountpoint> for unifyfs (default: /unifyfs)\n"
+" -f, --file=<name>          name of shared file within <mountpoint>\n"
+"                            (default: read-bench.<pid of rank 0>)\n"
+" -r, --region-size=<size>   bytes written by each rank (default: 64M)\n"
+" -s, --io-sizes=<list>      read sizes (default: 4K,64K,1M)\n"
+" -p, --placements=<list>    any of self,node,remote,all (default: all four)\n"
+" -P, --patterns=<list>      any of seq,strided,random (default: all three)\n"
+" -t, --tier=<tier>          store data in shmem, spill, or mixed (half in\n"
+"                            each) (default: shmem)\n"
+" -n, --reads=<count>        reads per rank per case (default: 1000)\n"
+" -S, --stride=<blocks>      read every <blocks>-th block for the strided\n"
+"                            pattern (default: 8)\n"
+" -q, --queue-depth=<depth>  reads dispatched together, latency is measured\n"
+"                            per dispatch (default: 1)\n"
+" -l, --laminate             laminate the file before reading\n"
+"\n";
+
+static char* program;
+
+static void print_usage(void)
+{
+    if (rank == 0) {
+        printf(usage_str, program);
+    }
+    MPI_Finalize();
+    exit(0);
+}
+
+int main(int argc, char** argv)
+{
+    int ret = 0;
+    int ch = 0;
+    int optidx = 0;
+    char* tmp_program = NULL;
+    char* list = NULL;
+    char* tok = NULL;
+    char* saveptr = NULL;
+    int i;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &total_ranks);
+
+    tmp_program = strdup(argv[0]);
+    if (!tmp_program) {
+        perror("failed to allocate memory");
+        MPI_Abort(MPI_COMM_WORLD, ENOMEM);
+    }
+    program = basename(tmp_program);
+
+    for (i = 0; i < PLACE_MAX; i++) {
+        use_placement[i] = 1;
+    }
+    for (i = 0; i < PATTERN_MAX; i++) {
+        use_pattern[i] = 1;
+    }
+
+    while ((ch = getopt_long(argc, argv,
+                             short_opts, long_opts, &optidx)) >= 0) {
+        switch (ch) {
+        case 'c':
+            check = 1;
+            break;
+
+        case 'C':
+            csv = 1;
+            break;
+
+        case 'm':
+            snprintf(mountpoint, sizeof(mountpoint), "%s", optarg);
+            break;
+
+        case 'f':
+            snprintf(filename, sizeof(filename), "%s", optarg);
+            break;
+
+        case 'r':
+            region_size = parse_size(optarg);
+            break;
+
+        case 's':
+            list = strdup(optarg);
+            num_io_sizes = 0;
+            for (tok = strtok_r(list, ",", &saveptr);
+                 (NULL != tok) && (num_io_sizes < 32);
+                 tok = strtok_r(NULL, ",", &saveptr)) {
+                io_sizes[num_io_sizes++] = parse_size(tok);
+            }
+            free(list);
+            break;
+
+        case 'p':
+            if (parse_names(optarg, placement_names, PLACE_MAX,
+                            use_placement)) {
+                print_usage();
+            }
+            break;
+
+        case 'P':
+            if (parse_names(optarg, pattern_names, PATTERN_MAX,
+                            use_pattern)) {
+                print_usage();
+            }
+            break;
+
+        case 't':
+            for (i = 0; i < TIER_MAX; i++) {
+                if (strcmp(optarg, tier_names[i]) == 0) {
+                    tier = (enum tier) i;
+                    break;
+                }
+            }
+            if (i == TIER_MAX) {
+                print_usage();
+            }
+            break;
+
+        case 'n':
+            num_reads = strtoull(optarg, NULL, 0);
+            break;
+
+        case 'S':
+            stride_blocks = strtoull(optarg, NULL, 0);
+            break;
+
+        case 'q':
+            queue_depth = atoi(optarg);
+            break;
+
+        case 'l':
+            laminate = 1;
+            break;
+
+        case 'h':
+        default:
+            print_usage();
+            break;
+        }
+    }
+
+    if (0 == num_io_sizes) {
+        io_sizes[num_io_sizes++] = 4 * KIB;
+        io_sizes[num_io_sizes++] = 64 * KIB;
+        io_sizes[num_io_sizes++] = 1 * MIB;
+    }
+
+    uint64_t max_io_size = 0;
+    for (i = 0; i < num_io_sizes; i++) {
+        if ((0 == io_sizes[i]) || (io_sizes[i] > region_size)) {
+            if (rank == 0) {
+                fprintf(stderr, "I/O size %" PRIu64 " must be between 1 and "
+                        "the region size (%" PRIu64 ")\n",
+                        io_sizes[i], region_size);
+            }
+            MPI_Finalize();
+            return -1;
+        }
+        if (io_sizes[i] > max_io_size) {
+            max_io_size = io_sizes[i];
+        }
+    }
+
+    if ((0 == num_reads) || (0 == stride_blocks) || (queue_depth < 1)) {
+        print_usage();
+    }
+    uint64_t nreads = (((num_reads + queue_depth - 1) / queue_depth) *
+                       queue_depth);
+    if ((nreads * total_ranks) > (uint64_t)INT_MAX) {
+        print_usage();
+    }
+
+    if (mountpoint[0] == '\0') {
+        snprintf(mountpoint, sizeof(mountpoint), "%s", DEFAULT_MOUNTPOINT);
+    }
+
+    /* use the same default file name on all ranks */
+    int pid = (int) getpid();
+    MPI_Bcast(&pid, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (filename[0] == '\0') {
+        snprintf(filename, sizeof(filename), "%s/read-bench.%d",
+                 mountpoint, pid);
+    } else if (filename[0] != '/') {
+        char name[PATH_MAX];
+        snprintf(name, sizeof(name), "%s", filename);
+        snprintf(filename, sizeof(filename), "%s/%s", mountpoint, name);
+    }
+
+    find_partners();
+    rand_state += (uint64_t)rank * 0x9E3779B97F4A7C15ULL;
+
+    ret = init_client();
+    if (ret) {
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    ret = write_region();
+    if (ret) {
+        unifyfs_finalize(fshdl);
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    char* buf = malloc(max_io_size * queue_depth);
+    unifyfs_io_request* reqs = calloc(queue_depth,
+                                      sizeof(unifyfs_io_request));
+    double* lat = calloc(nreads, sizeof(double));
+    if ((NULL == buf) || (NULL == reqs) || (NULL == lat)) {
+        fprintf(stderr, "[%d] failed to allocate read buffers\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, ENOMEM);
+    }
+
+    if ((rank == 0) && csv) {
+        printf("tier,placement,pattern,io_size,queue_depth,laminated,"
+               "ranks,nodes,reads,bytes,seconds,bandwidth_mibps,iops,"
+               "lat_mean_usec,lat_p50_usec,lat_p99_usec,lat_max_usec,"
+               "errors\n");
+    }
+
+    int place;
+    for (place = 0; place < PLACE_MAX; place++) {
+        if (!use_placement[place]) {
+            continue;
+        }
+
+        /* skip placements that are not possible on some rank */
+        int possible = (partner[place] >= 0);
+        int all_possible;
+        MPI_Allreduce(&possible, &all_possible, 1, MPI_INT, MPI_MIN,
+                      MPI_COMM_WORLD);
+        if (!all_possible) {
+            if (rank == 0) {
+                fprintf(stderr, "skipping placement %s with %d ranks on "
+                        "%d nodes\n", placement_names[place],
+                        total_ranks, num_nodes);
+            }
+            continue;
+        }
+
+        int pat;
+        for (pat = 0; pat < PATTERN_MAX; pat++) {
+            if (!use_pattern[pat]) {
+                continue;
+            }
+            for (i = 0; i < num_io_sizes; i++) {
+                run_case((enum placement) place, (enum pattern) pat,
+                         io_sizes[i], buf, reqs, lat);
+            }
+        }
+    }
+
+    free(buf);
+    free(reqs);
+    free(lat);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) {
+        unifyfs_rc urc = unifyfs_remove(fshdl, filename);
+        if (UNIFYFS_SUCCESS != urc) {
+            fprintf(stderr, "unifyfs_remove(%s) failed - %s\n",
+                    filename, unifyfs_rc_enum_description(urc));
+        }
+    }
+
+    unifyfs_finalize(fshdl);
+    free(tmp_program);
+    MPI_Finalize();
+    return 0;
+}
@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <time.h>
 
 
@@ -151,6 +152,7 @@ int main(int argc, char** argv)
 
     MPI_Barrier(MPI_COMM_WORLD);
 
+    double start = MPI_Wtime();
     if (mounted) {
         if (parallel) {
             ret = unifyfs_transfer_file_parallel(srcpath, dstpath);
@@ -165,6 +167,20 @@ int main(int argc, char** argv)
                         ret, strerror(ret));
             }
         }
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double secs = MPI_Wtime() - start;
+
+    if (mounted) {
+        /* report the aggregate bandwidth of the transfer */
+        struct stat sb;
+        if ((rank == 0) && (stat(srcpath, &sb) == 0) && (secs > 0.0)) {
+            double mib = (double)sb.st_size / (double)(1 << 20);
+            test_print_once(rank, "transferred %zu bytes in %.3f s "
+                            "(%.1f MiB/s)", (size_t)sb.st_size, secs,
+                            mib / secs);
+        }
         unifyfs_unmount();
     }
 
@@ -47,6 +47,7 @@ int extent_tree_init(struct extent_tree* tree)
     memset(tree, 0, sizeof(*tree));
     ABT_rwlock_create(&(tree->rwlock));
     RB_INIT(&(tree->head));
+    node_pool_init(&(tree->pool), sizeof(struct extent_tree_node), 0);
     return 0;
 }
 
@@ -56,21 +57,33 @@ int extent_tree_init(struct extent_tree* tree)
 void extent_tree_destroy(struct extent_tree* tree)
 {
     extent_tree_clear(tree);
+    node_pool_destroy(&(tree->pool));
     ABT_rwlock_free(&(tree->rwlock));
 }
 
-/* Allocate a node for the range tree.  Free node with free() when finished */
+/* Allocate a node for the range tree from the tree's node pool.
+ * Free node with extent_tree_node_free() when finished.
+ * Assumes the tree is write locked */
 static
-struct extent_tree_node* extent_tree_node_alloc(extent_metadata* extent)
+struct extent_tree_node* extent_tree_node_alloc(struct extent_tree* tree,
+                                                extent_metadata* extent)
 {
     /* allocate a new node structure */
-    struct extent_tree_node* node = calloc(1, sizeof(*node));
+    struct extent_tree_node* node = node_pool_alloc(&(tree->pool));
     if (NULL != node) {
         memcpy(&(node->extent), extent, sizeof(*extent));
     }
     return node;
 }
 
+/* Return a node to the tree's node pool.  Assumes the tree is write locked */
+static
+void extent_tree_node_free(struct extent_tree* tree,
+                           struct extent_tree_node* node)
+{
+    node_pool_free(&(tree->pool), node);
+}
+
 /*
  * Given two start/end ranges, return a new range from start1/end1 that
  * does not overlap start2/end2. The non-overlapping range is stored
@@ -120,24 +133,35 @@ static int get_non_overlapping_range(
     return 1;
 }
 
+/* returns true if extent b immediately follows extent a, both in file
+ * offset and in the same log */
+static inline
+bool extents_contiguous(extent_metadata* a,
+                        extent_metadata* b)
+{
+    return ((a->end + 1) == b->start) &&
+           (a->svr_rank == b->svr_rank) &&
+           (a->cli_id   == b->cli_id)   &&
+           (a->app_id   == b->app_id)   &&
+           (extent_log_pos_at(a, extent_length(a)) == b->log_pos);
+}
+
 /*
- * Add an entry to the range tree.  Returns 0 on success, nonzero otherwise.
+ * Add an entry to the range tree, assumes caller has write lock on tree.
+ * Returns 0 on success, nonzero otherwise.
  */
-int extent_tree_add(struct extent_tree* tree,
-                    struct extent_metadata* extent)
+static int extent_tree_add_locked(struct extent_tree* tree,
+                                  struct extent_metadata* extent)
 {
     /* assume we'll succeed */
     int ret = 0;
 
     /* Create node to define our new range */
-    struct extent_tree_node* node = extent_tree_node_alloc(extent);
+    struct extent_tree_node* node = extent_tree_node_alloc(tree, extent);
     if (!node) {
         return ENOMEM;
     }
 
-    /* lock the tree so we can modify it */
-    extent_tree_wrlock(tree);
-
     /* Try to insert our range into the RB tree.  If it overlaps with any other
      * range, then it is not inserted, and the overlapping range node is
      * returned in 'conflict'.  If 'conflict' is NULL, then there were no
@@ -159,13 +183,13 @@ int extent_tree_add(struct extent_tree* tree,
              * range in the tree defined in 'conflict'.
              * Delete the existing range. */
             RB_REMOVE(ext_tree, &tree->head, conflict);
-            free(conflict);
+            extent_tree_node_free(tree, conflict);
             tree->count--;
         } else {
             /* Part of the old range 'conflict' was non-overlapping. Create a
              * new smaller extent for that non-overlap portion. */
-            new_pos = conflict->extent.log_pos +
-                      (new_start - conflict->extent.start);
+            new_pos = extent_log_pos_at(&(conflict->extent),
+                                        new_start - conflict->extent.start);
             extent_metadata non_overlap_extent = {
                 .start    = new_start,
                 .end      = new_end,
@@ -175,12 +199,12 @@ int extent_tree_add(struct extent_tree* tree,
                 .cli_id   = conflict->extent.cli_id
             };
             struct extent_tree_node* non_overlap =
-                extent_tree_node_alloc(&non_overlap_extent);
+                extent_tree_node_alloc(tree, &non_overlap_extent);
             if (NULL == non_overlap) {
                 /* failed to allocate memory for range node,
                  * bail out and release lock without further
                  * changing state of extent tree */
-                free(node);
+                extent_tree_node_free(tree, node);
                 ret = ENOMEM;
                 goto release_add;
             }
@@ -191,8 +215,8 @@ int extent_tree_add(struct extent_tree* tree,
             if (non_overlap_extent.end < conflict->extent.end) {
                 new_start = non_overlap_extent.end + 1;
                 new_end   = conflict->extent.end;
-                new_pos   = conflict->extent.log_pos +
-                            (new_start - conflict->extent.start);
+                new_pos   = extent_log_pos_at(&(conflict->extent),
+                                    new_start - conflict->extent.start);
                 extent_metadata tail_extent = {
                     .start    = new_start,
                     .end      = new_end,
@@ -201,13 +225,13 @@ int extent_tree_add(struct extent_tree* tree,
                     .app_id   = conflict->extent.app_id,
                     .cli_id   = conflict->extent.cli_id
                 };
-                conflict_tail = extent_tree_node_alloc(&tail_extent);
+                conflict_tail = extent_tree_node_alloc(tree, &tail_extent);
                 if (NULL == conflict_tail) {
                     /* failed to allocate memory for range node,
                      * bail out and release lock without further
                      * changing state of extent tree */
-                    free(node);
-                    free(non_overlap);
+                    extent_tree_node_free(tree, node);
+                    extent_tree_node_free(tree, non_overlap);
                     ret = ENOMEM;
                     goto release_add;
                 }
@@ -215,7 +239,7 @@ int extent_tree_add(struct extent_tree* tree,
 
             /* Remove old range 'conflict' and release it */
             RB_REMOVE(ext_tree, &tree->head, conflict);
-            free(conflict);
+            extent_tree_node_free(tree, conflict);
             tree->count--;
 
             /* Insert the non-overlapping part of the old range */
@@ -247,8 +271,9 @@ int extent_tree_add(struct extent_tree* tree,
     if ((NULL != prev) && (prev->extent.end + 1 == target->extent.start)) {
         /* found an extent that ends just before the new extent starts,
          * check whether they are also contiguous in the log */
-        unsigned long pos_next = prev->extent.log_pos +
-                                 extent_length(&(prev->extent));
+        unsigned long pos_next =
+            extent_log_pos_at(&(prev->extent),
+                              extent_length(&(prev->extent)));
         if ((prev->extent.svr_rank == target->extent.svr_rank) &&
             (prev->extent.cli_id   == target->extent.cli_id)   &&
             (prev->extent.app_id   == target->extent.app_id)   &&
@@ -260,7 +285,7 @@ int extent_tree_add(struct extent_tree* tree,
 
             /* delete new extent from the tree and free it */
             RB_REMOVE(ext_tree, &tree->head, target);
-            free(target);
+            extent_tree_node_free(tree, target);
             tree->count--;
 
             /* update target to point at previous extent since we just
@@ -275,8 +300,9 @@ int extent_tree_add(struct extent_tree* tree,
     if ((NULL != next) && (target->extent.end + 1 == next->extent.start)) {
         /* found a extent that starts just after the new extent ends,
          * check whether they are also contiguous in the log */
-        unsigned long pos_next = target->extent.log_pos +
-                                 extent_length(&(target->extent));
+        unsigned long pos_next =
+            extent_log_pos_at(&(target->extent),
+                              extent_length(&(target->extent)));
         if (target->extent.svr_rank == next->extent.svr_rank &&
             target->extent.cli_id   == next->extent.cli_id   &&
             target->extent.app_id   == next->extent.app_id   &&
@@ -288,19 +314,262 @@ int extent_tree_add(struct extent_tree* tree,
 
             /* delete next extent from the tree and free it */
             RB_REMOVE(ext_tree, &tree->head, next);
-            free(next);
+            extent_tree_node_free(tree, next);
             tree->count--;
         }
     }
 
 release_add:
 
+    return ret;
+}
+
+/*
+ * Add an entry to the range tree.  Returns 0 on success, nonzero otherwise.
+ */
+int extent_tree_add(struct extent_tree* tree,
+                    struct extent_metadata* extent)
+{
+    /* lock the tree so we can modify it */
+    extent_tree_wrlock(tree);
+
+    int ret = extent_tree_add_locked(tree, extent);
+
     /* done modifying the tree */
     extent_tree_unlock(tree);
 
     return ret;
 }
 
+/* Link the sorted array of nodes [lo, hi] into a balanced subtree,
+ * and return its root. Nodes at the deepest level (red_depth) are
+ * colored red, all others black, which satisfies the red-black
+ * properties since the depths of all leaves differ by at most one. */
+static struct extent_tree_node* build_balanced_subtree(
+    struct extent_tree_node** nodes,
+    long lo,
+    long hi,
+    struct extent_tree_node* parent,
+    int depth,
+    int red_depth)
+{
+    if (lo > hi) {
+        return NULL;
+    }
+
+    long mid = lo + ((hi - lo) / 2);
+    struct extent_tree_node* node = nodes[mid];
+    RB_PARENT(node, entry) = parent;
+    RB_COLOR(node, entry) = (depth == red_depth) ? RB_RED : RB_BLACK;
+    RB_LEFT(node, entry) = build_balanced_subtree(nodes, lo, mid - 1, node,
+                                                  depth + 1, red_depth);
+    RB_RIGHT(node, entry) = build_balanced_subtree(nodes, mid + 1, hi, node,
+                                                   depth + 1, red_depth);
+    return node;
+}
+
+/*
+ * Merge a sorted array of non-overlapping extents into the tree in linear
+ * time, by relinking the existing and new nodes into a balanced tree.
+ * Contiguous ranges are coalesced. This is only done if none of the new
+ * extents overlap existing ranges, which is reported in *merged.
+ * Assumes caller has write lock on tree. Returns 0 on success, nonzero
+ * otherwise (in which case the tree is unchanged).
+ */
+static int extent_tree_merge_locked(struct extent_tree* tree,
+                                    int num_extents,
+                                    struct extent_metadata* extents,
+                                    bool* merged)
+{
+    *merged = false;
+
+    /* check that the new extents fall in gaps between existing ranges */
+    struct extent_tree_node* node = RB_MIN(ext_tree, &tree->head);
+    int i = 0;
+    while ((NULL != node) && (i < num_extents)) {
+        if (extents[i].end < node->extent.start) {
+            i++;
+        } else if (extents[i].start > node->extent.end) {
+            node = RB_NEXT(ext_tree, &tree->head, node);
+        } else {
+            /* overlap, caller must add extents one at a time */
+            return 0;
+        }
+    }
+
+    size_t n_old = (size_t) tree->count;
+    size_t n_total = n_old + (size_t) num_extents;
+    struct extent_tree_node** old_nodes = NULL;
+    struct extent_tree_node** new_nodes = NULL;
+    struct extent_tree_node** nodes = calloc(n_total, sizeof(*nodes));
+    if (n_old) {
+        old_nodes = calloc(n_old, sizeof(*old_nodes));
+    }
+    new_nodes = calloc(num_extents, sizeof(*new_nodes));
+    if ((NULL == nodes) || (NULL == new_nodes) ||
+        (n_old && (NULL == old_nodes))) {
+        free(nodes);
+        free(old_nodes);
+        free(new_nodes);
+        return ENOMEM;
+    }
+
+    /* allocate all new nodes up front, so we can bail out without
+     * having modified the tree */
+    for (i = 0; i < num_extents; i++) {
+        new_nodes[i] = extent_tree_node_alloc(tree, extents + i);
+        if (NULL == new_nodes[i]) {
+            while (i-- > 0) {
+                extent_tree_node_free(tree, new_nodes[i]);
+            }
+            free(nodes);
+            free(old_nodes);
+            free(new_nodes);
+            return ENOMEM;
+        }
+    }
+
+    size_t n_iter = 0;
+    node = NULL;
+    while ((node = extent_tree_iter(tree, node)) != NULL) {
+        old_nodes[n_iter++] = node;
+    }
+    assert(n_iter == n_old);
+
+    /* merge old and new nodes by offset, coalescing contiguous ranges.
+     * nodes that were coalesced are released once the tree is rebuilt */
+    size_t n_nodes = 0;
+    size_t o = 0;
+    int n = 0;
+    while ((o < n_old) || (n < num_extents)) {
+        struct extent_tree_node* next;
+        if ((n == num_extents) ||
+            ((o < n_old) &&
+             (old_nodes[o]->extent.start < new_nodes[n]->extent.start))) {
+            next = old_nodes[o];
+            old_nodes[o++] = NULL;
+        } else {
+            next = new_nodes[n];
+            new_nodes[n++] = NULL;
+        }
+
+        if (n_nodes > 0) {
+            struct extent_tree_node* last = nodes[n_nodes - 1];
+            if (extents_contiguous(&(last->extent), &(next->extent))) {
+                last->extent.end = next->extent.end;
+                extent_tree_node_free(tree, next);
+                continue;
+            }
+        }
+        nodes[n_nodes++] = next;
+    }
+    free(old_nodes);
+    free(new_nodes);
+
+    /* leaves of the balanced tree are at depth floor(log2(n)) or one
+     * less, color the deepest level red */
+    int red_depth = 0;
+    while (((size_t)2 << red_depth) <= n_nodes) {
+        red_depth++;
+    }
+
+    RB_ROOT(&tree->head) = build_balanced_subtree(nodes, 0,
+                                                  (long)n_nodes - 1,
+                                                  NULL, 0, red_depth);
+    if (red_depth == 0) {
+        /* a single node tree, root must be black */
+        RB_COLOR(RB_ROOT(&tree->head), entry) = RB_BLACK;
+    }
+    tree->count = (unsigned long) n_nodes;
+    tree->max = MAX(tree->max, nodes[n_nodes - 1]->extent.end);
+
+    free(nodes);
+
+    *merged = true;
+    return 0;
+}
+
+/*
+ * Add an array of extents to the range tree, in array order (later extents
+ * overwrite earlier ones). The tree is locked once for the whole batch.
+ *
+ * If the extents are sorted and non-overlapping, as they are in a single
+ * client sync, and do not overlap existing ranges, they are merged into
+ * the tree in time linear in the size of the tree and the batch.
+ * Otherwise, extents that start after the last range in the tree are
+ * appended without conflict checks, and are coalesced in place with that
+ * range when they are contiguous with it.
+ *
+ * Returns 0 on success, nonzero otherwise.
+ */
+int extent_tree_add_batch(struct extent_tree* tree,
+                          int num_extents,
+                          struct extent_metadata* extents)
+{
+    int ret = 0;
+
+    if (num_extents <= 0) {
+        return 0;
+    }
+
+    /* check whether the batch is sorted and non-overlapping */
+    bool sorted = true;
+    for (int i = 1; i < num_extents; i++) {
+        if (extents[i].start <= extents[i - 1].end) {
+            sorted = false;
+            break;
+        }
+    }
+
+    extent_tree_wrlock(tree);
+
+    /* relinking the whole tree costs time linear in its size, so only do
+     * it when the batch is large relative to the tree */
+    if (sorted && (((unsigned long)num_extents * 16) >= tree->count)) {
+        bool merged;
+        ret = extent_tree_merge_locked(tree, num_extents, extents, &merged);
+        if (ret || merged) {
+            extent_tree_unlock(tree);
+            return ret;
+        }
+    }
+
+    struct extent_tree_node* tail = RB_MAX(ext_tree, &tree->head);
+    for (int i = 0; i < num_extents; i++) {
+        extent_metadata* extent = extents + i;
+        if ((NULL == tail) || (extent->start > tail->extent.end)) {
+            /* extent follows every range in the tree */
+            if ((NULL != tail) &&
+                extents_contiguous(&(tail->extent), extent)) {
+                /* extend the last range in place */
+                tail->extent.end = extent->end;
+            } else {
+                struct extent_tree_node* node =
+                    extent_tree_node_alloc(tree, extent);
+                if (NULL == node) {
+                    ret = ENOMEM;
+                    break;
+                }
+                RB_INSERT(ext_tree, &tree->head, node);
+                tree->count++;
+                tail = node;
+            }
+            tree->max = MAX(tree->max, extent->end);
+        } else {
+            /* extent overlaps or precedes existing ranges */
+            ret = extent_tree_add_locked(tree, extent);
+            if (ret) {
+                break;
+            }
+            tail = RB_MAX(ext_tree, &tree->head);
+        }
+    }
+
+    extent_tree_unlock(tree);
+
+    return ret;
+}
+
 /* search tree for entry that overlaps with given start/end
  * offsets, return first overlapping entry if found, NULL otherwise,
  * assumes caller has lock on tree */
@@ -318,17 +587,15 @@ struct extent_tree_node* extent_tree_find(
         .app_id   = 0,
         .cli_id   = 0
     };
-    struct extent_tree_node* node = extent_tree_node_alloc(&start_byte);
-    if (NULL == node) {
-        return NULL;
-    }
+    struct extent_tree_node key;
+    memset(&key, 0, sizeof(key));
+    key.extent = start_byte;
 
     /* search tree for either a range that overlaps with
      * the target range (starting byte), or otherwise the
-     * node for the next biggest starting byte */
-    struct extent_tree_node* next = RB_NFIND(ext_tree, &tree->head, node);
-
-    free(node);
+     * node for the next biggest starting byte. the search key lives on
+     * the stack, since callers may only hold a read lock on the tree */
+    struct extent_tree_node* next = RB_NFIND(ext_tree, &tree->head, &key);
 
     /* we may have found a node that doesn't include our starting
      * byte offset, but it would be the range with the lowest
@@ -379,7 +646,7 @@ int extent_tree_truncate(
             LOGDBG("removing node [%lu, %lu] due to truncate=%lu",
                    node->extent.start, node->extent.end, size);
             RB_REMOVE(ext_tree, &tree->head, oldnode);
-            free(oldnode);
+            extent_tree_node_free(tree, oldnode);
 
             /* decrement the number of extents in the tree */
             tree->count--;
@@ -499,29 +766,12 @@ void extent_tree_unlock(struct extent_tree* tree)
  */
 void extent_tree_clear(struct extent_tree* tree)
 {
-    struct extent_tree_node* node = NULL;
-    struct extent_tree_node* oldnode = NULL;
-
     extent_tree_wrlock(tree);
 
-    if (RB_EMPTY(&tree->head)) {
-        /* extent_tree is empty, nothing to do */
-        extent_tree_unlock(tree);
-        return;
-    }
-
-    /* Remove and free each node in the tree */
-    while ((node = extent_tree_iter(tree, node)) != NULL) {
-        if (NULL != oldnode) {
-            RB_REMOVE(ext_tree, &tree->head, oldnode);
-            free(oldnode);
-        }
-        oldnode = node;
-    }
-    if (NULL != oldnode) {
-        RB_REMOVE(ext_tree, &tree->head, oldnode);
-        free(oldnode);
-    }
+    /* all nodes come from the tree's node pool, so rather than removing
+     * each node, just reset the tree and release the nodes all at once */
+    RB_INIT(&tree->head);
+    node_pool_reset(&(tree->pool));
 
     tree->count = 0;
     tree->max   = 0;
@@ -561,7 +811,7 @@ static void chunk_req_from_extent(
     if (offset < req_offset) {
         diff = req_offset - offset;
         offset = req_offset;
-        log_offset += diff;
+        log_offset = extent_log_pos_at(&(n->extent), diff);
         nbytes -= diff;
     }
 
@@ -16,6 +16,7 @@
 #define __EXTENT_TREE_H__
 
 #include "unifyfs_global.h"
+#include "node_pool.h"
 
 typedef struct extent_metadata {
     /* extent metadata */
@@ -35,6 +36,22 @@ typedef struct extent_metadata {
 #define extent_offset(meta_ptr) \
     (off_t)((meta_ptr)->start)
 
+/* true if the extent is a zero-filled hole with no data in a log */
+#define extent_is_hole(meta_ptr) \
+    unifyfs_is_hole_log_pos((meta_ptr)->log_pos)
+
+/* Return the log position of the byte 'delta' bytes into the extent.
+ * Every byte of a hole extent has the hole log position. */
+static inline
+unsigned long extent_log_pos_at(extent_metadata* meta,
+                                unsigned long delta)
+{
+    if (extent_is_hole(meta)) {
+        return meta->log_pos;
+    }
+    return meta->log_pos + delta;
+}
+
 struct extent_tree_node {
     RB_ENTRY(extent_tree_node) entry;
     struct extent_metadata extent;
@@ -45,6 +62,7 @@ struct extent_tree {
     ABT_rwlock rwlock;
     unsigned long count;     /* number of segments stored in tree */
     unsigned long max;       /* maximum logical offset value in the tree */
+    node_pool pool;          /* allocator for tree nodes */
 };
 
 /* Returns 0 on success, positive non-zero error code otherwise */
@@ -67,6 +85,15 @@ void extent_tree_destroy(struct extent_tree* tree);
 int extent_tree_add(struct extent_tree* tree,
                     struct extent_metadata* extent);
 
+/*
+ * Add an array of extents to the range tree in a single pass. Extents are
+ * applied in array order. Sorted, non-overlapping batches are merged
+ * efficiently. Returns 0 on success, nonzero otherwise.
+ */
+int extent_tree_add_batch(struct extent_tree* tree,
+                          int num_extents,
+                          struct extent_metadata* extents);
+
 /* search tree for entry that overlaps with given start/end
  * offsets, return first overlapping entry if found, NULL otherwise,
  * assumes caller has lock on tree */
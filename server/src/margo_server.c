@@ -35,6 +35,7 @@ double margo_client_server_timeout_msec =
 double margo_server_server_timeout_msec =
     UNIFYFS_MARGO_SERVER_SERVER_TIMEOUT_MSEC;
 int  margo_use_progress_thread = 1;
+bool margo_tune_tx_size; // = false
 
 // records pmi rank, server address string, and server address
 // for each server for use in server-to-server rpcs
@@ -206,6 +207,11 @@ static void register_server_server_rpcs(margo_instance_id mid)
                        laminate_bcast_in_t, laminate_bcast_out_t,
                        laminate_bcast_rpc);
 
+    unifyfsd_rpc_context->rpcs.list_files_id =
+        MARGO_REGISTER(mid, "list_files_rpc",
+                       list_files_in_t, list_files_out_t,
+                       list_files_rpc);
+
     unifyfsd_rpc_context->rpcs.metaget_id =
         MARGO_REGISTER(mid, "metaget_rpc",
                        metaget_in_t, metaget_out_t,
@@ -216,6 +222,11 @@ static void register_server_server_rpcs(margo_instance_id mid)
                        metaset_in_t, metaset_out_t,
                        metaset_rpc);
 
+    unifyfsd_rpc_context->rpcs.readdir_id =
+        MARGO_REGISTER(mid, "readdir_rpc",
+                       readdir_in_t, readdir_out_t,
+                       readdir_rpc);
+
     unifyfsd_rpc_context->rpcs.server_pid_id =
         MARGO_REGISTER(mid, "server_pid_rpc",
                        server_pid_in_t, server_pid_out_t,
@@ -311,6 +322,14 @@ static void register_client_server_rpcs(margo_instance_id mid)
                    unifyfs_metaset_in_t, unifyfs_metaset_out_t,
                    unifyfs_metaset_rpc);
 
+    MARGO_REGISTER(mid, "unifyfs_list_files_rpc",
+                   unifyfs_list_files_in_t, unifyfs_list_files_out_t,
+                   unifyfs_list_files_rpc);
+
+    MARGO_REGISTER(mid, "unifyfs_readdir_rpc",
+                   unifyfs_readdir_in_t, unifyfs_readdir_out_t,
+                   unifyfs_readdir_rpc);
+
     MARGO_REGISTER(mid, "unifyfs_fsync_rpc",
                    unifyfs_fsync_in_t, unifyfs_fsync_out_t,
                    unifyfs_fsync_rpc);
@@ -348,6 +367,10 @@ static void register_client_server_rpcs(margo_instance_id mid)
                    unifyfs_get_gfids_in_t, unifyfs_get_gfids_out_t,
                    unifyfs_get_gfids_rpc);
 
+    MARGO_REGISTER(mid, "unifyfs_stats_rpc",
+                   unifyfs_stats_in_t, unifyfs_stats_out_t,
+                   unifyfs_stats_rpc);
+
     /* register the RPCs we call (and capture assigned hg_id_t) */
     unifyfsd_rpc_context->rpcs.client_heartbeat_id =
             MARGO_REGISTER(mid, "unifyfs_heartbeat_rpc",
@@ -380,6 +403,47 @@ static void register_client_server_rpcs(margo_instance_id mid)
                        NULL);
 }
 
+/* create latency histograms for the RPCs this server invokes */
+static void register_rpc_stats(void)
+{
+    server_rpcs_t* rpcs = &(unifyfsd_rpc_context->rpcs);
+
+#define SERVER_RPC_STATS(name) \
+    unifyfs_stats_hist_register((uint64_t) rpcs->name##_id, #name "_rpc")
+
+    /* server-server rpcs */
+    SERVER_RPC_STATS(bootstrap_complete_bcast);
+    SERVER_RPC_STATS(chunk_read_request);
+    SERVER_RPC_STATS(chunk_read_response);
+    SERVER_RPC_STATS(extent_add);
+    SERVER_RPC_STATS(extent_bcast);
+    SERVER_RPC_STATS(extent_lookup);
+    SERVER_RPC_STATS(filesize);
+    SERVER_RPC_STATS(laminate);
+    SERVER_RPC_STATS(laminate_bcast);
+    SERVER_RPC_STATS(list_files);
+    SERVER_RPC_STATS(metaget);
+    SERVER_RPC_STATS(metaset);
+    SERVER_RPC_STATS(readdir);
+    SERVER_RPC_STATS(fileattr_bcast);
+    SERVER_RPC_STATS(server_pid);
+    SERVER_RPC_STATS(transfer);
+    SERVER_RPC_STATS(transfer_bcast);
+    SERVER_RPC_STATS(truncate);
+    SERVER_RPC_STATS(truncate_bcast);
+    SERVER_RPC_STATS(unlink_bcast);
+    SERVER_RPC_STATS(metaget_all_bcast);
+
+    /* server-client rpcs */
+    SERVER_RPC_STATS(client_heartbeat);
+    SERVER_RPC_STATS(client_mread_data);
+    SERVER_RPC_STATS(client_mread_complete);
+    SERVER_RPC_STATS(client_transfer_complete);
+    SERVER_RPC_STATS(client_unlink_callback);
+
+#undef SERVER_RPC_STATS
+}
+
 /* margo_server_rpc_init
  *
  * Initialize the server's Margo RPC functionality, for
@@ -441,6 +505,127 @@ int margo_server_rpc_init(void)
         register_server_server_rpcs(mid);
     }
 
+    register_rpc_stats();
+
+    return rc;
+}
+
+/* Return the transfer size from UNIFYFS_TX_TUNE_MIN_SIZE to
+ * UNIFYFS_TX_TUNE_MAX_SIZE with the highest throughput for bulk transfers
+ * of a local buffer to another through the given margo instance, or 0
+ * if the transfers failed. A larger size is only chosen if it is at
+ * least 5% faster, since smaller transfers pin less memory. */
+static size_t probe_bulk_tx_size(margo_instance_id mid,
+                                 const char* mid_name)
+{
+    size_t best_sz = 0;
+    double best_rate = 0.0;
+
+    hg_size_t total = UNIFYFS_TX_TUNE_BYTES;
+    void* src = malloc(total);
+    void* dst = malloc(total);
+    if ((NULL == src) || (NULL == dst)) {
+        LOGERR("failed to allocate %s transfer probe buffers", mid_name);
+        free(src);
+        free(dst);
+        return 0;
+    }
+    memset(src, 1, total);
+    memset(dst, 0, total);
+
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    hg_bulk_t src_bulk = HG_BULK_NULL;
+    hg_bulk_t dst_bulk = HG_BULK_NULL;
+    hg_return_t hret = margo_addr_self(mid, &self_addr);
+    if (hret == HG_SUCCESS) {
+        hret = margo_bulk_create(mid, 1, &src, &total,
+                                 HG_BULK_READ_ONLY, &src_bulk);
+    }
+    if (hret == HG_SUCCESS) {
+        hret = margo_bulk_create(mid, 1, &dst, &total,
+                                 HG_BULK_READWRITE, &dst_bulk);
+    }
+
+    /* the first size is probed twice, to warm up the buffers */
+    size_t tx_sz = UNIFYFS_TX_TUNE_MIN_SIZE;
+    int warmup = 1;
+    while ((hret == HG_SUCCESS) && (tx_sz <= UNIFYFS_TX_TUNE_MAX_SIZE)) {
+        double start = ABT_get_wtime();
+        for (hg_size_t off = 0; off < total; off += tx_sz) {
+            hg_size_t len = ((total - off) < tx_sz) ? (total - off) : tx_sz;
+            hret = margo_bulk_transfer(mid, HG_BULK_PULL, self_addr,
+                                       src_bulk, off, dst_bulk, off, len);
+            if (hret != HG_SUCCESS) {
+                LOGERR("%s transfer probe of %zu bytes failed - %s",
+                       mid_name, (size_t)len, HG_Error_to_string(hret));
+                break;
+            }
+        }
+        double secs = ABT_get_wtime() - start;
+        if ((hret != HG_SUCCESS) || warmup) {
+            warmup = 0;
+            continue;
+        }
+
+        double rate = (secs > 0.0) ? ((double)total / secs) : 0.0;
+        LOGDBG("%s transfer size %zu: %.1f MiB/s",
+               mid_name, tx_sz, rate / (double)MIB);
+        if ((0 == best_sz) || (rate > (best_rate * 1.05))) {
+            best_sz = tx_sz;
+            best_rate = rate;
+        }
+        tx_sz *= 2;
+    }
+    if (hret != HG_SUCCESS) {
+        best_sz = 0;
+    }
+
+    if (dst_bulk != HG_BULK_NULL) {
+        margo_bulk_free(dst_bulk);
+    }
+    if (src_bulk != HG_BULK_NULL) {
+        margo_bulk_free(src_bulk);
+    }
+    if (self_addr != HG_ADDR_NULL) {
+        margo_addr_free(mid, self_addr);
+    }
+    free(src);
+    free(dst);
+    return best_sz;
+}
+
+/* margo_server_tune_tx_sizes
+ *
+ * Measure bulk transfer throughput at several sizes, and use the best
+ * sizes for bulk transfers (server-server instance) and for read data
+ * sent to clients (client-server instance). Sizes are left unchanged
+ * if the measurements fail.
+ */
+int margo_server_tune_tx_sizes(void)
+{
+    if (NULL == unifyfsd_rpc_context) {
+        return EINVAL;
+    }
+
+    int rc = UNIFYFS_SUCCESS;
+    size_t bulk_sz = probe_bulk_tx_size(unifyfsd_rpc_context->svr_mid,
+                                        "server-server");
+    if (bulk_sz > 0) {
+        unifyfs_set_bulk_tx_size(bulk_sz);
+    } else {
+        rc = UNIFYFS_ERROR_MARGO;
+    }
+
+    size_t data_sz = probe_bulk_tx_size(unifyfsd_rpc_context->shm_mid,
+                                        "client-server");
+    if (data_sz > 0) {
+        server_data_tx_size = data_sz;
+    } else {
+        rc = UNIFYFS_ERROR_MARGO;
+    }
+
+    LOGINFO("tuned transfer sizes: bulk=%zu data=%zu",
+            unifyfs_get_bulk_tx_size(), server_data_tx_size);
     return rc;
 }
 
@@ -502,7 +687,7 @@ int margo_connect_server(int rank)
     /* lookup rpc address for this server */
     char* margo_addr_str = rpc_lookup_remote_server_addr(rank);
     if (NULL == margo_addr_str) {
-        LOGERR("server index=%zu - margo server lookup failed", rank);
+        LOGERR("server index=%d - margo server lookup failed", rank);
         return (int)UNIFYFS_ERROR_KEYVAL;
     }
     LOGDBG("server rank=%d, margo_addr=%s", rank, margo_addr_str);
@@ -512,7 +697,7 @@ int margo_connect_server(int rank)
                                          server->margo_svr_addr_str,
                                          &(server->margo_svr_addr));
     if (hret != HG_SUCCESS) {
-        LOGERR("server index=%zu - margo_addr_lookup(%s) failed",
+        LOGERR("server index=%d - margo_addr_lookup(%s) failed",
                rank, margo_addr_str);
         ret = UNIFYFS_ERROR_MARGO;
     }
@@ -610,11 +795,16 @@ static hg_handle_t create_client_handle(hg_id_t id,
 static int forward_to_client(hg_handle_t hdl, void* input_ptr)
 {
     double timeout_msec = margo_client_server_timeout_msec;
+    uint64_t start = unifyfs_stats_now_usec();
     hg_return_t hret = margo_forward_timed(hdl, input_ptr, timeout_msec);
     if (hret != HG_SUCCESS) {
         LOGWARN("margo_forward_timed() failed - %s", HG_Error_to_string(hret));
         return UNIFYFS_ERROR_MARGO;
     }
+    const struct hg_info* info = margo_get_info(hdl);
+    if (NULL != info) {
+        unifyfs_stats_hist_record(info->id, start);
+    }
     return UNIFYFS_SUCCESS;
 }
 
@@ -715,6 +905,8 @@ int invoke_client_mread_req_data_rpc(int app_id,
         margo_destroy(handle);
         return rc;
     }
+    unifyfs_stats_add(UNIFYFS_STAT_SERVER_CLIENT_DATA_BYTES,
+                      (int64_t)extent_size);
 
     /* decode response */
     int ret;
@@ -41,8 +41,10 @@ typedef struct ServerRpcIds {
     hg_id_t filesize_id;
     hg_id_t laminate_id;
     hg_id_t laminate_bcast_id;
+    hg_id_t list_files_id;
     hg_id_t metaget_id;
     hg_id_t metaset_id;
+    hg_id_t readdir_id;
     hg_id_t fileattr_bcast_id;
     hg_id_t server_pid_id;
     hg_id_t transfer_id;
@@ -75,10 +77,14 @@ extern int  margo_client_server_pool_sz;
 extern int  margo_server_server_pool_sz;
 extern double margo_client_server_timeout_msec;
 extern double margo_server_server_timeout_msec;
+extern bool margo_tune_tx_size;
 
 int margo_server_rpc_init(void);
 int margo_server_rpc_finalize(void);
 
+/* measure bulk transfer throughput to choose transfer sizes */
+int margo_server_tune_tx_sizes(void);
+
 int margo_connect_server(int rank);
 int margo_connect_servers(void);
 
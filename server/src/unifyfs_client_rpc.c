@@ -730,6 +730,138 @@ static void unifyfs_unlink_rpc(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(unifyfs_unlink_rpc)
 
+/* given an app_id, client_id, and global file id,
+ * return a page of entries of the directory */
+static void unifyfs_readdir_rpc(hg_handle_t handle)
+{
+    int ret = UNIFYFS_SUCCESS;
+    hg_return_t hret;
+
+    /* get input params */
+    unifyfs_readdir_in_t* in = malloc(sizeof(*in));
+    if (NULL == in) {
+        ret = ENOMEM;
+    } else {
+        hret = margo_get_input(handle, in);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_get_input() failed");
+            ret = UNIFYFS_ERROR_MARGO;
+        } else {
+            client_rpc_req_t* req = malloc(sizeof(client_rpc_req_t));
+            if (NULL == req) {
+                ret = ENOMEM;
+            } else {
+                unifyfs_fops_ctx_t ctx = {
+                    .app_id = in->app_id,
+                    .client_id = in->client_id,
+                };
+                req->req_type = UNIFYFS_CLIENT_RPC_READDIR;
+                req->handle = handle;
+                req->input = (void*) in;
+                req->bulk_buf = NULL;
+                req->bulk_sz = 0;
+                ret = rm_submit_client_rpc_request(&ctx, req);
+            }
+
+            if (ret != UNIFYFS_SUCCESS) {
+                if (NULL != req) {
+                    free(req);
+                }
+                margo_free_input(handle, in);
+            }
+        }
+    }
+
+    /* if we hit an error during request submission, respond with the error */
+    if (ret != UNIFYFS_SUCCESS) {
+        if (NULL != in) {
+            free(in);
+        }
+
+        /* return to caller */
+        unifyfs_readdir_out_t out;
+        out.ret = (int32_t) ret;
+        out.num_entries = 0;
+        out.end_of_dir = 0;
+        hret = margo_respond(handle, &out);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_respond() failed");
+        }
+
+        /* free margo resources */
+        margo_destroy(handle);
+    }
+
+}
+DEFINE_MARGO_RPC_HANDLER(unifyfs_readdir_rpc)
+
+/* given an app_id, client_id, a listing cursor, and a file filter,
+ * return a page of file records */
+static void unifyfs_list_files_rpc(hg_handle_t handle)
+{
+    int ret = UNIFYFS_SUCCESS;
+    hg_return_t hret;
+
+    /* get input params */
+    unifyfs_list_files_in_t* in = malloc(sizeof(*in));
+    if (NULL == in) {
+        ret = ENOMEM;
+    } else {
+        hret = margo_get_input(handle, in);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_get_input() failed");
+            ret = UNIFYFS_ERROR_MARGO;
+        } else {
+            client_rpc_req_t* req = malloc(sizeof(client_rpc_req_t));
+            if (NULL == req) {
+                ret = ENOMEM;
+            } else {
+                unifyfs_fops_ctx_t ctx = {
+                    .app_id = in->app_id,
+                    .client_id = in->client_id,
+                };
+                req->req_type = UNIFYFS_CLIENT_RPC_LIST_FILES;
+                req->handle = handle;
+                req->input = (void*) in;
+                req->bulk_buf = NULL;
+                req->bulk_sz = 0;
+                ret = rm_submit_client_rpc_request(&ctx, req);
+            }
+
+            if (ret != UNIFYFS_SUCCESS) {
+                if (NULL != req) {
+                    free(req);
+                }
+                margo_free_input(handle, in);
+            }
+        }
+    }
+
+    /* if we hit an error during request submission, respond with the error */
+    if (ret != UNIFYFS_SUCCESS) {
+        if (NULL != in) {
+            free(in);
+        }
+
+        /* return to caller */
+        unifyfs_list_files_out_t out;
+        out.ret = (int32_t) ret;
+        out.num_files = 0;
+        out.page_used = 0;
+        out.next_rank = -1;
+        out.next_gfid = 0;
+        hret = margo_respond(handle, &out);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_respond() failed");
+        }
+
+        /* free margo resources */
+        margo_destroy(handle);
+    }
+
+}
+DEFINE_MARGO_RPC_HANDLER(unifyfs_list_files_rpc)
+
 /* given an app_id, client_id, and global file id,
  * laminate file */
 static void unifyfs_laminate_rpc(hg_handle_t handle)
@@ -998,3 +1130,59 @@ static void unifyfs_node_local_extents_get_rpc(hg_handle_t handle)
     }
 }
 DEFINE_MARGO_RPC_HANDLER(unifyfs_node_local_extents_get_rpc)
+
+/* returns a report of the server's performance counters */
+static void unifyfs_stats_rpc(hg_handle_t handle)
+{
+    int ret = UNIFYFS_SUCCESS;
+    hg_return_t hret;
+    unifyfs_stats_out_t out;
+    out.report_size = 0;
+
+    /* get input params */
+    unifyfs_stats_in_t in;
+    hret = margo_get_input(handle, &in);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_get_input() failed");
+        ret = UNIFYFS_ERROR_MARGO;
+    } else {
+        char* stats = NULL;
+        size_t stats_len = 0;
+        ret = unifyfs_stats_report(&stats, &stats_len);
+        if (ret == UNIFYFS_SUCCESS) {
+            /* prefix report with our rank and host */
+            char* report = NULL;
+            int len = asprintf(&report, "unifyfsd rank %d on %s\n%s",
+                               glb_pmi_rank, glb_host, stats);
+            free(stats);
+            if (len < 0) {
+                ret = ENOMEM;
+            } else {
+                /* include terminating NUL */
+                hg_size_t report_sz = (hg_size_t)len + 1;
+                hg_size_t xfer_sz = report_sz;
+                if (xfer_sz > in.bulk_size) {
+                    xfer_sz = in.bulk_size;
+                }
+                out.report_size = report_sz;
+
+                /* push report to client buffer */
+                ret = push_margo_bulk_buffer(handle, in.bulk_report,
+                                             (void*) report, xfer_sz);
+                free(report);
+            }
+        }
+        margo_free_input(handle, &in);
+    }
+
+    /* return to caller */
+    out.ret = (int32_t) ret;
+    hret = margo_respond(handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
+    }
+
+    /* free margo resources */
+    margo_destroy(handle);
+}
+DEFINE_MARGO_RPC_HANDLER(unifyfs_stats_rpc)
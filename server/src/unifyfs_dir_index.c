@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include "unifyfs_dir_index.h"
+#include "unifyfs_p2p_rpc.h"
+
+/* an entry in a directory index */
+struct dir_index_entry {
+    RB_ENTRY(dir_index_entry) entry_tree_entry;
+    unifyfs_dirent_t dirent;
+};
+
+/* index of the entries of a directory owned by this server */
+struct dir_index {
+    RB_ENTRY(dir_index) index_tree_entry;
+    int gfid;                     /* gfid of directory */
+    size_t num_entries;           /* number of entries in tree */
+    RB_HEAD(rb_dirent_tree, dir_index_entry) entries;
+};
+
+static int dirent_compare_func(struct dir_index_entry* ent1,
+                               struct dir_index_entry* ent2)
+{
+    if (ent1->dirent.gfid > ent2->dirent.gfid) {
+        return 1;
+    } else if (ent1->dirent.gfid < ent2->dirent.gfid) {
+        return -1;
+    }
+    return 0;
+}
+
+static int dir_index_compare_func(struct dir_index* dir1,
+                                  struct dir_index* dir2)
+{
+    if (dir1->gfid > dir2->gfid) {
+        return 1;
+    } else if (dir1->gfid < dir2->gfid) {
+        return -1;
+    }
+    return 0;
+}
+
+RB_PROTOTYPE(rb_dirent_tree, dir_index_entry, entry_tree_entry,
+             dirent_compare_func)
+RB_GENERATE(rb_dirent_tree, dir_index_entry, entry_tree_entry,
+            dirent_compare_func)
+
+RB_HEAD(rb_dir_index_tree, dir_index);
+RB_PROTOTYPE(rb_dir_index_tree, dir_index, index_tree_entry,
+             dir_index_compare_func)
+RB_GENERATE(rb_dir_index_tree, dir_index, index_tree_entry,
+            dir_index_compare_func)
+
+/* all directory indexes held by this server, protected by lock */
+static struct rb_dir_index_tree dir_indexes =
+    RB_INITIALIZER(&dir_indexes);
+static ABT_rwlock dir_index_lock = ABT_RWLOCK_NULL;
+
+/* free a directory index and all of its entries */
+static void dir_index_free(struct dir_index* dir)
+{
+    struct dir_index_entry* ent;
+    struct dir_index_entry* tmp;
+    RB_FOREACH_SAFE(ent, rb_dirent_tree, &dir->entries, tmp) {
+        RB_REMOVE(rb_dirent_tree, &dir->entries, ent);
+        free(ent);
+    }
+    free(dir);
+}
+
+/* find index for directory, assumes caller holds lock */
+static struct dir_index* dir_index_find(int dir_gfid)
+{
+    struct dir_index key = { .gfid = dir_gfid, };
+    return RB_FIND(rb_dir_index_tree, &dir_indexes, &key);
+}
+
+int unifyfs_dir_index_init(void)
+{
+    RB_INIT(&dir_indexes);
+    int rc = ABT_rwlock_create(&dir_index_lock);
+    if (ABT_SUCCESS != rc) {
+        LOGERR("failed to create directory index lock");
+        return UNIFYFS_FAILURE;
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+void unifyfs_dir_index_fini(void)
+{
+    if (ABT_RWLOCK_NULL == dir_index_lock) {
+        return;
+    }
+
+    ABT_rwlock_wrlock(dir_index_lock);
+    struct dir_index* dir;
+    struct dir_index* tmp;
+    RB_FOREACH_SAFE(dir, rb_dir_index_tree, &dir_indexes, tmp) {
+        RB_REMOVE(rb_dir_index_tree, &dir_indexes, dir);
+        dir_index_free(dir);
+    }
+    ABT_rwlock_unlock(dir_index_lock);
+
+    ABT_rwlock_free(&dir_index_lock);
+}
+
+int unifyfs_dir_index_parent(const char* path,
+                             int* dir_gfid,
+                             const char** name)
+{
+    if ((NULL == path) || (NULL == dir_gfid) || (NULL == name)) {
+        return EINVAL;
+    }
+
+    const char* slash = strrchr(path, '/');
+    if ((NULL == slash) || ('\0' == slash[1])) {
+        /* root directory, or a path we did not normalize */
+        return EINVAL;
+    }
+
+    char parent[UNIFYFS_MAX_FILENAME];
+    size_t len = (size_t)(slash - path);
+    if (0 == len) {
+        /* parent is the root directory */
+        len = 1;
+    }
+    if (len >= sizeof(parent)) {
+        return ENAMETOOLONG;
+    }
+    memcpy(parent, path, len);
+    parent[len] = '\0';
+
+    *dir_gfid = unifyfs_generate_gfid(parent);
+    *name = slash + 1;
+    return UNIFYFS_SUCCESS;
+}
+
+int unifyfs_dir_index_file_created(unifyfs_file_attr_t* attr)
+{
+    int dir_gfid;
+    const char* name;
+    int ret = unifyfs_dir_index_parent(attr->filename, &dir_gfid, &name);
+    if (ret != UNIFYFS_SUCCESS) {
+        return ret;
+    }
+    if (hash_gfid_to_server(dir_gfid) != glb_pmi_rank) {
+        /* another server owns the parent directory */
+        return UNIFYFS_SUCCESS;
+    }
+    if (strlen(name) >= UNIFYFS_DIRENT_NAME_MAX) {
+        LOGWARN("name of %s is too long for a directory entry",
+                attr->filename);
+        return ENAMETOOLONG;
+    }
+
+    struct dir_index_entry* ent = calloc(1, sizeof(*ent));
+    if (NULL == ent) {
+        return ENOMEM;
+    }
+    unifyfs_dirent_set_attr(&(ent->dirent), attr);
+    strcpy(ent->dirent.name, name);
+
+    ABT_rwlock_wrlock(dir_index_lock);
+    struct dir_index* dir = dir_index_find(dir_gfid);
+    if (NULL == dir) {
+        dir = calloc(1, sizeof(*dir));
+        if (NULL == dir) {
+            ret = ENOMEM;
+        } else {
+            dir->gfid = dir_gfid;
+            RB_INIT(&dir->entries);
+            RB_INSERT(rb_dir_index_tree, &dir_indexes, dir);
+        }
+    }
+    if (NULL != dir) {
+        struct dir_index_entry* existing =
+            RB_INSERT(rb_dirent_tree, &dir->entries, ent);
+        if (NULL != existing) {
+            /* file was recreated, keep the new attributes */
+            existing->dirent = ent->dirent;
+            free(ent);
+        } else {
+            dir->num_entries++;
+        }
+        ent = NULL;
+    }
+    ABT_rwlock_unlock(dir_index_lock);
+
+    if (NULL != ent) {
+        free(ent);
+    }
+    LOGDBG("added gfid=%d as '%s' in directory gfid=%d",
+           attr->gfid, name, dir_gfid);
+    return ret;
+}
+
+int unifyfs_dir_index_file_removed(unifyfs_file_attr_t* attr)
+{
+    int dir_gfid;
+    const char* name;
+    int ret = unifyfs_dir_index_parent(attr->filename, &dir_gfid, &name);
+    if (ret != UNIFYFS_SUCCESS) {
+        return ret;
+    }
+    int own_parent = (hash_gfid_to_server(dir_gfid) == glb_pmi_rank);
+    int own_file = (hash_gfid_to_server(attr->gfid) == glb_pmi_rank);
+    if (!own_parent && !own_file) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    struct dir_index* removed_dir = NULL;
+    ABT_rwlock_wrlock(dir_index_lock);
+    if (own_parent) {
+        struct dir_index* dir = dir_index_find(dir_gfid);
+        if (NULL != dir) {
+            struct dir_index_entry key;
+            key.dirent.gfid = attr->gfid;
+            struct dir_index_entry* ent =
+                RB_FIND(rb_dirent_tree, &dir->entries, &key);
+            if (NULL != ent) {
+                RB_REMOVE(rb_dirent_tree, &dir->entries, ent);
+                dir->num_entries--;
+                free(ent);
+            }
+            if (0 == dir->num_entries) {
+                RB_REMOVE(rb_dir_index_tree, &dir_indexes, dir);
+                free(dir);
+            }
+        }
+    }
+    if (own_file) {
+        /* drop the index of a removed directory */
+        removed_dir = dir_index_find(attr->gfid);
+        if (NULL != removed_dir) {
+            RB_REMOVE(rb_dir_index_tree, &dir_indexes, removed_dir);
+        }
+    }
+    ABT_rwlock_unlock(dir_index_lock);
+
+    if (NULL != removed_dir) {
+        LOGDBG("dropped index of removed directory gfid=%d (%zu entries)",
+               attr->gfid, removed_dir->num_entries);
+        dir_index_free(removed_dir);
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+int unifyfs_dir_index_read(int dir_gfid,
+                           int start_gfid,
+                           unsigned int max_entries,
+                           unifyfs_dirent_t* entries,
+                           unsigned int* num_entries,
+                           int* end_of_dir)
+{
+    if ((NULL == entries) || (NULL == num_entries) || (NULL == end_of_dir)) {
+        return EINVAL;
+    }
+
+    unsigned int n = 0;
+    int eod = 1;
+
+    ABT_rwlock_rdlock(dir_index_lock);
+    struct dir_index* dir = dir_index_find(dir_gfid);
+    if (NULL != dir) {
+        struct dir_index_entry key;
+        key.dirent.gfid = start_gfid;
+        struct dir_index_entry* ent =
+            RB_NFIND(rb_dirent_tree, &dir->entries, &key);
+        while (NULL != ent) {
+            if (n == max_entries) {
+                eod = 0;
+                break;
+            }
+            entries[n++] = ent->dirent;
+            ent = RB_NEXT(rb_dirent_tree, &dir->entries, ent);
+        }
+    }
+    ABT_rwlock_unlock(dir_index_lock);
+
+    *num_entries = n;
+    *end_of_dir = eod;
+    return UNIFYFS_SUCCESS;
+}
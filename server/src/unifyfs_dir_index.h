@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#ifndef UNIFYFS_DIR_INDEX_H
+#define UNIFYFS_DIR_INDEX_H
+
+#include "unifyfs_global.h"
+
+/*
+ * Directory index: the server that owns a directory's gfid keeps the
+ * entries of the directory's children, ordered by child gfid. Entries
+ * are added when a child inode is created on the owner (every server
+ * learns of new files through the create broadcast) and removed when
+ * the child inode is unlinked. Directory reads resume from a child gfid,
+ * so a read cursor stays valid while entries are added or removed.
+ */
+
+/**
+ * @brief initialize the (empty) set of directory indexes
+ *
+ * @return 0 on success, errno otherwise
+ */
+int unifyfs_dir_index_init(void);
+
+/**
+ * @brief free all directory indexes
+ */
+void unifyfs_dir_index_fini(void);
+
+/**
+ * @brief get the gfid of the parent directory of path, and the name of
+ * path within that directory
+ *
+ * @param path     absolute file path
+ * @param dir_gfid [out] gfid of parent directory
+ * @param name     [out] pointer to last component within path
+ *
+ * @return 0 on success, EINVAL if path has no parent
+ */
+int unifyfs_dir_index_parent(const char* path,
+                             int* dir_gfid,
+                             const char** name);
+
+/**
+ * @brief add an entry for a new file to the index of its parent
+ * directory, if this server owns the parent directory
+ *
+ * @param attr attributes of new file, including its path
+ *
+ * @return 0 on success, errno otherwise
+ */
+int unifyfs_dir_index_file_created(unifyfs_file_attr_t* attr);
+
+/**
+ * @brief remove the entry for a file from the index of its parent
+ * directory if this server owns the parent, and drop the index of the
+ * file itself if it was a directory
+ *
+ * @param attr attributes of removed file, including its path
+ *
+ * @return 0 on success, errno otherwise
+ */
+int unifyfs_dir_index_file_removed(unifyfs_file_attr_t* attr);
+
+/**
+ * @brief read entries of a directory index in gfid order
+ *
+ * @param dir_gfid    gfid of directory
+ * @param start_gfid  return entries with gfids at or after this one
+ * @param max_entries size of entries array
+ * @param entries     [out] array of directory entries
+ * @param num_entries [out] number of entries returned
+ * @param end_of_dir  [out] set when no entries follow those returned
+ *
+ * @return 0 on success, errno otherwise
+ */
+int unifyfs_dir_index_read(int dir_gfid,
+                           int start_gfid,
+                           unsigned int max_entries,
+                           unifyfs_dirent_t* entries,
+                           unsigned int* num_entries,
+                           int* end_of_dir);
+
+#endif /* UNIFYFS_DIR_INDEX_H */
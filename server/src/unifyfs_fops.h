@@ -27,6 +27,7 @@ struct _unifyfs_fops_ctx {
     int app_id;
     int client_id;
     int mread_id;
+    int index_slot;
 };
 typedef struct _unifyfs_fops_ctx unifyfs_fops_ctx_t;
 
@@ -40,6 +41,14 @@ typedef int (*unifyfs_fops_filesize_t)(unifyfs_fops_ctx_t* ctx,
 
 typedef int (*unifyfs_fops_laminate_t)(unifyfs_fops_ctx_t* ctx, int gfid);
 
+typedef int (*unifyfs_fops_list_files_t)(unifyfs_fops_ctx_t* ctx,
+                                         const unifyfs_file_filter_t* filter,
+                                         int* cursor_rank, int* cursor_gfid,
+                                         unsigned int max_files,
+                                         void* page, size_t page_sz,
+                                         unsigned int* num_files,
+                                         size_t* page_used);
+
 typedef int (*unifyfs_fops_metaget_t)(unifyfs_fops_ctx_t* ctx,
                                       int gfid, unifyfs_file_attr_t* attr);
 
@@ -53,6 +62,13 @@ typedef int (*unifyfs_fops_mread_t)(unifyfs_fops_ctx_t* ctx,
 typedef int (*unifyfs_fops_read_t)(unifyfs_fops_ctx_t* ctx,
                                    int gfid, off_t offset, size_t len);
 
+typedef int (*unifyfs_fops_readdir_t)(unifyfs_fops_ctx_t* ctx,
+                                      int gfid, int start_gfid,
+                                      unsigned int max_entries,
+                                      unifyfs_dirent_t* entries,
+                                      unsigned int* num_entries,
+                                      int* end_of_dir);
+
 
 typedef int (*unifyfs_fops_transfer_t)(unifyfs_fops_ctx_t* ctx,
                                        int transfer_id,
@@ -74,10 +90,12 @@ struct unifyfs_fops {
     unifyfs_fops_fsync_t fsync;
     unifyfs_fops_get_gfids_t get_gfids;
     unifyfs_fops_laminate_t laminate;
+    unifyfs_fops_list_files_t list_files;
     unifyfs_fops_metaget_t metaget;
     unifyfs_fops_metaset_t metaset;
     unifyfs_fops_mread_t mread;
     unifyfs_fops_read_t read;
+    unifyfs_fops_readdir_t readdir;
     unifyfs_fops_transfer_t transfer;
     unifyfs_fops_truncate_t truncate;
     unifyfs_fops_unlink_t unlink;
@@ -141,6 +159,23 @@ static inline int unifyfs_fops_laminate(unifyfs_fops_ctx_t* ctx, int gfid)
     return global_fops_tab->laminate(ctx, gfid);
 }
 
+static inline int unifyfs_fops_list_files(unifyfs_fops_ctx_t* ctx,
+                                          const unifyfs_file_filter_t* filter,
+                                          int* cursor_rank, int* cursor_gfid,
+                                          unsigned int max_files,
+                                          void* page, size_t page_sz,
+                                          unsigned int* num_files,
+                                          size_t* page_used)
+{
+    if (!global_fops_tab->list_files) {
+        return ENOSYS;
+    }
+
+    return global_fops_tab->list_files(ctx, filter, cursor_rank, cursor_gfid,
+                                       max_files, page, page_sz,
+                                       num_files, page_used);
+}
+
 static inline int unifyfs_fops_metaget(unifyfs_fops_ctx_t* ctx,
                                        int gfid, unifyfs_file_attr_t* attr)
 {
@@ -217,6 +252,21 @@ static inline int unifyfs_fops_unlink(unifyfs_fops_ctx_t* ctx, int gfid)
     return global_fops_tab->unlink(ctx, gfid);
 }
 
+static inline int unifyfs_fops_readdir(unifyfs_fops_ctx_t* ctx,
+                                       int gfid, int start_gfid,
+                                       unsigned int max_entries,
+                                       unifyfs_dirent_t* entries,
+                                       unsigned int* num_entries,
+                                       int* end_of_dir)
+{
+    if (!global_fops_tab->readdir) {
+        return ENOSYS;
+    }
+
+    return global_fops_tab->readdir(ctx, gfid, start_gfid, max_entries,
+                                    entries, num_entries, end_of_dir);
+}
+
 static inline int unifyfs_fops_get_gfids(int** gfid_list, int* num_gfids)
 {
     if (!global_fops_tab->get_gfids) {
@@ -74,63 +74,162 @@ int rpc_fsync(unifyfs_fops_ctx_t* ctx,
      * created by the client, these are stored as index_t
      * structs starting one page size offset into meta region
      *
-     * Is it safe to assume that the index information in this superblock is
-     * not going to be modified by the client while we perform this operation?
+     * The client will not modify the given index slot until we respond
+     * to its sync request, but it may be filling the other slot(s).
      */
+    int slot = ctx->index_slot;
+    if ((slot < 0) || (slot >= UNIFYFS_WRITE_INDEX_SLOTS)) {
+        LOGERR("invalid write index slot %d", slot);
+        return EINVAL;
+    }
+    unifyfs_write_index* wr_index = &(client->state.write_index);
 
     /* get number of file extent index values client has for us,
      * stored as a size_t value in index region of shared memory */
-    size_t num_extents = *(client->state.write_index.ptr_num_entries);
+    size_t num_extents = *unifyfs_write_index_count(wr_index, slot);
 
     if (num_extents == 0) {
         return UNIFYFS_SUCCESS;  /* Nothing to do */
     }
 
-    unifyfs_index_t* index_entry = client->state.write_index.index_entries;
+    unifyfs_index_t* index_entry = unifyfs_write_index_slot(wr_index, slot);
 
-    /* the sync rpc now contains extents from a single file/gfid */
-    assert(gfid == index_entry[0].gfid);
+    /* the sync rpc may contain extents for several files, with the
+     * extents for each file stored contiguously. count the files. */
+    int num_gfids = 1;
+    for (i = 1; i < num_extents; i++) {
+        if (index_entry[i].gfid != index_entry[i - 1].gfid) {
+            num_gfids++;
+        }
+    }
+    if ((gfid != INVALID_GFID) &&
+        ((num_gfids != 1) || (gfid != index_entry[0].gfid))) {
+        LOGERR("sync for gfid=%d contains extents of other files", gfid);
+        return EINVAL;
+    }
 
     server_rpc_req_t* svr_req = malloc(sizeof(*svr_req));
-    int* pending_gfid = malloc(sizeof(int));
-    extent_metadata* extents = calloc(num_extents, sizeof(*extents));
-    if ((NULL == svr_req) || (NULL == pending_gfid) || (NULL == extents)) {
+    pending_sync_input* psi = malloc(sizeof(*psi));
+    int* gfids = calloc(num_gfids, sizeof(int));
+    pending_sync_req* sync_req = malloc(sizeof(*sync_req));
+    if ((NULL == svr_req) || (NULL == psi) ||
+        (NULL == gfids) || (NULL == sync_req)) {
         LOGERR("failed to allocate memory for local extents sync");
+        free(svr_req);
+        free(psi);
+        free(gfids);
+        free(sync_req);
         return ENOMEM;
     }
+    if (ABT_mutex_create(&(sync_req->sync)) != ABT_SUCCESS) {
+        LOGERR("ABT_mutex_create failed");
+        free(svr_req);
+        free(psi);
+        free(gfids);
+        free(sync_req);
+        return UNIFYFS_ERROR_MARGO;
+    }
+    sync_req->client_req  = client_req;
+    sync_req->num_pending = num_gfids;
+    sync_req->ret         = UNIFYFS_SUCCESS;
+
+    /* add the extents of each file as pending on its inode */
+    int num_added = 0;
+    size_t run_start = 0;
+    for (int g = 0; g < num_gfids; g++) {
+        int run_gfid = index_entry[run_start].gfid;
+        size_t run_end = run_start + 1;
+        while ((run_end < num_extents) &&
+               (index_entry[run_end].gfid == run_gfid)) {
+            run_end++;
+        }
+        size_t run_len = run_end - run_start;
+
+        extent_metadata* extents = calloc(run_len, sizeof(*extents));
+        if (NULL == extents) {
+            LOGERR("failed to allocate memory for local extents sync");
+            ret = ENOMEM;
+            break;
+        }
+        for (i = 0; i < run_len; i++) {
+            unifyfs_index_t* meta = index_entry + run_start + i;
+            extent_metadata* extent = extents + i;
+            extent->start    = meta->file_pos;
+            extent->end      = (meta->file_pos + meta->length) - 1;
+            extent->svr_rank = glb_pmi_rank;
+            extent->app_id   = ctx->app_id;
+            extent->cli_id   = ctx->client_id;
+            extent->log_pos  = meta->log_pos;
+        }
 
-    for (i = 0; i < num_extents; i++) {
-        unifyfs_index_t* meta = index_entry + i;
-        extent_metadata* extent = extents + i;
-        extent->start    = meta->file_pos;
-        extent->end      = (meta->file_pos + meta->length) - 1;
-        extent->svr_rank = glb_pmi_rank;
-        extent->app_id   = ctx->app_id;
-        extent->cli_id   = ctx->client_id;
-        extent->log_pos  = meta->log_pos;
+        /* update local inode state first */
+        int rc = unifyfs_inode_add_pending_extents(run_gfid, sync_req,
+                                                   (int) run_len, extents);
+        if (rc) {
+            LOGERR("failed to add pending local extents (gfid=%d, ret=%d)",
+                   run_gfid, rc);
+            free(extents);
+            ret = rc;
+            break;
+        }
+        gfids[num_added++] = run_gfid;
+        run_start = run_end;
     }
 
-    /* update local inode state first */
-    ret = unifyfs_inode_add_pending_extents(gfid, client_req,
-                                            num_extents, extents);
-    if (ret) {
-        LOGERR("failed to add pending local extents (gfid=%d, ret=%d)",
-               gfid, ret);
-        free(pending_gfid);
+    if (0 == num_added) {
+        /* nothing pending, the caller will respond to the client */
+        ABT_mutex_free(&(sync_req->sync));
+        free(sync_req);
+        free(gfids);
+        free(psi);
         free(svr_req);
         return ret;
-    } else {
-        /* then ask svcmgr to process the pending extent sync(s) */
-        *pending_gfid = gfid;
-        svr_req->req_type = UNIFYFS_SERVER_PENDING_SYNC;
-        svr_req->handle   = HG_HANDLE_NULL;
-        svr_req->input    = (void*) pending_gfid;
-        svr_req->bulk_buf = NULL;
-        svr_req->bulk_sz  = 0;
-        ret = sm_submit_service_request(svr_req);
     }
 
-    return ret;
+    /* then ask svcmgr to process the pending extent sync(s) */
+    psi->num_gfids = num_added;
+    psi->gfids     = gfids;
+    svr_req->req_type = UNIFYFS_SERVER_PENDING_SYNC;
+    svr_req->handle   = HG_HANDLE_NULL;
+    svr_req->input    = (void*) psi;
+    svr_req->bulk_buf = NULL;
+    svr_req->bulk_sz  = 0;
+    int num_failed = num_gfids - num_added;
+    int rc = sm_submit_service_request(svr_req);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to submit pending sync request");
+        free(psi);
+        free(svr_req);
+
+        /* withdraw our extents that are still pending. any taken by an
+         * earlier pending sync of the same file will still complete
+         * the request */
+        int num_removed = 0;
+        for (int g = 0; g < num_added; g++) {
+            int n = 0;
+            unifyfs_inode_remove_pending_extents(gfids[g], sync_req, &n);
+            num_removed += n;
+        }
+        free(gfids);
+
+        if (num_removed == num_added) {
+            /* nothing pending, the caller will respond to the client */
+            ABT_mutex_free(&(sync_req->sync));
+            free(sync_req);
+            return rc;
+        }
+        num_failed += num_removed;
+        ret = rc;
+    }
+
+    /* the files we failed to add will never be processed, so complete
+     * them now. the client is sent a single response once the added
+     * files are processed by the svcmgr. */
+    if (num_failed > 0) {
+        sm_complete_pending_sync(sync_req, num_failed, ret);
+    }
+
+    return UNIFYFS_SUCCESS;
 }
 
 static
@@ -157,7 +256,7 @@ int rpc_transfer(unifyfs_fops_ctx_t* ctx,
                                                  transfer_id, gfid,
                                                  transfer_mode, dest_file);
     } else {
-        LOGERR("invalid transfer mode=%d");
+        LOGERR("invalid transfer mode=%d", transfer_mode);
         return EINVAL;
     }
 
@@ -189,6 +288,87 @@ int rpc_unlink(unifyfs_fops_ctx_t* ctx,
     return unifyfs_invoke_broadcast_unlink(gfid);
 }
 
+/* fill a page with records of files matching the filter, walking the
+ * owner servers in rank order starting at the cursor. Each owner returns
+ * a bounded page of its files that is appended to those of previous
+ * owners, so no server ever holds more than a page of results */
+static
+int rpc_list_files(unifyfs_fops_ctx_t* ctx,
+                   const unifyfs_file_filter_t* filter,
+                   int* cursor_rank,
+                   int* cursor_gfid,
+                   unsigned int max_files,
+                   void* page,
+                   size_t page_sz,
+                   unsigned int* num_files,
+                   size_t* page_used)
+{
+    int rank = *cursor_rank;
+    int gfid = *cursor_gfid;
+    int last_rank = glb_pmi_size - 1;
+    if (filter->owner_rank >= 0) {
+        if (filter->owner_rank > last_rank) {
+            return EINVAL;
+        }
+        if (rank < filter->owner_rank) {
+            rank = filter->owner_rank;
+            gfid = 0;
+        }
+        last_rank = filter->owner_rank;
+    }
+
+    int ret = UNIFYFS_SUCCESS;
+    unsigned int n_files = 0;
+    size_t used = 0;
+    while ((rank >= 0) && (rank <= last_rank) && (n_files < max_files)) {
+        unsigned int n = 0;
+        size_t sz = 0;
+        int next_gfid = gfid;
+        int end_of_list = 0;
+        ret = unifyfs_invoke_list_files_rpc(rank, gfid, filter,
+                                            max_files - n_files,
+                                            (char*)page + used,
+                                            page_sz - used,
+                                            &n, &sz, &next_gfid,
+                                            &end_of_list);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("list files at server %d failed (rc=%d)", rank, ret);
+            break;
+        }
+        n_files += n;
+        used += sz;
+        if (!end_of_list) {
+            /* page is full, resume at this owner */
+            gfid = next_gfid;
+            break;
+        }
+        rank++;
+        gfid = 0;
+    }
+    if (ret != UNIFYFS_SUCCESS) {
+        return ret;
+    }
+
+    *cursor_rank = (rank > last_rank) ? -1 : rank;
+    *cursor_gfid = gfid;
+    *num_files = n_files;
+    *page_used = used;
+    return UNIFYFS_SUCCESS;
+}
+
+static
+int rpc_readdir(unifyfs_fops_ctx_t* ctx,
+                int gfid,
+                int start_gfid,
+                unsigned int max_entries,
+                unifyfs_dirent_t* entries,
+                unsigned int* num_entries,
+                int* end_of_dir)
+{
+    return unifyfs_invoke_readdir_rpc(gfid, start_gfid, max_entries,
+                                      entries, num_entries, end_of_dir);
+}
+
 static
 int create_remote_read_requests(unsigned int n_chunks,
                                 chunk_read_req_t* chunks,
@@ -367,10 +547,12 @@ static struct unifyfs_fops _fops_rpc = {
     .fsync     = rpc_fsync,
     .get_gfids = rpc_get_gfids,
     .laminate  = rpc_laminate,
+    .list_files = rpc_list_files,
     .metaget   = rpc_metaget,
     .metaset   = rpc_metaset,
     .mread     = rpc_mread,
     .read      = rpc_read,
+    .readdir   = rpc_readdir,
     .transfer  = rpc_transfer,
     .truncate  = rpc_truncate,
     .unlink    = rpc_unlink
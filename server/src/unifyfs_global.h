@@ -54,6 +54,7 @@
 #include "unifyfs_logio.h"
 #include "unifyfs_meta.h"
 #include "unifyfs_shm.h"
+#include "unifyfs_stats.h"
 #include "unifyfs_client_rpcs.h"
 #include "unifyfs_server_rpcs.h"
 
@@ -90,6 +91,23 @@ extern struct unifyfs_inode_tree* global_inode_tree;
 /* flag to control the use of server local extents for faster local reads */
 extern bool use_server_local_extents;
 
+/* microseconds the service manager waits to gather concurrent chunk
+ * reads before reading client logs, 0 disables the wait */
+extern int server_read_coalesce_usec;
+
+/* flag to control publishing node-local extents of laminated files in
+ * shared memory for local clients */
+extern bool use_server_shared_extents;
+
+/* maximum size of read data sent to a client in each rpc */
+extern size_t server_data_tx_size;
+
+/* maximum number of active read requests per client */
+extern int server_max_reads;
+
+/* maximum memory allocation for temporary file transfer data copies */
+extern size_t server_transfer_buffer;
+
 // NEW READ REQUEST STRUCTURES
 typedef enum {
     READREQ_NULL = 0,          /* request not initialized */
@@ -197,6 +215,22 @@ unifyfs_rc disconnect_app_client(app_client* clnt);
 
 unifyfs_rc cleanup_app_client(app_config* app, app_client* clnt);
 
+/* a range of data to read from the write log of an application client */
+typedef struct app_client_log_read {
+    int app_id;      /* application id of the log owner */
+    int client_id;   /* client id of the log owner */
+    int ndx;         /* caller's index for this read */
+    logio_iovec iov; /* log range and destination buffer */
+} app_client_log_read;
+
+/* Read many ranges from application client write logs, issuing the reads
+ * for each client log together using unifyfs_logio_readv(). Reads that are
+ * adjacent or overlapping in a log are merged into larger reads. The array
+ * is reordered by client and log offset. Sets iov.obytes and iov.rc for
+ * each read, and returns UNIFYFS_SUCCESS or the first error encountered. */
+unifyfs_rc read_app_client_logs(int n_reads,
+                                app_client_log_read* reads);
+
 unifyfs_rc add_failed_client(int app_id, int client_id);
 
 
@@ -483,6 +483,7 @@ static coll_request* collective_create(server_rpc_e req_type,
                coll_req, req_type, tree_root_rank);
         coll_req->resp_hdl      = handle;
         coll_req->req_type      = req_type;
+        coll_req->op_hgid       = op_hgid;
         coll_req->output        = output_struct;
         coll_req->input         = input_struct;
         coll_req->bulk_in       = bulk_in;
@@ -643,6 +644,8 @@ void collective_cleanup(coll_request* coll_req)
 /* Forward the collective request to any children */
 static int collective_forward(coll_request* coll_req)
 {
+    coll_req->start_usec = unifyfs_stats_now_usec();
+
     /* get info for tree */
     int child_count = coll_req->tree.child_count;
     if (0 == child_count) {
@@ -740,6 +743,11 @@ int collective_finish(coll_request* coll_req)
         ret = rc;
     }
 
+    if (-1 == coll_req->tree.parent_rank) {
+        /* root records latency of the whole collective */
+        unifyfs_stats_hist_record(coll_req->op_hgid, coll_req->start_usec);
+    }
+
     /* If there's output data AND there's a caller to send it back to,
      * then send the output back to the caller.  If we're at the root
      * of the tree, though, there might be output data, but no place
@@ -801,7 +809,7 @@ int invoke_bcast_progress_rpc(coll_request* coll_req)
                               &(coll_req->progress_req));
         if (hret != HG_SUCCESS) {
             LOGERR("failed to forward bcast progress for coll(%p) - %s",
-                   HG_Error_to_string(hret), coll_req);
+                   coll_req, HG_Error_to_string(hret));
             ret = UNIFYFS_ERROR_MARGO;
         }
     }
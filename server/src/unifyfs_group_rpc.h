@@ -40,6 +40,8 @@ typedef struct coll_request {
     margo_request  progress_req;
     margo_request* child_reqs;
     hg_handle_t*   child_hdls;
+    hg_id_t        op_hgid;         /* rpc id of the collective operation */
+    uint64_t       start_usec;      /* time request was forwarded */
 
     int            auto_cleanup;    /* If set (non-zero), bcast_progress_rpc()
                                      * will call collective_cleanup(). This is
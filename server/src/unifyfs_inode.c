@@ -17,11 +17,14 @@
 #include <string.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <sys/mman.h>
 
+#include "unifyfs_dir_index.h"
 #include "unifyfs_inode.h"
 #include "unifyfs_inode_tree.h"
 #include "unifyfs_request_manager.h"
 #include "unifyfs_p2p_rpc.h"  // for hash_gfid_to_server()
+#include "seg_tree.h"         // for struct seg_tree_snapshot
 
 struct unifyfs_inode_tree _global_inode_tree;
 struct unifyfs_inode_tree* global_inode_tree = &_global_inode_tree;
@@ -48,6 +51,7 @@ struct unifyfs_inode* unifyfs_inode_alloc(int gfid, unifyfs_file_attr_t* attr)
                                  &(ino->attr), attr);
 
         ABT_rwlock_create(&(ino->rwlock));
+        unifyfs_stats_add(UNIFYFS_STAT_SERVER_INODES, 1);
     } else {
         LOGERR("failed to allocate memory for inode");
     }
@@ -131,16 +135,137 @@ int unifyfs_inode_create(int gfid, unifyfs_file_attr_t* attr)
 
     if (ret != UNIFYFS_SUCCESS) {
         unifyfs_inode_destroy(ino);
+    } else if (NULL != attr->filename) {
+        /* add to parent directory index, if we own it */
+        unifyfs_dir_index_file_created(attr);
     }
 
     return ret;
 }
 
+/* Publish a shared extent index for each application with data of
+ * the laminated file in the logs of its clients on this node, so that
+ * local clients can find node-local extents without asking this server.
+ * Holes are included in each index. Caller must hold the inode lock. */
+static void inode_publish_shared_extents(struct unifyfs_inode* ino)
+{
+    if (!use_server_shared_extents || (NULL != ino->shared_extents) ||
+        (NULL == ino->extents)) {
+        return;
+    }
+
+    /* find the applications with extents on this node */
+    int app_ids[UNIFYFS_SERVER_MAX_NUM_APPS];
+    int n_apps = 0;
+    struct extent_tree* tree = ino->extents;
+    struct extent_tree_node* curr = NULL;
+    while (NULL != (curr = extent_tree_iter(tree, curr))) {
+        if ((curr->extent.svr_rank != glb_pmi_rank) ||
+            extent_is_hole(&(curr->extent))) {
+            continue;
+        }
+        int i;
+        for (i = 0; i < n_apps; i++) {
+            if (app_ids[i] == curr->extent.app_id) {
+                break;
+            }
+        }
+        if ((i == n_apps) && (n_apps < UNIFYFS_SERVER_MAX_NUM_APPS)) {
+            app_ids[n_apps++] = curr->extent.app_id;
+        }
+    }
+    if (0 == n_apps) {
+        return;
+    }
+
+    ino->shared_extents = calloc(n_apps, sizeof(shm_context*));
+    if (NULL == ino->shared_extents) {
+        LOGERR("failed to allocate shared extent indexes (gfid=%d)",
+               ino->gfid);
+        return;
+    }
+
+    for (int i = 0; i < n_apps; i++) {
+        int app_id = app_ids[i];
+
+        /* count extents readable by clients of the application */
+        unsigned long count = 0;
+        curr = NULL;
+        while (NULL != (curr = extent_tree_iter(tree, curr))) {
+            if (extent_is_hole(&(curr->extent)) ||
+                ((curr->extent.svr_rank == glb_pmi_rank) &&
+                 (curr->extent.app_id == app_id))) {
+                count++;
+            }
+        }
+
+        /* remove any region left from an earlier server, so that
+         * clients never see it while the new one is written */
+        char shm_name[SHMEM_NAME_LEN] = {0};
+        snprintf(shm_name, sizeof(shm_name), SHMEM_EXTENTS_FMTSTR,
+                 app_id, ino->gfid);
+        shm_unlink(shm_name);
+
+        size_t size = sizeof(shm_extents_header) +
+                      sizeof(struct seg_tree_snapshot) +
+                      (count * sizeof(struct seg_tree_extent));
+        shm_context* ctx = unifyfs_shm_alloc(shm_name, size);
+        if (NULL == ctx) {
+            LOGERR("failed to create shared extent index %s", shm_name);
+            continue;
+        }
+
+        shm_extents_header* hdr = (shm_extents_header*) ctx->addr;
+        struct seg_tree_snapshot* snap = (struct seg_tree_snapshot*)
+            ((char*)ctx->addr + sizeof(shm_extents_header));
+        hdr->gfid = ino->gfid;
+        hdr->size = size;
+        snap->count = count;
+
+        unsigned long n = 0;
+        curr = NULL;
+        while (NULL != (curr = extent_tree_iter(tree, curr))) {
+            if (extent_is_hole(&(curr->extent)) ||
+                ((curr->extent.svr_rank == glb_pmi_rank) &&
+                 (curr->extent.app_id == app_id))) {
+                struct seg_tree_extent* ext = snap->segs + n;
+                ext->start = curr->extent.start;
+                ext->end = curr->extent.end;
+                ext->ptr = curr->extent.log_pos;
+                ext->client_id = curr->extent.cli_id;
+                n++;
+            }
+        }
+        __atomic_store_n(&(hdr->ready), 1, __ATOMIC_RELEASE);
+
+        ino->shared_extents[ino->num_shared_extents++] = ctx;
+        LOGDBG("published %lu extents in %s", count, shm_name);
+    }
+}
+
+/* Remove the shared extent indexes of the inode. Clients that have
+ * mapped an index keep their mapping until they release the file */
+static void inode_remove_shared_extents(struct unifyfs_inode* ino)
+{
+    if (NULL == ino->shared_extents) {
+        return;
+    }
+    for (int i = 0; i < ino->num_shared_extents; i++) {
+        unifyfs_shm_unlink(ino->shared_extents[i]);
+        unifyfs_shm_free(&(ino->shared_extents[i]));
+    }
+    free(ino->shared_extents);
+    ino->shared_extents = NULL;
+    ino->num_shared_extents = 0;
+}
+
 int unifyfs_inode_destroy(struct unifyfs_inode* ino)
 {
     int ret = UNIFYFS_SUCCESS;
 
     if (ino) {
+        inode_remove_shared_extents(ino);
+
         if (NULL != ino->attr.filename) {
             free(ino->attr.filename);
         }
@@ -162,7 +287,8 @@ int unifyfs_inode_destroy(struct unifyfs_inode* ino)
                 struct extent_tree* tree = ino->extents;
                 struct extent_tree_node* curr = NULL;
                 while (NULL != (curr = extent_tree_iter(tree, curr))) {
-                    if (curr->extent.svr_rank == glb_pmi_rank) {
+                    if ((curr->extent.svr_rank == glb_pmi_rank) &&
+                        !extent_is_hole(&(curr->extent))) {
                         /* lookup client's logio context and release
                          * allocation for this extent */
                         int app_id    = curr->extent.app_id;
@@ -199,6 +325,8 @@ int unifyfs_inode_destroy(struct unifyfs_inode* ino)
             }
             unifyfs_inode_unlock(ino);
 
+            unifyfs_stats_add(UNIFYFS_STAT_SERVER_EXTENTS,
+                              -((int64_t)ino->extents->count));
             extent_tree_destroy(ino->extents);
             free(ino->extents);
 
@@ -233,6 +361,7 @@ int unifyfs_inode_destroy(struct unifyfs_inode* ino)
         }
 
         ABT_rwlock_free(&(ino->rwlock));
+        unifyfs_stats_add(UNIFYFS_STAT_SERVER_INODES, -1);
 
         free(ino);
     } else {
@@ -257,6 +386,9 @@ int unifyfs_inode_update_attr(int gfid, int attr_op,
         unifyfs_inode_wrlock(ino);
         {
             unifyfs_file_attr_update(attr_op, &ino->attr, attr);
+            if (ino->attr.is_laminated) {
+                inode_publish_shared_extents(ino);
+            }
         }
         unifyfs_inode_unlock(ino);
     }
@@ -303,6 +435,10 @@ int unifyfs_inode_unlink(int gfid)
     unifyfs_inode_tree_unlock(global_inode_tree);
 
     if (ret == UNIFYFS_SUCCESS) {
+        if (NULL != ino->attr.filename) {
+            /* remove from parent directory index, if we own it */
+            unifyfs_dir_index_file_removed(&(ino->attr));
+        }
         ret = unifyfs_inode_destroy(ino);
     }
 
@@ -325,7 +461,10 @@ int unifyfs_inode_truncate(int gfid, unsigned long size)
             } else {
                 ino->attr.size = size;
                 if (NULL != ino->extents) {
+                    int64_t count = (int64_t) ino->extents->count;
                     ret = extent_tree_truncate(ino->extents, size);
+                    unifyfs_stats_add(UNIFYFS_STAT_SERVER_EXTENTS,
+                        (int64_t)ino->extents->count - count);
                 }
             }
         }
@@ -336,7 +475,7 @@ int unifyfs_inode_truncate(int gfid, unsigned long size)
 }
 
 int unifyfs_inode_add_pending_extents(int gfid,
-                                      client_rpc_req_t* client_req,
+                                      pending_sync_req* sync_req,
                                       int num_extents,
                                       extent_metadata* extents)
 {
@@ -371,7 +510,7 @@ int unifyfs_inode_add_pending_extents(int gfid,
                 goto add_pending_unlock_inode;
 
         }
-        list_item->client_req = client_req;
+        list_item->sync_req = sync_req;
         list_item->num_extents = num_extents;
         list_item->extents = extents;
 
@@ -387,6 +526,45 @@ add_pending_unlock_inode:
     return ret;
 }
 
+int unifyfs_inode_remove_pending_extents(int gfid,
+                                         pending_sync_req* sync_req,
+                                         int* num_removed)
+{
+    if (NULL == num_removed) {
+        return EINVAL;
+    }
+    *num_removed = 0;
+
+    struct unifyfs_inode* ino = unifyfs_inode_lookup(gfid);
+    if (NULL == ino) {
+        return ENOENT;
+    }
+
+    unifyfs_inode_wrlock(ino);
+    {
+        arraylist_t* list = ino->pending_extents;
+        if (NULL != list) {
+            int n_items = arraylist_size(list);
+            for (int i = 0; i < n_items; i++) {
+                pending_extents_item* pei = arraylist_get(list, i);
+                if ((NULL != pei) && (pei->sync_req == sync_req)) {
+                    arraylist_remove(list, i);
+                    free(pei->extents);
+                    free(pei);
+                    (*num_removed)++;
+                }
+            }
+            if (0 == arraylist_size(list)) {
+                arraylist_free(list);
+                ino->pending_extents = NULL;
+            }
+        }
+    }
+    unifyfs_inode_unlock(ino);
+
+    return UNIFYFS_SUCCESS;
+}
+
 bool unifyfs_inode_has_pending_extents(int gfid)
 {
     struct unifyfs_inode* ino = unifyfs_inode_lookup(gfid);
@@ -457,14 +635,14 @@ int unifyfs_inode_add_extents(int gfid,
             goto add_unlock_inode;
         }
 
-        for (int i = 0; i < num_extents; i++) {
-            extent_metadata* current = extents + i;
-            ret = extent_tree_add(tree, current);
-            if (ret) {
-                LOGERR("failed to add extent [%lu, %lu] to gfid=%d",
-                       current->start, current->end, gfid);
-                goto add_unlock_inode;
-            }
+        int64_t count = (int64_t) tree->count;
+        ret = extent_tree_add_batch(tree, num_extents, extents);
+        unifyfs_stats_add(UNIFYFS_STAT_SERVER_EXTENTS,
+                          (int64_t)tree->count - count);
+        if (ret) {
+            LOGERR("failed to add %d extents to gfid=%d",
+                   num_extents, gfid);
+            goto add_unlock_inode;
         }
 
         /* if the extent tree max offset is greater than the size we
@@ -519,6 +697,7 @@ int unifyfs_inode_laminate(int gfid)
         unifyfs_inode_wrlock(ino);
         {
             ino->attr.is_laminated = 1;
+            inode_publish_shared_extents(ino);
         }
         unifyfs_inode_unlock(ino);
         LOGDBG("laminated file (gfid=%d)", gfid);
@@ -877,3 +1056,55 @@ int unifyfs_get_owned_files(unsigned int* num_files,
     *num_files = num_files_int;
     return UNIFYFS_SUCCESS;
 }
+
+int unifyfs_inode_list_owned(int start_gfid,
+                             const unifyfs_file_filter_t* filter,
+                             unsigned int max_files,
+                             void* page,
+                             size_t page_sz,
+                             unsigned int* num_files,
+                             size_t* page_used,
+                             int* next_gfid,
+                             int* end_of_list)
+{
+    if ((NULL == filter) || (NULL == num_files) || (NULL == page_used) ||
+        (NULL == next_gfid) || (NULL == end_of_list)) {
+        return EINVAL;
+    }
+
+    unsigned int n = 0;
+    size_t used = 0;
+    *end_of_list = 1;
+    *next_gfid = start_gfid;
+
+    unifyfs_inode_tree_rdlock(global_inode_tree);
+    {
+        struct unifyfs_inode* node =
+            unifyfs_inode_tree_search_next(global_inode_tree, start_gfid);
+        while (NULL != node) {
+            if ((hash_gfid_to_server(node->attr.gfid) == glb_pmi_rank) &&
+                unifyfs_file_filter_match(filter, &node->attr)) {
+                size_t sz = 0;
+                if (n < max_files) {
+                    sz = unifyfs_file_rec_pack(&node->attr,
+                                               (char*)page + used,
+                                               page_sz - used);
+                }
+                if (0 == sz) {
+                    /* page is full, resume from this file */
+                    *end_of_list = 0;
+                    *next_gfid = node->gfid;
+                    break;
+                }
+                used += sz;
+                n++;
+            }
+            node = unifyfs_inode_tree_iter(global_inode_tree, node);
+        }
+    }
+    unifyfs_inode_tree_unlock(global_inode_tree);
+
+    *num_files = n;
+    *page_used = used;
+    return UNIFYFS_SUCCESS;
+}
@@ -18,8 +18,18 @@
 #include "unifyfs_global.h"
 #include "extent_tree.h"
 
-typedef struct pending_extents_item {
+/* a client sync request may carry extents for several files, each of
+ * which is processed separately. the client is sent a single response
+ * once all of the files have been processed. */
+typedef struct pending_sync_req {
     client_rpc_req_t* client_req; /* req details, including response handle */
+    int num_pending;              /* number of files not yet processed */
+    int ret;                      /* first error seen, or UNIFYFS_SUCCESS */
+    ABT_mutex sync;               /* protects num_pending and ret */
+} pending_sync_req;
+
+typedef struct pending_extents_item {
+    pending_sync_req* sync_req;   /* the client sync request */
     unsigned int num_extents;     /* number of extents in array */
     extent_metadata* extents;     /* array of extent metadata */
 } pending_extents_item;
@@ -36,6 +46,10 @@ struct unifyfs_inode {
     struct extent_tree* extents;  /* extent information */
     arraylist_t* pending_extents; /* list of pending_extents_item */
 
+    shm_context** shared_extents; /* shared extent indexes of laminated
+                                   * file, one per local application */
+    int num_shared_extents;       /* number of shared extent indexes */
+
     ABT_rwlock rwlock;            /* reader-writer lock */
 };
 
@@ -133,17 +147,31 @@ int unifyfs_inode_get_extents(int gfid,
  * @brief add extents pending sync to the inode
  *
  * @param gfid               the global file identifier
- * @param client_req         the client req to sync the extents
+ * @param sync_req           the client sync req for the extents
  * @param num_extents        the number of extents in @extents
  * @param extents            an array of extents to be added as pending
  *
  * @return 0 on success, errno otherwise
  */
 int unifyfs_inode_add_pending_extents(int gfid,
-                                      client_rpc_req_t* client_req,
+                                      pending_sync_req* sync_req,
                                       int num_extents,
                                       extent_metadata* extents);
 
+/**
+ * @brief remove the extents of a client sync request that are still
+ *        pending on the inode (i.e., not yet taken for processing)
+ *
+ * @param       gfid            the global file identifier
+ * @param       sync_req        the client sync req for the extents
+ * @param[out]  num_removed     the number of pending items removed
+ *
+ * @return 0 on success, errno otherwise
+ */
+int unifyfs_inode_remove_pending_extents(int gfid,
+                                         pending_sync_req* sync_req,
+                                         int* num_removed);
+
 /**
  * @brief check if inode has pending extents to sync
  *
@@ -264,5 +292,31 @@ int unifyfs_get_gfids(int* num_gfids, int** gfid_list);
 int unifyfs_get_owned_files(unsigned int* num_files,
                             unifyfs_file_attr_t** attr_list);
 
+/**
+ * @brief Pack records (see unifyfs_file_rec_t) for files that we own and
+ * that match the filter into a page buffer, in gfid order.
+ *
+ * @param start_gfid  pack files with gfids at or after this one
+ * @param filter      file filter (the owner is not checked)
+ * @param max_files   maximum number of records to pack
+ * @param page        buffer to hold records
+ * @param page_sz     size of page buffer
+ * @param num_files   [out] number of records packed
+ * @param page_used   [out] bytes of page used by records
+ * @param next_gfid   [out] gfid to resume from, if not end_of_list
+ * @param end_of_list [out] set when no more files match
+ *
+ * @return 0 on success, errno otherwise
+ */
+int unifyfs_inode_list_owned(int start_gfid,
+                             const unifyfs_file_filter_t* filter,
+                             unsigned int max_files,
+                             void* page,
+                             size_t page_sz,
+                             unsigned int* num_files,
+                             size_t* page_used,
+                             int* next_gfid,
+                             int* end_of_list);
+
 #endif /* __UNIFYFS_INODE_H */
 
@@ -96,6 +96,15 @@ struct unifyfs_inode* unifyfs_inode_tree_search(
     return RB_FIND(rb_inode_tree, &tree->head, &node);
 }
 
+struct unifyfs_inode* unifyfs_inode_tree_search_next(
+    struct unifyfs_inode_tree* tree,
+    int gfid)
+{
+    struct unifyfs_inode node = { .gfid = gfid, };
+
+    return RB_NFIND(rb_inode_tree, &tree->head, &node);
+}
+
 int unifyfs_inode_tree_remove(
     struct unifyfs_inode_tree* tree,
     int gfid,
@@ -88,6 +88,12 @@ struct unifyfs_inode* unifyfs_inode_tree_search(
     struct unifyfs_inode_tree* tree, /* tree to search */
     int gfid);                       /* global file id to find */
 
+/* Return the inode with the smallest gfid that is at least the given
+ * gfid, or NULL if none, assumes caller has lock on tree */
+struct unifyfs_inode* unifyfs_inode_tree_search_next(
+    struct unifyfs_inode_tree* tree, /* tree to search */
+    int gfid);                       /* smallest global file id to find */
+
 /**
  * @brief Iterate the inode tree.
  *
@@ -61,6 +61,7 @@ int forward_p2p_request(void* input_ptr,
 
     /* call rpc function */
     double timeout_ms = margo_server_server_timeout_msec;
+    req->start_usec = unifyfs_stats_now_usec();
     hg_return_t hret = margo_iforward_timed(req->handle, input_ptr,
                                             timeout_ms, &(req->request));
     if (hret != HG_SUCCESS) {
@@ -84,6 +85,11 @@ int wait_for_p2p_request(p2p_request* req)
                req, HG_Error_to_string(hret));
         //margo_state_dump(unifyfsd_rpc_context->svr_mid, "-", 0, NULL);
         rc = UNIFYFS_ERROR_MARGO;
+    } else {
+        const struct hg_info* info = margo_get_info(req->handle);
+        if (NULL != info) {
+            unifyfs_stats_hist_record(info->id, req->start_usec);
+        }
     }
 
     return rc;
@@ -291,6 +297,7 @@ int invoke_chunk_read_response_rpc(server_chunk_reads_t* scr)
     in.req_id    = (int32_t) scr->rdreq_id;
     in.num_chks  = (int32_t) scr->num_chunks;
     in.bulk_size = bulk_sz;
+    unifyfs_stats_add(UNIFYFS_STAT_SERVER_PEER_DATA_BYTES, (int64_t)bulk_sz);
 
     /* call the read response rpc */
     LOGDBG("invoking the chunk-read-response rpc function");
@@ -410,32 +417,57 @@ DEFINE_MARGO_RPC_HANDLER(chunk_read_response_rpc)
  * File extents metadata update request
  *************************************************************************/
 
-/* Add extents to target file */
-int unifyfs_invoke_add_extents_rpc(int gfid,
-                                   unsigned int num_extents,
-                                   extent_metadata* extents)
+/* Add extents to target files of the same owner */
+int unifyfs_invoke_add_extents_rpc(int owner_rank,
+                                   int num_files,
+                                   add_extents_file* files,
+                                   extent_metadata** extents)
 {
-    int owner_rank = hash_gfid_to_server(gfid);
-    if (owner_rank == glb_pmi_rank) {
+    if ((owner_rank == glb_pmi_rank) || (num_files <= 0)) {
         /* I'm the owner, already did local add */
         return UNIFYFS_SUCCESS;
     }
 
+    /* the bulk holds the files array, then the extents of each file */
+    void** bufs = calloc((size_t)num_files + 1, sizeof(void*));
+    hg_size_t* buf_szs = calloc((size_t)num_files + 1, sizeof(hg_size_t));
+    if ((NULL == bufs) || (NULL == buf_szs)) {
+        free(bufs);
+        free(buf_szs);
+        return ENOMEM;
+    }
+    uint32_t num_segs = 0;
+    unsigned int num_extents = 0;
+    bufs[num_segs] = (void*) files;
+    buf_szs[num_segs] = (hg_size_t)num_files * sizeof(add_extents_file);
+    num_segs++;
+    for (int i = 0; i < num_files; i++) {
+        if (files[i].num_extents > 0) {
+            bufs[num_segs] = (void*) extents[i];
+            buf_szs[num_segs] =
+                (hg_size_t)files[i].num_extents * sizeof(extent_metadata);
+            num_segs++;
+            num_extents += files[i].num_extents;
+        }
+    }
+
     /* forward request to file owner */
     p2p_request preq;
     hg_id_t req_hgid = unifyfsd_rpc_context->rpcs.extent_add_id;
     int rc = init_p2p_request_handle(req_hgid, owner_rank, &preq);
     if (rc != UNIFYFS_SUCCESS) {
+        free(bufs);
+        free(buf_szs);
         return rc;
     }
 
-    /* create a margo bulk transfer handle for extents array */
+    /* create a margo bulk transfer handle for files and extents */
     hg_bulk_t bulk_handle;
-    void* buf = (void*) extents;
-    size_t buf_sz = (size_t)num_extents * sizeof(extent_metadata);
     hg_return_t hret = margo_bulk_create(unifyfsd_rpc_context->svr_mid,
-                                         1, &buf, &buf_sz,
+                                         num_segs, bufs, buf_szs,
                                          HG_BULK_READ_ONLY, &bulk_handle);
+    free(bufs);
+    free(buf_szs);
     if (hret != HG_SUCCESS) {
         LOGERR("margo_bulk_create() failed - %s", HG_Error_to_string(hret));
         margo_destroy(preq.handle);
@@ -445,10 +477,11 @@ int unifyfs_invoke_add_extents_rpc(int gfid,
     /* fill rpc input struct and forward request */
     add_extents_in_t in;
     in.src_rank    = (int32_t) glb_pmi_rank;
-    in.gfid        = (int32_t) gfid;
+    in.num_files   = (int32_t) num_files;
     in.num_extents = (int32_t) num_extents;
     in.extents     = bulk_handle;
-    LOGDBG("forwarding add_extents(gfid=%d) to server[%d]", gfid, owner_rank);
+    LOGDBG("forwarding add_extents(files=%d, extents=%u) to server[%d]",
+           num_files, num_extents, owner_rank);
     rc = forward_p2p_request((void*)&in, &preq);
     if (rc != UNIFYFS_SUCCESS) {
         margo_bulk_free(bulk_handle);
@@ -499,8 +532,10 @@ static void add_extents_rpc(hg_handle_t handle)
             LOGERR("margo_get_input() failed");
             ret = UNIFYFS_ERROR_MARGO;
         } else {
+            size_t num_files = (size_t) in->num_files;
             size_t num_extents = (size_t) in->num_extents;
-            size_t bulk_sz = num_extents * sizeof(extent_metadata);
+            size_t bulk_sz = (num_files * sizeof(add_extents_file)) +
+                             (num_extents * sizeof(extent_metadata));
 
             /* allocate memory for extents */
             void* extents_buf = pull_margo_bulk_buffer(handle, in->extents,
@@ -787,7 +822,8 @@ int unifyfs_invoke_metaget_rpc(int gfid,
             return UNIFYFS_SUCCESS;
         } else {
             LOGINFO("cached attributes for gfid=%d have expired "
-                    "(now=%d, expiration=%d)", gfid, tp.tv_sec, expire);
+                    "(now=%ld, expiration=%ld)", gfid,
+                    (long) tp.tv_sec, (long) expire);
         }
     } else if (rc == ENOENT) {
         /* local metaget gave ENOENT, need to create inode if file exists */
@@ -1208,6 +1244,306 @@ static void metaset_rpc(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(metaset_rpc)
 
+/*************************************************************************
+ * Directory listing request
+ *************************************************************************/
+
+/* Get a page of entries of the target directory from its owner */
+int unifyfs_invoke_readdir_rpc(int gfid,
+                               int start_gfid,
+                               unsigned int max_entries,
+                               unifyfs_dirent_t* entries,
+                               unsigned int* num_entries,
+                               int* end_of_dir)
+{
+    if ((NULL == entries) || (NULL == num_entries) || (NULL == end_of_dir)) {
+        return EINVAL;
+    }
+    *num_entries = 0;
+    *end_of_dir = 1;
+
+    int owner_rank = hash_gfid_to_server(gfid);
+    if (owner_rank == glb_pmi_rank) {
+        /* I'm the owner, return local result */
+        return sm_readdir(gfid, start_gfid, max_entries,
+                          entries, num_entries, end_of_dir);
+    }
+
+    if (0 == max_entries) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* forward request to directory owner */
+    p2p_request preq;
+    margo_instance_id mid = unifyfsd_rpc_context->svr_mid;
+    hg_id_t req_hgid = unifyfsd_rpc_context->rpcs.readdir_id;
+    int rc = init_p2p_request_handle(req_hgid, owner_rank, &preq);
+    if (rc != UNIFYFS_SUCCESS) {
+        return rc;
+    }
+
+    /* create a margo bulk transfer handle the owner fills with entries */
+    hg_bulk_t bulk_handle;
+    void* buf = (void*) entries;
+    hg_size_t buf_sz = (hg_size_t)max_entries * sizeof(unifyfs_dirent_t);
+    hg_return_t hret = margo_bulk_create(mid, 1, &buf, &buf_sz,
+                                         HG_BULK_WRITE_ONLY, &bulk_handle);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_bulk_create() failed - %s", HG_Error_to_string(hret));
+        margo_destroy(preq.handle);
+        return UNIFYFS_ERROR_MARGO;
+    }
+
+    /* fill rpc input struct and forward request */
+    readdir_in_t in;
+    in.gfid        = (int32_t) gfid;
+    in.start_gfid  = (int32_t) start_gfid;
+    in.max_entries = (int32_t) max_entries;
+    in.entries     = bulk_handle;
+    rc = forward_p2p_request((void*)&in, &preq);
+    if (rc == UNIFYFS_SUCCESS) {
+        /* wait for request completion */
+        rc = wait_for_p2p_request(&preq);
+    }
+    if (rc != UNIFYFS_SUCCESS) {
+        margo_bulk_free(bulk_handle);
+        margo_destroy(preq.handle);
+        return rc;
+    }
+
+    /* get the output of the rpc */
+    int ret;
+    readdir_out_t out;
+    hret = margo_get_output(preq.handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_get_output() failed - %s", HG_Error_to_string(hret));
+        ret = UNIFYFS_ERROR_MARGO;
+    } else {
+        /* set return value */
+        ret = out.ret;
+        if (ret == UNIFYFS_SUCCESS) {
+            *num_entries = (unsigned int) out.num_entries;
+            *end_of_dir  = (int) out.end_of_dir;
+            LOGDBG("received %u entries for directory gfid=%d",
+                   *num_entries, gfid);
+        }
+        margo_free_output(preq.handle, &out);
+    }
+    margo_bulk_free(bulk_handle);
+    margo_destroy(preq.handle);
+
+    return ret;
+}
+
+/* Readdir rpc handler */
+static void readdir_rpc(hg_handle_t handle)
+{
+    LOGDBG("readdir rpc handler");
+
+    int ret = UNIFYFS_SUCCESS;
+
+    /* get input params */
+    readdir_in_t* in = calloc(1, sizeof(*in));
+    server_rpc_req_t* req = calloc(1, sizeof(*req));
+    if ((NULL == in) || (NULL == req)) {
+        ret = ENOMEM;
+    } else {
+        hg_return_t hret = margo_get_input(handle, in);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_get_input() failed");
+            ret = UNIFYFS_ERROR_MARGO;
+        } else {
+            req->req_type = UNIFYFS_SERVER_RPC_READDIR;
+            req->handle   = handle;
+            req->input    = (void*) in;
+            req->bulk_buf = NULL;
+            req->bulk_sz  = 0;
+            ret = sm_submit_service_request(req);
+            if (ret != UNIFYFS_SUCCESS) {
+                margo_free_input(handle, in);
+            }
+        }
+    }
+
+    /* if we hit an error during request submission, respond with the error */
+    if (ret != UNIFYFS_SUCCESS) {
+        if (NULL != in) {
+            free(in);
+        }
+        if (NULL != req) {
+            free(req);
+        }
+
+        /* return to caller */
+        readdir_out_t out;
+        out.ret         = (int32_t) ret;
+        out.num_entries = 0;
+        out.end_of_dir  = 0;
+        hg_return_t hret = margo_respond(handle, &out);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_respond() failed");
+        }
+
+        /* free margo resources */
+        margo_destroy(handle);
+    }
+}
+DEFINE_MARGO_RPC_HANDLER(readdir_rpc)
+
+/*************************************************************************
+ * File listing request
+ *************************************************************************/
+
+/* Get a page of records for files owned by a server */
+int unifyfs_invoke_list_files_rpc(int owner_rank,
+                                  int start_gfid,
+                                  const unifyfs_file_filter_t* filter,
+                                  unsigned int max_files,
+                                  void* page,
+                                  size_t page_sz,
+                                  unsigned int* num_files,
+                                  size_t* page_used,
+                                  int* next_gfid,
+                                  int* end_of_list)
+{
+    if ((NULL == filter) || (NULL == page) || (NULL == num_files) ||
+        (NULL == page_used) || (NULL == next_gfid) || (NULL == end_of_list)) {
+        return EINVAL;
+    }
+    *num_files = 0;
+    *page_used = 0;
+    *next_gfid = start_gfid;
+    *end_of_list = 0;
+
+    if (owner_rank == glb_pmi_rank) {
+        /* list my own files */
+        return unifyfs_inode_list_owned(start_gfid, filter, max_files,
+                                        page, page_sz, num_files, page_used,
+                                        next_gfid, end_of_list);
+    }
+
+    /* forward request to file owner */
+    p2p_request preq;
+    margo_instance_id mid = unifyfsd_rpc_context->svr_mid;
+    hg_id_t req_hgid = unifyfsd_rpc_context->rpcs.list_files_id;
+    int rc = init_p2p_request_handle(req_hgid, owner_rank, &preq);
+    if (rc != UNIFYFS_SUCCESS) {
+        return rc;
+    }
+
+    /* create a margo bulk transfer handle the owner fills with records */
+    hg_bulk_t bulk_handle;
+    hg_size_t buf_sz = (hg_size_t) page_sz;
+    hg_return_t hret = margo_bulk_create(mid, 1, &page, &buf_sz,
+                                         HG_BULK_WRITE_ONLY, &bulk_handle);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_bulk_create() failed - %s", HG_Error_to_string(hret));
+        margo_destroy(preq.handle);
+        return UNIFYFS_ERROR_MARGO;
+    }
+
+    /* fill rpc input struct and forward request */
+    list_files_in_t in;
+    in.start_gfid = (int32_t) start_gfid;
+    in.max_files  = (int32_t) max_files;
+    in.laminated  = (int32_t) filter->laminated;
+    in.prefix     = (NULL != filter->prefix) ? filter->prefix : "";
+    in.page_size  = buf_sz;
+    in.page       = bulk_handle;
+    rc = forward_p2p_request((void*)&in, &preq);
+    if (rc == UNIFYFS_SUCCESS) {
+        /* wait for request completion */
+        rc = wait_for_p2p_request(&preq);
+    }
+    if (rc != UNIFYFS_SUCCESS) {
+        margo_bulk_free(bulk_handle);
+        margo_destroy(preq.handle);
+        return rc;
+    }
+
+    /* get the output of the rpc */
+    int ret;
+    list_files_out_t out;
+    hret = margo_get_output(preq.handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_get_output() failed - %s", HG_Error_to_string(hret));
+        ret = UNIFYFS_ERROR_MARGO;
+    } else {
+        /* set return value */
+        ret = out.ret;
+        if (ret == UNIFYFS_SUCCESS) {
+            *num_files   = (unsigned int) out.num_files;
+            *page_used   = (size_t) out.page_used;
+            *next_gfid   = (int) out.next_gfid;
+            *end_of_list = (int) out.end_of_list;
+            LOGDBG("received %u file records from server %d",
+                   *num_files, owner_rank);
+        }
+        margo_free_output(preq.handle, &out);
+    }
+    margo_bulk_free(bulk_handle);
+    margo_destroy(preq.handle);
+
+    return ret;
+}
+
+/* List files rpc handler */
+static void list_files_rpc(hg_handle_t handle)
+{
+    LOGDBG("list_files rpc handler");
+
+    int ret = UNIFYFS_SUCCESS;
+
+    /* get input params */
+    list_files_in_t* in = calloc(1, sizeof(*in));
+    server_rpc_req_t* req = calloc(1, sizeof(*req));
+    if ((NULL == in) || (NULL == req)) {
+        ret = ENOMEM;
+    } else {
+        hg_return_t hret = margo_get_input(handle, in);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_get_input() failed");
+            ret = UNIFYFS_ERROR_MARGO;
+        } else {
+            req->req_type = UNIFYFS_SERVER_RPC_LIST_FILES;
+            req->handle   = handle;
+            req->input    = (void*) in;
+            req->bulk_buf = NULL;
+            req->bulk_sz  = 0;
+            ret = sm_submit_service_request(req);
+            if (ret != UNIFYFS_SUCCESS) {
+                margo_free_input(handle, in);
+            }
+        }
+    }
+
+    /* if we hit an error during request submission, respond with the error */
+    if (ret != UNIFYFS_SUCCESS) {
+        if (NULL != in) {
+            free(in);
+        }
+        if (NULL != req) {
+            free(req);
+        }
+
+        /* return to caller */
+        list_files_out_t out;
+        out.ret         = (int32_t) ret;
+        out.num_files   = 0;
+        out.page_used   = 0;
+        out.next_gfid   = 0;
+        out.end_of_list = 0;
+        hg_return_t hret = margo_respond(handle, &out);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_respond() failed");
+        }
+
+        /* free margo resources */
+        margo_destroy(handle);
+    }
+}
+DEFINE_MARGO_RPC_HANDLER(list_files_rpc)
+
 
 /*************************************************************************
  * File lamination request
@@ -31,6 +31,7 @@ typedef struct {
     margo_request request;
     hg_addr_t     peer;
     hg_handle_t   handle;
+    uint64_t      start_usec; /* time request was forwarded */
 } p2p_request;
 
 /* helper method to initialize peer request rpc handle */
@@ -68,18 +69,27 @@ int invoke_chunk_read_request_rpc(int dst_srvr_rank,
  */
 int invoke_chunk_read_response_rpc(server_chunk_reads_t* scr);
 
+/* a file's run of extents in an add_extents rpc */
+typedef struct add_extents_file {
+    int gfid;                 /* target file */
+    unsigned int num_extents; /* number of extents of the file */
+} add_extents_file;
+
 /**
- * @brief Add new extents to target file
+ * @brief Add new extents to files owned by the same server, using a
+ *        single rpc for all of them
  *
- * @param gfid         target file
- * @param num_extents  length of file extents array
- * @param extents      array of extents to add
+ * @param owner_rank   server owning the files
+ * @param num_files    length of files and extents arrays
+ * @param files        target files and their extent counts
+ * @param extents      array of extents to add for each file
  *
  * @return success|failure
  */
-int unifyfs_invoke_add_extents_rpc(int gfid,
-                                   unsigned int num_extents,
-                                   extent_metadata* extents);
+int unifyfs_invoke_add_extents_rpc(int owner_rank,
+                                   int num_files,
+                                   add_extents_file* files,
+                                   extent_metadata** extents);
 
 /**
  * @brief Find location of extents for target file
@@ -143,6 +153,49 @@ int unifyfs_invoke_metaget_rpc(int gfid,
 int unifyfs_invoke_metaset_rpc(int gfid, int attr_op,
                                unifyfs_file_attr_t* attrs);
 
+/**
+ * @brief Get a page of entries of target directory from its owner
+ *
+ * @param gfid         target directory
+ * @param start_gfid   return entries with gfid >= start_gfid
+ * @param max_entries  maximum number of entries to return
+ * @param entries      array to fill with entries (size >= max_entries)
+ * @param num_entries  [out] number of entries returned
+ * @param end_of_dir   [out] set to 0 if more entries remain, 1 otherwise
+ *
+ * @return success|failure
+ */
+int unifyfs_invoke_readdir_rpc(int gfid, int start_gfid,
+                               unsigned int max_entries,
+                               unifyfs_dirent_t* entries,
+                               unsigned int* num_entries,
+                               int* end_of_dir);
+
+/**
+ * @brief Get a page of records for files owned by a server
+ *
+ * @param owner_rank   server to list files of
+ * @param start_gfid   list files with gfid >= start_gfid
+ * @param filter       file filter (the owner is not checked)
+ * @param max_files    maximum number of records to return
+ * @param page         buffer to fill with file records
+ * @param page_sz      size of page buffer
+ * @param num_files    [out] number of records returned
+ * @param page_used    [out] bytes of page used by records
+ * @param next_gfid    [out] gfid to resume from, if not end_of_list
+ * @param end_of_list  [out] set when server has no more matching files
+ *
+ * @return success|failure
+ */
+int unifyfs_invoke_list_files_rpc(int owner_rank, int start_gfid,
+                                  const unifyfs_file_filter_t* filter,
+                                  unsigned int max_files,
+                                  void* page, size_t page_sz,
+                                  unsigned int* num_files,
+                                  size_t* page_used,
+                                  int* next_gfid,
+                                  int* end_of_list);
+
 /**
  * @brief Transfer target file
  *
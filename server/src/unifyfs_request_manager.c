@@ -155,6 +155,21 @@ reqmgr_thrd_t* unifyfs_rm_thrd_create(int app_id, int client_id)
         return NULL;
     }
 
+    /* allocate the array of server read requests */
+    thrd_ctrl->read_reqs = calloc(server_max_reads,
+                                  sizeof(server_read_req_t));
+    if (thrd_ctrl->read_reqs == NULL) {
+        LOGERR("failed to allocate request manager read_reqs!");
+        arraylist_free(thrd_ctrl->client_callbacks);
+        arraylist_free(thrd_ctrl->client_reqs);
+        ABT_mutex_free(&(thrd_ctrl->reqs_sync));
+        pthread_cond_destroy(&(thrd_ctrl->thrd_cond));
+        pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
+        free(thrd_ctrl);
+        return NULL;
+    }
+    thrd_ctrl->max_read_reqs = server_max_reads;
+
     /* record app and client id this thread will be serving */
     thrd_ctrl->app_id    = app_id;
     thrd_ctrl->client_id = client_id;
@@ -172,6 +187,7 @@ reqmgr_thrd_t* unifyfs_rm_thrd_create(int app_id, int client_id)
         LOGERR("failed to create request manager thread for "
                "app_id=%d client_id=%d - rc=%d (%s)",
                app_id, client_id, rc, strerror(rc));
+        free(thrd_ctrl->read_reqs);
         arraylist_free(thrd_ctrl->client_callbacks);
         arraylist_free(thrd_ctrl->client_reqs);
         ABT_mutex_free(&(thrd_ctrl->reqs_sync));
@@ -196,13 +212,13 @@ server_read_req_t* rm_reserve_read_req(reqmgr_thrd_t* thrd_ctrl)
 {
     server_read_req_t* rdreq = NULL;
     RM_REQ_LOCK(thrd_ctrl);
-    if (thrd_ctrl->num_read_reqs < UNIFYFS_SERVER_MAX_READS) {
-        if (thrd_ctrl->next_rdreq_ndx < (UNIFYFS_SERVER_MAX_READS - 1)) {
+    if (thrd_ctrl->num_read_reqs < thrd_ctrl->max_read_reqs) {
+        if (thrd_ctrl->next_rdreq_ndx < (thrd_ctrl->max_read_reqs - 1)) {
             rdreq = thrd_ctrl->read_reqs + thrd_ctrl->next_rdreq_ndx;
             assert((rdreq->req_ndx == 0) && (rdreq->in_use == 0));
             rdreq->req_ndx = thrd_ctrl->next_rdreq_ndx++;
         } else { // search for unused slot
-            for (int i = 0; i < UNIFYFS_SERVER_MAX_READS; i++) {
+            for (int i = 0; i < thrd_ctrl->max_read_reqs; i++) {
                 rdreq = thrd_ctrl->read_reqs + i;
                 if ((rdreq->req_ndx == 0) && (rdreq->in_use == 0)) {
                     rdreq->req_ndx = i;
@@ -352,6 +368,10 @@ int unifyfs_rm_thrd_cleanup(reqmgr_thrd_t* thrd_ctrl)
     if (NULL != thrd_ctrl->client_callbacks) {
         arraylist_free(thrd_ctrl->client_callbacks);
     }
+    if (NULL != thrd_ctrl->read_reqs) {
+        free(thrd_ctrl->read_reqs);
+        thrd_ctrl->read_reqs = NULL;
+    }
 
     ABT_mutex_free(&(thrd_ctrl->reqs_sync));
 
@@ -408,7 +428,7 @@ static int rm_request_remote_chunks(reqmgr_thrd_t* thrd_ctrl)
 
     /* iterate over each active read request */
     RM_REQ_LOCK(thrd_ctrl);
-    for (i = 0; i < UNIFYFS_SERVER_MAX_READS; i++) {
+    for (i = 0; i < thrd_ctrl->max_read_reqs; i++) {
         server_read_req_t* req = thrd_ctrl->read_reqs + i;
         if (!req->in_use) {
             continue;
@@ -466,7 +486,7 @@ static int rm_process_remote_chunk_responses(reqmgr_thrd_t* thrd_ctrl)
     int ret = (int)UNIFYFS_SUCCESS;
 
     /* iterate over each active read request */
-    for (i = 0; i < UNIFYFS_SERVER_MAX_READS; i++) {
+    for (i = 0; i < thrd_ctrl->max_read_reqs; i++) {
         server_read_req_t* req = thrd_ctrl->read_reqs + i;
         if (!req->in_use) {
             continue;
@@ -585,7 +605,7 @@ int send_data_to_client(server_read_req_t* rdreq,
     }
 
     size_t data_size = (size_t) resp->read_rc;
-    size_t send_sz = UNIFYFS_SERVER_MAX_DATA_TX_SIZE;
+    size_t send_sz = server_data_tx_size;
     char* bufpos = data;
 
     size_t resp_file_offset = resp->offset;
@@ -922,6 +942,8 @@ int rm_submit_client_rpc_request(unifyfs_fops_ctx_t* ctx,
     RM_REQ_LOCK(reqmgr);
     arraylist_add(reqmgr->client_reqs, req);
     RM_REQ_UNLOCK(reqmgr);
+    unifyfs_stats_add(UNIFYFS_STAT_SERVER_RM_QUEUE, 1);
+    unifyfs_stats_add(UNIFYFS_STAT_SERVER_RM_REQUESTS, 1);
 
     signal_new_requests(reqmgr);
 
@@ -1023,14 +1045,16 @@ static int process_fsync_rpc(reqmgr_thrd_t* reqmgr,
     unifyfs_fsync_in_t* in = req->input;
     assert(in != NULL);
     int gfid = in->gfid;
+    int index_slot = in->index_slot;
     margo_free_input(req->handle, in);
     free(in);
 
-    LOGINFO("syncing gfid=%d", gfid);
+    LOGINFO("syncing gfid=%d (index slot %d)", gfid, index_slot);
 
     unifyfs_fops_ctx_t ctx = {
         .app_id = reqmgr->app_id,
         .client_id = reqmgr->client_id,
+        .index_slot = index_slot,
     };
     ret = unifyfs_fops_fsync(&ctx, gfid, req);
     if (ret != UNIFYFS_SUCCESS) {
@@ -1229,6 +1253,159 @@ static int process_read_rpc(reqmgr_thrd_t* reqmgr,
     return ret;
 }
 
+static int process_list_files_rpc(reqmgr_thrd_t* reqmgr,
+                                  client_rpc_req_t* req)
+{
+    int ret = UNIFYFS_SUCCESS;
+
+    unifyfs_list_files_in_t* in = req->input;
+    assert(in != NULL);
+    int cursor_rank = (int) in->cursor_rank;
+    int cursor_gfid = (int) in->cursor_gfid;
+    unsigned int max_files = (unsigned int) in->max_files;
+    unifyfs_file_filter_t filter = {
+        .prefix = in->prefix,
+        .owner_rank = (int) in->owner_rank,
+        .laminated = (int) in->laminated
+    };
+
+    /* a page must hold at least one record of maximum size */
+    size_t page_sz = (size_t) in->bulk_size;
+    if (page_sz > UNIFYFS_LIST_FILES_MAX_BYTES) {
+        page_sz = UNIFYFS_LIST_FILES_MAX_BYTES;
+    }
+    if (page_sz < unifyfs_file_rec_size(UNIFYFS_MAX_FILENAME)) {
+        ret = EINVAL;
+    }
+
+    LOGDBG("list files from rank=%d gfid=%d max=%u",
+           cursor_rank, cursor_gfid, max_files);
+
+    unsigned int num_files = 0;
+    size_t page_used = 0;
+    void* page = NULL;
+    if (ret == UNIFYFS_SUCCESS) {
+        page = malloc(page_sz);
+        if (NULL == page) {
+            ret = ENOMEM;
+        }
+    }
+
+    if (ret == UNIFYFS_SUCCESS) {
+        unifyfs_fops_ctx_t ctx = {
+            .app_id = reqmgr->app_id,
+            .client_id = reqmgr->client_id,
+        };
+        ret = unifyfs_fops_list_files(&ctx, &filter,
+                                      &cursor_rank, &cursor_gfid,
+                                      max_files, page, page_sz,
+                                      &num_files, &page_used);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("unifyfs_fops_list_files() failed");
+        }
+    }
+
+    /* push records into the client bulk buffer */
+    if ((ret == UNIFYFS_SUCCESS) && (page_used > 0)) {
+        ret = push_margo_bulk_buffer(req->handle, in->bulk_page,
+                                     page, (hg_size_t) page_used);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("failed to push file records to client");
+        }
+    }
+    if (NULL != page) {
+        free(page);
+    }
+    margo_free_input(req->handle, in);
+    free(in);
+
+    /* send rpc response */
+    unifyfs_list_files_out_t out;
+    out.ret = (int32_t) ret;
+    out.num_files = (ret == UNIFYFS_SUCCESS) ? (int32_t) num_files : 0;
+    out.page_used = (ret == UNIFYFS_SUCCESS) ? (hg_size_t) page_used : 0;
+    out.next_rank = (int32_t) cursor_rank;
+    out.next_gfid = (int32_t) cursor_gfid;
+    hg_return_t hret = margo_respond(req->handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
+    }
+
+    /* cleanup req */
+    margo_destroy(req->handle);
+
+    return ret;
+}
+
+static int process_readdir_rpc(reqmgr_thrd_t* reqmgr,
+                               client_rpc_req_t* req)
+{
+    int ret = UNIFYFS_SUCCESS;
+
+    unifyfs_readdir_in_t* in = req->input;
+    assert(in != NULL);
+    int gfid = (int) in->gfid;
+    int start_gfid = (int) in->start_gfid;
+    unsigned int max_entries = (unsigned int) in->max_entries;
+    if (max_entries > UNIFYFS_READDIR_MAX_ENTRIES) {
+        max_entries = UNIFYFS_READDIR_MAX_ENTRIES;
+    }
+
+    LOGDBG("readdir gfid=%d start=%d max=%u", gfid, start_gfid, max_entries);
+
+    unsigned int num_entries = 0;
+    int end_of_dir = 0;
+    unifyfs_dirent_t* entries = NULL;
+    if (max_entries > 0) {
+        entries = calloc(max_entries, sizeof(unifyfs_dirent_t));
+        if (NULL == entries) {
+            ret = ENOMEM;
+        }
+    }
+
+    if (ret == UNIFYFS_SUCCESS) {
+        unifyfs_fops_ctx_t ctx = {
+            .app_id = reqmgr->app_id,
+            .client_id = reqmgr->client_id,
+        };
+        ret = unifyfs_fops_readdir(&ctx, gfid, start_gfid, max_entries,
+                                   entries, &num_entries, &end_of_dir);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("unifyfs_fops_readdir() failed");
+        }
+    }
+
+    /* push entries into the client bulk buffer */
+    if ((ret == UNIFYFS_SUCCESS) && (num_entries > 0)) {
+        hg_size_t sz = (hg_size_t)num_entries * sizeof(unifyfs_dirent_t);
+        ret = push_margo_bulk_buffer(req->handle, in->bulk_entries,
+                                     (void*)entries, sz);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("failed to push directory entries to client");
+        }
+    }
+    if (NULL != entries) {
+        free(entries);
+    }
+    margo_free_input(req->handle, in);
+    free(in);
+
+    /* send rpc response */
+    unifyfs_readdir_out_t out;
+    out.ret = (int32_t) ret;
+    out.num_entries = (ret == UNIFYFS_SUCCESS) ? (int32_t) num_entries : 0;
+    out.end_of_dir = (int32_t) end_of_dir;
+    hg_return_t hret = margo_respond(req->handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
+    }
+
+    /* cleanup req */
+    margo_destroy(req->handle);
+
+    return ret;
+}
+
 static int process_transfer_rpc(reqmgr_thrd_t* reqmgr,
                                 client_rpc_req_t* req)
 {
@@ -1344,6 +1521,9 @@ static int process_unlink_rpc(reqmgr_thrd_t* reqmgr,
     return ret;
 }
 
+/* returns the extents stored on this node's server for the requested
+ * file ranges, as an array ordered by requested range and then by
+ * file offset */
 static int process_node_local_extents_get_rpc(reqmgr_thrd_t* reqmgr,
                                               client_rpc_req_t* req)
 {
@@ -1353,78 +1533,98 @@ static int process_node_local_extents_get_rpc(reqmgr_thrd_t* reqmgr,
     size_t num_req = in->num_req;
     margo_free_input(req->handle, in);
     free(in);
+
     unifyfs_extent_t* in_extents = (unifyfs_extent_t*) req->bulk_buf;
-    struct extents_list out_list;
-    struct extents_list* out_list_cur = &out_list;
+    if ((num_req * sizeof(unifyfs_extent_t)) > req->bulk_sz) {
+        LOGERR("node local extents request of %zu ranges is truncated",
+               num_req);
+        num_req = 0;
+        ret = EINVAL;
+    }
+
+    unifyfs_client_index_t* extents_buffer = NULL;
     size_t total_chunks = 0;
-    bool add_node = false;
-    for (int i = 0; i < num_req; ++i) {
-        LOGDBG("getting node local extent for gfid=%d", in_extents[i].gfid);
+    for (size_t i = 0; i < num_req; i++) {
+        LOGDBG("getting node local extents for gfid=%d [%zu, +%zu)",
+               in_extents[i].gfid, in_extents[i].offset,
+               in_extents[i].length);
         unsigned int n_chunks = 0;
         chunk_read_req_t* chunks = NULL;
         int rc = unifyfs_invoke_find_extents_rpc(in_extents[i].gfid, 1,
                                                  &in_extents[i],
                                                  &n_chunks, &chunks);
-        if (!rc) {
-            if (add_node) {
-                out_list_cur->next = calloc(1, sizeof(struct extents_list));
-                out_list_cur = out_list_cur->next;
+        if ((rc != UNIFYFS_SUCCESS) || (0 == n_chunks)) {
+            if (NULL != chunks) {
+                free(chunks);
             }
-            for (int j = 0; j < n_chunks; ++j) {
-                out_list_cur->value.file_pos = chunks[j].offset;
-                out_list_cur->value.log_pos = chunks[j].log_offset;
-                out_list_cur->value.length = chunks[j].nbytes;
-                out_list_cur->value.gfid = in_extents[j].gfid;
-                out_list_cur->value.log_app_id = chunks[j].log_app_id;
-                out_list_cur->value.log_client_id = chunks[j].log_client_id;
-                if (i < n_chunks - 1) {
-                    out_list_cur->next = calloc(1, sizeof(struct extents_list));
-                    out_list_cur = out_list_cur->next;
-                } else {
-                    out_list_cur->next = NULL;
-                }
-            }
-            add_node = true;
-            total_chunks += n_chunks;
+            continue;
+        }
+
+        /* append the chunks stored on this node, which are sorted
+         * by offset */
+        unifyfs_client_index_t* tmp = realloc(extents_buffer,
+            (total_chunks + n_chunks) * sizeof(unifyfs_client_index_t));
+        if (NULL == tmp) {
             free(chunks);
+            ret = ENOMEM;
+            break;
         }
+        extents_buffer = tmp;
+        for (unsigned int j = 0; j < n_chunks; j++) {
+            if (chunks[j].rank != glb_pmi_rank) {
+                continue;
+            }
+            unifyfs_client_index_t* ext = extents_buffer + total_chunks;
+            ext->file_pos = chunks[j].offset;
+            ext->log_pos = chunks[j].log_offset;
+            ext->length = chunks[j].nbytes;
+            ext->gfid = in_extents[i].gfid;
+            ext->log_app_id = chunks[j].log_app_id;
+            ext->log_client_id = chunks[j].log_client_id;
+            total_chunks++;
+        }
+        free(chunks);
     }
     free(req->bulk_buf);
+
+    if (ret != UNIFYFS_SUCCESS) {
+        total_chunks = 0;
+    }
+
     /* prepare the response for node local extents get */
     unifyfs_node_local_extents_get_out_t out;
-    hg_return_t hret = 0;
+    hg_return_t hret;
     out.ret = (int32_t) ret;
     out.extent_count = total_chunks;
-    size_t extents_size = total_chunks*sizeof(unifyfs_client_index_t);
-    unifyfs_client_index_t* extents_buffer =
-            malloc(extents_size);
-    extents_list* cur = &out_list;
-    for (int i = 0; i < total_chunks; ++i) {
-        extents_buffer[i].file_pos = cur->value.file_pos;
-        extents_buffer[i].length = cur->value.length;
-        extents_buffer[i].gfid = cur->value.gfid;
-        extents_buffer[i].log_pos = cur->value.log_pos;
-        extents_buffer[i].log_app_id = cur->value.log_app_id;
-        extents_buffer[i].log_client_id = cur->value.log_client_id;
-        cur = cur->next;
-    }
-    hret = margo_bulk_create(unifyfsd_rpc_context->shm_mid,
-                             1, (void**) &extents_buffer, &extents_size,
-                             HG_BULK_READ_ONLY, &out.bulk_data);
-    out.bulk_size = extents_size;
+    out.bulk_data = HG_BULK_NULL;
+    out.bulk_size = 0;
+    if (total_chunks > 0) {
+        hg_size_t extents_size = total_chunks * sizeof(unifyfs_client_index_t);
+        hret = margo_bulk_create(unifyfsd_rpc_context->shm_mid,
+                                 1, (void**) &extents_buffer, &extents_size,
+                                 HG_BULK_READ_ONLY, &out.bulk_data);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_bulk_create() failed");
+            out.ret = UNIFYFS_ERROR_MARGO;
+            out.extent_count = 0;
+        } else {
+            out.bulk_size = extents_size;
+        }
+    }
 
     /* send rpc response */
     hret = margo_respond(req->handle, &out);
     if (hret != HG_SUCCESS) {
         LOGERR("margo_respond() failed");
     }
-    if (hret != HG_SUCCESS) {
-        LOGERR("margo_bulk_free() failed");
+
+    if (out.bulk_data != HG_BULK_NULL) {
+        margo_bulk_free(out.bulk_data);
+    }
+    if (NULL != extents_buffer) {
+        free(extents_buffer);
     }
-    free(extents_buffer);
-    /* margo_forward serializes all data before returning,
-     * and it's safe to free the rpc params */
-    margo_bulk_free(out.bulk_data);
+
     /* cleanup req */
     margo_destroy(req->handle);
     return ret;
@@ -1517,6 +1717,7 @@ static int rm_process_client_requests(reqmgr_thrd_t* reqmgr)
 
     /* release lock on reqmgr requests */
     RM_REQ_UNLOCK(reqmgr);
+    unifyfs_stats_add(UNIFYFS_STAT_SERVER_RM_QUEUE, -num_client_reqs);
 
     /* iterate over each client request */
     for (int i = 0; i < num_client_reqs; i++) {
@@ -1534,6 +1735,9 @@ static int rm_process_client_requests(reqmgr_thrd_t* reqmgr)
         case UNIFYFS_CLIENT_RPC_LAMINATE:
             rret = process_laminate_rpc(reqmgr, req);
             break;
+        case UNIFYFS_CLIENT_RPC_LIST_FILES:
+            rret = process_list_files_rpc(reqmgr, req);
+            break;
         case UNIFYFS_CLIENT_RPC_METAGET:
             rret = process_metaget_rpc(reqmgr, req);
             break;
@@ -1543,6 +1747,9 @@ static int rm_process_client_requests(reqmgr_thrd_t* reqmgr)
         case UNIFYFS_CLIENT_RPC_READ:
             rret = process_read_rpc(reqmgr, req);
             break;
+        case UNIFYFS_CLIENT_RPC_READDIR:
+            rret = process_readdir_rpc(reqmgr, req);
+            break;
         case UNIFYFS_CLIENT_RPC_SYNC:
             /* we remove this req since it will be finished by the svcmgr and
              * we don't want it deleted below as part of arraylist_free() */
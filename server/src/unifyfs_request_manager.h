@@ -80,7 +80,8 @@ typedef struct reqmgr_thrd {
     /* array of server read requests */
     int num_read_reqs;
     int next_rdreq_ndx;
-    server_read_req_t read_reqs[UNIFYFS_SERVER_MAX_READS];
+    int max_read_reqs;
+    server_read_req_t* read_reqs;
 
     /* list of client rpc requests */
     arraylist_t* client_reqs;
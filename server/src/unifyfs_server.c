@@ -34,12 +34,14 @@
 // common headers
 #include "unifyfs_configurator.h"
 #include "unifyfs_keyval.h"
+#include "unifyfs_rpc_util.h"
 
 // server components
 #include "unifyfs_global.h"
 #include "unifyfs_request_manager.h"
 #include "unifyfs_service_manager.h"
 #include "unifyfs_inode_tree.h"
+#include "unifyfs_dir_index.h"
 
 // margo rpcs
 #include "margo_server.h"
@@ -54,6 +56,16 @@ unifyfs_cfg_t server_cfg;
 
 bool use_server_local_extents; // = false
 
+int server_read_coalesce_usec; // = 0
+
+bool use_server_shared_extents; // = false
+
+size_t server_data_tx_size = UNIFYFS_SERVER_MAX_DATA_TX_SIZE;
+
+int server_max_reads = UNIFYFS_SERVER_MAX_READS;
+
+size_t server_transfer_buffer = UNIFYFS_TRANSFER_MAX_BUFFER;
+
 /* arraylist to track failed clients */
 arraylist_t* failed_clients; // = NULL
 
@@ -66,6 +78,16 @@ static size_t clients_per_app = UNIFYFS_SERVER_MAX_APP_CLIENTS;
 arraylist_t* pending_metagets; // = NULL
 static ABT_mutex pending_metagets_abt_sync;
 
+/* shmem-to-spill tiering thread, which periodically migrates cold
+ * client log chunks from shmem to spill */
+static pthread_t tier_thrd;
+static pthread_mutex_t tier_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tier_cond = PTHREAD_COND_INITIALIZER;
+static int tier_exit;                   /* set to stop tiering thread */
+static int tier_interval;               /* secs between passes, 0=disabled */
+static unsigned int tier_cold_secs = UNIFYFS_LOGIO_TIER_COLD_SECS;
+static size_t tier_batch = UNIFYFS_LOGIO_TIER_BATCH;
+
 
 static int unifyfs_exit(void);
 
@@ -238,6 +260,70 @@ static int get_server_rank_and_size(const unifyfs_cfg_t* cfg)
     return (int)UNIFYFS_SUCCESS;
 }
 
+/* migrate cold shmem chunks of each client log to spill */
+static void tier_app_client_logs(void)
+{
+    ABT_mutex_lock(app_configs_abt_sync);
+    for (int i = 0; i < UNIFYFS_SERVER_MAX_NUM_APPS; i++) {
+        app_config* app = app_configs[i];
+        if (NULL == app) {
+            continue;
+        }
+        for (size_t j = 0; j < app->clients_sz; j++) {
+            app_client* client = app->clients[j];
+            if ((NULL == client) || (NULL == client->state.logio_ctx)) {
+                continue;
+            }
+            logio_context* logio = client->state.logio_ctx;
+            size_t n_migrated = 0;
+            int rc = unifyfs_logio_tier_migrate(logio, tier_cold_secs,
+                                                tier_batch, &n_migrated);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("log tiering failed for client[%d:%d] - %s",
+                       client->state.app_id, client->state.client_id,
+                       unifyfs_rc_enum_description(rc));
+            }
+            if (n_migrated) {
+                logio_tier_stats stats;
+                unifyfs_logio_get_tier_stats(logio, &stats);
+                size_t reads = stats.mem_read_bytes + stats.spill_read_bytes;
+                double hit_pct = 100.0;
+                if (reads) {
+                    hit_pct = (100.0 * (double)stats.mem_read_bytes) /
+                              (double)reads;
+                }
+                LOGINFO("client[%d:%d] log tiering - migrated %zu chunks "
+                        "(%zu total), shmem chunks used %zu of %zu, "
+                        "shmem read hit rate %.1f%%",
+                        client->state.app_id, client->state.client_id,
+                        n_migrated, stats.migrated_chunks,
+                        stats.mem_chunks_used, stats.mem_chunks_total,
+                        hit_pct);
+            }
+        }
+    }
+    ABT_mutex_unlock(app_configs_abt_sync);
+}
+
+static void* tier_thread_main(void* arg)
+{
+    pthread_mutex_lock(&tier_mutex);
+    while (!tier_exit) {
+        struct timespec wakeup;
+        clock_gettime(CLOCK_REALTIME, &wakeup);
+        wakeup.tv_sec += tier_interval;
+        pthread_cond_timedwait(&tier_cond, &tier_mutex, &wakeup);
+        if (tier_exit) {
+            break;
+        }
+        pthread_mutex_unlock(&tier_mutex);
+        tier_app_client_logs();
+        pthread_mutex_lock(&tier_mutex);
+    }
+    pthread_mutex_unlock(&tier_mutex);
+    return NULL;
+}
+
 static void process_client_failures(void)
 {
     int num_failed = 0;
@@ -321,6 +407,69 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (server_cfg.server_read_coalesce_usec != NULL) {
+        rc = configurator_int_val(server_cfg.server_read_coalesce_usec, &l);
+        if ((0 == rc) && (l > 0)) {
+            server_read_coalesce_usec = (int) l;
+        }
+    }
+
+    if (server_cfg.server_shared_extents != NULL) {
+        bool enable = false;
+        rc = configurator_bool_val(server_cfg.server_shared_extents, &enable);
+        if ((0 == rc) && enable) {
+            use_server_shared_extents = true;
+        }
+    }
+
+    /* transfer sizes and limits, checked by config validation */
+    if (server_cfg.server_data_tx_size != NULL) {
+        rc = configurator_int_val(server_cfg.server_data_tx_size, &l);
+        if (0 == rc) {
+            server_data_tx_size = (size_t) l;
+        }
+    }
+
+    if (server_cfg.server_max_reads != NULL) {
+        rc = configurator_int_val(server_cfg.server_max_reads, &l);
+        if (0 == rc) {
+            server_max_reads = (int) l;
+        }
+    }
+
+    if (server_cfg.server_transfer_buffer != NULL) {
+        rc = configurator_int_val(server_cfg.server_transfer_buffer, &l);
+        if (0 == rc) {
+            server_transfer_buffer = (size_t) l;
+        }
+    }
+
+    if (server_cfg.margo_bulk_tx_size != NULL) {
+        rc = configurator_int_val(server_cfg.margo_bulk_tx_size, &l);
+        if (0 == rc) {
+            unifyfs_set_bulk_tx_size((size_t) l);
+        }
+    }
+
+    if (server_cfg.logio_tier_interval != NULL) {
+        rc = configurator_int_val(server_cfg.logio_tier_interval, &l);
+        if ((0 == rc) && (l > 0)) {
+            tier_interval = (int) l;
+        }
+    }
+    if (server_cfg.logio_tier_cold_secs != NULL) {
+        rc = configurator_int_val(server_cfg.logio_tier_cold_secs, &l);
+        if ((0 == rc) && (l >= 0)) {
+            tier_cold_secs = (unsigned int) l;
+        }
+    }
+    if (server_cfg.logio_tier_batch != NULL) {
+        rc = configurator_int_val(server_cfg.logio_tier_batch, &l);
+        if ((0 == rc) && (l > 0)) {
+            tier_batch = (size_t) l;
+        }
+    }
+
     // setup clean termination by signal
     memset(&sa, 0, sizeof(struct sigaction));
     sa.sa_handler = exit_request;
@@ -351,6 +500,27 @@ int main(int argc, char* argv[])
         LOGERR("%s", unifyfs_rc_enum_description((unifyfs_rc)rc));
     }
 
+    // use the background log writer if requested
+    if (server_cfg.log_async != NULL) {
+        bool enable = false;
+        rc = configurator_bool_val(server_cfg.log_async, &enable);
+        if ((0 == rc) && enable) {
+            bool binary = false;
+            if (server_cfg.log_binary != NULL) {
+                configurator_bool_val(server_cfg.log_binary, &binary);
+            }
+            bool drop = false;
+            if (server_cfg.log_async_drop != NULL) {
+                configurator_bool_val(server_cfg.log_async_drop, &drop);
+            }
+            unifyfs_log_async_drop = (int)drop;
+            rc = unifyfs_log_async_start((int)binary);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("failed to start async log writer (rc=%d)", rc);
+            }
+        }
+    }
+
     // print config
     unifyfs_config_print(&server_cfg, unifyfs_log_stream);
 
@@ -432,12 +602,27 @@ int main(int argc, char* argv[])
         margo_use_tcp = b;
     }
 
+    rc = configurator_bool_val(server_cfg.margo_tune_tx_size, &b);
+    if (0 == rc) {
+        margo_tune_tx_size = b;
+    }
+
     rc = margo_server_rpc_init();
     if (rc != UNIFYFS_SUCCESS) {
         LOGERR("RPC init failed - %s", unifyfs_rc_enum_description(rc));
         exit(1);
     }
 
+    if (margo_tune_tx_size) {
+        rc = margo_server_tune_tx_sizes();
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGWARN("transfer size tuning failed - using configured sizes");
+        }
+    }
+    LOGINFO("transfer sizes: bulk=%zu data=%zu transfer_buffer=%zu "
+            "max_reads=%d", unifyfs_get_bulk_tx_size(), server_data_tx_size,
+            server_transfer_buffer, server_max_reads);
+
     /* We wait to call any ABT functions until after margo_init.
      * Margo configures ABT in a particular way, so we defer to
      * Margo to call ABT_init. */
@@ -478,6 +663,9 @@ int main(int argc, char* argv[])
     /* initialize our tree that maps a gfid to its extent tree */
     unifyfs_inode_tree_init(global_inode_tree);
 
+    /* initialize indexes of the directories we own */
+    unifyfs_dir_index_init();
+
     LOGDBG("waiting for server bootstrapping to complete");
     rc = unifyfs_complete_bootstrap();
     if (rc != 0) {
@@ -486,6 +674,17 @@ int main(int argc, char* argv[])
         exit(1);
     }
 
+    if (tier_interval > 0) {
+        LOGDBG("launching log tiering thread (interval=%d secs)",
+               tier_interval);
+        rc = pthread_create(&tier_thrd, NULL, tier_thread_main, NULL);
+        if (rc != 0) {
+            LOGERR("failed to create log tiering thread - %s",
+                   strerror(rc));
+            tier_interval = 0;
+        }
+    }
+
     LOGDBG("server[%d] - finished initialization", glb_pmi_rank);
 
     while (1) {
@@ -500,8 +699,18 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (tier_interval > 0) {
+        LOGDBG("stopping log tiering thread");
+        pthread_mutex_lock(&tier_mutex);
+        tier_exit = 1;
+        pthread_cond_signal(&tier_cond);
+        pthread_mutex_unlock(&tier_mutex);
+        pthread_join(tier_thrd, NULL);
+    }
+
     /* tear down gfid-to-extents tree */
     unifyfs_inode_tree_destroy(global_inode_tree);
+    unifyfs_dir_index_fini();
 
     LOGDBG("stopping service manager thread");
     rc = svcmgr_fini();
@@ -835,13 +1044,18 @@ unifyfs_rc attach_app_client(app_client* client,
         return UNIFYFS_FAILURE;
     }
 
+    /* the index region holds a page of per-slot entry counts,
+     * followed by equal-sized slots of index entries */
+    size_t pgsz = get_page_size();
     client->state.write_index.index_offset = super_meta_offset;
     client->state.write_index.index_size = super_meta_size;
+    client->state.write_index.slot_entries = (super_meta_size - pgsz) /
+        (UNIFYFS_WRITE_INDEX_SLOTS * sizeof(unifyfs_index_t));
 
     char* super_ptr = (char*)(client->state.shm_super_ctx->addr);
     char* index_ptr = super_ptr + super_meta_offset;
     client->state.write_index.ptr_num_entries = (size_t*) index_ptr;
-    index_ptr += get_page_size();
+    index_ptr += pgsz;
     client->state.write_index.index_entries = (unifyfs_index_t*) index_ptr;
 
     client->state.initialized = 1;
@@ -937,6 +1151,205 @@ unifyfs_rc cleanup_app_client(app_config* app, app_client* client)
     return urc;
 }
 
+static int compare_log_read_client(const void* a, const void* b)
+{
+    const app_client_log_read* ra = (const app_client_log_read*) a;
+    const app_client_log_read* rb = (const app_client_log_read*) b;
+    if (ra->app_id != rb->app_id) {
+        return (ra->app_id < rb->app_id) ? -1 : 1;
+    }
+    if (ra->client_id != rb->client_id) {
+        return (ra->client_id < rb->client_id) ? -1 : 1;
+    }
+    if (ra->iov.log_offset != rb->iov.log_offset) {
+        return (ra->iov.log_offset < rb->iov.log_offset) ? -1 : 1;
+    }
+    if (ra->ndx != rb->ndx) {
+        return (ra->ndx < rb->ndx) ? -1 : 1;
+    }
+    return 0;
+}
+
+/* a merged read of log-adjacent or overlapping ranges of one client log */
+typedef struct log_read_run {
+    int first;      /* index of first read in the run */
+    int count;      /* number of reads in the run */
+    off_t end;      /* end log offset of the run */
+    int direct;     /* reads are contiguous in both log and memory */
+    char* tmp;      /* temporary buffer used if not direct */
+} log_read_run;
+
+/* Read the given reads of one client log, which are sorted by log offset.
+ * Reads that are adjacent or overlapping in the log are merged into a
+ * single larger read, whose data is then scattered to the read buffers.
+ * When the merged reads are also contiguous in memory, the data is read
+ * directly into their buffers. */
+static int read_client_log_coalesced(logio_context* logio_ctx,
+                                     int n_reads,
+                                     app_client_log_read* reads)
+{
+    int i, r;
+    int n_runs = 0;
+    log_read_run* runs = (log_read_run*) calloc(n_reads, sizeof(*runs));
+    logio_iovec* iov = (logio_iovec*) calloc(n_reads, sizeof(*iov));
+    if ((NULL == runs) || (NULL == iov)) {
+        LOGERR("failed to allocate log read iovecs");
+        free(runs);
+        free(iov);
+        return ENOMEM;
+    }
+
+    /* build the runs of reads to merge */
+    log_read_run* run = NULL;
+    for (i = 0; i < n_reads; i++) {
+        logio_iovec* v = &(reads[i].iov);
+        off_t v_end = v->log_offset + (off_t) v->nbytes;
+        if (NULL != run) {
+            off_t run_start = reads[run->first].iov.log_offset;
+            off_t new_end = (v_end > run->end) ? v_end : run->end;
+            if ((v->log_offset <= run->end) &&
+                ((size_t)(new_end - run_start) <=
+                 UNIFYFS_SERVER_READ_COALESCE_MAX)) {
+                /* direct reads need exact adjacency in both the log
+                 * and the destination memory */
+                logio_iovec* prev = &(reads[i - 1].iov);
+                if ((v->log_offset != run->end) ||
+                    (v->buf != (prev->buf + prev->nbytes))) {
+                    run->direct = 0;
+                }
+                run->count++;
+                run->end = new_end;
+                continue;
+            }
+        }
+        run = runs + n_runs;
+        n_runs++;
+        run->first = i;
+        run->count = 1;
+        run->end = v_end;
+        run->direct = 1;
+    }
+
+    /* set up one iovec per run */
+    int ret = UNIFYFS_SUCCESS;
+    for (r = 0; r < n_runs; r++) {
+        run = runs + r;
+        logio_iovec* first = &(reads[run->first].iov);
+        iov[r].log_offset = first->log_offset;
+        iov[r].nbytes = (size_t)(run->end - first->log_offset);
+        if (run->direct) {
+            iov[r].buf = first->buf;
+        } else {
+            run->tmp = (char*) malloc(iov[r].nbytes);
+            if (NULL == run->tmp) {
+                LOGERR("failed to allocate coalesced read buffer");
+                ret = ENOMEM;
+                break;
+            }
+            iov[r].buf = run->tmp;
+        }
+    }
+
+    if (UNIFYFS_SUCCESS == ret) {
+        if (n_runs < n_reads) {
+            LOGDBG("coalesced %d log reads into %d", n_reads, n_runs);
+        }
+        ret = unifyfs_logio_readv(logio_ctx, n_runs, iov);
+
+        /* scatter the results to the original reads */
+        for (r = 0; r < n_runs; r++) {
+            run = runs + r;
+            for (i = run->first; i < (run->first + run->count); i++) {
+                logio_iovec* v = &(reads[i].iov);
+                size_t rel = (size_t)(v->log_offset - iov[r].log_offset);
+                size_t got = 0;
+                if (iov[r].obytes > rel) {
+                    got = iov[r].obytes - rel;
+                    if (got > v->nbytes) {
+                        got = v->nbytes;
+                    }
+                }
+                if (!run->direct && got) {
+                    memcpy(v->buf, run->tmp + rel, got);
+                }
+                v->obytes = got;
+                v->rc = (got > 0) ? UNIFYFS_SUCCESS : iov[r].rc;
+            }
+        }
+    } else {
+        for (i = 0; i < n_reads; i++) {
+            reads[i].iov.obytes = 0;
+            reads[i].iov.rc = ret;
+        }
+    }
+
+    for (r = 0; r < n_runs; r++) {
+        free(runs[r].tmp);
+    }
+    free(runs);
+    free(iov);
+    return ret;
+}
+
+unifyfs_rc read_app_client_logs(int n_reads,
+                                app_client_log_read* reads)
+{
+    if ((n_reads > 0) && (NULL == reads)) {
+        return EINVAL;
+    }
+
+    /* group the reads by client log, in log offset order */
+    qsort(reads, (size_t) n_reads, sizeof(*reads), compare_log_read_client);
+
+    unifyfs_rc ret = UNIFYFS_SUCCESS;
+    int start = 0;
+    while (start < n_reads) {
+        int app_id = reads[start].app_id;
+        int cli_id = reads[start].client_id;
+        int end = start + 1;
+        while ((end < n_reads) &&
+               (reads[end].app_id == app_id) &&
+               (reads[end].client_id == cli_id)) {
+            end++;
+        }
+        int n_client = end - start;
+
+        int rc = UNIFYFS_SUCCESS;
+        logio_context* logio_ctx = NULL;
+        app_client* client = get_app_client(app_id, cli_id);
+        if (NULL == client) {
+            LOGERR("failed to get application client [%d:%d] state",
+                   app_id, cli_id);
+            rc = EINVAL;
+        } else {
+            logio_ctx = client->state.logio_ctx;
+            if (NULL == logio_ctx) {
+                LOGERR("app client [%d:%d] has NULL logio context",
+                       app_id, cli_id);
+                rc = EINVAL;
+            }
+        }
+
+        if (NULL != logio_ctx) {
+            LOGDBG("reading %d ranges from log[%d:%d]",
+                   n_client, app_id, cli_id);
+            rc = read_client_log_coalesced(logio_ctx, n_client,
+                                           reads + start);
+        } else {
+            for (int i = 0; i < n_client; i++) {
+                reads[start + i].iov.obytes = 0;
+                reads[start + i].iov.rc = rc;
+            }
+        }
+
+        if ((rc != UNIFYFS_SUCCESS) && (ret == UNIFYFS_SUCCESS)) {
+            ret = rc;
+        }
+        start = end;
+    }
+    return ret;
+}
+
 unifyfs_rc add_failed_client(int app_id, int client_id)
 {
     app_client* client = get_app_client(app_id, client_id);
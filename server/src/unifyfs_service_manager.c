@@ -28,9 +28,11 @@
  */
 
 #include "unifyfs_global.h"
+#include "unifyfs_dir_index.h"
 #include "unifyfs_group_rpc.h"
 #include "unifyfs_p2p_rpc.h"
 #include "unifyfs_request_manager.h"
+#include "unifyfs_rpc_util.h"
 #include "unifyfs_service_manager.h"
 #include "unifyfs_server_rpcs.h"
 #include "unifyfs_transfer.h"
@@ -124,6 +126,8 @@ int sm_submit_service_request(server_rpc_req_t* req)
     SM_REQ_LOCK();
     arraylist_add(sm->svc_reqs, req);
     SM_REQ_UNLOCK();
+    unifyfs_stats_add(UNIFYFS_STAT_SERVER_SM_QUEUE, 1);
+    unifyfs_stats_add(UNIFYFS_STAT_SERVER_SM_REQUESTS, 1);
 
     signal_svcmgr();
 
@@ -275,29 +279,18 @@ int svcmgr_fini(void)
     return UNIFYFS_SUCCESS;
 }
 
-/* Decode and issue chunk-reads received from request manager.
- * We get a list of read requests for data on our node.  Read
- * data for each request and construct a set of read replies
- * that will be sent back to the request manager.
- *
- * @param src_rank      : source server rank
- * @param src_app_id    : app id at source server
- * @param src_client_id : client id at source server
- * @param src_req_id    : request id at source server
- * @param num_chks      : number of chunk requests
- * @param msg_buf       : message buffer containing request(s)
- * @return success/error code
- */
-int sm_issue_chunk_reads(int src_rank,
-                         int src_app_id,
-                         int src_client_id,
-                         int src_req_id,
-                         int num_chks,
-                         size_t total_data_sz,
-                         char* msg_buf)
+/* Set up the chunk read responses for one request of a batch, and add
+ * its reads of client log data to the batch's log reads. The response
+ * for chunk i of the request is recorded at resps[base + i]. */
+static int prepare_chunk_reads(sm_chunk_read_req* creq,
+                               int base,
+                               chunk_read_resp_t** resps,
+                               app_client_log_read* log_reads,
+                               int* n_log_reads)
 {
     /* get pointer to read request array */
-    chunk_read_req_t* reqs = (chunk_read_req_t*)msg_buf;
+    chunk_read_req_t* reqs = (chunk_read_req_t*) creq->msg_buf;
+    int num_chks = creq->num_chks;
 
     /* we'll allocate a buffer to hold a list of chunk read response
      * structures, one for each chunk, followed by a data buffer
@@ -305,7 +298,7 @@ int sm_issue_chunk_reads(int src_rank,
 
     /* compute the size of that buffer */
     size_t resp_sz = sizeof(chunk_read_resp_t) * num_chks;
-    size_t buf_sz  = resp_sz + total_data_sz;
+    size_t buf_sz  = resp_sz + creq->total_data_sz;
 
     /* allocate the buffer */
     // NOTE: calloc() is required here, don't use malloc
@@ -326,28 +319,29 @@ int sm_issue_chunk_reads(int src_rank,
         calloc(1, sizeof(server_chunk_reads_t));
     if (NULL == scr) {
         LOGERR("failed to allocate remote_chunk_reads");
+        free(crbuf);
         return ENOMEM;
     }
 
     /* fill in chunk read request */
-    scr->rank       = src_rank;
-    scr->app_id     = src_app_id;
-    scr->client_id  = src_client_id;
-    scr->rdreq_id   = src_req_id;
+    scr->rank       = creq->src_rank;
+    scr->app_id     = creq->src_app_id;
+    scr->client_id  = creq->src_client_id;
+    scr->rdreq_id   = creq->src_req_id;
     scr->num_chunks = num_chks;
     scr->reqs       = NULL;
     scr->total_sz   = buf_sz;
     scr->resp       = resp;
+    creq->scr = scr;
 
     LOGDBG("issuing %d requests for req=%d, total data size = %zu",
-           num_chks, src_req_id, total_data_sz);
+           num_chks, creq->src_req_id, creq->total_data_sz);
 
     /* points to offset in read reply buffer to place
      * data for next read */
     size_t buf_cursor = 0;
 
     int i;
-    app_client* app_clnt = NULL;
     for (i = 0; i < num_chks; i++) {
         /* pointer to next read request */
         chunk_read_req_t* rreq = reqs + i;
@@ -355,6 +349,7 @@ int sm_issue_chunk_reads(int src_rank,
 
         /* pointer to next read response */
         chunk_read_resp_t* rresp = resp + i;
+        resps[base + i] = rresp;
 
         /* get size and log offset of data we are to read */
         size_t nbytes = rreq->nbytes;
@@ -369,37 +364,35 @@ int sm_issue_chunk_reads(int src_rank,
         /* get pointer to next position in buffer to store read data */
         char* buf_ptr = databuf + buf_cursor;
 
-        /* read data from client log */
-        int app_id = rreq->log_app_id;
-        int cli_id = rreq->log_client_id;
-        app_clnt = get_app_client(app_id, cli_id);
-        if (NULL != app_clnt) {
-            logio_context* logio_ctx = app_clnt->state.logio_ctx;
-            if (NULL != logio_ctx) {
-                size_t nread = 0;
-                int rc = unifyfs_logio_read(logio_ctx, log_offset, nbytes,
-                                            buf_ptr, &nread);
-                if (UNIFYFS_SUCCESS == rc) {
-                    rresp->read_rc = nread;
-                } else {
-                    rresp->read_rc = (ssize_t)(-rc);
-                }
-            } else {
-                LOGERR("app client [%d:%d] has NULL logio context",
-                       app_id, cli_id);
-                rresp->read_rc = (ssize_t)(-EINVAL);
-            }
-        } else {
-            LOGERR("failed to get application client [%d:%d] state",
-                   app_id, cli_id);
-            rresp->read_rc = (ssize_t)(-EINVAL);
-        }
-
         /* update to point to next slot in read reply buffer */
         buf_cursor += nbytes;
+
+        if (unifyfs_is_hole_log_pos(log_offset)) {
+            /* hole extents have no log data, fill with zeros */
+            memset(buf_ptr, 0, nbytes);
+            rresp->read_rc = nbytes;
+            continue;
+        }
+
+        /* read data from client log */
+        app_client_log_read* lr = log_reads + *n_log_reads;
+        (*n_log_reads)++;
+        lr->app_id         = rreq->log_app_id;
+        lr->client_id      = rreq->log_client_id;
+        lr->ndx            = base + i;
+        lr->iov.log_offset = (off_t) log_offset;
+        lr->iov.nbytes     = nbytes;
+        lr->iov.buf        = buf_ptr;
     }
 
-    if (src_rank != glb_pmi_rank) {
+    return UNIFYFS_SUCCESS;
+}
+
+/* Deliver the chunk read responses for one request of a batch */
+static int post_chunk_reads(sm_chunk_read_req* creq)
+{
+    server_chunk_reads_t* scr = creq->scr;
+    if (creq->src_rank != glb_pmi_rank) {
         /* we need to send these read responses to another rank,
          * add chunk_reads to svcmgr response list */
         LOGDBG("adding to svcmgr chunk_reads");
@@ -416,9 +409,13 @@ int sm_issue_chunk_reads(int src_rank,
     } else {
         /* response is for myself, post it directly */
         LOGDBG("responding to myself");
-        int rc = rm_post_chunk_read_responses(src_app_id, src_client_id,
-                                              src_rank, src_req_id,
-                                              num_chks, buf_sz, crbuf);
+        int rc = rm_post_chunk_read_responses(creq->src_app_id,
+                                              creq->src_client_id,
+                                              creq->src_rank,
+                                              creq->src_req_id,
+                                              scr->num_chunks,
+                                              scr->total_sz,
+                                              (char*) scr->resp);
         if (rc != UNIFYFS_SUCCESS) {
             LOGERR("failed to handle chunk read responses");
         }
@@ -430,6 +427,106 @@ int sm_issue_chunk_reads(int src_rank,
     }
 }
 
+/* Issue the chunk reads of many requests together, so that reads of
+ * adjacent client log data from different requests can be merged.
+ * Sets creqs[i].ret for each request, and returns the first error. */
+int sm_issue_chunk_read_batch(int n_creqs,
+                              sm_chunk_read_req* creqs)
+{
+    int i;
+    int ret = UNIFYFS_SUCCESS;
+
+    int total_chks = 0;
+    for (i = 0; i < n_creqs; i++) {
+        creqs[i].scr = NULL;
+        creqs[i].ret = UNIFYFS_SUCCESS;
+        total_chks += creqs[i].num_chks;
+    }
+
+    /* read requests for chunks stored in client logs */
+    app_client_log_read* log_reads = (app_client_log_read*)
+        calloc(total_chks, sizeof(app_client_log_read));
+    chunk_read_resp_t** resps = (chunk_read_resp_t**)
+        calloc(total_chks, sizeof(chunk_read_resp_t*));
+    if ((total_chks > 0) && ((NULL == log_reads) || (NULL == resps))) {
+        LOGERR("failed to allocate chunk log reads");
+        free(log_reads);
+        free(resps);
+        for (i = 0; i < n_creqs; i++) {
+            creqs[i].ret = ENOMEM;
+        }
+        return ENOMEM;
+    }
+    int n_log_reads = 0;
+
+    int base = 0;
+    for (i = 0; i < n_creqs; i++) {
+        creqs[i].ret = prepare_chunk_reads(creqs + i, base, resps,
+                                           log_reads, &n_log_reads);
+        base += creqs[i].num_chks;
+    }
+
+    /* issue the reads for all chunks in each client log together */
+    if (n_creqs > 1) {
+        LOGDBG("issuing %d log reads for %d chunk read requests",
+               n_log_reads, n_creqs);
+    }
+    read_app_client_logs(n_log_reads, log_reads);
+    for (i = 0; i < n_log_reads; i++) {
+        app_client_log_read* lr = log_reads + i;
+        chunk_read_resp_t* rresp = resps[lr->ndx];
+        if (UNIFYFS_SUCCESS == lr->iov.rc) {
+            rresp->read_rc = lr->iov.obytes;
+        } else {
+            rresp->read_rc = (ssize_t)(-(lr->iov.rc));
+        }
+    }
+    free(log_reads);
+    free(resps);
+
+    for (i = 0; i < n_creqs; i++) {
+        if (NULL != creqs[i].scr) {
+            creqs[i].ret = post_chunk_reads(creqs + i);
+        }
+        if ((creqs[i].ret != UNIFYFS_SUCCESS) && (ret == UNIFYFS_SUCCESS)) {
+            ret = creqs[i].ret;
+        }
+    }
+    return ret;
+}
+
+/* Decode and issue chunk-reads received from request manager.
+ * We get a list of read requests for data on our node.  Read
+ * data for each request and construct a set of read replies
+ * that will be sent back to the request manager.
+ *
+ * @param src_rank      : source server rank
+ * @param src_app_id    : app id at source server
+ * @param src_client_id : client id at source server
+ * @param src_req_id    : request id at source server
+ * @param num_chks      : number of chunk requests
+ * @param msg_buf       : message buffer containing request(s)
+ * @return success/error code
+ */
+int sm_issue_chunk_reads(int src_rank,
+                         int src_app_id,
+                         int src_client_id,
+                         int src_req_id,
+                         int num_chks,
+                         size_t total_data_sz,
+                         char* msg_buf)
+{
+    sm_chunk_read_req creq = {0};
+    creq.src_rank      = src_rank;
+    creq.src_app_id    = src_app_id;
+    creq.src_client_id = src_client_id;
+    creq.src_req_id    = src_req_id;
+    creq.num_chks      = num_chks;
+    creq.total_data_sz = total_data_sz;
+    creq.msg_buf       = msg_buf;
+    return sm_issue_chunk_read_batch(1, &creq);
+}
+
 int sm_laminate(int gfid)
 {
     int owner_rank = hash_gfid_to_server(gfid);
@@ -492,6 +589,35 @@ int sm_set_fileattr(int gfid,
     return ret;
 }
 
+int sm_readdir(int gfid,
+               int start_gfid,
+               unsigned int max_entries,
+               unifyfs_dirent_t* entries,
+               unsigned int* num_entries,
+               int* end_of_dir)
+{
+    int ret = unifyfs_dir_index_read(gfid, start_gfid, max_entries,
+                                     entries, num_entries, end_of_dir);
+    if (ret != UNIFYFS_SUCCESS) {
+        LOGERR("failed to read directory gfid=%d (rc=%d)", gfid, ret);
+        return ret;
+    }
+
+    /* refresh entry attributes from local copies of the child inodes,
+     * which may have changed since the entries were added */
+    unsigned int i;
+    for (i = 0; i < *num_entries; i++) {
+        unifyfs_file_attr_t attrs;
+        int rc = unifyfs_inode_metaget(entries[i].gfid, &attrs);
+        if (rc == UNIFYFS_SUCCESS) {
+            unifyfs_dirent_set_attr(&(entries[i]), &attrs);
+        }
+    }
+    LOGDBG("readdir(gfid=%d, start=%d) returning %u entries (eod=%d)",
+           gfid, start_gfid, *num_entries, *end_of_dir);
+    return ret;
+}
+
 int sm_add_extents(int gfid,
                    size_t num_extents,
                    extent_metadata* extents)
@@ -795,41 +921,59 @@ static int complete_local_transfers(void)
     return ret;
 }
 
-static int process_chunk_read_rpc(server_rpc_req_t* req)
+/* Process a run of chunk read rpc requests as one batch of reads */
+static int process_chunk_read_rpcs(server_rpc_req_t** reqs,
+                                   int n_reqs)
 {
-    int ret;
-    chunk_read_request_in_t* in = req->input;
-
-    /* issue chunk read requests */
-    int src_rank    = (int)in->src_rank;
-    int app_id      = (int)in->app_id;
-    int client_id   = (int)in->client_id;
-    int req_id      = (int)in->req_id;
-    int num_chks    = (int)in->num_chks;
-    size_t total_sz = (size_t)in->total_data_size;
+    int i;
+    int ret = UNIFYFS_SUCCESS;
 
-    LOGDBG("handling chunk read requests from server[%d]: "
-           "req=%d num_chunks=%d data_sz=%zu bulk_sz=%zu",
-           src_rank, req_id, num_chks, total_sz, req->bulk_sz);
+    sm_chunk_read_req* creqs = (sm_chunk_read_req*)
+        calloc(n_reqs, sizeof(sm_chunk_read_req));
+    if (NULL == creqs) {
+        LOGERR("failed to allocate chunk read batch");
+        ret = ENOMEM;
+    } else {
+        for (i = 0; i < n_reqs; i++) {
+            chunk_read_request_in_t* in = reqs[i]->input;
+
+            /* issue chunk read requests */
+            sm_chunk_read_req* creq = creqs + i;
+            creq->src_rank      = (int)in->src_rank;
+            creq->src_app_id    = (int)in->app_id;
+            creq->src_client_id = (int)in->client_id;
+            creq->src_req_id    = (int)in->req_id;
+            creq->num_chks      = (int)in->num_chks;
+            creq->total_data_sz = (size_t)in->total_data_size;
+            creq->msg_buf       = (char*)reqs[i]->bulk_buf;
+
+            LOGDBG("handling chunk read requests from server[%d]: "
+                   "req=%d num_chunks=%d data_sz=%zu bulk_sz=%zu",
+                   creq->src_rank, creq->src_req_id, creq->num_chks,
+                   creq->total_data_sz, reqs[i]->bulk_sz);
+        }
+        ret = sm_issue_chunk_read_batch(n_reqs, creqs);
+    }
 
-    ret = sm_issue_chunk_reads(src_rank, app_id, client_id,
-                               req_id, num_chks, total_sz,
-                               (char*)req->bulk_buf);
+    for (i = 0; i < n_reqs; i++) {
+        server_rpc_req_t* req = reqs[i];
+        chunk_read_request_in_t* in = req->input;
+        margo_free_input(req->handle, in);
+        free(in);
+        free(req->bulk_buf);
 
-    margo_free_input(req->handle, in);
-    free(in);
-    free(req->bulk_buf);
+        /* send rpc response */
+        chunk_read_request_out_t out;
+        out.ret = (int32_t)((NULL != creqs) ? creqs[i].ret : ret);
+        hg_return_t hret = margo_respond(req->handle, &out);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_respond() failed");
+        }
 
-    /* send rpc response */
-    chunk_read_request_out_t out;
-    out.ret = (int32_t) ret;
-    hg_return_t hret = margo_respond(req->handle, &out);
-    if (hret != HG_SUCCESS) {
-        LOGERR("margo_respond() failed");
+        /* cleanup req */
+        margo_destroy(req->handle);
     }
-
-    /* cleanup req */
-    margo_destroy(req->handle);
+    free(creqs);
 
     return ret;
 }
@@ -839,16 +983,31 @@ static int process_add_extents_rpc(server_rpc_req_t* req)
     /* get input parameters */
     add_extents_in_t* in = req->input;
     int sender = (int) in->src_rank;
-    int gfid = (int) in->gfid;
+    int num_files = (int) in->num_files;
     size_t num_extents = (size_t) in->num_extents;
-    extent_metadata* extents = req->bulk_buf;
+    add_extents_file* files = req->bulk_buf;
+    extent_metadata* extents = (extent_metadata*)(files + num_files);
 
-    /* add extents */
-    LOGDBG("adding %zu extents to gfid=%d from server[%d]",
-           num_extents, gfid, sender);
-    int ret = sm_add_extents(gfid, num_extents, extents);
-    if (ret) {
-        LOGERR("failed to add extents from %d (ret=%d)", sender, ret);
+    /* add the extents of each file */
+    int ret = UNIFYFS_SUCCESS;
+    size_t n_added = 0;
+    for (int i = 0; i < num_files; i++) {
+        int gfid = files[i].gfid;
+        size_t n_file = (size_t) files[i].num_extents;
+        if ((num_extents - n_added) < n_file) {
+            LOGERR("bad extent count %zu for gfid=%d from server[%d]",
+                   n_file, gfid, sender);
+            ret = EINVAL;
+            break;
+        }
+        LOGDBG("adding %zu extents to gfid=%d from server[%d]",
+               n_file, gfid, sender);
+        int rc = sm_add_extents(gfid, n_file, extents + n_added);
+        if (rc) {
+            LOGERR("failed to add extents from %d (ret=%d)", sender, rc);
+            ret = rc;
+        }
+        n_added += n_file;
     }
 
     margo_free_input(req->handle, in);
@@ -1042,6 +1201,125 @@ static int process_metaset_rpc(server_rpc_req_t* req)
     return ret;
 }
 
+static int process_list_files_rpc(server_rpc_req_t* req)
+{
+    /* get listing position and filter */
+    list_files_in_t* in = req->input;
+    int start_gfid = (int) in->start_gfid;
+    unsigned int max_files = (unsigned int) in->max_files;
+    size_t page_sz = (size_t) in->page_size;
+    if (page_sz > UNIFYFS_LIST_FILES_MAX_BYTES) {
+        page_sz = UNIFYFS_LIST_FILES_MAX_BYTES;
+    }
+    unifyfs_file_filter_t filter = {
+        .prefix = in->prefix,
+        .owner_rank = glb_pmi_rank,
+        .laminated = (int) in->laminated
+    };
+
+    unsigned int num_files = 0;
+    size_t page_used = 0;
+    int next_gfid = start_gfid;
+    int end_of_list = 0;
+    int ret = ENOMEM;
+    void* page = NULL;
+    if (page_sz > 0) {
+        page = malloc(page_sz);
+    }
+    if (NULL != page) {
+        ret = unifyfs_inode_list_owned(start_gfid, &filter, max_files,
+                                       page, page_sz, &num_files,
+                                       &page_used, &next_gfid, &end_of_list);
+    }
+
+    /* push records into the bulk buffer of the requesting server */
+    if ((ret == UNIFYFS_SUCCESS) && (page_used > 0)) {
+        ret = push_margo_bulk_buffer(req->handle, in->page,
+                                     page, (hg_size_t) page_used);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("failed to push file records");
+        }
+    }
+    if (NULL != page) {
+        free(page);
+    }
+
+    margo_free_input(req->handle, in);
+    free(in);
+
+    /* send rpc response */
+    list_files_out_t out;
+    out.ret         = (int32_t) ret;
+    out.num_files   = (ret == UNIFYFS_SUCCESS) ? (int32_t) num_files : 0;
+    out.page_used   = (ret == UNIFYFS_SUCCESS) ? (hg_size_t) page_used : 0;
+    out.next_gfid   = (int32_t) next_gfid;
+    out.end_of_list = (int32_t) end_of_list;
+    hg_return_t hret = margo_respond(req->handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
+    }
+
+    /* cleanup req */
+    margo_destroy(req->handle);
+
+    return ret;
+}
+
+static int process_readdir_rpc(server_rpc_req_t* req)
+{
+    /* get target directory and read position */
+    readdir_in_t* in = req->input;
+    int gfid = (int) in->gfid;
+    int start_gfid = (int) in->start_gfid;
+    unsigned int max_entries = (unsigned int) in->max_entries;
+    if (max_entries > UNIFYFS_READDIR_MAX_ENTRIES) {
+        max_entries = UNIFYFS_READDIR_MAX_ENTRIES;
+    }
+
+    unsigned int num_entries = 0;
+    int end_of_dir = 0;
+    int ret = ENOMEM;
+    unifyfs_dirent_t* entries = NULL;
+    if (max_entries > 0) {
+        entries = calloc(max_entries, sizeof(unifyfs_dirent_t));
+    }
+    if ((0 == max_entries) || (NULL != entries)) {
+        ret = sm_readdir(gfid, start_gfid, max_entries,
+                         entries, &num_entries, &end_of_dir);
+    }
+
+    /* push entries into the bulk buffer of the requesting server */
+    if ((ret == UNIFYFS_SUCCESS) && (num_entries > 0)) {
+        hg_size_t sz = (hg_size_t)num_entries * sizeof(unifyfs_dirent_t);
+        ret = push_margo_bulk_buffer(req->handle, in->entries,
+                                     (void*)entries, sz);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("failed to push directory entries");
+        }
+    }
+    if (NULL != entries) {
+        free(entries);
+    }
+
+    margo_free_input(req->handle, in);
+    free(in);
+
+    /* send rpc response */
+    readdir_out_t out;
+    out.ret = (int32_t) ret;
+    out.num_entries = (ret == UNIFYFS_SUCCESS) ? (int32_t) num_entries : 0;
+    out.end_of_dir = (int32_t) end_of_dir;
+    hg_return_t hret = margo_respond(req->handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
+    }
+
+    /* cleanup req */
+    margo_destroy(req->handle);
+
+    return ret;
+}
+
 static int process_transfer_rpc(server_rpc_req_t* req)
 {
     /* get target file and requested file size */
@@ -1370,7 +1648,7 @@ static int process_metaget_bcast_rpc(server_rpc_req_t* req)
     }
     if (sizeof(metaget_all_bcast_out_t) != coll->output_sz) {
         LOGERR("Unexpected size for collective output struct. "
-                "Expected %d but value was %d",
+                "Expected %zu but value was %zu",
                 sizeof(metaget_all_bcast_out_t),
                 coll->output_sz);
         free(attr_list);
@@ -1418,100 +1696,259 @@ static int process_metaget_bcast_rpc(server_rpc_req_t* req)
     return invoke_bcast_progress_rpc(req->coll);
 }
 
-static int process_pending_sync(server_rpc_req_t* req)
+void sm_complete_pending_sync(pending_sync_req* sync_req,
+                              int num_done,
+                              int ret)
 {
-    int ret = UNIFYFS_SUCCESS;
+    if (NULL == sync_req) {
+        return;
+    }
 
-    /* get target file */
-    int* pending_gfid = req->input;
-    int gfid = *pending_gfid;
-    free(pending_gfid);
+    ABT_mutex_lock(sync_req->sync);
+    if ((ret != UNIFYFS_SUCCESS) && (sync_req->ret == UNIFYFS_SUCCESS)) {
+        sync_req->ret = ret;
+    }
+    sync_req->num_pending -= num_done;
+    int remaining = sync_req->num_pending;
+    ABT_mutex_unlock(sync_req->sync);
 
-    int owner_rank = hash_gfid_to_server(gfid);
-    int is_owner = (owner_rank == glb_pmi_rank);
+    if (remaining > 0) {
+        return;
+    }
 
-    bool has_pending = unifyfs_inode_has_pending_extents(gfid);
-    if (has_pending) {
-        usleep(50000); /* sleep 50 ms to catch more pending extents */
+    /* send rpc response to requesting client */
+    client_rpc_req_t* creq = sync_req->client_req;
+    unifyfs_fsync_out_t out;
+    out.ret = (int32_t) sync_req->ret;
+    hg_return_t hret = margo_respond(creq->handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
     }
 
-    arraylist_t* pending_list = NULL;
-    int rc = unifyfs_inode_get_pending_extents(gfid, &pending_list);
-    if (NULL != pending_list) {
-        LOGDBG("processing pending sync for gfid=%d", gfid);
+    /* cleanup req */
+    margo_destroy(creq->handle);
+    free(creq);
+    ABT_mutex_free(&(sync_req->sync));
+    free(sync_req);
+}
+
+/* pending extents of a file, gathered for a pending sync */
+typedef struct pending_sync_file {
+    int gfid;
+    int owner_rank;
+    arraylist_t* pending_list;  /* pending items, NULL if none */
+    unsigned int num_extents;
+    extent_metadata* extents;   /* combined extents of the items */
+    int ret;
+} pending_sync_file;
 
-        /* iterate through pending list to count total number of extents
-         * we will add locally (and possibly send to owner) */
-        unsigned int total_extents = 0;
+/* gather the pending extents of a file and add them to the local inode */
+static void gather_pending_sync_file(pending_sync_file* psf)
+{
+    int gfid = psf->gfid;
+    psf->owner_rank = hash_gfid_to_server(gfid);
+    psf->ret = UNIFYFS_SUCCESS;
+
+    int rc = unifyfs_inode_get_pending_extents(gfid, &(psf->pending_list));
+    arraylist_t* pending_list = psf->pending_list;
+    if (NULL == pending_list) {
+        if (rc != UNIFYFS_SUCCESS) {
+            psf->ret = rc;
+            LOGERR("failed to get pending extents list for gfid=%d- rc=%d",
+                   gfid, rc);
+        }
+        return;
+    }
+    LOGDBG("processing pending sync for gfid=%d", gfid);
+
+    /* iterate through pending list to count total number of extents
+     * we will add locally (and possibly send to owner) */
+    unsigned int total_extents = 0;
+    int n_items = arraylist_size(pending_list);
+    for (int i = 0; i < n_items; i++) {
+        void* item = arraylist_get(pending_list, i);
+        if (NULL != item) {
+            pending_extents_item* pei = (pending_extents_item*) item;
+            total_extents += pei->num_extents;
+        }
+    }
+
+    /* allocate array for all the extents and then copy the sub-arrays
+     * from the pending list */
+    extent_metadata* combined_extents = calloc((size_t)total_extents,
+                                               sizeof(extent_metadata));
+    if (NULL == combined_extents) {
+        LOGERR("failed to allocate for combined extents");
+        psf->ret = ENOMEM;
+        return;
+    }
+    unsigned int n_copied = 0;
+    for (int i = 0; i < n_items; i++) {
+        void* item = arraylist_get(pending_list, i);
+        if (NULL != item) {
+            pending_extents_item* pei = (pending_extents_item*) item;
+            memcpy(combined_extents + n_copied, pei->extents,
+                   pei->num_extents * sizeof(extent_metadata));
+            n_copied += pei->num_extents;
+            free(pei->extents);
+            pei->extents = NULL;
+        }
+    }
+    psf->num_extents = total_extents;
+    psf->extents = combined_extents;
+
+    /* add the combined list to local inode */
+    psf->ret = unifyfs_inode_add_extents(gfid, total_extents,
+                                         combined_extents);
+}
+
+/* complete the client sync requests of a file's pending items, which
+ * responds to a client after its last file is processed */
+static void complete_pending_sync_file(pending_sync_file* psf)
+{
+    arraylist_t* pending_list = psf->pending_list;
+    if (NULL != pending_list) {
         int n_items = arraylist_size(pending_list);
         for (int i = 0; i < n_items; i++) {
             void* item = arraylist_get(pending_list, i);
             if (NULL != item) {
                 pending_extents_item* pei = (pending_extents_item*) item;
-                total_extents += pei->num_extents;
-            }
-        }
-
-        /* allocate array for all the extents and then copy the sub-arrays
-         * from the pending list */
-        extent_metadata* combined_extents = calloc((size_t)total_extents,
-                                                   sizeof(extent_metadata));
-        if (NULL == combined_extents) {
-            LOGERR("failed to allocate for combined extents");
-            ret = ENOMEM;
-        } else {
-            unsigned int n_copied = 0;
-            for (int i = 0; i < n_items; i++) {
-                void* item = arraylist_get(pending_list, i);
-                if (NULL != item) {
-                    pending_extents_item* pei = (pending_extents_item*) item;
-                    memcpy(combined_extents + n_copied, pei->extents,
-                           pei->num_extents * sizeof(extent_metadata));
-                    n_copied += pei->num_extents;
+                if (NULL != pei->extents) {
                     free(pei->extents);
                 }
+                sm_complete_pending_sync(pei->sync_req, 1, psf->ret);
             }
+        }
 
-            /* add the combined list to local inode */
-            ret = unifyfs_inode_add_extents(gfid, total_extents,
-                                            combined_extents);
+        /* this frees the list and each of the items */
+        arraylist_free(pending_list);
+        psf->pending_list = NULL;
+    }
+    free(psf->extents);
+    psf->extents = NULL;
+}
 
-            if ((ret == UNIFYFS_SUCCESS) && !is_owner) {
-                /* send the combined list to the owner */
-                ret = unifyfs_invoke_add_extents_rpc(gfid, total_extents,
-                                                     combined_extents);
+/* Forward the extents of files owned by other servers, using one
+ * add_extents rpc per owner for all of its files */
+static void forward_pending_sync_files(int num_files,
+                                       pending_sync_file* files)
+{
+    add_extents_file* owner_files = calloc((size_t)num_files,
+                                           sizeof(add_extents_file));
+    extent_metadata** owner_extents = calloc((size_t)num_files,
+                                             sizeof(extent_metadata*));
+    int* owner_ndx = calloc((size_t)num_files, sizeof(int));
+    int* sent = calloc((size_t)num_files, sizeof(int));
+    if ((NULL == owner_files) || (NULL == owner_extents) ||
+        (NULL == owner_ndx) || (NULL == sent)) {
+        LOGERR("failed to allocate for forwarding pending extents");
+        for (int i = 0; i < num_files; i++) {
+            pending_sync_file* psf = files + i;
+            if ((psf->owner_rank != glb_pmi_rank) &&
+                (psf->ret == UNIFYFS_SUCCESS)) {
+                psf->ret = ENOMEM;
             }
         }
+        free(owner_files);
+        free(owner_extents);
+        free(owner_ndx);
+        free(sent);
+        return;
+    }
+
+    for (int i = 0; i < num_files; i++) {
+        pending_sync_file* psf = files + i;
+        if (sent[i] || (psf->owner_rank == glb_pmi_rank) ||
+            (psf->ret != UNIFYFS_SUCCESS) || (0 == psf->num_extents)) {
+            continue;
+        }
 
-        /* iterate through pending list to send responses to client reqs */
-        for (int i = 0; i < n_items; i++) {
-            void* item = arraylist_get(pending_list, i);
-            if (NULL != item) {
-                pending_extents_item* pei = (pending_extents_item*) item;
-                client_rpc_req_t* creq = pei->client_req;
-
-                /* send rpc response to requesting client */
-                unifyfs_fsync_out_t out;
-                out.ret = (int32_t) ret;
-                hg_return_t hret = margo_respond(creq->handle, &out);
-                if (hret != HG_SUCCESS) {
-                    LOGERR("margo_respond() failed");
-                }
+        /* gather this and the later files of the same owner */
+        int owner = psf->owner_rank;
+        int n_owner = 0;
+        for (int j = i; j < num_files; j++) {
+            pending_sync_file* f = files + j;
+            if (!sent[j] && (f->owner_rank == owner) &&
+                (f->ret == UNIFYFS_SUCCESS) && (f->num_extents > 0)) {
+                owner_files[n_owner].gfid = f->gfid;
+                owner_files[n_owner].num_extents = f->num_extents;
+                owner_extents[n_owner] = f->extents;
+                owner_ndx[n_owner] = j;
+                n_owner++;
+                sent[j] = 1;
+            }
+        }
 
-                /* cleanup req */
-                margo_destroy(creq->handle);
-                free(creq);
+        int rc = unifyfs_invoke_add_extents_rpc(owner, n_owner,
+                                                owner_files, owner_extents);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("add_extents for %d files to server[%d] failed - rc=%d",
+                   n_owner, owner, rc);
+            for (int k = 0; k < n_owner; k++) {
+                files[owner_ndx[k]].ret = rc;
             }
         }
+    }
 
-        /* this frees the list and each of the items */
-        arraylist_free(pending_list);
-    } else if (rc != UNIFYFS_SUCCESS) {
-        ret = rc;
-        LOGERR("failed to get pending extents list for gfid=%d- rc=%d",
-               gfid, ret);
+    free(owner_files);
+    free(owner_extents);
+    free(owner_ndx);
+    free(sent);
+}
+
+static int process_pending_sync(server_rpc_req_t* req)
+{
+    int ret = UNIFYFS_SUCCESS;
+
+    /* get target files */
+    pending_sync_input* psi = req->input;
+    assert(psi != NULL);
+
+    bool has_pending = false;
+    for (int i = 0; i < psi->num_gfids; i++) {
+        if (unifyfs_inode_has_pending_extents(psi->gfids[i])) {
+            has_pending = true;
+            break;
+        }
+    }
+    if (has_pending) {
+        usleep(50000); /* sleep 50 ms to catch more pending extents */
+    }
+
+    pending_sync_file* files = calloc((size_t)psi->num_gfids,
+                                      sizeof(pending_sync_file));
+    if (NULL == files) {
+        /* fall back to processing one file at a time */
+        LOGERR("failed to allocate for pending sync files");
+        for (int i = 0; i < psi->num_gfids; i++) {
+            pending_sync_file psf = { .gfid = psi->gfids[i] };
+            gather_pending_sync_file(&psf);
+            forward_pending_sync_files(1, &psf);
+            if (psf.ret != UNIFYFS_SUCCESS) {
+                ret = psf.ret;
+            }
+            complete_pending_sync_file(&psf);
+        }
+    } else {
+        /* add the extents of all files locally, then send them to their
+         * owners with one rpc per owner, before responding to clients */
+        for (int i = 0; i < psi->num_gfids; i++) {
+            files[i].gfid = psi->gfids[i];
+            gather_pending_sync_file(files + i);
+        }
+        forward_pending_sync_files(psi->num_gfids, files);
+        for (int i = 0; i < psi->num_gfids; i++) {
+            if (files[i].ret != UNIFYFS_SUCCESS) {
+                ret = files[i].ret;
+            }
+            complete_pending_sync_file(files + i);
+        }
+        free(files);
     }
 
+    free(psi->gfids);
+    free(psi);
+
     return ret;
 }
 
@@ -1541,6 +1978,37 @@ static int process_service_requests(void)
     /* release lock on sm requests */
     SM_REQ_UNLOCK();
 
+    if ((server_read_coalesce_usec > 0) && num_svc_reqs) {
+        /* if there are chunk reads, wait briefly to gather more
+         * requests so their log reads can be coalesced */
+        int have_chunk_reads = 0;
+        for (int i = 0; i < num_svc_reqs; i++) {
+            server_rpc_req_t* req = (server_rpc_req_t*)
+                arraylist_get(svc_reqs, i);
+            if (req->req_type == UNIFYFS_SERVER_RPC_CHUNK_READ) {
+                have_chunk_reads = 1;
+                break;
+            }
+        }
+        if (have_chunk_reads) {
+            usleep(server_read_coalesce_usec);
+
+            /* move newly arrived requests to the end of our list */
+            SM_REQ_LOCK();
+            int num_new = arraylist_size(sm->svc_reqs);
+            for (int i = 0; i < num_new; i++) {
+                void* req = arraylist_remove(sm->svc_reqs, i);
+                if (NULL != req) {
+                    arraylist_add(svc_reqs, req);
+                }
+            }
+            arraylist_reset(sm->svc_reqs);
+            SM_REQ_UNLOCK();
+            num_svc_reqs = arraylist_size(svc_reqs);
+        }
+    }
+    unifyfs_stats_add(UNIFYFS_STAT_SERVER_SM_QUEUE, -num_svc_reqs);
+
     /* iterate over each client request */
     for (int i = 0; i < num_svc_reqs; i++) {
         /* process next request */
@@ -1548,9 +2016,34 @@ static int process_service_requests(void)
         server_rpc_req_t* req = (server_rpc_req_t*)
             arraylist_get(svc_reqs, i);
         switch (req->req_type) {
-        case UNIFYFS_SERVER_RPC_CHUNK_READ:
-            rret = process_chunk_read_rpc(req);
+        case UNIFYFS_SERVER_RPC_CHUNK_READ: {
+            /* process consecutive chunk reads together */
+            int n_reads = 1;
+            while ((i + n_reads) < num_svc_reqs) {
+                server_rpc_req_t* next = (server_rpc_req_t*)
+                    arraylist_get(svc_reqs, i + n_reads);
+                if (next->req_type != UNIFYFS_SERVER_RPC_CHUNK_READ) {
+                    break;
+                }
+                n_reads++;
+            }
+            server_rpc_req_t** run = (server_rpc_req_t**)
+                calloc(n_reads, sizeof(server_rpc_req_t*));
+            if (NULL == run) {
+                /* process just this one */
+                n_reads = 1;
+                rret = process_chunk_read_rpcs(&req, 1);
+            } else {
+                for (int j = 0; j < n_reads; j++) {
+                    run[j] = (server_rpc_req_t*)
+                        arraylist_get(svc_reqs, i + j);
+                }
+                rret = process_chunk_read_rpcs(run, n_reads);
+                free(run);
+            }
+            i += n_reads - 1;
             break;
+        }
         case UNIFYFS_SERVER_RPC_EXTENTS_ADD:
             rret = process_add_extents_rpc(req);
             break;
@@ -1563,12 +2056,18 @@ static int process_service_requests(void)
         case UNIFYFS_SERVER_RPC_LAMINATE:
             rret = process_laminate_rpc(req);
             break;
+        case UNIFYFS_SERVER_RPC_LIST_FILES:
+            rret = process_list_files_rpc(req);
+            break;
         case UNIFYFS_SERVER_RPC_METAGET:
             rret = process_metaget_rpc(req);
             break;
         case UNIFYFS_SERVER_RPC_METASET:
             rret = process_metaset_rpc(req);
             break;
+        case UNIFYFS_SERVER_RPC_READDIR:
+            rret = process_readdir_rpc(req);
+            break;
         case UNIFYFS_SERVER_RPC_TRANSFER:
             rret = process_transfer_rpc(req);
             break;
@@ -31,6 +31,7 @@
 #define UNIFYFS_SERVICE_MANAGER_H
 
 #include "unifyfs_global.h"
+#include "unifyfs_inode.h"
 #include "unifyfs_transfer.h"
 
 
@@ -52,12 +53,50 @@ int svcmgr_fini(void);
  */
 int sm_submit_service_request(server_rpc_req_t* req);
 
+/* input for UNIFYFS_SERVER_PENDING_SYNC requests, the list of files
+ * that have pending extents from a client sync */
+typedef struct pending_sync_input {
+    int num_gfids; /* number of files in gfids */
+    int* gfids;    /* array of global file ids */
+} pending_sync_input;
+
+/**
+ * @brief mark files of a client sync request as processed. Once all files
+ * have been processed, the client is sent a response and the request
+ * is freed.
+ *
+ * @param sync_req  the client sync request
+ * @param num_done  number of files processed
+ * @param ret       result of processing those files
+ */
+void sm_complete_pending_sync(pending_sync_req* sync_req,
+                              int num_done,
+                              int ret);
+
 /* submit a transfer request to the service manager thread */
 int sm_submit_transfer_request(transfer_thread_args* tta);
 
 /* tell service manager thread transfer has completed */
 int sm_complete_transfer_request(transfer_thread_args* tta);
 
+/* a request for chunk reads from a server's request manager */
+typedef struct {
+    int src_rank;               /* source server rank */
+    int src_app_id;             /* app id at source server */
+    int src_client_id;          /* client id at source server */
+    int src_req_id;             /* request id at source server */
+    int num_chks;               /* number of chunk requests */
+    size_t total_data_sz;       /* total data size of chunk requests */
+    char* msg_buf;              /* buffer of chunk_read_req_t requests */
+    server_chunk_reads_t* scr;  /* responses (set by issue) */
+    int ret;                    /* result (set by issue) */
+} sm_chunk_read_req;
+
+/* issue the chunk reads of many requests together, merging reads of
+ * adjacent client log data across requests */
+int sm_issue_chunk_read_batch(int n_creqs,
+                              sm_chunk_read_req* creqs);
+
 /* decode and issue chunk reads contained in message buffer */
 int sm_issue_chunk_reads(int src_rank,
                          int src_app_id,
@@ -78,6 +117,13 @@ int sm_set_fileattr(int gfid,
                     int file_op,
                     unifyfs_file_attr_t* attrs);
 
+int sm_readdir(int gfid,
+               int start_gfid,
+               unsigned int max_entries,
+               unifyfs_dirent_t* entries,
+               unsigned int* num_entries,
+               int* end_of_dir);
+
 int sm_add_extents(int gfid,
                    size_t num_extents,
                    extent_metadata* extents);
@@ -24,11 +24,6 @@
 #define UNIFYFS_TRANSFER_MAX_WRITE (16 * 1048576) // 16 MiB
 #endif
 
-/* maximum memory allocation for temporary transfer data copies */
-#ifndef UNIFYFS_TRANSFER_MAX_BUFFER
-#define UNIFYFS_TRANSFER_MAX_BUFFER (512 * 1048576) // 512 MiB
-#endif
-
 typedef struct transfer_chunk {
     char*  chunk_data;
     size_t chunk_sz;
@@ -65,44 +60,49 @@ static int write_transfer_chunk(int fd,
     return UNIFYFS_SUCCESS;
 }
 
-static int read_local_extent(extent_metadata* ext,
-                             transfer_chunk* chk)
+/* read data for the given local extents into their transfer chunks,
+ * batching the reads from each client log */
+static int read_local_extents(extent_metadata* exts,
+                              transfer_chunk* chks,
+                              size_t n_exts)
 {
-    int ret = UNIFYFS_SUCCESS;
-
-    char* buf = chk->chunk_data;
-    chk->chunk_sz = extent_length(ext);
-    chk->file_offset = extent_offset(ext);
-
-    /* read data from client log */
-    app_client* app_clnt = NULL;
-    int app_id = ext->app_id;
-    int cli_id = ext->cli_id;
-    off_t log_offset = (off_t) ext->log_pos;
-    app_clnt = get_app_client(app_id, cli_id);
-    if (NULL != app_clnt) {
-        logio_context* logio_ctx = app_clnt->state.logio_ctx;
-        if (NULL != logio_ctx) {
-            LOGDBG("reading extent(file_offset=%zu, sz=%zu) from log[%d:%d]",
-                   (size_t)chk->file_offset, chk->chunk_sz, app_id, cli_id);
-
-            size_t nread = 0;
-            int rc = unifyfs_logio_read(logio_ctx, log_offset, chk->chunk_sz,
-                                        buf, &nread);
-            if (rc != UNIFYFS_SUCCESS) {
-                ret = rc;
-            }
-        } else {
-            LOGERR("app client [%d:%d] has NULL logio context",
-                   app_id, cli_id);
-            ret = EINVAL;
+    app_client_log_read* log_reads = (app_client_log_read*)
+        calloc(n_exts, sizeof(app_client_log_read));
+    if (NULL == log_reads) {
+        LOGERR("failed to allocate extent log reads");
+        return ENOMEM;
+    }
+    int n_log_reads = 0;
+
+    for (size_t i = 0; i < n_exts; i++) {
+        extent_metadata* ext = exts + i;
+        transfer_chunk* chk = chks + i;
+        chk->chunk_sz = extent_length(ext);
+        chk->file_offset = extent_offset(ext);
+
+        if (extent_is_hole(ext)) {
+            /* hole extents have no log data, fill with zeros */
+            memset(chk->chunk_data, 0, chk->chunk_sz);
+            continue;
         }
-    } else {
-        LOGERR("failed to get application client [%d:%d] state",
-               app_id, cli_id);
-        ret = EINVAL;
+
+        LOGDBG("reading extent(file_offset=%zu, sz=%zu) from log[%d:%d]",
+               (size_t)chk->file_offset, chk->chunk_sz,
+               ext->app_id, ext->cli_id);
+
+        app_client_log_read* lr = log_reads + n_log_reads;
+        n_log_reads++;
+        lr->app_id         = ext->app_id;
+        lr->client_id      = ext->cli_id;
+        lr->ndx            = (int) i;
+        lr->iov.log_offset = (off_t) ext->log_pos;
+        lr->iov.nbytes     = chk->chunk_sz;
+        lr->iov.buf        = chk->chunk_data;
     }
 
+    int ret = read_app_client_logs(n_log_reads, log_reads);
+    free(log_reads);
+
     return ret;
 }
 
@@ -236,7 +236,7 @@ void* transfer_helper_thread(void* arg)
         }
 
         /* allocate copy buffer for chunk data */
-        size_t max_buffer = UNIFYFS_TRANSFER_MAX_BUFFER;
+        size_t max_buffer = server_transfer_buffer;
         size_t buf_sz = max_buffer;
         if (total_local_data_sz <= max_buffer) {
             buf_sz = total_local_data_sz;
@@ -263,6 +263,7 @@ void* transfer_helper_thread(void* arg)
         size_t chk_ndx = 0; /* tracks chunk array index */
         do {
             size_t begin_chk_ndx = chk_ndx;
+            size_t begin_ext_ndx = ext_ndx;
             size_t copy_sz = 0;
             for (size_t i = ext_ndx; i < n_extents; i++) {
                 ext = tta->local_extents + i;
@@ -274,20 +275,23 @@ void* transfer_helper_thread(void* arg)
 
                     chk->chunk_data = data_copy_buf + copy_sz;
                     copy_sz += ext_sz;
-
-                    rc = read_local_extent(ext, chk);
-                    if (rc != UNIFYFS_SUCCESS) {
-                        LOGERR("failed to copy extent[%zu] data for gfid=%d",
-                               i, tta->gfid);
-                        ret = rc;
-                        goto transfer_cleanup;
-                    }
                 } else {
                     /* no room left in copy buffer */
                     break;
                 }
             }
 
+            /* read data for all extents that fit in the copy buffer */
+            rc = read_local_extents(tta->local_extents + begin_ext_ndx,
+                                    chunks + begin_chk_ndx,
+                                    chk_ndx - begin_chk_ndx);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("failed to copy extents[%zu-%zu] data for gfid=%d",
+                       begin_ext_ndx, ext_ndx - 1, tta->gfid);
+                ret = rc;
+                goto transfer_cleanup;
+            }
+
             /* write out data chunks for extents processed in this iteration */
             for (size_t i = begin_chk_ndx; i < chk_ndx; i++) {
                 chk = chunks + i;
@@ -228,6 +228,83 @@ int api_get_gfids_and_metadata_test(char* unifyfs_root,
 
     //-------------
 
+    diag("Starting API list_files tests");
+
+    /* list files under the mountpoint one at a time, so the cursor
+     * is used to page through the listing */
+    unifyfs_file_filter filter;
+    filter.path_prefix = unifyfs_root;
+    filter.owner_rank = -1;
+    filter.laminated = -1;
+
+    unifyfs_list_cursor cursor = UNIFYFS_LIST_CURSOR_START;
+    int num_found = 0;
+    int num_listed = 0;
+    int num_calls = 0;
+    rc = UNIFYFS_SUCCESS;
+    while ((UNIFYFS_LIST_CURSOR_END != cursor) && (num_calls < 100000)) {
+        unifyfs_server_file_meta fmeta;
+        size_t num_files = 0;
+        rc = unifyfs_list_files(*fshdl, &filter, &cursor, 1,
+                                &fmeta, &num_files);
+        num_calls++;
+        if (rc != UNIFYFS_SUCCESS) {
+            break;
+        }
+        if (1 == num_files) {
+            num_listed++;
+            for (unsigned int j = 0; j < NUM_TEST_FILES; j++) {
+                if ((fmeta.gfid == tf_gfids[j]) &&
+                    (0 == strcmp(fmeta.filename, testfiles[j])) &&
+                    (fmeta.size == filesize)) {
+                    num_found++;
+                }
+            }
+            free(fmeta.filename);
+        }
+    }
+    if (!ok((rc == UNIFYFS_SUCCESS) && (UNIFYFS_LIST_CURSOR_END == cursor),
+            "%s:%d unifyfs_list_files() listing completes",
+            __FILE__, __LINE__)) {
+        diag("unifyfs_list_files() failed: rc=%d (%s)",
+             rc, unifyfs_rc_enum_description(rc));
+    }
+    if (!ok(num_found == NUM_TEST_FILES,
+            "%s:%d unifyfs_list_files() lists all test files",
+            __FILE__, __LINE__)) {
+        diag("found %d of %d test files in %d listed files",
+             num_found, NUM_TEST_FILES, num_listed);
+    }
+
+    /* none of the test files are laminated */
+    filter.laminated = 1;
+    cursor = UNIFYFS_LIST_CURSOR_START;
+    num_found = 0;
+    while (UNIFYFS_LIST_CURSOR_END != cursor) {
+        unifyfs_server_file_meta flist[16];
+        size_t num_files = 0;
+        rc = unifyfs_list_files(*fshdl, &filter, &cursor, 16,
+                                flist, &num_files);
+        if (rc != UNIFYFS_SUCCESS) {
+            break;
+        }
+        for (size_t i = 0; i < num_files; i++) {
+            for (unsigned int j = 0; j < NUM_TEST_FILES; j++) {
+                if (flist[i].gfid == tf_gfids[j]) {
+                    num_found++;
+                }
+            }
+            free(flist[i].filename);
+        }
+    }
+    ok((rc == UNIFYFS_SUCCESS) && (0 == num_found),
+       "%s:%d unifyfs_list_files() filters laminated files (found=%d)",
+       __FILE__, __LINE__, num_found);
+
+    diag("Finished API list_files tests");
+
+    //-------------
+
     diag("Removing test files");
 
     for (unsigned int i = 0; i < NUM_TEST_FILES; i++) {
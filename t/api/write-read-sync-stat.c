@@ -356,6 +356,44 @@ int api_write_read_sync_stat_test(char* unifyfs_root,
                "%s:%d read(%s, offset=%zu, sz=%zu) data check is successful",
                __FILE__, __LINE__, testfile3, (size_t)off, bytes);
         }
+
+        /* (8) rewrite testfile1 and cancel the requests right away. each
+         * request is either canceled, or runs to completion if the
+         * progress engine had already started it */
+        unifyfs_io_request t1_rewrites[n_chks];
+        for (size_t i = 0; i < n_chks; i++) {
+            t1_rewrites[i].op = UNIFYFS_IOREQ_OP_WRITE;
+            t1_rewrites[i].gfid = t1_gfid;
+            t1_rewrites[i].nbytes = chksize;
+            t1_rewrites[i].offset = (off_t)(i * chksize);
+            t1_rewrites[i].user_buf = databuf + (i * chksize);
+        }
+
+        rc = unifyfs_dispatch_io(*fshdl, n_chks, t1_rewrites);
+        ok(rc == UNIFYFS_SUCCESS,
+           "%s:%d unifyfs_dispatch_io(%s, OP_WRITE) is successful: rc=%d (%s)",
+           __FILE__, __LINE__, testfile1, rc, unifyfs_rc_enum_description(rc));
+
+        rc = unifyfs_cancel_io(*fshdl, n_chks, t1_rewrites);
+        ok(rc == UNIFYFS_SUCCESS,
+           "%s:%d unifyfs_cancel_io(%s) is successful: rc=%d (%s)",
+           __FILE__, __LINE__, testfile1, rc, unifyfs_rc_enum_description(rc));
+
+        rc = unifyfs_wait_io(*fshdl, n_chks, t1_rewrites, 1);
+        ok(rc == UNIFYFS_SUCCESS,
+           "%s:%d unifyfs_wait_io(%s, OP_WRITE) is successful: rc=%d (%s)",
+           __FILE__, __LINE__, testfile1, rc, unifyfs_rc_enum_description(rc));
+
+        for (size_t i = 0; i < n_chks; i++) {
+            unifyfs_req_state state = t1_rewrites[i].state;
+            int err = t1_rewrites[i].result.error;
+            ok(((state == UNIFYFS_REQ_STATE_CANCELED) && (err == ECANCELED)) ||
+               ((state == UNIFYFS_REQ_STATE_COMPLETED) && (err == 0)),
+               "%s:%d write(%s, offset=%zu) was canceled or completed:"
+               " state=%d, rc=%d (%s)", __FILE__, __LINE__, testfile1,
+               (size_t)t1_rewrites[i].offset, (int)state, err,
+               unifyfs_rc_enum_description(err));
+        }
     }
 
     diag("Finished API write/read/truncate/sync/stat tests");
@@ -0,0 +1,167 @@
+#include "unifyfs_const.h"
+#include "unifyfs_log.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+#define NUM_THREADS 4
+#define NUM_MSGS 2000
+
+static void* log_thread(void* arg)
+{
+    int id = (int)(long) arg;
+    for (int i = 0; i < NUM_MSGS; i++) {
+        LOGDBG("thread %d msg %d", id, i);
+    }
+    return NULL;
+}
+
+/* log messages from several threads, and wait for them to exit */
+static void run_threads(void)
+{
+    pthread_t threads[NUM_THREADS];
+    for (long t = 0; t < NUM_THREADS; t++) {
+        pthread_create(&threads[t], NULL, log_thread, (void*) t);
+    }
+    for (int t = 0; t < NUM_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+}
+
+/* return number of problems found in a text log written by
+ * run_threads(): every message present once and in order per thread */
+static int check_text_log(const char* path, int* nmsgs)
+{
+    FILE* fp = fopen(path, "r");
+    if (NULL == fp) {
+        return -1;
+    }
+
+    int next[NUM_THREADS] = {0};
+    int bad = 0;
+    char line[1024];
+    *nmsgs = 0;
+    while (NULL != fgets(line, sizeof(line), fp)) {
+        int t, i;
+        char* msg = strstr(line, "] thread ");
+        if ((NULL == msg) ||
+            (sscanf(msg, "] thread %d msg %d", &t, &i) != 2)) {
+            continue;
+        }
+        if ((NULL == strstr(line, "@ log_thread() [")) ||
+            (NULL == strstr(line, "log_async_test.c:"))) {
+            bad++;
+        }
+        if ((t < 0) || (t >= NUM_THREADS) || (i != next[t])) {
+            bad++;
+        } else {
+            next[t]++;
+        }
+        (*nmsgs)++;
+    }
+    fclose(fp);
+    return bad;
+}
+
+int main(int argc, char** argv)
+{
+    char text_log[256];
+    char bin_log[256];
+    char dec_log[256];
+    char* tmpdir = getenv("TMPDIR");
+    if (NULL == tmpdir) {
+        tmpdir = "/tmp";
+    }
+    snprintf(text_log, sizeof(text_log), "%s/log_async.%d.txt",
+             tmpdir, (int) getpid());
+    snprintf(bin_log, sizeof(bin_log), "%s/log_async.%d.bin",
+             tmpdir, (int) getpid());
+    snprintf(dec_log, sizeof(dec_log), "%s/log_async.%d.dec",
+             tmpdir, (int) getpid());
+
+    plan(NO_PLAN);
+
+    unifyfs_set_log_level(LOG_DBG);
+
+    /* text format */
+    int rc = unifyfs_log_open(text_log);
+    ok(rc == UNIFYFS_SUCCESS, "open text log (rc=%d)", rc);
+    rc = unifyfs_log_async_start(0);
+    ok((rc == UNIFYFS_SUCCESS) && unifyfs_log_async,
+       "start async text logging (rc=%d)", rc);
+
+    LOGDBG("flush test");
+    unifyfs_log_flush();
+    FILE* fp = fopen(text_log, "r");
+    char line[1024] = {0};
+    ok((NULL != fp) && (NULL != fgets(line, sizeof(line), fp)) &&
+       (NULL != strstr(line, "flush test")),
+       "message written after flush");
+    if (NULL != fp) {
+        fclose(fp);
+    }
+
+    run_threads();
+    rc = unifyfs_log_close();
+    ok((rc == UNIFYFS_SUCCESS) && !unifyfs_log_async,
+       "close stops async logging (rc=%d)", rc);
+
+    int nmsgs = 0;
+    int bad = check_text_log(text_log, &nmsgs);
+    ok((bad == 0) && (nmsgs == (NUM_THREADS * NUM_MSGS)),
+       "text log has %d of %d messages in order (%d bad)",
+       nmsgs, NUM_THREADS * NUM_MSGS, bad);
+
+    /* binary format, new threads reuse the rings of exited threads */
+    rc = unifyfs_log_open(bin_log);
+    ok(rc == UNIFYFS_SUCCESS, "open binary log (rc=%d)", rc);
+    LOGDBG("text before binary log");
+    rc = unifyfs_log_async_start(1);
+    ok(rc == UNIFYFS_SUCCESS, "start async binary logging (rc=%d)", rc);
+    run_threads();
+    unifyfs_log_close();
+
+    FILE* in = fopen(bin_log, "r");
+    FILE* out = fopen(dec_log, "w");
+    rc = EINVAL;
+    if ((NULL != in) && (NULL != out)) {
+        rc = unifyfs_log_decode(in, out);
+    }
+    if (NULL != in) {
+        fclose(in);
+    }
+    if (NULL != out) {
+        fclose(out);
+    }
+    ok(rc == UNIFYFS_SUCCESS, "decode binary log (rc=%d)", rc);
+
+    fp = fopen(dec_log, "r");
+    memset(line, 0, sizeof(line));
+    ok((NULL != fp) && (NULL != fgets(line, sizeof(line), fp)) &&
+       (NULL != strstr(line, "text before binary log")),
+       "text preceding binary log is kept");
+    if (NULL != fp) {
+        fclose(fp);
+    }
+
+    bad = check_text_log(dec_log, &nmsgs);
+    ok((bad == 0) && (nmsgs == (NUM_THREADS * NUM_MSGS)),
+       "decoded log has %d of %d messages in order (%d bad)",
+       nmsgs, NUM_THREADS * NUM_MSGS, bad);
+
+    /* messages are written directly once async logging stops */
+    LOGDBG("after stop");
+    ok(!unifyfs_log_async, "async logging stays off after close");
+
+    unlink(text_log);
+    unlink(bin_log);
+    unlink(dec_log);
+
+    done_testing();
+}
@@ -0,0 +1,279 @@
+#include "lz_block.h"
+#include "unifyfs_configurator.h"
+#include "unifyfs_logio.h"
+#include "unifyfs_rc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+#define CHUNK_SZ (64 * 1024)
+#define SPILL_SZ (1024 * 1024)
+#define MAX_ALLOCS 64
+
+/* fill buffer with a compressible pattern unique to the allocation */
+static void fill_chunk(char* buf, size_t len, int n)
+{
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (char)((n * 31) + (i % 251));
+    }
+}
+
+/* fill buffer with data that does not compress */
+static void fill_random(char* buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (char) rand();
+    }
+}
+
+static int codec_tests(void)
+{
+    size_t len = 3 * CHUNK_SZ;
+    char* src = malloc(len);
+    char* comp = malloc(LZ_BLOCK_BOUND(len));
+    char* out = malloc(len);
+
+    fill_chunk(src, len, 1);
+    size_t clen = lz_block_compress(src, len, comp, LZ_BLOCK_BOUND(len));
+    ssize_t dlen = lz_block_decompress(comp, clen, out, len);
+    ok((clen > 0) && (clen < (len / 4)) && (dlen == (ssize_t)len) &&
+       (memcmp(src, out, len) == 0),
+       "compressible block round trip (%zu -> %zu bytes)", len, clen);
+
+    memset(out, 0, len);
+    dlen = lz_block_decompress(comp, clen, out, 1000);
+    ok((dlen == 1000) && (memcmp(src, out, 1000) == 0),
+       "partial decompression of block prefix");
+
+    fill_random(src, len);
+    clen = lz_block_compress(src, len, comp, LZ_BLOCK_BOUND(len));
+    dlen = lz_block_decompress(comp, clen, out, len);
+    ok((clen > 0) && (dlen == (ssize_t)len) && (memcmp(src, out, len) == 0),
+       "incompressible block round trip (%zu -> %zu bytes)", len, clen);
+
+    ok(lz_block_compress(src, len, comp, len / 2) == 0,
+       "compression fails when output does not fit");
+
+    /* corrupt offsets must be detected, not followed */
+    fill_chunk(src, len, 2);
+    clen = lz_block_compress(src, len, comp, LZ_BLOCK_BOUND(len));
+    memset(comp + 1, 0xff, 64);
+    dlen = lz_block_decompress(comp, clen, out, len);
+    ok(dlen != (ssize_t)len || memcmp(src, out, len) != 0,
+       "corrupt block is not decompressed as the original");
+
+    free(src);
+    free(comp);
+    free(out);
+    return 0;
+}
+
+/* return number of allocations whose data does not match */
+static int check_chunks(logio_context* ctx, off_t* offs, char** data,
+                        int n_allocs)
+{
+    char* buf = malloc(CHUNK_SZ);
+    int bad = 0;
+    for (int i = 0; i < n_allocs; i++) {
+        size_t nread = 0;
+        memset(buf, 0, CHUNK_SZ);
+        int rc = unifyfs_logio_read(ctx, offs[i], CHUNK_SZ, buf, &nread);
+        if ((rc != UNIFYFS_SUCCESS) || (nread != CHUNK_SZ) ||
+            (memcmp(buf, data[i], CHUNK_SZ) != 0)) {
+            bad++;
+        }
+    }
+    free(buf);
+    return bad;
+}
+
+int main(int argc, char** argv)
+{
+    char* spill_dir = getenv("TMPDIR");
+    if (NULL == spill_dir) {
+        spill_dir = "/tmp";
+    }
+
+    plan(NO_PLAN);
+
+    codec_tests();
+
+    char chunk_str[32];
+    char spill_str[32];
+    snprintf(chunk_str, sizeof(chunk_str), "%d", CHUNK_SZ);
+    snprintf(spill_str, sizeof(spill_str), "%d", SPILL_SZ);
+    unifyfs_cfg_option options[] = {
+        { .opt_name = "logio.chunk_size",     .opt_value = chunk_str },
+        { .opt_name = "logio.shmem_size",     .opt_value = "0" },
+        { .opt_name = "logio.spill_size",     .opt_value = spill_str },
+        { .opt_name = "logio.spill_dir",      .opt_value = spill_dir },
+        { .opt_name = "logio.spill_compress", .opt_value = "on" }
+    };
+    int n_opts = (int)(sizeof(options) / sizeof(options[0]));
+
+    unifyfs_cfg_t cfg;
+    int rc = unifyfs_config_init(&cfg, 0, NULL, n_opts, options);
+    if (rc != 0) {
+        BAIL_OUT("failed to initialize configuration");
+    }
+
+    /* the client creates the log, the server attaches to it */
+    int app_id = (int) getpid();
+    logio_context* client = NULL;
+    rc = unifyfs_logio_init_client(app_id, 1, &cfg, &client);
+    ok(rc == UNIFYFS_SUCCESS, "client logio init (rc=%d)", rc);
+    if (rc != UNIFYFS_SUCCESS) {
+        BAIL_OUT("client logio init failed");
+    }
+    logio_context* server = NULL;
+    rc = unifyfs_logio_init(app_id, 1, 0, SPILL_SZ, spill_dir, &server);
+    ok(rc == UNIFYFS_SUCCESS, "server logio init (rc=%d)", rc);
+    if (rc != UNIFYFS_SUCCESS) {
+        BAIL_OUT("server logio init failed");
+    }
+
+    /* store three times the spill size of compressible data */
+    off_t offs[MAX_ALLOCS];
+    char* data[MAX_ALLOCS];
+    int n_allocs = 0;
+    int failed = 0;
+    for (int i = 0; i < 48; i++) {
+        size_t nwrite = 0;
+        data[i] = malloc(CHUNK_SZ);
+        fill_chunk(data[i], CHUNK_SZ, i);
+        rc = unifyfs_logio_alloc(client, CHUNK_SZ, offs + i);
+        if (rc == UNIFYFS_SUCCESS) {
+            rc = unifyfs_logio_write(client, offs[i], CHUNK_SZ,
+                                     data[i], &nwrite);
+        }
+        if ((rc != UNIFYFS_SUCCESS) || (nwrite != CHUNK_SZ)) {
+            failed++;
+        }
+        n_allocs++;
+    }
+    ok(failed == 0, "wrote %d chunks of %d bytes to %d byte spill",
+       n_allocs, CHUNK_SZ, SPILL_SZ);
+
+    logio_compress_stats stats;
+    unifyfs_logio_get_compress_stats(client, &stats);
+    ok((stats.data_bytes == ((size_t)n_allocs * CHUNK_SZ)) &&
+       (stats.stored_bytes < (stats.data_bytes / 4)) &&
+       (stats.used_bytes <= stats.space_bytes),
+       "compression stats (data=%zu, stored=%zu, used=%zu, space=%zu)",
+       stats.data_bytes, stats.stored_bytes, stats.used_bytes,
+       stats.space_bytes);
+
+    ok(check_chunks(client, offs, data, n_allocs) == 0,
+       "client reads compressed chunks");
+    ok(check_chunks(server, offs, data, n_allocs) == 0,
+       "server reads compressed chunks");
+
+    /* a partial read in the middle of a chunk */
+    char* buf = malloc(2 * CHUNK_SZ);
+    size_t nread = 0;
+    rc = unifyfs_logio_read(server, offs[5] + 1000, 5000, buf, &nread);
+    ok((rc == UNIFYFS_SUCCESS) && (nread == 5000) &&
+       (memcmp(buf, data[5] + 1000, 5000) == 0),
+       "partial chunk read");
+
+    /* a partial overwrite keeps the rest of the chunk */
+    size_t nwrite = 0;
+    memset(data[7] + 3000, 'x', 2000);
+    rc = unifyfs_logio_write(client, offs[7] + 3000, 2000,
+                             data[7] + 3000, &nwrite);
+    ok((rc == UNIFYFS_SUCCESS) && (nwrite == 2000) &&
+       (check_chunks(server, offs, data, n_allocs) == 0),
+       "partial chunk overwrite");
+
+    /* a two-chunk allocation written in one call */
+    off_t off2;
+    char* data2 = malloc(2 * CHUNK_SZ);
+    fill_chunk(data2, 2 * CHUNK_SZ, 99);
+    rc = unifyfs_logio_alloc(client, 2 * CHUNK_SZ, &off2);
+    if (rc == UNIFYFS_SUCCESS) {
+        rc = unifyfs_logio_write(client, off2, 2 * CHUNK_SZ, data2, &nwrite);
+    }
+    memset(buf, 0, 2 * CHUNK_SZ);
+    if (rc == UNIFYFS_SUCCESS) {
+        rc = unifyfs_logio_read(server, off2, 2 * CHUNK_SZ, buf, &nread);
+    }
+    ok((rc == UNIFYFS_SUCCESS) && (nread == (2 * CHUNK_SZ)) &&
+       (memcmp(buf, data2, 2 * CHUNK_SZ) == 0),
+       "write and read spanning two chunks");
+    unifyfs_logio_free(client, off2, 2 * CHUNK_SZ);
+
+    /* vectored reads of compressed chunks */
+    logio_iovec iov[MAX_ALLOCS];
+    char* vbuf = malloc((size_t)n_allocs * CHUNK_SZ);
+    for (int i = 0; i < n_allocs; i++) {
+        iov[i].log_offset = offs[i];
+        iov[i].nbytes = CHUNK_SZ;
+        iov[i].buf = vbuf + ((size_t)i * CHUNK_SZ);
+    }
+    rc = unifyfs_logio_readv(server, n_allocs, iov);
+    failed = 0;
+    for (int i = 0; i < n_allocs; i++) {
+        if ((iov[i].obytes != CHUNK_SZ) ||
+            (memcmp(iov[i].buf, data[i], CHUNK_SZ) != 0)) {
+            failed++;
+        }
+    }
+    ok((rc == UNIFYFS_SUCCESS) && (failed == 0),
+       "vectored read of compressed chunks (%d bad)", failed);
+
+    /* release everything */
+    failed = 0;
+    for (int i = 0; i < n_allocs; i++) {
+        rc = unifyfs_logio_free(client, offs[i], CHUNK_SZ);
+        if (rc != UNIFYFS_SUCCESS) {
+            failed++;
+        }
+        free(data[i]);
+    }
+    unifyfs_logio_get_compress_stats(client, &stats);
+    ok((failed == 0) && (stats.used_bytes == 0) &&
+       (stats.data_bytes == 0) && (stats.stored_bytes == 0),
+       "all chunks freed (used=%zu)", stats.used_bytes);
+
+    /* incompressible data is limited by the spill size */
+    n_allocs = 0;
+    failed = 0;
+    while (n_allocs < MAX_ALLOCS) {
+        off_t off;
+        rc = unifyfs_logio_alloc(client, CHUNK_SZ, &off);
+        if (rc != UNIFYFS_SUCCESS) {
+            break;
+        }
+        data[n_allocs] = malloc(CHUNK_SZ);
+        fill_random(data[n_allocs], CHUNK_SZ);
+        rc = unifyfs_logio_write(client, off, CHUNK_SZ,
+                                 data[n_allocs], &nwrite);
+        if (rc != UNIFYFS_SUCCESS) {
+            failed++;
+        }
+        offs[n_allocs++] = off;
+    }
+    ok((rc == ENOSPC) && (failed == 0) &&
+       (n_allocs == (int)(stats.space_bytes / CHUNK_SZ)),
+       "incompressible chunks fill the spill space (%d chunks)", n_allocs);
+    ok(check_chunks(server, offs, data, n_allocs) == 0,
+       "server reads incompressible chunks");
+    for (int i = 0; i < n_allocs; i++) {
+        unifyfs_logio_free(client, offs[i], CHUNK_SZ);
+        free(data[i]);
+    }
+
+    free(buf);
+    free(data2);
+    free(vbuf);
+    unifyfs_logio_close(server, 0);
+    unifyfs_logio_close(client, 1);
+    unifyfs_config_fini(&cfg);
+
+    done_testing();
+}
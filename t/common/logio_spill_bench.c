@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Benchmark for buffered versus O_DIRECT spillover writes.
+ *
+ * Usage: logio_spill_bench <spill_dir> [total_MiB] [write_KiB]
+ *
+ * For each spill mode, writes total_MiB of data to a spill-only log using
+ * writes of write_KiB, then syncs the log. Reports the write and sync
+ * bandwidth, and how much of the spill file remains in the page cache.
+ * The spill directory should be on the local storage device to measure.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "unifyfs_configurator.h"
+#include "unifyfs_logio.h"
+#include "unifyfs_rc.h"
+
+#define LOGIO_SPILL_FMTSTR "%s/logio_spill.%d.%d"
+
+static double now_secs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + ((double)tv.tv_usec / 1000000.0);
+}
+
+/* return number of bytes of the given file held in the page cache */
+static size_t cached_bytes(const char* path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        close(fd);
+        return 0;
+    }
+
+    size_t pgsz = (size_t) sysconf(_SC_PAGESIZE);
+    size_t len = (size_t) st.st_size;
+    size_t npages = (len + pgsz - 1) / pgsz;
+    size_t cached = 0;
+
+    void* addr = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    unsigned char* vec = malloc(npages);
+    if ((MAP_FAILED != addr) && (NULL != vec)) {
+        if (mincore(addr, len, vec) == 0) {
+            for (size_t i = 0; i < npages; i++) {
+                if (vec[i] & 1) {
+                    cached += pgsz;
+                }
+            }
+        }
+    }
+    free(vec);
+    if (MAP_FAILED != addr) {
+        munmap(addr, len);
+    }
+    close(fd);
+    return cached;
+}
+
+static int run_mode(const char* spill_dir,
+                    int client_id,
+                    int direct,
+                    size_t total_bytes,
+                    size_t write_bytes)
+{
+    char chunk_str[32];
+    char spill_str[32];
+    size_t align = UNIFYFS_LOGIO_DIRECT_ALIGN;
+    size_t chunk_sz = ((write_bytes + align - 1) / align) * align;
+    size_t n_writes = total_bytes / write_bytes;
+    snprintf(chunk_str, sizeof(chunk_str), "%zu", chunk_sz);
+    snprintf(spill_str, sizeof(spill_str), "%zu",
+             (n_writes * chunk_sz) + (64 * 1024 * 1024));
+
+    const char* direct_str = direct ? "on" : "off";
+    unifyfs_cfg_option options[] = {
+        { .opt_name = "logio.chunk_size",   .opt_value = chunk_str },
+        { .opt_name = "logio.shmem_size",   .opt_value = "0" },
+        { .opt_name = "logio.spill_size",   .opt_value = spill_str },
+        { .opt_name = "logio.spill_dir",    .opt_value = spill_dir },
+        { .opt_name = "logio.spill_direct", .opt_value = direct_str }
+    };
+    int n_opts = (int)(sizeof(options) / sizeof(options[0]));
+
+    unifyfs_cfg_t cfg;
+    int rc = unifyfs_config_init(&cfg, 0, NULL, n_opts, options);
+    if (rc != 0) {
+        fprintf(stderr, "failed to initialize configuration (rc=%d)\n", rc);
+        return rc;
+    }
+
+    logio_context* ctx = NULL;
+    rc = unifyfs_logio_init_client(getpid(), client_id, &cfg, &ctx);
+    if (rc != UNIFYFS_SUCCESS) {
+        fprintf(stderr, "failed to initialize logio (rc=%d)\n", rc);
+        unifyfs_config_fini(&cfg);
+        return rc;
+    }
+    if (direct && (NULL == ctx->spill_direct)) {
+        printf("O_DIRECT is not available in %s, skipping\n", spill_dir);
+        unifyfs_logio_close(ctx, 1);
+        unifyfs_config_fini(&cfg);
+        return 0;
+    }
+
+    char* buf = malloc(write_bytes);
+    if (NULL == buf) {
+        unifyfs_logio_close(ctx, 1);
+        unifyfs_config_fini(&cfg);
+        return ENOMEM;
+    }
+    memset(buf, 'A' + client_id, write_bytes);
+
+    double start = now_secs();
+    for (size_t i = 0; i < n_writes; i++) {
+        off_t log_off;
+        size_t nwrite;
+        rc = unifyfs_logio_alloc(ctx, write_bytes, &log_off);
+        if (rc == UNIFYFS_SUCCESS) {
+            rc = unifyfs_logio_write(ctx, log_off, write_bytes, buf, &nwrite);
+        }
+        if (rc != UNIFYFS_SUCCESS) {
+            fprintf(stderr, "log write %zu failed (rc=%d)\n", i, rc);
+            break;
+        }
+    }
+    double write_secs = now_secs() - start;
+
+    start = now_secs();
+    unifyfs_logio_sync(ctx);
+    double sync_secs = now_secs() - start;
+
+    char path[1024];
+    snprintf(path, sizeof(path), LOGIO_SPILL_FMTSTR,
+             spill_dir, getpid(), client_id);
+    size_t cached = cached_bytes(path);
+
+    double mib = (double)(n_writes * write_bytes) / (1024.0 * 1024.0);
+    printf("%-8s: write %.3f s (%.1f MiB/s), sync %.3f s, "
+           "write+sync %.1f MiB/s, page cache %.1f MiB\n",
+           direct ? "direct" : "buffered", write_secs, mib / write_secs,
+           sync_secs, mib / (write_secs + sync_secs),
+           (double)cached / (1024.0 * 1024.0));
+
+    free(buf);
+    unifyfs_logio_close(ctx, 1);
+    unifyfs_config_fini(&cfg);
+    return rc;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <spill_dir> [total_MiB] [write_KiB]\n",
+                argv[0]);
+        return 1;
+    }
+    const char* spill_dir = argv[1];
+
+    size_t total_mib = 1024;
+    if (argc > 2) {
+        total_mib = (size_t) atol(argv[2]);
+    }
+
+    size_t write_kib = 1024;
+    if (argc > 3) {
+        write_kib = (size_t) atol(argv[3]);
+    }
+
+    size_t total_bytes = total_mib * 1024 * 1024;
+    size_t write_bytes = write_kib * 1024;
+    if ((write_bytes == 0) || (total_bytes < write_bytes)) {
+        fprintf(stderr, "invalid total or write size\n");
+        return 1;
+    }
+
+    printf("spill dir %s: %zu MiB in %zu KiB writes\n",
+           spill_dir, total_mib, write_kib);
+
+    int rc = run_mode(spill_dir, 1, 0, total_bytes, write_bytes);
+    if (rc == 0) {
+        rc = run_mode(spill_dir, 2, 1, total_bytes, write_bytes);
+    }
+    return (rc == 0) ? 0 : 1;
+}
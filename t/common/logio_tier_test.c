@@ -0,0 +1,210 @@
+#include "unifyfs_configurator.h"
+#include "unifyfs_logio.h"
+#include "unifyfs_rc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+#define CHUNK_SZ (64 * 1024)
+#define MAX_ALLOCS 64
+
+/* fill buffer with a pattern unique to the allocation number */
+static void fill_chunk(char* buf, int n)
+{
+    for (size_t i = 0; i < CHUNK_SZ; i++) {
+        buf[i] = (char)((n * 31) + (i % 251));
+    }
+}
+
+/* return number of allocations whose data does not match the pattern */
+static int check_chunks(logio_context* ctx, off_t* offs, int n_allocs)
+{
+    char* expect = malloc(CHUNK_SZ);
+    char* buf = malloc(CHUNK_SZ);
+    int bad = 0;
+    for (int i = 0; i < n_allocs; i++) {
+        size_t nread = 0;
+        memset(buf, 0, CHUNK_SZ);
+        int rc = unifyfs_logio_read(ctx, offs[i], CHUNK_SZ, buf, &nread);
+        fill_chunk(expect, i);
+        if ((rc != UNIFYFS_SUCCESS) || (nread != CHUNK_SZ) ||
+            (memcmp(buf, expect, CHUNK_SZ) != 0)) {
+            bad++;
+        }
+    }
+    free(expect);
+    free(buf);
+    return bad;
+}
+
+int main(int argc, char** argv)
+{
+    char* spill_dir = getenv("TMPDIR");
+    if (NULL == spill_dir) {
+        spill_dir = "/tmp";
+    }
+
+    plan(NO_PLAN);
+
+    char chunk_str[32];
+    snprintf(chunk_str, sizeof(chunk_str), "%d", CHUNK_SZ);
+    unifyfs_cfg_option options[] = {
+        { .opt_name = "logio.chunk_size", .opt_value = chunk_str },
+        { .opt_name = "logio.shmem_size", .opt_value = "1048576" },
+        { .opt_name = "logio.spill_size", .opt_value = "4194304" },
+        { .opt_name = "logio.spill_dir",  .opt_value = spill_dir }
+    };
+    int n_opts = (int)(sizeof(options) / sizeof(options[0]));
+
+    unifyfs_cfg_t cfg;
+    int rc = unifyfs_config_init(&cfg, 0, NULL, n_opts, options);
+    if (rc != 0) {
+        BAIL_OUT("failed to initialize configuration");
+    }
+
+    /* the client creates the log, the server attaches to it */
+    int app_id = (int) getpid();
+    logio_context* client = NULL;
+    rc = unifyfs_logio_init_client(app_id, 1, &cfg, &client);
+    ok(rc == UNIFYFS_SUCCESS, "client logio init (rc=%d)", rc);
+    if (rc != UNIFYFS_SUCCESS) {
+        BAIL_OUT("client logio init failed");
+    }
+
+    off_t mem_size = 0;
+    off_t spill_size = 0;
+    unifyfs_logio_get_sizes(client, &mem_size, &spill_size);
+    logio_context* server = NULL;
+    rc = unifyfs_logio_init(app_id, 1, 1048576, 4194304, spill_dir, &server);
+    ok(rc == UNIFYFS_SUCCESS, "server logio init (rc=%d)", rc);
+    if (rc != UNIFYFS_SUCCESS) {
+        BAIL_OUT("server logio init failed");
+    }
+
+    /* fill the shmem chunks */
+    int n_mem = (int)(mem_size / CHUNK_SZ);
+    off_t offs[MAX_ALLOCS];
+    char* buf = malloc(CHUNK_SZ);
+    int n_allocs = 0;
+    int failed = 0;
+    for (int i = 0; i < n_mem; i++) {
+        size_t nwrite = 0;
+        fill_chunk(buf, n_allocs);
+        rc = unifyfs_logio_alloc(client, CHUNK_SZ, offs + n_allocs);
+        if (rc == UNIFYFS_SUCCESS) {
+            rc = unifyfs_logio_write(client, offs[n_allocs], CHUNK_SZ,
+                                     buf, &nwrite);
+        }
+        if ((rc != UNIFYFS_SUCCESS) || (offs[n_allocs] >= mem_size)) {
+            failed++;
+        }
+        n_allocs++;
+    }
+    ok(failed == 0, "filled %d shmem chunks", n_mem);
+
+    logio_tier_stats stats;
+    unifyfs_logio_get_tier_stats(client, &stats);
+    ok((stats.mem_chunks_used == (size_t)n_mem) &&
+       (stats.mem_chunks_total == (size_t)n_mem),
+       "all shmem chunks used (%zu of %zu)",
+       stats.mem_chunks_used, stats.mem_chunks_total);
+
+    /* nothing is cold yet */
+    size_t n_migrated = 0;
+    rc = unifyfs_logio_tier_migrate(server, 3600, 4, &n_migrated);
+    ok((rc == UNIFYFS_SUCCESS) && (n_migrated == 0),
+       "no chunks migrated before they are cold (n=%zu)", n_migrated);
+
+    /* read the first chunks so the later ones are the coldest */
+    sleep(1);
+    size_t nread;
+    for (int i = 0; i < 4; i++) {
+        unifyfs_logio_read(client, offs[i], CHUNK_SZ, buf, &nread);
+    }
+    rc = unifyfs_logio_tier_migrate(server, 1, 4, &n_migrated);
+    ok((rc == UNIFYFS_SUCCESS) && (n_migrated == 4),
+       "migrated cold shmem chunks (n=%zu)", n_migrated);
+    ok(check_chunks(client, offs, n_allocs) == 0,
+       "client reads migrated chunks");
+    ok(check_chunks(server, offs, n_allocs) == 0,
+       "server reads migrated chunks");
+
+    /* the next pass frees the vacated shmem chunks, which are then
+     * used for new allocations that are past the shmem log offsets */
+    rc = unifyfs_logio_tier_migrate(server, 3600, 4, &n_migrated);
+    unifyfs_logio_get_tier_stats(client, &stats);
+    ok(stats.mem_chunks_used == (size_t)(n_mem - 4),
+       "vacated shmem chunks freed (%zu used)", stats.mem_chunks_used);
+
+    size_t mem_writes = stats.mem_write_bytes;
+    failed = 0;
+    for (int i = 0; i < 4; i++) {
+        size_t nwrite = 0;
+        fill_chunk(buf, n_allocs);
+        rc = unifyfs_logio_alloc(client, CHUNK_SZ, offs + n_allocs);
+        if (rc == UNIFYFS_SUCCESS) {
+            rc = unifyfs_logio_write(client, offs[n_allocs], CHUNK_SZ,
+                                     buf, &nwrite);
+        }
+        if ((rc != UNIFYFS_SUCCESS) || (offs[n_allocs] < mem_size)) {
+            failed++;
+        }
+        n_allocs++;
+    }
+    unifyfs_logio_get_tier_stats(client, &stats);
+    ok((failed == 0) &&
+       ((stats.mem_write_bytes - mem_writes) == (4 * CHUNK_SZ)),
+       "new allocations stored in shmem (%zu bytes)",
+       stats.mem_write_bytes - mem_writes);
+    ok(check_chunks(server, offs, n_allocs) == 0,
+       "server reads all chunks");
+
+    /* vectored reads split ranges that span moved chunks */
+    logio_iovec iov[MAX_ALLOCS];
+    char* vbuf = malloc((size_t)n_allocs * CHUNK_SZ);
+    char* expect = malloc(CHUNK_SZ);
+    for (int i = 0; i < n_allocs; i++) {
+        iov[i].log_offset = offs[i];
+        iov[i].nbytes = CHUNK_SZ;
+        iov[i].buf = vbuf + ((size_t)i * CHUNK_SZ);
+    }
+    rc = unifyfs_logio_readv(server, n_allocs, iov);
+    failed = 0;
+    for (int i = 0; i < n_allocs; i++) {
+        fill_chunk(expect, i);
+        if ((iov[i].obytes != CHUNK_SZ) ||
+            (memcmp(iov[i].buf, expect, CHUNK_SZ) != 0)) {
+            failed++;
+        }
+    }
+    ok((rc == UNIFYFS_SUCCESS) && (failed == 0),
+       "vectored read of all chunks (%d bad)", failed);
+
+    /* release everything */
+    failed = 0;
+    for (int i = 0; i < n_allocs; i++) {
+        rc = unifyfs_logio_free(client, offs[i], CHUNK_SZ);
+        if (rc != UNIFYFS_SUCCESS) {
+            failed++;
+        }
+    }
+    unifyfs_logio_get_tier_stats(client, &stats);
+    ok((failed == 0) && (stats.mem_chunks_used == 0),
+       "all chunks freed (%zu shmem chunks used)", stats.mem_chunks_used);
+    ok(stats.migrated_chunks == 4, "migrated chunk count is %zu",
+       stats.migrated_chunks);
+
+    free(buf);
+    free(vbuf);
+    free(expect);
+    unifyfs_logio_close(server, 0);
+    unifyfs_logio_close(client, 1);
+    unifyfs_config_fini(&cfg);
+
+    done_testing();
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Benchmark for segment tree node allocation.
+ *
+ * Usage: seg_tree_bench [num_extents] [num_rounds] [seed]
+ *
+ * Each round adds num_extents extents to a segment tree, using a mix of
+ * appends and random overwrites that split existing segments, and then
+ * clears the tree. Also compares raw node pool alloc/free against
+ * calloc/free. Reports elapsed times and the peak resident set size.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include "node_pool.h"
+#include "seg_tree.h"
+
+static double now_secs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + ((double)tv.tv_usec / 1000000.0);
+}
+
+static long max_rss_kb(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+int main(int argc, char** argv)
+{
+    size_t num_extents = 4 * 1024 * 1024;
+    if (argc > 1) {
+        num_extents = (size_t) atol(argv[1]);
+    }
+
+    int num_rounds = 4;
+    if (argc > 2) {
+        num_rounds = atoi(argv[2]);
+    }
+
+    unsigned int seed = 12345678;
+    if (argc > 3) {
+        seed = (unsigned int) atoi(argv[3]);
+    }
+    srand(seed);
+
+    const unsigned long ext_size = 4096;
+    unsigned long file_size = num_extents * ext_size;
+
+    /* raw allocator comparison */
+    size_t node_sz = sizeof(struct seg_tree_node);
+    void** nodes = calloc(num_extents, sizeof(void*));
+    if (NULL == nodes) {
+        fprintf(stderr, "failed to allocate node array\n");
+        return 1;
+    }
+
+    double start = now_secs();
+    for (size_t i = 0; i < num_extents; i++) {
+        nodes[i] = calloc(1, node_sz);
+    }
+    for (size_t i = 0; i < num_extents; i++) {
+        free(nodes[i]);
+    }
+    double calloc_secs = now_secs() - start;
+
+    node_pool pool;
+    node_pool_init(&pool, node_sz, 0);
+    start = now_secs();
+    for (size_t i = 0; i < num_extents; i++) {
+        nodes[i] = node_pool_alloc(&pool);
+    }
+    for (size_t i = 0; i < num_extents; i++) {
+        node_pool_free(&pool, nodes[i]);
+    }
+    double pool_secs = now_secs() - start;
+    node_pool_destroy(&pool);
+    free(nodes);
+
+    printf("alloc/free of %zu nodes: calloc=%.3f s  node_pool=%.3f s\n",
+           num_extents, calloc_secs, pool_secs);
+
+    /* segment tree add/clear rounds */
+    struct seg_tree tree;
+    seg_tree_init(&tree);
+
+    double add_secs = 0.0;
+    double clear_secs = 0.0;
+    unsigned long log_pos = 0;
+    for (int r = 0; r < num_rounds; r++) {
+        start = now_secs();
+        for (size_t i = 0; i < num_extents; i++) {
+            unsigned long off;
+            if (i & 1) {
+                /* random overwrite, splitting an existing segment */
+                off = ((unsigned long)rand() % num_extents) * ext_size;
+                off += ext_size / 4;
+            } else {
+                /* append, not contiguous in the log with the last one */
+                off = (i / 2) * ext_size;
+            }
+            unsigned long end = off + (ext_size / 2) - 1;
+            if (end >= file_size) {
+                end = file_size - 1;
+            }
+            seg_tree_add(&tree, off, end, log_pos, 0);
+            log_pos += 2 * ext_size;
+        }
+        add_secs += now_secs() - start;
+
+        unsigned long count = seg_tree_count(&tree);
+
+        start = now_secs();
+        seg_tree_clear(&tree);
+        clear_secs += now_secs() - start;
+
+        printf("round %d: %lu segments\n", r, count);
+    }
+    seg_tree_destroy(&tree);
+
+    double total_adds = (double)num_extents * (double)num_rounds;
+    printf("seg_tree_add: %.3f s total, %.1f ns/add\n",
+           add_secs, (add_secs * 1e9) / total_adds);
+    printf("seg_tree_clear: %.3f s total, %.3f ms/clear\n",
+           clear_secs, (clear_secs * 1e3) / (double)num_rounds);
+    printf("peak RSS: %ld KiB\n", max_rss_kb());
+
+    return 0;
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Benchmark for concurrent segment tree lookups, with and without
+ * lock-free snapshots.
+ *
+ * Usage: seg_tree_read_bench [num_readers] [num_segments] [seconds]
+ *                            [sync_interval]
+ *
+ * Each case runs num_readers threads that look up random offsets in a
+ * tree of num_segments segments for the given number of seconds:
+ *   read-only:  no writer (e.g., a laminated file)
+ *   read/write: a writer thread overwrites random segments. In snapshot
+ *               mode, it publishes a snapshot every sync_interval writes,
+ *               as the client does when extents are synced
+ * Readers either lock the tree, or use the published snapshot when there
+ * is one and fall back to locking the tree otherwise. Reports lookups
+ * and writes per second.
+ */
+
+#include <abt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "seg_tree.h"
+
+#define SEG_SIZE 4096UL
+
+struct bench_state {
+    struct seg_tree tree;
+    unsigned long num_segments;
+    int use_snapshot;
+    unsigned long sync_interval;
+    volatile int stop;
+};
+
+struct reader_result {
+    struct bench_state* state;
+    unsigned int seed;
+    unsigned long lookups;
+    unsigned long snapshot_lookups;
+    unsigned long checksum;
+};
+
+struct writer_result {
+    struct bench_state* state;
+    unsigned int seed;
+    unsigned long writes;
+};
+
+static double now_secs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + ((double)tv.tv_usec / 1000000.0);
+}
+
+static void* reader_main(void* arg)
+{
+    struct reader_result* res = (struct reader_result*) arg;
+    struct bench_state* state = res->state;
+    struct seg_tree* tree = &state->tree;
+    unsigned long file_size = state->num_segments * SEG_SIZE;
+
+    while (!state->stop) {
+        unsigned long off = (unsigned long) rand_r(&res->seed) % file_size;
+
+        unsigned long ticket;
+        const struct seg_tree_snapshot* snap = NULL;
+        if (state->use_snapshot) {
+            snap = seg_tree_snapshot_get(tree, &ticket);
+        }
+        if (NULL != snap) {
+            unsigned long i = seg_tree_snapshot_find(snap, off);
+            if ((i < snap->count) && (snap->segs[i].start <= off)) {
+                res->checksum += snap->segs[i].ptr;
+            }
+            seg_tree_snapshot_put(tree, ticket);
+            res->snapshot_lookups++;
+        } else {
+            seg_tree_rdlock(tree);
+            struct seg_tree_node* node = seg_tree_find_nolock(tree, off, off);
+            if (NULL != node) {
+                res->checksum += node->ptr;
+            }
+            seg_tree_unlock(tree);
+        }
+        res->lookups++;
+    }
+    return NULL;
+}
+
+static void* writer_main(void* arg)
+{
+    struct writer_result* res = (struct writer_result*) arg;
+    struct bench_state* state = res->state;
+    unsigned long log_pos = 2 * state->num_segments * SEG_SIZE;
+
+    while (!state->stop) {
+        unsigned long seg = (unsigned long) rand_r(&res->seed) %
+                            state->num_segments;
+        unsigned long start = seg * SEG_SIZE;
+        seg_tree_add(&state->tree, start, start + SEG_SIZE - 1, log_pos, 0);
+        log_pos += 2 * SEG_SIZE;
+        res->writes++;
+
+        if (state->use_snapshot &&
+            ((res->writes % state->sync_interval) == 0)) {
+            seg_tree_snapshot_publish(&state->tree);
+        }
+    }
+    return NULL;
+}
+
+static void run_case(const char* name,
+                     int num_readers,
+                     unsigned long num_segments,
+                     double seconds,
+                     int use_writer,
+                     int use_snapshot,
+                     unsigned long sync_interval)
+{
+    struct bench_state state;
+    seg_tree_init(&state.tree);
+    state.num_segments = num_segments;
+    state.use_snapshot = use_snapshot;
+    state.sync_interval = sync_interval;
+    state.stop = 0;
+
+    /* segments are not contiguous in the log, so they are not merged */
+    for (unsigned long i = 0; i < num_segments; i++) {
+        unsigned long start = i * SEG_SIZE;
+        seg_tree_add(&state.tree, start, start + SEG_SIZE - 1,
+                     2 * start, 0);
+    }
+    if (use_snapshot) {
+        seg_tree_snapshot_publish(&state.tree);
+    }
+
+    pthread_t* readers = calloc(num_readers, sizeof(pthread_t));
+    struct reader_result* rres = calloc(num_readers,
+                                        sizeof(struct reader_result));
+    if ((NULL == readers) || (NULL == rres)) {
+        fprintf(stderr, "failed to allocate reader state\n");
+        exit(1);
+    }
+
+    double start = now_secs();
+    for (int i = 0; i < num_readers; i++) {
+        rres[i].state = &state;
+        rres[i].seed = (unsigned int)(i + 1);
+        pthread_create(&readers[i], NULL, reader_main, &rres[i]);
+    }
+    pthread_t writer;
+    struct writer_result wres = { .state = &state, .seed = 12345678 };
+    if (use_writer) {
+        pthread_create(&writer, NULL, writer_main, &wres);
+    }
+
+    struct timespec ts;
+    ts.tv_sec = (time_t) seconds;
+    ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+    state.stop = 1;
+
+    unsigned long lookups = 0;
+    unsigned long snapshot_lookups = 0;
+    for (int i = 0; i < num_readers; i++) {
+        pthread_join(readers[i], NULL);
+        lookups += rres[i].lookups;
+        snapshot_lookups += rres[i].snapshot_lookups;
+    }
+    if (use_writer) {
+        pthread_join(writer, NULL);
+    }
+    double elapsed = now_secs() - start;
+
+    printf("%-26s %12.0f lookups/s  %10.0f writes/s  %5.1f%% from snapshot\n",
+           name, (double)lookups / elapsed, (double)wres.writes / elapsed,
+           (lookups > 0) ?
+           (100.0 * (double)snapshot_lookups / (double)lookups) : 0.0);
+
+    free(readers);
+    free(rres);
+    seg_tree_destroy(&state.tree);
+}
+
+int main(int argc, char** argv)
+{
+    int num_readers = 8;
+    if (argc > 1) {
+        num_readers = atoi(argv[1]);
+    }
+
+    unsigned long num_segments = 1024 * 1024;
+    if (argc > 2) {
+        num_segments = (unsigned long) atol(argv[2]);
+    }
+
+    double seconds = 2.0;
+    if (argc > 3) {
+        seconds = atof(argv[3]);
+    }
+
+    unsigned long sync_interval = 10000;
+    if (argc > 4) {
+        sync_interval = (unsigned long) atol(argv[4]);
+    }
+
+    if ((num_readers <= 0) || (num_segments == 0) || (seconds <= 0.0) ||
+        (sync_interval == 0)) {
+        fprintf(stderr, "Usage: %s [num_readers] [num_segments] [seconds] "
+                "[sync_interval]\n", argv[0]);
+        return 1;
+    }
+
+    ABT_init(0, NULL);
+
+    printf("%d readers, %lu segments, %.1f s per case, "
+           "snapshot every %lu writes\n",
+           num_readers, num_segments, seconds, sync_interval);
+
+    run_case("read-only, locked", num_readers, num_segments, seconds,
+             0, 0, sync_interval);
+    run_case("read-only, snapshot", num_readers, num_segments, seconds,
+             0, 1, sync_interval);
+    run_case("read/write, locked", num_readers, num_segments, seconds,
+             1, 0, sync_interval);
+    run_case("read/write, snapshot", num_readers, num_segments, seconds,
+             1, 1, sync_interval);
+
+    ABT_finalize();
+    return 0;
+}
@@ -34,8 +34,13 @@ char* print_tree(char* dst, struct seg_tree* seg_tree)
 
     seg_tree_rdlock(seg_tree);
     while ((node = seg_tree_iter(seg_tree, node))) {
-        ptr += sprintf(&dst[ptr], "[%lu-%lu:%lu]", node->start, node->end,
-            node->ptr);
+        if (node->ptr == SEG_TREE_HOLE_PTR) {
+            ptr += sprintf(&dst[ptr], "[%lu-%lu:hole]", node->start,
+                node->end);
+        } else {
+            ptr += sprintf(&dst[ptr], "[%lu-%lu:%lu]", node->start, node->end,
+                node->ptr);
+        }
     }
     seg_tree_unlock(seg_tree);
     return dst;
@@ -197,6 +202,51 @@ int main(int argc, char** argv)
     ok(max == 150, "max is 150 (got %lu)", max);
     ok(count == 1, "count is 1 (got %lu)", count);
 
+    /* Sequential appends that are contiguous in the log extend the
+     * last segment in place */
+    seg_tree_clear(&seg_tree);
+    unsigned long coalesced = seg_tree_coalesced(&seg_tree);
+    seg_tree_add(&seg_tree, 0, 9, 1000, 0);
+    seg_tree_add(&seg_tree, 10, 19, 1010, 0);
+    seg_tree_add(&seg_tree, 20, 29, 1020, 0);
+    is("[0-29:1000]", print_tree(tmp, &seg_tree),
+        "Sequential appends coalesce");
+    ok(seg_tree_coalesced(&seg_tree) - coalesced == 2,
+        "coalesced 2 appends (got %lu)",
+        seg_tree_coalesced(&seg_tree) - coalesced);
+
+    /* Appends that are not contiguous in the log, or that come from
+     * another client, add a new segment */
+    seg_tree_add(&seg_tree, 30, 39, 2000, 0);
+    seg_tree_add(&seg_tree, 40, 49, 2010, 1);
+    is("[0-29:1000][30-39:2000][40-49:2010]", print_tree(tmp, &seg_tree),
+        "Non-contiguous appends do not coalesce");
+    max = seg_tree_max(&seg_tree);
+    count = seg_tree_count(&seg_tree);
+    ok(max == 49, "max is 49 (got %lu)", max);
+    ok(count == 3, "count is 3 (got %lu)", count);
+
+    /* Hole segments have no log position. Adjacent holes coalesce, and
+     * splitting or trimming a hole leaves holes */
+    seg_tree_clear(&seg_tree);
+    seg_tree_add(&seg_tree, 0, 99, 1000, 0);
+    seg_tree_add(&seg_tree, 10, 19, SEG_TREE_HOLE_PTR, 0);
+    seg_tree_add(&seg_tree, 20, 29, SEG_TREE_HOLE_PTR, 0);
+    is("[0-9:1000][10-29:hole][30-99:1030]", print_tree(tmp, &seg_tree),
+        "Adjacent holes coalesce");
+    seg_tree_add(&seg_tree, 15, 16, 5000, 0);
+    is("[0-9:1000][10-14:hole][15-16:5000][17-29:hole][30-99:1030]",
+        print_tree(tmp, &seg_tree), "Split hole works");
+    seg_tree_add(&seg_tree, 100, 109, SEG_TREE_HOLE_PTR, 0);
+    is("[0-9:1000][10-14:hole][15-16:5000][17-29:hole][30-99:1030]"
+        "[100-109:hole]", print_tree(tmp, &seg_tree),
+        "Hole does not coalesce with data");
+    seg_tree_remove(&seg_tree, 0, 11);
+    seg_tree_remove(&seg_tree, 105, 106);
+    is("[12-14:hole][15-16:5000][17-29:hole][30-99:1030]"
+        "[100-104:hole][107-109:hole]", print_tree(tmp, &seg_tree),
+        "Remove from holes works");
+
     seg_tree_clear(&seg_tree);
     seg_tree_add(&seg_tree, 0, 0, 0, 0);
     seg_tree_add(&seg_tree, 1, 10, 101, 0);
@@ -215,6 +265,48 @@ int main(int argc, char** argv)
        "removed a range that truncated two entries, got %s",
        print_tree(tmp, &seg_tree));
 
+    /* Snapshots */
+    unsigned long ticket;
+    const struct seg_tree_snapshot* snap;
+    snap = seg_tree_snapshot_get(&seg_tree, &ticket);
+    ok(snap == NULL, "no snapshot before publish");
+
+    ok(seg_tree_snapshot_publish(&seg_tree) == 0, "published snapshot");
+    snap = seg_tree_snapshot_get(&seg_tree, &ticket);
+    ok(snap != NULL && snap->count == 3, "snapshot has 3 segments");
+    if (snap != NULL) {
+        ok(snap->segs[1].start == 20 && snap->segs[1].end == 24 &&
+           snap->segs[1].ptr == 20, "snapshot segment is [20-24:20]");
+        ok(seg_tree_snapshot_find(snap, 0) == 0 &&
+           seg_tree_snapshot_find(snap, 10) == 0 &&
+           seg_tree_snapshot_find(snap, 11) == 1 &&
+           seg_tree_snapshot_find(snap, 32) == 2 &&
+           seg_tree_snapshot_find(snap, 41) == 3,
+           "seg_tree_snapshot_find found correct segments");
+        seg_tree_snapshot_put(&seg_tree, ticket);
+    }
+
+    seg_tree_add(&seg_tree, 50, 59, 500, 0);
+    snap = seg_tree_snapshot_get(&seg_tree, &ticket);
+    ok(snap == NULL, "snapshot withdrawn by add");
+
+    seg_tree_snapshot_publish(&seg_tree);
+    seg_tree_remove(&seg_tree, 50, 59);
+    snap = seg_tree_snapshot_get(&seg_tree, &ticket);
+    ok(snap == NULL, "snapshot withdrawn by remove");
+
+    seg_tree_snapshot_publish(&seg_tree);
+    seg_tree_clear(&seg_tree);
+    snap = seg_tree_snapshot_get(&seg_tree, &ticket);
+    ok(snap == NULL, "snapshot withdrawn by clear");
+
+    seg_tree_snapshot_publish(&seg_tree);
+    snap = seg_tree_snapshot_get(&seg_tree, &ticket);
+    ok(snap != NULL && snap->count == 0, "snapshot of empty tree");
+    if (snap != NULL) {
+        seg_tree_snapshot_put(&seg_tree, ticket);
+    }
+
     seg_tree_clear(&seg_tree);
     seg_tree_destroy(&seg_tree);
 
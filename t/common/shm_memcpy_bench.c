@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Benchmark for memcpy throughput into shared memory logs.
+ *
+ * Usage: shm_memcpy_bench [shmem_MiB] [write_KiB] [passes]
+ *
+ * For each shmem placement mode (default, huge pages, NUMA-local, and
+ * both), creates a shmem-only log of shmem_MiB, then writes the whole
+ * log passes times using writes of write_KiB. Reports the log creation
+ * time, the write bandwidth, and how much of the log is mapped with
+ * huge pages.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "unifyfs_configurator.h"
+#include "unifyfs_logio.h"
+#include "unifyfs_rc.h"
+
+static double now_secs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + ((double)tv.tv_usec / 1000000.0);
+}
+
+/* return KiB of shared memory mapped with huge pages by this process */
+static long shmem_hugepage_kb(void)
+{
+    long total = 0;
+    FILE* fp = fopen("/proc/self/smaps", "r");
+    if (NULL == fp) {
+        return -1;
+    }
+    char line[256];
+    while (NULL != fgets(line, sizeof(line), fp)) {
+        long kb;
+        if (sscanf(line, "ShmemPmdMapped: %ld kB", &kb) == 1) {
+            total += kb;
+        }
+    }
+    fclose(fp);
+    return total;
+}
+
+static int run_mode(const char* label,
+                    int client_id,
+                    const char* hugepages,
+                    const char* numa_local,
+                    size_t shmem_bytes,
+                    size_t write_bytes,
+                    int passes)
+{
+    char shmem_str[32];
+    char chunk_str[32];
+    snprintf(shmem_str, sizeof(shmem_str), "%zu", shmem_bytes);
+    snprintf(chunk_str, sizeof(chunk_str), "%zu", write_bytes);
+
+    unifyfs_cfg_option options[] = {
+        { .opt_name = "logio.chunk_size",       .opt_value = chunk_str },
+        { .opt_name = "logio.shmem_size",       .opt_value = shmem_str },
+        { .opt_name = "logio.spill_size",       .opt_value = "0" },
+        { .opt_name = "logio.shmem_hugepages",  .opt_value = hugepages },
+        { .opt_name = "logio.shmem_numa_local", .opt_value = numa_local }
+    };
+    int n_opts = (int)(sizeof(options) / sizeof(options[0]));
+
+    unifyfs_cfg_t cfg;
+    int rc = unifyfs_config_init(&cfg, 0, NULL, n_opts, options);
+    if (rc != 0) {
+        fprintf(stderr, "failed to initialize configuration (rc=%d)\n", rc);
+        return rc;
+    }
+
+    double start = now_secs();
+    logio_context* ctx = NULL;
+    rc = unifyfs_logio_init_client(getpid(), client_id, &cfg, &ctx);
+    double init_secs = now_secs() - start;
+    if (rc != UNIFYFS_SUCCESS) {
+        fprintf(stderr, "failed to initialize logio (rc=%d)\n", rc);
+        unifyfs_config_fini(&cfg);
+        return rc;
+    }
+
+    off_t mem_size = 0;
+    off_t spill_size = 0;
+    unifyfs_logio_get_sizes(ctx, &mem_size, &spill_size);
+    size_t n_writes = (size_t)mem_size / write_bytes;
+
+    off_t* offs = calloc(n_writes, sizeof(off_t));
+    char* buf = malloc(write_bytes);
+    if ((NULL == offs) || (NULL == buf)) {
+        free(offs);
+        free(buf);
+        unifyfs_logio_close(ctx, 1);
+        unifyfs_config_fini(&cfg);
+        return ENOMEM;
+    }
+    memset(buf, 'A' + client_id, write_bytes);
+
+    for (size_t i = 0; i < n_writes; i++) {
+        rc = unifyfs_logio_alloc(ctx, write_bytes, offs + i);
+        if (rc != UNIFYFS_SUCCESS) {
+            fprintf(stderr, "log alloc %zu failed (rc=%d)\n", i, rc);
+            n_writes = i;
+            break;
+        }
+    }
+
+    start = now_secs();
+    for (int p = 0; p < passes; p++) {
+        for (size_t i = 0; i < n_writes; i++) {
+            size_t nwrite;
+            rc = unifyfs_logio_write(ctx, offs[i], write_bytes, buf, &nwrite);
+            if (rc != UNIFYFS_SUCCESS) {
+                fprintf(stderr, "log write %zu failed (rc=%d)\n", i, rc);
+                break;
+            }
+        }
+    }
+    double write_secs = now_secs() - start;
+
+    double mib = (double)(n_writes * write_bytes) * (double)passes /
+                 (1024.0 * 1024.0);
+    printf("%-10s: create %.3f s, write %.3f s (%.1f MiB/s), "
+           "huge pages %ld KiB\n",
+           label, init_secs, write_secs, mib / write_secs,
+           shmem_hugepage_kb());
+
+    free(offs);
+    free(buf);
+    unifyfs_logio_close(ctx, 1);
+    unifyfs_config_fini(&cfg);
+    return rc;
+}
+
+int main(int argc, char** argv)
+{
+    size_t shmem_mib = 256;
+    if (argc > 1) {
+        shmem_mib = (size_t) atol(argv[1]);
+    }
+
+    size_t write_kib = 64;
+    if (argc > 2) {
+        write_kib = (size_t) atol(argv[2]);
+    }
+
+    int passes = 8;
+    if (argc > 3) {
+        passes = atoi(argv[3]);
+    }
+
+    size_t shmem_bytes = shmem_mib * 1024 * 1024;
+    size_t write_bytes = write_kib * 1024;
+    if ((write_bytes == 0) || (shmem_bytes < (2 * write_bytes)) ||
+        (passes <= 0)) {
+        fprintf(stderr, "invalid shmem size, write size, or passes\n");
+        return 1;
+    }
+
+    printf("shmem log %zu MiB: %d passes of %zu KiB writes\n",
+           shmem_mib, passes, write_kib);
+
+    int rc = run_mode("default", 1, "off", "off",
+                      shmem_bytes, write_bytes, passes);
+    if (rc == 0) {
+        rc = run_mode("hugepages", 2, "on", "off",
+                      shmem_bytes, write_bytes, passes);
+    }
+    if (rc == 0) {
+        rc = run_mode("numa", 3, "off", "on",
+                      shmem_bytes, write_bytes, passes);
+    }
+    if (rc == 0) {
+        rc = run_mode("both", 4, "on", "on",
+                      shmem_bytes, write_bytes, passes);
+    }
+    return (rc == 0) ? 0 : 1;
+}
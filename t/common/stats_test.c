@@ -0,0 +1,98 @@
+#include "unifyfs_stats.h"
+#include "unifyfs_rc.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+#define N_THREADS 8
+#define N_ADDS 10000
+#define HIST_KEY 42
+
+static void* add_thread(void* arg)
+{
+    (void) arg;
+    uint64_t now = unifyfs_stats_now_usec();
+    for (int i = 0; i < N_ADDS; i++) {
+        unifyfs_stats_add(UNIFYFS_STAT_LOGIO_WRITE_BYTES, 3);
+        unifyfs_stats_add(UNIFYFS_STAT_SERVER_RM_QUEUE, 1);
+        unifyfs_stats_add(UNIFYFS_STAT_SERVER_RM_QUEUE, -1);
+        unifyfs_stats_hist_record(HIST_KEY, now);
+    }
+    return NULL;
+}
+
+static int run_threads(void)
+{
+    pthread_t threads[N_THREADS];
+    int started = 0;
+    for (int i = 0; i < N_THREADS; i++) {
+        if (pthread_create(threads + i, NULL, add_thread, NULL) == 0) {
+            started++;
+        }
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return started;
+}
+
+int main(int argc, char** argv)
+{
+    plan(NO_PLAN);
+
+    int rc = unifyfs_stats_hist_register(HIST_KEY, "test_op");
+    ok(rc == UNIFYFS_SUCCESS, "registered histogram (rc=%d)", rc);
+    rc = unifyfs_stats_hist_register(HIST_KEY, "test_op");
+    ok(rc == UNIFYFS_SUCCESS, "registering histogram twice is harmless");
+
+    /* unregistered keys are ignored */
+    unifyfs_stats_hist_record(HIST_KEY + 1, unifyfs_stats_now_usec());
+
+    int started = run_threads();
+    ok(started == N_THREADS, "started %d threads", started);
+
+    unifyfs_stats* stats = malloc(sizeof(*stats));
+    unifyfs_stats_snapshot(stats);
+    int64_t expect = (int64_t)N_THREADS * N_ADDS * 3;
+    ok(stats->counters[UNIFYFS_STAT_LOGIO_WRITE_BYTES] == expect,
+       "counter sums all threads (%lld)",
+       (long long) stats->counters[UNIFYFS_STAT_LOGIO_WRITE_BYTES]);
+    ok(stats->counters[UNIFYFS_STAT_SERVER_RM_QUEUE] == 0,
+       "increments and decrements cancel out");
+    ok((stats->n_hists == 1) &&
+       (stats->hists[0].count == (uint64_t)N_THREADS * N_ADDS) &&
+       (strcmp(stats->hists[0].name, "test_op") == 0),
+       "histogram has %llu samples",
+       (unsigned long long) stats->hists[0].count);
+
+    uint64_t bucket_sum = 0;
+    for (int b = 0; b < UNIFYFS_STATS_HIST_BUCKETS; b++) {
+        bucket_sum += stats->hists[0].buckets[b];
+    }
+    ok(bucket_sum == stats->hists[0].count, "bucket counts sum to count");
+
+    /* counts of exited threads are kept when new threads reuse blocks */
+    started = run_threads();
+    unifyfs_stats_snapshot(stats);
+    ok(stats->counters[UNIFYFS_STAT_LOGIO_WRITE_BYTES] == (2 * expect),
+       "counts kept across thread exits (%lld)",
+       (long long) stats->counters[UNIFYFS_STAT_LOGIO_WRITE_BYTES]);
+
+    char* report = NULL;
+    size_t len = 0;
+    rc = unifyfs_stats_report(&report, &len);
+    ok((rc == UNIFYFS_SUCCESS) && (NULL != report) &&
+       (strlen(report) == len), "created report (%zu bytes)", len);
+    ok((NULL != report) && (NULL != strstr(report, "logio_write_bytes")) &&
+       (NULL != strstr(report, "test_op")),
+       "report lists counters and histograms");
+    free(report);
+    free(stats);
+
+    done_testing();
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+ /*
+  * Test fallocate punch hole and zero range
+  */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+static int check_contents(char* buf, size_t len, char c)
+{
+    int valid = 1;
+    size_t i;
+    for (i = 0; i < len; i++) {
+        if (buf[i] != c) {
+            valid = 0;
+        }
+    }
+    return valid;
+}
+
+int fallocate_test(char* unifyfs_root)
+{
+    char path[64];
+    int err, rc;
+    int fd;
+    size_t global;
+    ssize_t szrc;
+
+    size_t bufsize = 1024*1024;
+    char* buf = (char*) malloc(3*bufsize);
+    memset(buf, 1, 3*bufsize);
+
+    testutil_rand_path(path, sizeof(path), unifyfs_root);
+
+    /* create a file that contains:
+     * [0, 1MB)       - data = "1"
+     * [1MB, 2MB)     - punched hole = "0"
+     * [2MB, 2.5MB)   - data = "1"
+     * [2.5MB, 3.5MB) - zero range = "0", extends the file */
+    errno = 0;
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    err = errno;
+    ok(fd != -1, "%s:%d open(%s) (fd=%d): %s",
+        __FILE__, __LINE__, path, fd, strerror(err));
+
+    /* write "1" to [0MB, 3MB) */
+    errno = 0;
+    szrc = write(fd, buf, 3*bufsize);
+    err = errno;
+    ok(szrc == 3*bufsize, "%s:%d write() (rc=%zd): %s",
+        __FILE__, __LINE__, szrc, strerror(err));
+
+    errno = 0;
+    rc = fsync(fd);
+    err = errno;
+    ok(rc == 0, "%s:%d fsync() (rc=%d): %s",
+        __FILE__, __LINE__, rc, strerror(err));
+
+    /* punching a hole without keeping the size is invalid */
+    errno = 0;
+    rc = fallocate(fd, FALLOC_FL_PUNCH_HOLE, bufsize, bufsize);
+    err = errno;
+    ok(rc == -1 && err == EOPNOTSUPP,
+        "%s:%d fallocate(PUNCH_HOLE) without KEEP_SIZE (rc=%d): %s",
+        __FILE__, __LINE__, rc, strerror(err));
+
+    /* punch a hole over [1MB, 2MB) */
+    errno = 0;
+    rc = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                   bufsize, bufsize);
+    err = errno;
+    ok(rc == 0, "%s:%d fallocate(PUNCH_HOLE) (rc=%d): %s",
+        __FILE__, __LINE__, rc, strerror(err));
+
+    /* zero [2.5MB, 3.5MB), which extends the file by 0.5MB */
+    errno = 0;
+    rc = fallocate(fd, FALLOC_FL_ZERO_RANGE,
+                   2*bufsize + bufsize/2, bufsize);
+    err = errno;
+    ok(rc == 0, "%s:%d fallocate(ZERO_RANGE) (rc=%d): %s",
+        __FILE__, __LINE__, rc, strerror(err));
+
+    errno = 0;
+    rc = fsync(fd);
+    err = errno;
+    ok(rc == 0, "%s:%d fsync() (rc=%d): %s",
+        __FILE__, __LINE__, rc, strerror(err));
+
+    testutil_get_size(path, &global);
+    ok(global == 3*bufsize + bufsize/2,
+        "%s:%d global size is %zu, expected %zu",
+        __FILE__, __LINE__, global, 3*bufsize + bufsize/2);
+
+    /* read back the whole file and check each region */
+    memset(buf, 2, 3*bufsize);
+    errno = 0;
+    szrc = pread(fd, buf, 3*bufsize, bufsize/2);
+    err = errno;
+    ok(szrc == 3*bufsize, "%s:%d pread expected=%zu got=%zd: errno=%s",
+        __FILE__, __LINE__, 3*bufsize, szrc, strerror(err));
+
+    ok(check_contents(buf, bufsize/2, 1),
+        "%s:%d data check [0.5MB, 1MB)", __FILE__, __LINE__);
+    ok(check_contents(buf + bufsize/2, bufsize, 0),
+        "%s:%d punched hole check [1MB, 2MB)", __FILE__, __LINE__);
+    ok(check_contents(buf + bufsize/2 + bufsize, bufsize/2, 1),
+        "%s:%d data check [2MB, 2.5MB)", __FILE__, __LINE__);
+    ok(check_contents(buf + 2*bufsize, bufsize, 0),
+        "%s:%d zero range check [2.5MB, 3.5MB)", __FILE__, __LINE__);
+
+    close(fd);
+    free(buf);
+
+    return 0;
+}
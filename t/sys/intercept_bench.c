@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Benchmark for the overhead of path interception on system calls.
+ *
+ * Usage: intercept_bench [num_calls] [outside_path]
+ *
+ * Times num_calls stat() calls on paths outside of UnifyFS (an absolute
+ * path, default /tmp, and a relative path) before mounting, when every
+ * wrapper passes straight through, and again after mounting, when each
+ * path is checked against the mount point. Also times stat() of a file
+ * within UnifyFS. Requires a running server for the mount point given
+ * by UNIFYFS_MOUNTPOINT.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <unifyfs.h>
+
+#include "t/lib/testutil.h"
+
+static double now_secs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + ((double)tv.tv_usec / 1000000.0);
+}
+
+/* return average time in nsecs of num_calls stat() calls on path */
+static double time_stat(const char* path, long num_calls)
+{
+    struct stat sb;
+    double start = now_secs();
+    for (long i = 0; i < num_calls; i++) {
+        stat(path, &sb);
+    }
+    return ((now_secs() - start) * 1e9) / (double)num_calls;
+}
+
+int main(int argc, char** argv)
+{
+    long num_calls = 1000000;
+    if (argc > 1) {
+        num_calls = atol(argv[1]);
+    }
+    if (num_calls <= 0) {
+        fprintf(stderr, "Usage: %s [num_calls] [outside_path]\n", argv[0]);
+        return 1;
+    }
+
+    const char* abs_path = "/tmp";
+    if (argc > 2) {
+        abs_path = argv[2];
+    }
+    const char* rel_path = "intercept_bench.tmp";
+
+    char* unifyfs_root = testutil_get_mount_point();
+
+    /* passthrough before mount */
+    double abs_base = time_stat(abs_path, num_calls);
+    double rel_base = time_stat(rel_path, num_calls);
+
+    int rc = unifyfs_mount(unifyfs_root, 0, 1);
+    if (rc != 0) {
+        fprintf(stderr, "unifyfs_mount(%s) failed (rc=%d)\n",
+                unifyfs_root, rc);
+        return 1;
+    }
+
+    char upath[256];
+    testutil_rand_path(upath, sizeof(upath), unifyfs_root);
+    int fd = open(upath, O_WRONLY | O_CREAT, 0600);
+    if (fd < 0) {
+        fprintf(stderr, "failed to create %s\n", upath);
+        unifyfs_unmount();
+        return 1;
+    }
+    close(fd);
+
+    /* passthrough and intercepted after mount */
+    double abs_mnt = time_stat(abs_path, num_calls);
+    double rel_mnt = time_stat(rel_path, num_calls);
+    double unifyfs_mnt = time_stat(upath, num_calls);
+
+    printf("%ld stat() calls, mount point %s\n", num_calls, unifyfs_root);
+    printf("%-24s %12s %12s %12s\n",
+           "path", "unmounted", "mounted", "overhead");
+    printf("%-24s %9.1f ns %9.1f ns %9.1f ns\n",
+           abs_path, abs_base, abs_mnt, abs_mnt - abs_base);
+    printf("%-24s %9.1f ns %9.1f ns %9.1f ns\n",
+           rel_path, rel_base, rel_mnt, rel_mnt - rel_base);
+    printf("%-24s %12s %9.1f ns\n", "(within UnifyFS)", "-", unifyfs_mnt);
+
+    unlink(upath);
+    unifyfs_unmount();
+    return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+#define NUM_FILES 3
+
+static const char* file_names[NUM_FILES] = { "a", "b", "c" };
+
+/* filter for scandir() that skips the "." and ".." entries */
+static int skip_dots(const struct dirent* d)
+{
+    return (strcmp(d->d_name, ".") != 0) && (strcmp(d->d_name, "..") != 0);
+}
+
+/* read remaining entries of dirp, and return a bit mask of the
+ * files (bit i set for file_names[i]) and dot entries (bits
+ * NUM_FILES and NUM_FILES+1) found */
+static int read_entries(DIR* dirp, int* count)
+{
+    int found = 0;
+    struct dirent* d;
+    *count = 0;
+    while (NULL != (d = readdir(dirp))) {
+        (*count)++;
+        if (strcmp(d->d_name, ".") == 0) {
+            found |= (1 << NUM_FILES);
+        } else if (strcmp(d->d_name, "..") == 0) {
+            found |= (1 << (NUM_FILES + 1));
+        } else {
+            for (int i = 0; i < NUM_FILES; i++) {
+                if (strcmp(d->d_name, file_names[i]) == 0) {
+                    found |= (1 << i);
+                }
+            }
+        }
+    }
+    return found;
+}
+
+/* This function contains the tests for UNIFYFS_WRAP(opendir), readdir,
+ * telldir, seekdir, rewinddir, and scandir found in
+ * client/src/unifyfs-dirops.c */
+int readdir_test(char* unifyfs_root)
+{
+    diag("Starting UNIFYFS_WRAP(readdir) tests");
+
+    char dir_path[64];
+    char path[128];
+    int all_found = (1 << (NUM_FILES + 2)) - 1;
+    int err, fd, rc, count;
+
+    testutil_rand_path(dir_path, sizeof(dir_path), unifyfs_root);
+
+    errno = 0;
+    rc = mkdir(dir_path, 0700);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d mkdir(%s): %s",
+       __FILE__, __LINE__, dir_path, strerror(err));
+
+    for (int i = 0; i < NUM_FILES; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir_path, file_names[i]);
+        errno = 0;
+        fd = open(path, O_WRONLY | O_CREAT, 0600);
+        err = errno;
+        ok(fd >= 0 && err == 0, "%s:%d open(%s): %s",
+           __FILE__, __LINE__, path, strerror(err));
+        close(fd);
+    }
+
+    /* Verify all entries are listed */
+    errno = 0;
+    DIR* dirp = opendir(dir_path);
+    err = errno;
+    ok(dirp != NULL && err == 0, "%s:%d opendir(%s): %s",
+       __FILE__, __LINE__, dir_path, strerror(err));
+    if (NULL == dirp) {
+        return 0;
+    }
+
+    errno = 0;
+    int found = read_entries(dirp, &count);
+    err = errno;
+    ok(found == all_found && count == (NUM_FILES + 2) && err == 0,
+       "%s:%d readdir() returned %d entries (found=0x%x): %s",
+       __FILE__, __LINE__, count, found, strerror(err));
+
+    /* Verify rewinddir restarts the listing */
+    rewinddir(dirp);
+    found = read_entries(dirp, &count);
+    ok(found == all_found && count == (NUM_FILES + 2),
+       "%s:%d readdir() after rewinddir() returned %d entries",
+       __FILE__, __LINE__, count);
+
+    /* Verify seekdir to a position from telldir resumes the listing */
+    rewinddir(dirp);
+    struct dirent* d = readdir(dirp);
+    d = readdir(dirp);
+    long pos = telldir(dirp);
+    d = readdir(dirp);
+    char name[256] = { 0 };
+    if (NULL != d) {
+        snprintf(name, sizeof(name), "%s", d->d_name);
+    }
+    read_entries(dirp, &count);
+    seekdir(dirp, pos);
+    d = readdir(dirp);
+    ok(d != NULL && strcmp(d->d_name, name) == 0,
+       "%s:%d readdir() after seekdir() returned %s (expected %s)",
+       __FILE__, __LINE__, (d != NULL) ? d->d_name : "NULL", name);
+
+    errno = 0;
+    rc = closedir(dirp);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d closedir(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    /* Verify scandir filters and sorts entries */
+    struct dirent** namelist = NULL;
+    errno = 0;
+    rc = scandir(dir_path, &namelist, skip_dots, alphasort);
+    err = errno;
+    ok(rc == NUM_FILES && err == 0, "%s:%d scandir(%s) (rc=%d): %s",
+       __FILE__, __LINE__, dir_path, rc, strerror(err));
+    if (rc > 0) {
+        int sorted = (rc == NUM_FILES);
+        for (int i = 0; i < rc; i++) {
+            if (sorted && (strcmp(namelist[i]->d_name, file_names[i]) != 0)) {
+                sorted = 0;
+            }
+            free(namelist[i]);
+        }
+        free(namelist);
+        ok(sorted, "%s:%d scandir() entries are sorted", __FILE__, __LINE__);
+    }
+
+    /* Verify an unlinked file is no longer listed */
+    snprintf(path, sizeof(path), "%s/%s", dir_path, file_names[0]);
+    rc = unlink(path);
+    ok(rc == 0, "%s:%d unlink(%s)", __FILE__, __LINE__, path);
+    dirp = opendir(dir_path);
+    if (NULL != dirp) {
+        found = read_entries(dirp, &count);
+        ok(found == (all_found & ~1) && count == (NUM_FILES + 1),
+           "%s:%d readdir() after unlink returned %d entries",
+           __FILE__, __LINE__, count);
+        closedir(dirp);
+    }
+
+    return 0;
+}
@@ -103,8 +103,12 @@ int main(int argc, char* argv[])
     truncate_trunc_before_sync(unifyfs_root);
     truncate_twice(unifyfs_root);
 
+    fallocate_test(unifyfs_root);
+
     unlink_test(unifyfs_root);
 
+    readdir_test(unifyfs_root);
+
     chdir_test(unifyfs_root);
 
     stat_test(unifyfs_root);
@@ -69,9 +69,15 @@ int truncate_ftrunc_before_sync(char* unifyfs_root);
 int truncate_trunc_before_sync(char* unifyfs_root);
 int truncate_twice(char* unifyfs_root);
 
+/* Test for UNIFYFS_WRAP(fallocate) */
+int fallocate_test(char* unifyfs_root);
+
 /* Test for UNIFYFS_WRAP(unlink) */
 int unlink_test(char* unifyfs_root);
 
+/* Test for UNIFYFS_WRAP(opendir, readdir, telldir, seekdir, scandir) */
+int readdir_test(char* unifyfs_root);
+
 int chdir_test(char* unifyfs_root);
 
 /* Test for UNIFYFS_WRAP(stat, lstat, fstat) */
@@ -1,5 +1,5 @@
-// This is a very simple program that is designed to test the new
-// get_gfids rpc I've added to UnifyFS.
+// This is a very simple program that lists the files known to the
+// UnifyFS servers, fetching their metadata one page at a time.
 //
 
 #include "unifyfs_api.h"
@@ -18,6 +18,7 @@
 struct CommandOptions
 {
     std::string mount_point;  // where is UnifyFS mounted
+    std::string prefix;  // only list files with this path prefix
     bool verbose;  // verbose display or not
 
     CommandOptions() : mount_point("/unifyfs"), verbose(false) {}
@@ -62,39 +63,42 @@ int main( int argc, char **argv)
         return 1;
     }
 
-    std::cout << "Attempting to call unifyfs_get_gfids()..." << std::endl;
-    int num_gfids = -1;
-    unifyfs_gfid *gfid_list;
-    int ret = unifyfs_get_gfid_list(fshdl, &num_gfids, &gfid_list);
-    std::cout << "...and done.  ret=" << ret << "\tnum_gfids=" << num_gfids << std::endl;
+    // Fetch the metadata of matching files, one page at a time
+    unifyfs_file_filter filter;
+    filter.path_prefix = opts.prefix.empty() ? NULL : opts.prefix.c_str();
+    filter.owner_rank = -1;
+    filter.laminated = -1;
 
+    const size_t page_files = 256;
+    unifyfs_server_file_meta page[page_files];
+    unifyfs_list_cursor cursor = UNIFYFS_LIST_CURSOR_START;
     std::set<unifyfs_server_file_meta, CompareByFilename> file_set;
-    if (UNIFYFS_SUCCESS==ret && num_gfids > 0) {
-        unifyfs_server_file_meta fmeta;
-
-        for (unsigned i = 0; i < num_gfids; i++) {
-            //ret = unifyfs_stat(fshdl, gfid_list[i], &gfattr);
-            ret = unifyfs_get_server_file_meta(fshdl, gfid_list[i], &fmeta);
-            if (UNIFYFS_SUCCESS == ret) {
-                file_set.insert(fmeta);
-                // Note: insert() does a shallow copy and does *not* allocate
-                // new memory for the fmeta.filename pointer.  That's fine
-                // since fmeta is going to get overwritten in the next loop
-                // iteration anyway.  We do need to rember to explicitly free
-                // the memory when removing items from the set, though.
-            } else {
-                std::cerr << "\t!!!ERROR " << ret << " retrieving metadata for GFID "
-                          << gfid_list[i] << "!!!" << std::endl;
-            }
+    while (cursor != UNIFYFS_LIST_CURSOR_END) {
+        size_t num_files = 0;
+        unifyfs_rc ret = unifyfs_list_files(fshdl, &filter, &cursor,
+                                            page_files, page, &num_files);
+        if (UNIFYFS_SUCCESS != ret) {
+            std::cerr << "UNIFYFS ERROR: failed to list files - "
+                      << unifyfs_rc_enum_description(ret) << std::endl;
+            break;
+        }
+        for (size_t i = 0; i < num_files; i++) {
+            // Note: insert() does a shallow copy and does *not* allocate
+            // new memory for the filename pointer.  We need to remember
+            // to explicitly free the memory when removing items from the
+            // set, though.
+            file_set.insert(page[i]);
         }
     }
 
-
     // Now iterate through the set and print everything out (sorted by filename)
-    std::cout << "GFIDs received:" << std::endl;
     auto it = file_set.cbegin();
     while (it != file_set.cend()) {
-        print_fmeta_ls(*it++);
+        if (opts.verbose) {
+            print_fmeta(*it++);
+        } else {
+            print_fmeta_ls(*it++);
+        }
     }
 
     // Walk the set freeing the filename strings so we don't have any
@@ -161,6 +165,7 @@ void print_fmeta_ls(const unifyfs_server_file_meta& attr)
 
 struct option long_options[] = {
     {"mount_point", required_argument, 0, 'm'},
+    {"prefix",      required_argument, 0, 'p'},
     {"verbose",     no_argument,       0, 'v'},
     {"help",        no_argument,       0, 'h'},
     {0, 0, 0, 0} };
@@ -171,7 +176,7 @@ void parseOpts( int argc, char **argv, CommandOptions &cmdLineOpts)
     {
         /* getopt_long stores the option index here. */
         int option_index = 0;
-        int c = getopt_long( argc, argv, "m:vh?", long_options, &option_index);
+        int c = getopt_long( argc, argv, "m:p:vh?", long_options, &option_index);
 
         /* Detect the end of the options. */
         if (c == -1)
@@ -183,6 +188,10 @@ void parseOpts( int argc, char **argv, CommandOptions &cmdLineOpts)
                     cmdLineOpts.mount_point.assign(optarg);
                     break;
 
+                case 'p':
+                    cmdLineOpts.prefix.assign(optarg);
+                    break;
+
                 case 'v':
                     cmdLineOpts.verbose = true;
                     break;
@@ -203,10 +212,13 @@ void printHelp( const char *exeName)
 
     cout << "Usage:" << endl;
     cout << "  " << exeName << " [ -v | --verbose ] "
-         << "[ -m <dir_name> | --mount_point_dir=<dir_name> ]" << endl;
+         << "[ -m <dir_name> | --mount_point_dir=<dir_name> ] "
+         << "[ -p <path> | --prefix=<path> ]" << endl;
     cout << endl;
     cout << "  " << "-v | --verbose: " << "show verbose information"
          << "(default: " << opts.verbose << ")" << endl;
     cout << "  " << "-m | --mount_point: " << "the location where unifyfs is mounted "
          << "(default: " << opts.mount_point << ")" << endl;
+    cout << "  " << "-p | --prefix: " << "only list files whose path "
+         << "starts with the given prefix" << endl;
 }
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "unifyfs_api.h"
+
+static void usage(char* arg0)
+{
+    fprintf(stderr, "USAGE: %s <mountpoint>\n", arg0);
+    fflush(stderr);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "USAGE ERROR: expected one argument!\n");
+        usage(argv[0]);
+        return -1;
+    }
+
+    char* mountpt = argv[1];
+
+    unifyfs_handle fshdl;
+    unifyfs_rc urc = unifyfs_initialize(mountpt, NULL, 0, &fshdl);
+    if (UNIFYFS_SUCCESS != urc) {
+        fprintf(stderr, "UNIFYFS ERROR: init failed at mountpoint %s - %s\n",
+                mountpt, unifyfs_rc_enum_description(urc));
+        return 1;
+    }
+
+    char* report = NULL;
+    urc = unifyfs_get_stats(fshdl, &report);
+    if (UNIFYFS_SUCCESS != urc) {
+        fprintf(stderr, "UNIFYFS ERROR: failed to get stats - %s\n",
+                unifyfs_rc_enum_description(urc));
+        unifyfs_finalize(fshdl);
+        return 2;
+    }
+    printf("%s", report);
+    free(report);
+
+    urc = unifyfs_finalize(fshdl);
+    if (UNIFYFS_SUCCESS != urc) {
+        fprintf(stderr, "UNIFYFS ERROR: failed to finalize - %s\n",
+                unifyfs_rc_enum_description(urc));
+        return 3;
+    }
+
+    return 0;
+}
@@ -16,6 +16,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -131,19 +132,59 @@ int read_file_block(int fd,
 {
     int err;
     int ret = 0;
-    errno = 0;
-    ssize_t len = pread(fd, (void*) databuf, bufsize, file_offset);
-    if (-1 == len) {
-        err = errno;
-        fprintf(stderr, "UNIFYFS-STAGE ERROR: pread() failed - %s",
-                strerror(err));
-        ret = err;
-        len = 0;
+    size_t total = 0;
+
+    /* keep reading until the buffer is full or we reach end of file,
+     * since parallel file systems may return short reads */
+    while (total < bufsize) {
+        errno = 0;
+        ssize_t len = pread(fd, (void*)(databuf + total), bufsize - total,
+                            file_offset + (off_t)total);
+        if (-1 == len) {
+            err = errno;
+            if (EINTR == err) {
+                continue;
+            }
+            fprintf(stderr, "UNIFYFS-STAGE ERROR: pread() failed - %s",
+                    strerror(err));
+            ret = err;
+            break;
+        } else if (0 == len) {
+            break;
+        }
+        total += (size_t) len;
     }
-    *nread = len;
+    *nread = total;
     return ret;
 }
 
+/**
+ * @brief compute the md5 digest of a single data block
+ *
+ * @param md5       MD5 context to use
+ * @param data      block data
+ * @param len       length of block data
+ * @param digest    buffer of MD5_DIGEST_LENGTH bytes for block digest
+ *
+ * @return 0 on success, EIO on failure
+ */
+static int md5_block(EVP_MD_CTX* md5,
+                     const char* data,
+                     size_t len,
+                     unsigned char* digest)
+{
+    unsigned int digest_len = MD5_DIGEST_LENGTH;
+
+    /* NOTE: EVP_Digest*() functions return 1 for success */
+    if ((EVP_DigestInit_ex(md5, EVP_md5(), NULL) != 1) ||
+        (EVP_DigestUpdate(md5, data, len) != 1) ||
+        (EVP_DigestFinal_ex(md5, digest, &digest_len) != 1)) {
+        fprintf(stderr, "UNIFYFS-STAGE ERROR: block MD5 checksum failed\n");
+        return EIO;
+    }
+    return 0;
+}
+
 /**
  * @brief Run md5 checksum on specified file, send back
  *        digest.
@@ -166,7 +207,7 @@ static int md5_checksum(unifyfs_stage* ctx,
     off_t file_offset;
     EVP_MD_CTX* md5;
     unsigned char data[UNIFYFS_STAGE_MD5_BLOCKSIZE];
-    unsigned int digest_len = UNIFYFS_STAGE_MD5_BLOCKSIZE;
+    unsigned int digest_len = MD5_DIGEST_LENGTH;
 
     if (is_unify_file) {
         fd = -1;
@@ -222,7 +263,7 @@ static int md5_checksum(unifyfs_stage* ctx,
             }
         } while (len != 0);
 
-        md5_rc = EVP_DigestFinal_ex(md5, data, &digest_len);
+        md5_rc = EVP_DigestFinal_ex(md5, digest, &digest_len);
         if (md5_rc != 1) {
             fprintf(stderr, "UNIFYFS-STAGE ERROR: failed to finalize MD5\n");
             ret = EIO;
@@ -321,28 +362,388 @@ static int verify_checksum(unifyfs_stage* ctx,
     return ret;
 }
 
+/*
+ * Stage-in pipeline
+ *
+ * Each rank copies its range of source file blocks using a set of reader
+ * threads and a set of writer threads that share a pool of aligned block
+ * buffers. Readers pread() source blocks into free buffers, and when
+ * checksums are enabled compute each block's MD5 digest from the same
+ * buffer. Writers write the filled buffers to UnifyFS and return them to
+ * the free pool, so reads of later blocks overlap with earlier writes.
+ */
+
+typedef struct stage_buffer {
+    char* data;                 /* aligned block buffer */
+    size_t block_ndx;           /* file block held in the buffer */
+    size_t nbytes;              /* valid bytes in the buffer */
+    struct stage_buffer* next;
+} stage_buffer;
+
+typedef struct stage_pipeline {
+    unifyfs_stage* ctx;
+    int src_fd;                 /* source file descriptor */
+    unifyfs_gfid gfid;          /* destination file gfid */
+    size_t blksz;               /* transfer block size */
+    size_t first_block;         /* first block for this rank */
+    size_t end_block;           /* one past the last block for this rank */
+    size_t next_block;          /* next block to be read */
+    unsigned char* digests;     /* per-block MD5 digests, or NULL */
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    stage_buffer* free_bufs;    /* buffers available to readers */
+    stage_buffer* full_head;    /* buffers waiting for writers */
+    stage_buffer* full_tail;
+    int n_readers;              /* number of reader threads */
+    int readers_done;           /* number of finished reader threads */
+    int err;                    /* first error seen, or 0 */
+} stage_pipeline;
+
+static void* stage_reader_thread(void* arg)
+{
+    stage_pipeline* p = (stage_pipeline*) arg;
+    EVP_MD_CTX* md5 = NULL;
+    int rc;
+
+    if (NULL != p->digests) {
+        md5 = EVP_MD_CTX_create();
+    }
+
+    while (1) {
+        pthread_mutex_lock(&(p->lock));
+        while (!p->err && (p->next_block < p->end_block) &&
+               (NULL == p->free_bufs)) {
+            pthread_cond_wait(&(p->cond), &(p->lock));
+        }
+        if (p->err || (p->next_block >= p->end_block)) {
+            p->readers_done++;
+            pthread_cond_broadcast(&(p->cond));
+            pthread_mutex_unlock(&(p->lock));
+            break;
+        }
+        stage_buffer* buf = p->free_bufs;
+        p->free_bufs = buf->next;
+        buf->next = NULL;
+        buf->block_ndx = p->next_block++;
+        pthread_mutex_unlock(&(p->lock));
+
+        off_t block_offset = (off_t)(buf->block_ndx * p->blksz);
+        rc = read_file_block(p->src_fd, block_offset, p->blksz,
+                             buf->data, &(buf->nbytes));
+        if ((0 == rc) && (NULL != p->digests)) {
+            size_t ndx = buf->block_ndx - p->first_block;
+            if (NULL == md5) {
+                rc = ENOMEM;
+            } else {
+                rc = md5_block(md5, buf->data, buf->nbytes,
+                               p->digests + (ndx * MD5_DIGEST_LENGTH));
+            }
+        }
+
+        pthread_mutex_lock(&(p->lock));
+        if (rc) {
+            if (!p->err) {
+                p->err = rc;
+            }
+            buf->next = p->free_bufs;
+            p->free_bufs = buf;
+        } else {
+            if (NULL == p->full_tail) {
+                p->full_head = buf;
+            } else {
+                p->full_tail->next = buf;
+            }
+            p->full_tail = buf;
+        }
+        pthread_cond_broadcast(&(p->cond));
+        pthread_mutex_unlock(&(p->lock));
+    }
+
+    if (NULL != md5) {
+        EVP_MD_CTX_destroy(md5);
+    }
+    return NULL;
+}
+
+static void* stage_writer_thread(void* arg)
+{
+    stage_pipeline* p = (stage_pipeline*) arg;
+    int rc;
+
+    while (1) {
+        pthread_mutex_lock(&(p->lock));
+        while ((NULL == p->full_head) &&
+               (p->readers_done < p->n_readers)) {
+            pthread_cond_wait(&(p->cond), &(p->lock));
+        }
+        stage_buffer* buf = p->full_head;
+        if (NULL == buf) {
+            /* all readers have finished and no blocks remain */
+            pthread_mutex_unlock(&(p->lock));
+            break;
+        }
+        p->full_head = buf->next;
+        if (NULL == p->full_head) {
+            p->full_tail = NULL;
+        }
+        buf->next = NULL;
+        int skip = p->err;
+        pthread_mutex_unlock(&(p->lock));
+
+        rc = 0;
+        if (!skip && buf->nbytes) {
+            size_t nwrite = 0;
+            off_t block_offset = (off_t)(buf->block_ndx * p->blksz);
+            rc = write_unify_file_block(p->ctx->fshdl, p->gfid, block_offset,
+                                        buf->nbytes, buf->data, &nwrite);
+            if ((0 == rc) && (nwrite != buf->nbytes)) {
+                fprintf(stderr, "[rank=%d] UNIFYFS-STAGE ERROR: "
+                        "mismatch on read=%zu / write=%zu bytes\n",
+                        p->ctx->rank, buf->nbytes, nwrite);
+                rc = EIO;
+            }
+        }
+
+        pthread_mutex_lock(&(p->lock));
+        if (rc && !p->err) {
+            p->err = rc;
+        }
+        buf->next = p->free_bufs;
+        p->free_bufs = buf;
+        pthread_cond_broadcast(&(p->cond));
+        pthread_mutex_unlock(&(p->lock));
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief copy a range of source file blocks to a UnifyFS file using the
+ *        stage-in pipeline
+ *
+ * @param ctx           stage context
+ * @param fd            source file descriptor
+ * @param gfid          destination file gfid
+ * @param blksz         transfer block size
+ * @param first_block   first block to copy
+ * @param n_blocks      number of blocks to copy
+ * @param digests       if not NULL, receives the MD5 digest of each block
+ *
+ * @return 0 on success, errno otherwise
+ */
+static int run_stage_pipeline(unifyfs_stage* ctx,
+                              int fd,
+                              unifyfs_gfid gfid,
+                              size_t blksz,
+                              size_t first_block,
+                              size_t n_blocks,
+                              unsigned char* digests)
+{
+    int ret = 0;
+    int n_threads = ctx->n_threads;
+    if ((size_t)n_threads > n_blocks) {
+        n_threads = (int) n_blocks;
+    }
+    if (n_threads < 1) {
+        n_threads = 1;
+    }
+
+    /* two buffers per reader, so each reader can fill its next block
+     * while a writer drains the previous one */
+    int n_bufs = 2 * n_threads;
+    stage_buffer* bufs = calloc(n_bufs, sizeof(stage_buffer));
+    pthread_t* threads = calloc(2 * n_threads, sizeof(pthread_t));
+    if ((NULL == bufs) || (NULL == threads)) {
+        free(bufs);
+        free(threads);
+        return ENOMEM;
+    }
+
+    stage_pipeline pipe = {0};
+    pipe.ctx = ctx;
+    pipe.src_fd = fd;
+    pipe.gfid = gfid;
+    pipe.blksz = blksz;
+    pipe.first_block = first_block;
+    pipe.end_block = first_block + n_blocks;
+    pipe.next_block = first_block;
+    pipe.digests = digests;
+    pthread_mutex_init(&(pipe.lock), NULL);
+    pthread_cond_init(&(pipe.cond), NULL);
+
+    for (int i = 0; i < n_bufs; i++) {
+        void* data = NULL;
+        if (posix_memalign(&data, UNIFYFS_STAGE_BLOCK_ALIGN, blksz) != 0) {
+            ret = ENOMEM;
+            break;
+        }
+        bufs[i].data = data;
+        bufs[i].next = pipe.free_bufs;
+        pipe.free_bufs = bufs + i;
+    }
+
+    int n_started = 0;
+    if (0 == ret) {
+        for (int i = 0; i < n_threads; i++) {
+            if (pthread_create(threads + n_started, NULL,
+                               stage_reader_thread, &pipe) != 0) {
+                ret = EAGAIN;
+                break;
+            }
+            n_started++;
+        }
+        pthread_mutex_lock(&(pipe.lock));
+        pipe.n_readers = n_started;
+        if (ret) {
+            pipe.err = ret;
+        }
+        pthread_cond_broadcast(&(pipe.cond));
+        pthread_mutex_unlock(&(pipe.lock));
+
+        /* without writers, the readers would never get their buffers
+         * back, so always start at least one */
+        for (int i = 0; i < n_threads; i++) {
+            if (pthread_create(threads + n_started, NULL,
+                               stage_writer_thread, &pipe) != 0) {
+                if (0 == i) {
+                    /* fall back to writing from this thread */
+                    stage_writer_thread(&pipe);
+                }
+                break;
+            }
+            n_started++;
+        }
+        for (int i = 0; i < n_started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        if (0 == ret) {
+            ret = pipe.err;
+        }
+    }
+
+    for (int i = 0; i < n_bufs; i++) {
+        free(bufs[i].data);
+    }
+    free(bufs);
+    free(threads);
+    pthread_mutex_destroy(&(pipe.lock));
+    pthread_cond_destroy(&(pipe.cond));
+
+    return ret;
+}
+
+/**
+ * @brief read back a range of blocks from a UnifyFS file and compare
+ *        their MD5 digests to those computed from the source file
+ *
+ * @return 0 if all blocks match, errno otherwise
+ */
+static int verify_block_checksums(unifyfs_stage* ctx,
+                                  unifyfs_gfid gfid,
+                                  const char* dst_file_path,
+                                  size_t blksz,
+                                  size_t file_size,
+                                  size_t first_block,
+                                  size_t n_blocks,
+                                  unsigned char* digests)
+{
+    int ret = 0;
+    void* data = NULL;
+    unsigned char digest[MD5_DIGEST_LENGTH];
+    char md5src[2 * MD5_DIGEST_LENGTH + 1] = { 0, };
+    char md5dst[2 * MD5_DIGEST_LENGTH + 1] = { 0, };
+
+    if (posix_memalign(&data, UNIFYFS_STAGE_BLOCK_ALIGN, blksz) != 0) {
+        return ENOMEM;
+    }
+    EVP_MD_CTX* md5 = EVP_MD_CTX_create();
+    if (NULL == md5) {
+        free(data);
+        return ENOMEM;
+    }
+
+    for (size_t i = 0; i < n_blocks; i++) {
+        size_t block_ndx = first_block + i;
+        size_t block_offset = block_ndx * blksz;
+        size_t expect = file_size - block_offset;
+        if (expect > blksz) {
+            expect = blksz;
+        }
+
+        size_t nread = 0;
+        ret = read_unify_file_block(ctx->fshdl, gfid, (off_t)block_offset,
+                                    expect, (char*)data, &nread);
+        if (0 == ret) {
+            if (nread != expect) {
+                fprintf(stderr, "[rank=%d] UNIFYFS-STAGE ERROR: "
+                        "short read of block %zu in %s (%zu of %zu B)\n",
+                        ctx->rank, block_ndx, dst_file_path, nread, expect);
+                ret = EIO;
+            } else {
+                ret = md5_block(md5, (char*)data, nread, digest);
+            }
+        }
+        if (ret) {
+            break;
+        }
+
+        unsigned char* src_digest = digests + (i * MD5_DIGEST_LENGTH);
+        if (memcmp(digest, src_digest, MD5_DIGEST_LENGTH) != 0) {
+            fprintf(stderr, "[rank=%d] UNIFYFS-STAGE ERROR: "
+                    "checksums do not match for block %zu of %s! "
+                    "(src=%s, dst=%s)\n",
+                    ctx->rank, block_ndx, dst_file_path,
+                    checksum_str(md5src, src_digest),
+                    checksum_str(md5dst, digest));
+            ret = EIO;
+            break;
+        }
+    }
+
+    if (verbose && (0 == ret)) {
+        printf("[rank=%d] UNIFYFS-STAGE INFO: "
+               "verified checksums of %zu blocks of %s\n",
+               ctx->rank, n_blocks, dst_file_path);
+    }
+
+    EVP_MD_CTX_destroy(md5);
+    free(data);
+    return ret;
+}
+
 static
 int distribute_source_file_data(unifyfs_stage* ctx,
+                                int mgr_rank,
                                 const char* src_file_path,
                                 const char* dst_file_path,
+                                size_t src_file_size,
                                 size_t transfer_blksz,
                                 size_t num_file_blocks)
 {
-    int rc;
-    int fd = -1;
     int ret = 0;
+    int fd = -1;
     unifyfs_gfid gfid;
     unifyfs_rc urc;
+    unsigned char* digests = NULL;
 
     size_t blocks_per_client = num_file_blocks / ctx->total_ranks;
+    if (num_file_blocks % ctx->total_ranks) {
+        blocks_per_client++;
+    }
     if (blocks_per_client < 8) {
         /* somewhat arbitrary choice of minimum 8 blocks per client.
          * also avoids distribution of small files */
         blocks_per_client = 8;
     }
 
-    /* rank 0 creates destination file */
-    if (ctx->rank == 0) {
+    /* number block ranges starting from the manager rank, so that the
+     * ranks writing small files are spread the same way as managers */
+    int rel_rank = (ctx->rank - mgr_rank + ctx->total_ranks) %
+                   ctx->total_ranks;
+
+    /* manager rank creates destination file */
+    if (ctx->rank == mgr_rank) {
         urc = unifyfs_create(ctx->fshdl, O_WRONLY, dst_file_path, &gfid);
         if (UNIFYFS_SUCCESS != urc) {
             fprintf(stderr, "UNIFYFS-STAGE ERROR: "
@@ -353,8 +754,13 @@ int distribute_source_file_data(unifyfs_stage* ctx,
     }
     MPI_Barrier(MPI_COMM_WORLD);
 
-    size_t start_block_ndx = ctx->rank * blocks_per_client;
+    size_t start_block_ndx = (size_t)rel_rank * blocks_per_client;
     if (start_block_ndx < num_file_blocks) {
+        size_t n_blocks = num_file_blocks - start_block_ndx;
+        if (n_blocks > blocks_per_client) {
+            n_blocks = blocks_per_client;
+        }
+
         /* open source file */
         errno = 0;
         fd = open(src_file_path, O_RDONLY);
@@ -362,10 +768,14 @@ int distribute_source_file_data(unifyfs_stage* ctx,
             ret = errno;
             fprintf(stderr, "UNIFYFS-STAGE ERROR: failed to open(%s) - %s\n",
                     src_file_path, strerror(ret));
+        } else {
+            posix_fadvise(fd, (off_t)(start_block_ndx * transfer_blksz),
+                          (off_t)(n_blocks * transfer_blksz),
+                          POSIX_FADV_SEQUENTIAL);
         }
 
-        /* non-zero ranks just open destination file */
-        if (ctx->rank != 0) {
+        /* other ranks just open destination file */
+        if (ctx->rank != mgr_rank) {
             urc = unifyfs_open(ctx->fshdl, O_WRONLY, dst_file_path, &gfid);
             if (UNIFYFS_SUCCESS != urc) {
                 fprintf(stderr, "UNIFYFS-STAGE ERROR: "
@@ -380,39 +790,17 @@ int distribute_source_file_data(unifyfs_stage* ctx,
             goto err_ret;
         }
 
-        char* block_data = malloc(transfer_blksz);
-        if (NULL == block_data) {
-            ret = ENOMEM;
-            goto err_ret;
-        }
-
-        for (size_t i = 0; i < blocks_per_client; i++) {
-            memset(block_data, 0, transfer_blksz);
-            size_t block_ndx = start_block_ndx + i;
-            if (block_ndx < num_file_blocks) {
-                size_t nread = 0;
-                off_t block_offset = block_ndx * transfer_blksz;
-                rc = read_file_block(fd, block_offset, transfer_blksz,
-                                     block_data, &nread);
-                if (rc) {
-                    ret = rc;
-                    break;
-                } else {
-                    size_t nwrite = 0;
-                    rc = write_unify_file_block(ctx->fshdl, gfid, block_offset,
-                                                nread, block_data, &nwrite);
-                    if (rc) {
-                        ret = rc;
-                        break;
-                    } else if (verbose && (nread != nwrite)) {
-                        printf("[rank=%d] UNIFYFS-STAGE DEBUG: "
-                               "mismatch on read=%zu / write=%zu bytes\n",
-                               ctx->rank, nread, nwrite);
-                    }
-                }
+        if (ctx->checksum) {
+            digests = calloc(n_blocks, MD5_DIGEST_LENGTH);
+            if (NULL == digests) {
+                ret = ENOMEM;
+                goto err_ret;
             }
         }
 
+        ret = run_stage_pipeline(ctx, fd, gfid, transfer_blksz,
+                                 start_block_ndx, n_blocks, digests);
+
         /* synchronize local writes */
         urc = unifyfs_sync(ctx->fshdl, gfid);
         if (UNIFYFS_SUCCESS != urc) {
@@ -421,12 +809,138 @@ int distribute_source_file_data(unifyfs_stage* ctx,
                     dst_file_path, unifyfs_rc_enum_description(urc));
             ret = unifyfs_rc_errno(urc);
         }
+
+        /* verify the blocks written by this rank against the digests
+         * computed while they were read from the source file */
+        if ((0 == ret) && (NULL != digests)) {
+            ret = verify_block_checksums(ctx, gfid, dst_file_path,
+                                         transfer_blksz, src_file_size,
+                                         start_block_ndx, n_blocks,
+                                         digests);
+        }
     }
 
 err_ret:
     if (fd != -1) {
         close(fd);
     }
+    free(digests);
+
+    return ret;
+}
+
+typedef struct stage_file_size {
+    unsigned long size;         /* source file size */
+    int index;                  /* manifest index of file */
+} stage_file_size;
+
+/* qsort comparison to order files by size, largest first */
+static int compare_file_size(const void* a, const void* b)
+{
+    const stage_file_size* fa = (const stage_file_size*) a;
+    const stage_file_size* fb = (const stage_file_size*) b;
+    if (fa->size != fb->size) {
+        return (fa->size > fb->size) ? -1 : 1;
+    }
+    return fa->index - fb->index;
+}
+
+/* get the size of a source file, or 0 if it cannot be accessed (the
+ * error will be reported when the file is transferred) */
+static unsigned long source_file_size(unifyfs_stage* ctx, const char* path)
+{
+    if (is_unifyfs_path(ctx->fshdl, path)) {
+        unifyfs_gfid gfid;
+        unifyfs_file_status st;
+        unifyfs_rc urc = unifyfs_open(ctx->fshdl, O_RDONLY, path, &gfid);
+        if (UNIFYFS_SUCCESS == urc) {
+            urc = unifyfs_stat(ctx->fshdl, gfid, &st);
+            if (UNIFYFS_SUCCESS == urc) {
+                return (unsigned long) st.global_file_size;
+            }
+        }
+    } else {
+        struct stat ss;
+        if (0 == stat(path, &ss)) {
+            return (unsigned long) ss.st_size;
+        }
+    }
+    return 0;
+}
+
+int unifyfs_stage_schedule(unifyfs_stage* ctx,
+                           int n_files,
+                           char** src_files)
+{
+    int ret = 0;
+
+    ctx->n_files = n_files;
+    ctx->mgr_ranks = NULL;
+    if (n_files == 0) {
+        return 0;
+    }
+
+    int* mgr_ranks = calloc(n_files, sizeof(int));
+    if (NULL == mgr_ranks) {
+        return ENOMEM;
+    }
+
+    if (ctx->rank == 0) {
+        stage_file_size* files = calloc(n_files, sizeof(stage_file_size));
+        unsigned long* loads = calloc(ctx->total_ranks,
+                                      sizeof(unsigned long));
+        if ((NULL == files) || (NULL == loads)) {
+            /* fall back to round-robin assignment */
+            for (int i = 0; i < n_files; i++) {
+                mgr_ranks[i] = i % ctx->total_ranks;
+            }
+        } else {
+            for (int i = 0; i < n_files; i++) {
+                files[i].size = source_file_size(ctx, src_files[i]);
+                files[i].index = i;
+            }
+
+            /* assign each file, largest first, to the rank with the
+             * least total size so far */
+            qsort(files, n_files, sizeof(stage_file_size),
+                  compare_file_size);
+            for (int i = 0; i < n_files; i++) {
+                int min_rank = 0;
+                for (int r = 1; r < ctx->total_ranks; r++) {
+                    if (loads[r] < loads[min_rank]) {
+                        min_rank = r;
+                    }
+                }
+                mgr_ranks[files[i].index] = min_rank;
+                /* count empty files too, so they are spread out */
+                loads[min_rank] += files[i].size + 1;
+            }
+
+            if (verbose) {
+                for (int r = 0; r < ctx->total_ranks; r++) {
+                    printf("UNIFYFS-STAGE INFO: rank %d manages %lu B\n",
+                           r, loads[r]);
+                }
+            }
+        }
+        free(files);
+        free(loads);
+    }
+
+    int rc = MPI_Bcast((void*)mgr_ranks, n_files, MPI_INT,
+                       0, MPI_COMM_WORLD);
+    if (rc != MPI_SUCCESS) {
+        char mpi_errstr[MPI_MAX_ERROR_STRING];
+        int errstr_len = 0;
+        MPI_Error_string(rc, mpi_errstr, &errstr_len);
+        fprintf(stderr, "[rank=%d] UNIFYFS-STAGE ERROR: "
+                "MPI_Bcast() of file schedule failed - %s\n",
+                ctx->rank, mpi_errstr);
+        free(mgr_ranks);
+        ret = UNIFYFS_FAILURE;
+    } else {
+        ctx->mgr_ranks = mgr_ranks;
+    }
 
     return ret;
 }
@@ -462,6 +976,9 @@ int unifyfs_stage_transfer(unifyfs_stage* ctx,
 
     /* decide which rank gets to manage the transfer */
     int mgr_rank = (file_index - 1) % ctx->total_ranks;
+    if ((NULL != ctx->mgr_ranks) && (file_index <= ctx->n_files)) {
+        mgr_rank = ctx->mgr_ranks[file_index - 1];
+    }
 
     bool src_in_unify = is_unifyfs_path(ctx->fshdl, src);
     bool dst_in_unify = is_unifyfs_path(ctx->fshdl, dst);
@@ -551,7 +1068,7 @@ int unifyfs_stage_transfer(unifyfs_stage* ctx,
                     ctx->rank, mpi_errstr);
             ret = UNIFYFS_FAILURE;
         } else {
-            size_t transfer_blksz = UNIFYFS_STAGE_TRANSFER_BLOCKSIZE;
+            size_t transfer_blksz = ctx->block_size;
             size_t n_blocks = src_file_size / transfer_blksz;
             if (src_file_size % transfer_blksz) {
                 n_blocks++;
@@ -559,8 +1076,9 @@ int unifyfs_stage_transfer(unifyfs_stage* ctx,
 
             if (ctx->data_dist == UNIFYFS_STAGE_DATA_BALANCED) {
                 /* spread source file data evenly across clients */
-                rc = distribute_source_file_data(ctx, src, dst,
-                                                transfer_blksz, n_blocks);
+                rc = distribute_source_file_data(ctx, mgr_rank, src, dst,
+                                                 (size_t) src_file_size,
+                                                 transfer_blksz, n_blocks);
                 if (rc) {
                     ret = rc;
                     fprintf(stderr, "[rank=%d] UNIFYFS-STAGE ERROR: "
@@ -574,8 +1092,10 @@ int unifyfs_stage_transfer(unifyfs_stage* ctx,
         }
     }
 
+    /* stage-in checksums are verified per block by each rank as part of
+     * distributing the data, so only stage-out needs a whole-file pass */
     if (0 == ret) { /* transfer completed OK */
-        if ((mgr_rank == ctx->rank) && (ctx->checksum)) {
+        if ((mgr_rank == ctx->rank) && (ctx->checksum) && !dst_in_unify) {
             rc = verify_checksum(ctx, src_in_unify, dst_in_unify,
                                  src, dst);
             if (rc) {
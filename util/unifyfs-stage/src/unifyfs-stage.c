@@ -34,6 +34,8 @@ static int debug_pause;
 static int checksum;
 static int data_distribution;
 static int transfer_mode;
+static int n_threads;
+static size_t block_size;
 static char* manifest_file;
 static char* mountpoint = "/unifyfs";
 static char* status_file;
@@ -68,9 +70,10 @@ static int create_status_file(int status)
     return 0;
 }
 
-static char* short_opts = "cDhm:psS:v";
+static char* short_opts = "b:cDhm:psS:t:v";
 
 static struct option long_opts[] = {
+    { "block-size", 1, 0, 'b' },
     { "checksum", 0, 0, 'c' },
     { "debug-pause", 0, 0, 'D' },
     { "help", 0, 0, 'h' },
@@ -78,6 +81,7 @@ static struct option long_opts[] = {
     { "parallel", 0, 0, 'p' },
     { "skewed", 0, 0, 's' },
     { "status-file", 1, 0, 'S' },
+    { "threads", 1, 0, 't' },
     { "verbose", 0, 0, 'v' },
     { 0, 0, 0, 0 },
 };
@@ -100,6 +104,8 @@ static const char* usage_str =
     "\n"
     "Available options:\n"
     "\n"
+    "  -b, --block-size=<N>     Transfer data in blocks of <N> bytes\n"
+    "                           (default: 16 MiB)\n"
     "  -c, --checksum           Verify md5 checksum for each transfer\n"
     "                           (default: off)\n"
     "  -h, --help               Print usage information\n"
@@ -110,6 +116,8 @@ static const char* usage_str =
     "  -s, --skewed             Use skewed data distribution for stage-in\n"
     "                           (default: off, use balanced distribution)\n"
     "  -S, --status-file=<path> Create stage status file at <path>\n"
+    "  -t, --threads=<N>        Use <N> reader and <N> writer threads\n"
+    "                           per process for stage-in (default: 2)\n"
     "  -v, --verbose            Print verbose information\n"
     "                           (default: off)\n"
     "\n";
@@ -143,6 +151,8 @@ static int parse_option(int argc, char** argv)
 {
     int ch = 0;
     int optidx = 0;
+    long val;
+    char* endp = NULL;
     char* filepath = NULL;
 
     /* set defaults */
@@ -151,6 +161,8 @@ static int parse_option(int argc, char** argv)
     status_file = NULL;
     transfer_mode = UNIFYFS_STAGE_MODE_SERIAL;
     data_distribution = UNIFYFS_STAGE_DATA_BALANCED;
+    n_threads = UNIFYFS_STAGE_THREADS;
+    block_size = UNIFYFS_STAGE_TRANSFER_BLOCKSIZE;
 
     if (argc < 2) {
         return EINVAL;
@@ -159,6 +171,19 @@ static int parse_option(int argc, char** argv)
     while ((ch = getopt_long(argc, argv,
                              short_opts, long_opts, &optidx)) >= 0) {
         switch (ch) {
+        case 'b':
+            val = strtol(optarg, &endp, 0);
+            if ((val <= 0) || (*endp != '\0')) {
+                fprintf(stderr, "UNIFYFS-STAGE ERROR: "
+                        "invalid block size '%s'\n", optarg);
+                return EINVAL;
+            }
+            /* round up to the buffer alignment */
+            block_size = (((size_t)val + UNIFYFS_STAGE_BLOCK_ALIGN - 1) /
+                          UNIFYFS_STAGE_BLOCK_ALIGN) *
+                         UNIFYFS_STAGE_BLOCK_ALIGN;
+            break;
+
         case 'c':
             checksum = 1;
             break;
@@ -183,6 +208,16 @@ static int parse_option(int argc, char** argv)
             status_file = strdup(optarg);
             break;
 
+        case 't':
+            val = strtol(optarg, &endp, 0);
+            if ((val <= 0) || (val > 256) || (*endp != '\0')) {
+                fprintf(stderr, "UNIFYFS-STAGE ERROR: "
+                        "invalid thread count '%s'\n", optarg);
+                return EINVAL;
+            }
+            n_threads = (int) val;
+            break;
+
         case 'v':
             verbose = 1;
             break;
@@ -229,12 +264,16 @@ void print_unifyfs_stage_context(unifyfs_stage* ctx)
             "                  : transfer mode = %s\n"
             "                  : data distribution = %s\n"
             "                  : verify checksums = %d\n"
+            "                  : threads = %d\n"
+            "                  : block size = %zu\n"
             "                  : rank = %d of %d\n",
             ctx->manifest_file,
             ctx->mountpoint,
             mode_str,
             dist_str,
             ctx->checksum,
+            ctx->n_threads,
+            ctx->block_size,
             ctx->rank, ctx->total_ranks);
 }
 
@@ -385,6 +424,8 @@ int main(int argc, char** argv)
     ctx->data_dist = data_distribution;
     ctx->manifest_file = manifest_file;
     ctx->mode = transfer_mode;
+    ctx->n_threads = n_threads;
+    ctx->block_size = block_size;
     ctx->mountpoint = mountpoint;
     ctx->rank = rank;
     ctx->total_ranks = total_ranks;
@@ -424,11 +465,16 @@ int main(int argc, char** argv)
         MPI_Abort(MPI_COMM_WORLD, ret);
     }
 
+    /* read all the file pairs first, so that the transfers can be
+     * balanced across ranks by file size */
     int line_count = 0;
     int file_count = 0;
+    int file_max = 0;
     int n_xfer_failures = 0;
     char* src = NULL;
     char* dst = NULL;
+    char** src_files = NULL;
+    char** dst_files = NULL;
     char linebuf[LINE_MAX] = { 0, };
     while (NULL != fgets(linebuf, LINE_MAX - 1, manifest)) {
         line_count++;
@@ -441,16 +487,44 @@ int main(int argc, char** argv)
             }
             ret = rc;
         } else if ((0 == rc) && (NULL != src) && (NULL != dst)) {
-            file_count++;
-            rc = unifyfs_stage_transfer(ctx, file_count, src, dst);
-            if (rc) {
-                if (rc != EINVAL) {
-                    n_xfer_failures++;
+            if (file_count == file_max) {
+                file_max = (file_max ? (2 * file_max) : 64);
+                src_files = realloc(src_files, file_max * sizeof(char*));
+                dst_files = realloc(dst_files, file_max * sizeof(char*));
+                if ((NULL == src_files) || (NULL == dst_files)) {
+                    fprintf(stderr, "UNIFYFS-STAGE ERROR: "
+                            "failed to allocate manifest file list\n");
+                    MPI_Abort(MPI_COMM_WORLD, ENOMEM);
                 }
-                ret = rc;
             }
+            src_files[file_count] = src;
+            dst_files[file_count] = dst;
+            file_count++;
+        }
+    }
+    fclose(manifest);
+
+    rc = unifyfs_stage_schedule(ctx, file_count, src_files);
+    if (rc) {
+        /* fall back to assigning files to ranks round-robin */
+        ret = rc;
+    }
+
+    for (int i = 0; i < file_count; i++) {
+        rc = unifyfs_stage_transfer(ctx, i + 1, src_files[i], dst_files[i]);
+        if (rc) {
+            if (rc != EINVAL) {
+                n_xfer_failures++;
+            }
+            ret = rc;
         }
+        free(src_files[i]);
+        free(dst_files[i]);
     }
+    free(src_files);
+    free(dst_files);
+    free(ctx->mgr_ranks);
+    ctx->mgr_ranks = NULL;
 
     // wait until all processes are done
     MPI_Barrier(MPI_COMM_WORLD);
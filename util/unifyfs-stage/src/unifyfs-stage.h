@@ -12,6 +12,16 @@
 #define UNIFYFS_STAGE_TRANSFER_BLOCKSIZE (16 * 1048576)
 #endif
 
+/* transfer buffers and block sizes are aligned to this many bytes */
+#ifndef UNIFYFS_STAGE_BLOCK_ALIGN
+#define UNIFYFS_STAGE_BLOCK_ALIGN (4096)
+#endif
+
+/* default number of reader (and writer) threads per rank */
+#ifndef UNIFYFS_STAGE_THREADS
+#define UNIFYFS_STAGE_THREADS (2)
+#endif
+
 extern int verbose;
 
 enum {
@@ -25,6 +35,8 @@ struct _unifyfs_stage {
     int checksum;           /* perform checksum? 0:no, 1:yes */
     int data_dist;          /* data distribution? UNIFYFS_STAGE_DATA_xxxx */
     int mode;               /* transfer mode? UNIFYFS_STAGE_MODE_xxxx */
+    int n_threads;          /* reader and writer threads per rank */
+    size_t block_size;      /* transfer block size in bytes */
 
     int rank;               /* my rank */
     int total_ranks;        /* mpi world size */
@@ -33,6 +45,9 @@ struct _unifyfs_stage {
     char* manifest_file;    /* manifest file containing the transfer list */
 
     unifyfs_handle fshdl;   /* UnifyFS API client handle */
+
+    int n_files;            /* number of files in manifest */
+    int* mgr_ranks;         /* rank managing each file's transfer */
 };
 typedef struct _unifyfs_stage unifyfs_stage;
 
@@ -53,6 +68,22 @@ int unifyfs_parse_manifest_line(int line_number,
                                 char** src_file,
                                 char** dst_file);
 
+/**
+ * @brief choose the rank that manages each file's transfer, balancing
+ *        the total size of the source files managed by each rank. This
+ *        is a collective call, where rank 0 gets the file sizes and
+ *        broadcasts the choices, which are stored in the stage context.
+ *
+ * @param ctx               stage context
+ * @param n_files           number of files in manifest
+ * @param src_files         source file paths
+ *
+ * @return 0 on success, errno otherwise
+ */
+int unifyfs_stage_schedule(unifyfs_stage* ctx,
+                           int n_files,
+                           char** src_files);
+
 /**
  * @brief transfer source file to destination according to stage context
  *
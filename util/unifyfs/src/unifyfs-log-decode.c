@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Convert a binary server log (log.binary = on) to text.
+ *
+ * Usage: unifyfs-log-decode [binary_log] [text_log]
+ *
+ * Reads from stdin and writes to stdout when files are not given.
+ */
+
+#ifndef _CONFIG_H
+#define _CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "unifyfs_const.h"
+#include "unifyfs_log.h"
+
+int main(int argc, char** argv)
+{
+    FILE* in = stdin;
+    FILE* out = stdout;
+
+    if ((argc > 1) && ((0 == strcmp(argv[1], "-h")) ||
+                       (0 == strcmp(argv[1], "--help")))) {
+        printf("Usage: %s [binary_log] [text_log]\n", argv[0]);
+        return 0;
+    }
+
+    if ((argc > 1) && (0 != strcmp(argv[1], "-"))) {
+        in = fopen(argv[1], "r");
+        if (NULL == in) {
+            fprintf(stderr, "failed to open %s (%s)\n",
+                    argv[1], strerror(errno));
+            return 1;
+        }
+    }
+
+    if (argc > 2) {
+        out = fopen(argv[2], "w");
+        if (NULL == out) {
+            fprintf(stderr, "failed to open %s (%s)\n",
+                    argv[2], strerror(errno));
+            return 1;
+        }
+    }
+
+    int rc = unifyfs_log_decode(in, out);
+    if (rc == EINVAL) {
+        fprintf(stderr, "input is not a UnifyFS binary log\n");
+    } else if (rc == EIO) {
+        fprintf(stderr, "warning: last log record is incomplete\n");
+    } else if (rc != UNIFYFS_SUCCESS) {
+        fprintf(stderr, "failed to decode log (%s)\n", strerror(rc));
+    }
+
+    if (in != stdin) {
+        fclose(in);
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return (rc == UNIFYFS_SUCCESS) ? 0 : 1;
+}
@@ -39,6 +39,7 @@
 #include <config.h>
 #endif
 
+#include <errno.h>
 #include <libgen.h> // basename
 #include <stdio.h>
 #include <stdlib.h>
@@ -56,10 +57,11 @@ typedef enum {
     INVALID_ACTION   = -1,
     ACT_START        = 0,
     ACT_TERMINATE    = 1,
-    N_ACT            = 2
+    ACT_STATS        = 2,
+    N_ACT            = 3
 } action_e;
 
-static char* actions[N_ACT] = { "start", "terminate" };
+static char* actions[N_ACT] = { "start", "terminate", "stats" };
 
 static action_e action = INVALID_ACTION;
 static unifyfs_args_t cli_args;
@@ -90,6 +92,7 @@ static char* usage_str =
     "<command> should be one of the following:\n"
     "  start       start the UnifyFS server daemons\n"
     "  terminate   terminate the UnifyFS server daemons\n"
+    "  stats       print performance counters of the local UnifyFS server\n"
     "\n"
     "Common options:\n"
     "  -d, --debug               enable debug output\n"
@@ -112,6 +115,9 @@ static char* usage_str =
     "  -T, --stage-timeout=<sec>  [OPTIONAL] timeout for stage-out operation\n"
     "  -s, --script=<path>        [OPTIONAL] <path> to custom termination script\n"
     "  -S, --share-dir=<path>     [REQUIRED for --stage-out] shared file system <path> for use by servers\n"
+    "\n"
+    "Command options for \"stats\":\n"
+    "  -m, --mount=<path>         [REQUIRED] UnifyFS mountpoint <path>\n"
     "\n";
 
 static int debug;
@@ -254,6 +260,20 @@ int main(int argc, char** argv)
         printf("stage_timeout:\t%d\n", cli_args.stage_timeout);
     }
 
+    if (action == ACT_STATS) {
+        /* the stats helper is a UnifyFS client of the local server */
+        if (NULL == cli_args.mountpoint) {
+            printf("USAGE ERROR: mountpoint (-m) is required!\n");
+            usage(1);
+            return -EINVAL;
+        }
+        char* stats_argv[] = { LIBEXECDIR "/unifyfs-stats",
+                               cli_args.mountpoint, NULL };
+        execv(stats_argv[0], stats_argv);
+        perror("failed to execv() unifyfs-stats");
+        return -errno;
+    }
+
     ret = unifyfs_detect_resources(&resource);
     if (ret) {
         fprintf(stderr, "ERROR: no supported resource manager detected\n");